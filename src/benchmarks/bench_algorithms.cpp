@@ -0,0 +1,252 @@
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/any.hpp>
+
+#include "algorithms/algebraic_constraints/bin_operation_enum.h"
+#include "algorithms/algo_factory.h"
+#include "algorithms/algorithm_types.h"
+#include "algorithms/association_rules/ar_algorithm_enums.h"
+#include "algorithms/cfd/enums.h"
+#include "algorithms/metric/enums.h"
+#include "bench_datasets.h"
+#include "config/indices/type.h"
+#include "config/max_arity/type.h"
+#include "config/names.h"
+#include "config/tabular_data/input_table_type.h"
+#include "parser/csv_parser/create_csv_parser.h"
+
+namespace benchmarks {
+
+namespace {
+
+using algos::AlgorithmType;
+
+/// an end-to-end run of an algorithm on one input
+struct AlgorithmBenchmark {
+    AlgorithmType type;
+    std::string input_name;
+    /// files the algorithm reads, the benchmark is skipped if any of them is missing
+    std::vector<std::filesystem::path> input_files;
+    algos::StdParamsMap params;
+};
+
+/* Algorithms that finish on the heavy tables in reasonable time, see Dataset::heavy */
+bool RunsOnHeavyTables(AlgorithmType type) {
+    switch (type) {
+        case AlgorithmType::pyro:
+        case AlgorithmType::tane:
+        case AlgorithmType::hyfd:
+        case AlgorithmType::hyucc:
+        case AlgorithmType::pyroucc:
+        case AlgorithmType::hpivalid:
+        case AlgorithmType::stats:
+        case AlgorithmType::fd_verifier:
+        case AlgorithmType::ucc_verifier:
+        case AlgorithmType::faida:
+        case AlgorithmType::spider:
+        case AlgorithmType::mind:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::vector<AlgorithmBenchmark> MakeAlgorithmBenchmarks() {
+    using namespace config::names;
+    std::vector<AlgorithmBenchmark> benchmarks;
+    auto add_table_benchmark = [&benchmarks](AlgorithmType type, Dataset const& dataset,
+                                             algos::StdParamsMap params) {
+        if (dataset.heavy && !RunsOnHeavyTables(type)) return;
+        params.emplace(kCsvConfig, dataset.config);
+        benchmarks.push_back({type, dataset.name, {dataset.config.path}, std::move(params)});
+    };
+    auto find_dataset = [](std::string_view name) -> Dataset const& {
+        for (Dataset const& dataset : GetDatasets()) {
+            if (dataset.name == name) return dataset;
+        }
+        throw std::logic_error("Unknown dataset " + std::string(name));
+    };
+
+    /* Miners that take the whole table and nothing else */
+    for (AlgorithmType type :
+         {AlgorithmType::depminer, AlgorithmType::dfd, AlgorithmType::fastfds,
+          AlgorithmType::fdep, AlgorithmType::fdmine, AlgorithmType::pyro, AlgorithmType::tane,
+          AlgorithmType::pfdtane, AlgorithmType::fun, AlgorithmType::hyfd, AlgorithmType::aidfd,
+          AlgorithmType::stats, AlgorithmType::hyucc, AlgorithmType::pyroucc,
+          AlgorithmType::hpivalid}) {
+        for (Dataset const& dataset : GetDatasets()) {
+            add_table_benchmark(type, dataset, {});
+        }
+    }
+    /* Order dependencies are only mined on the tables the tests check them on, the lattice of the
+     * wider ones is too large */
+    for (char const* name : {"iris", "breast_cancer", "abalone", "neighbors10k"}) {
+        add_table_benchmark(AlgorithmType::fastod, find_dataset(name), {});
+    }
+    add_table_benchmark(AlgorithmType::order, find_dataset("neighbors10k"), {});
+
+    for (Dataset const& dataset : GetDatasets()) {
+        add_table_benchmark(AlgorithmType::fd_verifier, dataset,
+                            {{kLhsIndices, config::IndicesType{0}},
+                             {kRhsIndices, config::IndicesType{1}}});
+        add_table_benchmark(AlgorithmType::ucc_verifier, dataset,
+                            {{kUCCIndices, config::IndicesType{0, 1}}});
+        /* Without a limit on the arity n-ary INDs of the wider tables take gigabytes */
+        for (AlgorithmType type :
+             {AlgorithmType::faida, AlgorithmType::spider, AlgorithmType::mind}) {
+            if (dataset.heavy && !RunsOnHeavyTables(type)) continue;
+            benchmarks.push_back({type,
+                                  dataset.name,
+                                  {dataset.config.path},
+                                  {{kCsvConfigs, std::vector<CSVConfig>{dataset.config}},
+                                   {kMaximumArity, config::MaxArityType{2}}}});
+        }
+    }
+
+    /* Metric FDs and algebraic constraints need numeric columns */
+    for (char const* name : {"iris", "abalone"}) {
+        add_table_benchmark(AlgorithmType::metric, find_dataset(name),
+                            {{kParameter, 1.0L},
+                             {kLhsIndices, config::IndicesType{0}},
+                             {kRhsIndices, config::IndicesType{1}},
+                             {kEqualNulls, true},
+                             {kMetric, +algos::metric::Metric::euclidean},
+                             {kMetricAlgorithm, +algos::metric::MetricAlgo::brute},
+                             {kDistFromNullIsInfinity, false}});
+    }
+    add_table_benchmark(AlgorithmType::ac, find_dataset("iris"),
+                        {{kBinaryOperation, +algos::Binop::Addition},
+                         {kFuzziness, 0.1},
+                         {kFuzzinessProbability, 0.9},
+                         {kWeight, 0.05},
+                         {kBumpsLimit, size_t{0}},
+                         {kIterationsLimit, size_t{4}},
+                         {kACSeed, 0.0}});
+
+    /* Inputs that are not tables of datasets.zip, they are copied from test_input_data */
+    Dataset const tennis = MakeDataset("tennis", "cfd_data/tennis.csv", ',', true);
+    Dataset const mushroom = MakeDataset("mushroom", "cfd_data/mushroom.csv", ',', true);
+    add_table_benchmark(AlgorithmType::fd_first_dfs, tennis,
+                        {{kCfdMinimumSupport, 8u},
+                         {kCfdMinimumConfidence, 0.85},
+                         {kCfdMaximumLhs, 3u},
+                         {kCfdSubstrategy, +algos::cfd::Substrategy::dfs},
+                         {kCfdColumnsNumber, 0u},
+                         {kCfdTuplesNumber, 0u}});
+    add_table_benchmark(AlgorithmType::fd_first_dfs, mushroom,
+                        {{kCfdMinimumSupport, 4u},
+                         {kCfdMinimumConfidence, 0.9},
+                         {kCfdMaximumLhs, 4u},
+                         {kCfdSubstrategy, +algos::cfd::Substrategy::dfs},
+                         {kCfdColumnsNumber, 4u},
+                         {kCfdTuplesNumber, 50u}});
+
+    Dataset const rules_book =
+            MakeDataset("rules-book", "transactional_data/rules-book.csv", ',', false);
+    Dataset const rules_kaggle =
+            MakeDataset("rules-kaggle-rows", "transactional_data/rules-kaggle-rows.csv", ',', true);
+    add_table_benchmark(AlgorithmType::apriori, rules_book,
+                        {{kInputFormat, +algos::InputFormat::singular},
+                         {kMinimumSupport, 0.3},
+                         {kMinimumConfidence, 0.5},
+                         {kTIdColumnIndex, 0u},
+                         {kItemColumnIndex, 1u}});
+    add_table_benchmark(AlgorithmType::apriori, rules_kaggle,
+                        {{kInputFormat, +algos::InputFormat::tabular},
+                         {kMinimumSupport, 0.1},
+                         {kMinimumConfidence, 0.5},
+                         {kFirstColumnTId, true}});
+
+    Dataset const dd_table = MakeDataset("TestDD", "TestDD.csv", ',', true);
+    Dataset const dif_table = MakeDataset("TestDif", "dif_tables/TestDif.csv", ',', true);
+    algos::StdParamsMap split_params;
+    /* The parser opens the file at once, a missing one is reported when the benchmark runs */
+    if (std::filesystem::exists(dif_table.config.path)) {
+        split_params.emplace(kDifferenceTable, CreateCSVParser(dif_table.config));
+    }
+    add_table_benchmark(AlgorithmType::split, dd_table, std::move(split_params));
+    benchmarks.back().input_files.push_back(dif_table.config.path);
+
+    for (std::string_view graph : {"directors", "quadrangle"}) {
+        std::filesystem::path const graph_path =
+                kInputDataDir / "graph_data" / (std::string(graph) + ".dot");
+        std::filesystem::path const gfd_path =
+                kInputDataDir / "graph_data" / (std::string(graph) + "_gfd.dot");
+        for (AlgorithmType type : {AlgorithmType::gfdvalid, AlgorithmType::egfdvalid,
+                                   AlgorithmType::naivegfdvalid}) {
+            benchmarks.push_back({type,
+                                  std::string(graph),
+                                  {graph_path, gfd_path},
+                                  {{kGraphData, graph_path},
+                                   {kGfdData, std::vector<std::filesystem::path>{gfd_path}}}});
+        }
+    }
+    return benchmarks;
+}
+
+/* Tables passed as options are read on every execution, so they are rewound before it */
+void RewindTables(algos::StdParamsMap const& params) {
+    for (auto const& [name, value] : params) {
+        if (auto const* table = boost::any_cast<config::InputTable>(&value)) {
+            (*table)->Reset();
+        }
+    }
+}
+
+void BM_Algorithm(benchmark::State& state, AlgorithmBenchmark const& bench) {
+    for (std::filesystem::path const& path : bench.input_files) {
+        if (SkipIfMissing(state, path)) return;
+    }
+
+    /* Loading is not measured, every iteration only sets the options again, as Execute unsets
+     * them */
+    std::unique_ptr<algos::Algorithm> algorithm;
+    try {
+        algorithm = algos::CreateAlgorithm(bench.type, bench.params);
+    } catch (std::exception const& e) {
+        state.SkipWithError(e.what());
+        return;
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        RewindTables(bench.params);
+        algos::ConfigureFromMap(*algorithm, bench.params);
+        state.ResumeTiming();
+        algorithm->Execute();
+    }
+
+    state.counters["peak_memory_bytes"] = static_cast<double>(algorithm->GetPeakMemoryUsage());
+    for (auto const& [name, value] : algorithm->GetMetrics().GetCounters()) {
+        state.counters[name] = static_cast<double>(value);
+    }
+}
+
+}  // namespace
+
+void RegisterAlgorithmBenchmarks() {
+    std::unordered_set<AlgorithmType::_integral> covered;
+    for (AlgorithmBenchmark& bench : MakeAlgorithmBenchmarks()) {
+        covered.insert(bench.type._to_integral());
+        std::string const name =
+                std::string("Algorithm/") + bench.type._to_string() + "/" + bench.input_name;
+        benchmark::RegisterBenchmark(name.c_str(), BM_Algorithm, std::move(bench))
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+    }
+    for (AlgorithmType type : AlgorithmType::_values()) {
+        if (!covered.contains(type._to_integral())) {
+            throw std::logic_error(std::string("No benchmark for algorithm ") + type._to_string());
+        }
+    }
+}
+
+}  // namespace benchmarks
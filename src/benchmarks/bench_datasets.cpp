@@ -0,0 +1,30 @@
+#include "bench_datasets.h"
+
+#include <utility>
+
+namespace benchmarks {
+
+Dataset MakeDataset(std::string name, std::string_view filename, char separator,
+                    bool has_header, bool heavy) {
+    return {std::move(name), {kInputDataDir / filename, separator, has_header}, heavy};
+}
+
+std::vector<Dataset> const& GetDatasets() {
+    static std::vector<Dataset> const datasets = {
+            MakeDataset("iris", "iris.csv", ',', false),
+            MakeDataset("breast_cancer", "breast_cancer.csv", ',', true),
+            MakeDataset("abalone", "abalone.csv", ',', false),
+            MakeDataset("CIPublicHighway10k", "CIPublicHighway10k.csv", ',', true),
+            MakeDataset("neighbors10k", "neighbors10k.csv", ',', true),
+            MakeDataset("adult", "adult.csv", ';', false, true),
+    };
+    return datasets;
+}
+
+bool SkipIfMissing(benchmark::State& state, std::filesystem::path const& path) {
+    if (std::filesystem::exists(path)) return false;
+    state.SkipWithError(("no input file " + path.string()).c_str());
+    return true;
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "parser/csv_parser/csv_parser.h"
+
+namespace benchmarks {
+
+/// path to the directory with the unpacked datasets.zip and the test data
+static auto const kInputDataDir = std::filesystem::current_path() / "input_data";
+
+/// a table and the name it has in the benchmark names
+struct Dataset {
+    std::string name;
+    CSVConfig config;
+    /// only the algorithms that scale to tens of thousands of rows run on heavy tables
+    bool heavy;
+};
+
+/// create `Dataset` using relative path to the directory with input data
+Dataset MakeDataset(std::string name, std::string_view filename, char separator,
+                    bool has_header, bool heavy = false);
+
+/// tables of datasets.zip the kernels and the table miners run on, from the smallest one
+std::vector<Dataset> const& GetDatasets();
+
+/// skips the benchmark if `path` doesn't exist, e.g. when datasets.zip is not unpacked.
+/// Must be called before the benchmark loop
+bool SkipIfMissing(benchmark::State& state, std::filesystem::path const& path);
+
+void RegisterKernelBenchmarks();
+void RegisterAlgorithmBenchmarks();
+
+}  // namespace benchmarks
@@ -0,0 +1,189 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/dynamic_bitset.hpp>
+
+#include "bench_datasets.h"
+#include "model/table/agree_set_factory.h"
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/position_list_index.h"
+#include "model/table/relational_schema.h"
+#include "model/table/typed_column_data.h"
+#include "model/table/vertical.h"
+#include "model/table/vertical_map.h"
+#include "parser/csv_parser/create_csv_parser.h"
+
+namespace benchmarks {
+
+namespace {
+
+using model::PositionListIndex;
+
+std::unique_ptr<ColumnLayoutRelationData> LoadRelation(CSVConfig const& csv_config) {
+    auto table = CreateCSVParser(csv_config);
+    return ColumnLayoutRelationData::CreateFrom(*table, true);
+}
+
+void BM_CsvParse(benchmark::State& state, CSVConfig csv_config, CSVReaderType reader_type) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    csv_config.reader_type = reader_type;
+    size_t rows = 0;
+    for (auto _ : state) {
+        auto table = CreateCSVParser(csv_config);
+        while (table->HasNextRow()) {
+            benchmark::DoNotOptimize(table->GetNextRow());
+            ++rows;
+        }
+    }
+    state.SetItemsProcessed(rows);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(csv_config.path));
+}
+
+void BM_TypeInference(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    for (auto _ : state) {
+        auto table = CreateCSVParser(csv_config);
+        benchmark::DoNotOptimize(model::CreateTypedColumnData(*table, true));
+    }
+}
+
+void BM_PliCreateFor(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    /* Value ids are assigned beforehand, so that only building the clusters is measured */
+    std::vector<std::vector<int>> columns;
+    auto table = CreateCSVParser(csv_config);
+    std::vector<std::unordered_map<std::string, int>> value_ids(table->GetNumberOfColumns());
+    columns.resize(value_ids.size());
+    while (table->HasNextRow()) {
+        std::vector<std::string> row = table->GetNextRow();
+        for (size_t i = 0; i < row.size() && i < columns.size(); ++i) {
+            auto it = value_ids[i].try_emplace(std::move(row[i]), value_ids[i].size()).first;
+            columns[i].push_back(it->second);
+        }
+    }
+
+    for (auto _ : state) {
+        for (std::vector<int>& column : columns) {
+            benchmark::DoNotOptimize(PositionListIndex::CreateFor(column, true));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columns.size());
+}
+
+void BM_PliIntersect(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    auto relation = LoadRelation(csv_config);
+    size_t const columns_num = relation->GetNumColumns();
+    for (auto _ : state) {
+        for (size_t i = 0; i < columns_num; ++i) {
+            PositionListIndex const* left = relation->GetColumnData(i).GetPositionListIndex();
+            for (size_t j = i + 1; j < columns_num; ++j) {
+                benchmark::DoNotOptimize(
+                        left->Intersect(relation->GetColumnData(j).GetPositionListIndex()));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * columns_num * (columns_num - 1) / 2);
+}
+
+void BM_AgreeSets(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    auto relation = LoadRelation(csv_config);
+    model::AgreeSetFactory factory(relation.get());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(factory.GenAgreeSets());
+    }
+}
+
+/* Map from every column and every pair of columns to itself, the shape of the PLI cache of the
+ * lattice traversing miners */
+std::unique_ptr<model::VerticalMap<Vertical>> MakeVerticalMap(
+        RelationalSchema const* schema, std::vector<Vertical>& keys) {
+    auto map = std::make_unique<model::VerticalMap<Vertical>>(schema);
+    size_t const columns_num = schema->GetNumColumns();
+    for (size_t i = 0; i < columns_num; ++i) {
+        for (size_t j = i; j < columns_num; ++j) {
+            boost::dynamic_bitset<> indices(columns_num);
+            indices.set(i).set(j);
+            keys.push_back(schema->GetVertical(std::move(indices)));
+            map->Put(keys.back(), std::make_shared<Vertical>(keys.back()));
+        }
+    }
+    return map;
+}
+
+void BM_VerticalMapGet(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    auto relation = LoadRelation(csv_config);
+    std::vector<Vertical> keys;
+    auto map = MakeVerticalMap(relation->GetSchema(), keys);
+    auto const& const_map = *map;
+    for (auto _ : state) {
+        for (Vertical const& key : keys) {
+            benchmark::DoNotOptimize(const_map.Get(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_VerticalMapSubsetEntries(benchmark::State& state, CSVConfig const& csv_config) {
+    if (SkipIfMissing(state, csv_config.path)) return;
+    auto relation = LoadRelation(csv_config);
+    std::vector<Vertical> keys;
+    auto map = MakeVerticalMap(relation->GetSchema(), keys);
+    /* Every key of three consecutive columns has six subsets in the map */
+    RelationalSchema const* schema = relation->GetSchema();
+    size_t const columns_num = schema->GetNumColumns();
+    std::vector<Vertical> queries;
+    for (size_t i = 0; i + 2 < columns_num; ++i) {
+        boost::dynamic_bitset<> indices(columns_num);
+        indices.set(i).set(i + 1).set(i + 2);
+        queries.push_back(schema->GetVertical(std::move(indices)));
+    }
+    for (auto _ : state) {
+        for (Vertical const& query : queries) {
+            benchmark::DoNotOptimize(map->GetSubsetEntries(query));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+}  // namespace
+
+void RegisterKernelBenchmarks() {
+    for (Dataset const& dataset : GetDatasets()) {
+        CSVConfig const& config = dataset.config;
+        std::vector<benchmark::internal::Benchmark*> kernels = {
+                benchmark::RegisterBenchmark(("CSVParser/stream/" + dataset.name).c_str(),
+                                             BM_CsvParse, config, CSVReaderType::kStream),
+                benchmark::RegisterBenchmark(("CSVParser/mmap/" + dataset.name).c_str(),
+                                             BM_CsvParse, config, CSVReaderType::kMmap),
+                benchmark::RegisterBenchmark(("TypeInference/" + dataset.name).c_str(),
+                                             BM_TypeInference, config),
+                benchmark::RegisterBenchmark(("PLI/CreateFor/" + dataset.name).c_str(),
+                                             BM_PliCreateFor, config),
+                benchmark::RegisterBenchmark(("PLI/Intersect/" + dataset.name).c_str(),
+                                             BM_PliIntersect, config),
+                benchmark::RegisterBenchmark(("VerticalMap/Get/" + dataset.name).c_str(),
+                                             BM_VerticalMapGet, config),
+                benchmark::RegisterBenchmark(
+                        ("VerticalMap/GetSubsetEntries/" + dataset.name).c_str(),
+                        BM_VerticalMapSubsetEntries, config)};
+        /* Agree sets are built from all pairs of rows in the same clusters, which doesn't finish
+         * in reasonable time on the heavy tables */
+        if (!dataset.heavy) {
+            kernels.push_back(benchmark::RegisterBenchmark(
+                    ("AgreeSetFactory/" + dataset.name).c_str(), BM_AgreeSets, config));
+        }
+        for (benchmark::internal::Benchmark* kernel : kernels) {
+            kernel->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
+
+}  // namespace benchmarks
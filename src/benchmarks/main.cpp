@@ -0,0 +1,30 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <easylogging++.h>
+
+#include "bench_datasets.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char** argv) {
+    el::Loggers::configureFromGlobal("logging.conf");
+
+    /* JSON is the default so that the results of two commits can be compared with compare.py of
+     * Google Benchmark, a --benchmark_format given by the user comes later and wins */
+    std::string json_format = "--benchmark_format=json";
+    std::vector<char*> args(argv, argv + argc);
+    args.insert(args.begin() + 1, json_format.data());
+    int args_num = static_cast<int>(args.size());
+
+    benchmark::Initialize(&args_num, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_num, args.data())) return 1;
+
+    benchmarks::RegisterKernelBenchmarks();
+    benchmarks::RegisterAlgorithmBenchmarks();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
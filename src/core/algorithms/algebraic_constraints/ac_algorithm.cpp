@@ -132,7 +132,7 @@ std::vector<std::byte const*> ACAlgorithm::Sampling(std::vector<model::TypedColu
     size_t i = 0;
     size_t sample_size = CalculateSampleSize(k_bumps);
     size_t new_k_bumps = 1;
-    size_t n_rows = data.at(lhs_i).GetData().size();
+    size_t n_rows = data.at(lhs_i).GetNumRows();
     while (i < iterations_limit_ &&
            (ranges.empty() || sample_size < CalculateSampleSize(new_k_bumps))) {
         k_bumps = new_k_bumps;
@@ -155,19 +155,19 @@ std::vector<std::byte const*> ACAlgorithm::Sampling(std::vector<model::TypedColu
 std::vector<std::byte const*> ACAlgorithm::SamplingIteration(
         std::vector<model::TypedColumnData> const& data, size_t lhs_i, size_t rhs_i,
         double probability, ACPairs& ac_pairs) {
-    std::vector<std::byte const*> const& lhs = data.at(lhs_i).GetData();
-    std::vector<std::byte const*> const& rhs = data.at(rhs_i).GetData();
+    model::TypedColumnData const& lhs = data.at(lhs_i);
+    model::TypedColumnData const& rhs = data.at(rhs_i);
     ac_pairs.clear();
     std::mt19937 gen(seed_);
 
     std::bernoulli_distribution d(probability);
-    for (size_t i = 0; i < lhs.size(); ++i) {
+    for (size_t i = 0; i < lhs.GetNumRows(); ++i) {
         if (d(gen)) {
-            std::byte const* l = lhs.at(i);
-            std::byte const* r = rhs.at(i);
-            if (data[lhs_i].IsNullOrEmpty(i) || data[rhs_i].IsNullOrEmpty(i)) {
+            if (lhs.IsNullOrEmpty(i) || rhs.IsNullOrEmpty(i)) {
                 continue;
             }
+            std::byte const* l = lhs.GetValue(i);
+            std::byte const* r = rhs.GetValue(i);
             auto res = std::unique_ptr<std::byte[]>(num_type_->Allocate());
             num_type_->ValueFromStr(res.get(), "0");
             if (bin_operation_ == +Binop::Division &&
@@ -37,16 +37,16 @@ void ACExceptionFinder::CollectColumnPairExceptions(std::vector<model::TypedColu
                                                     RangesCollection const& ranges_collection) {
     size_t lhs_i = ranges_collection.col_pair.col_i.first;
     size_t rhs_i = ranges_collection.col_pair.col_i.second;
-    std::vector<std::byte const*> const& lhs = data.at(lhs_i).GetData();
-    std::vector<std::byte const*> const& rhs = data.at(rhs_i).GetData();
+    model::TypedColumnData const& lhs = data.at(lhs_i);
+    model::TypedColumnData const& rhs = data.at(rhs_i);
     std::unique_ptr<model::INumericType> num_type =
-            model::CreateSpecificType<model::INumericType>(data.at(lhs_i).GetTypeId(), true);
-    for (size_t i = 0; i < lhs.size(); ++i) {
-        std::byte const* l = lhs.at(i);
-        std::byte const* r = rhs.at(i);
-        if (data[lhs_i].IsNullOrEmpty(i) || data[rhs_i].IsNullOrEmpty(i)) {
+            model::CreateSpecificType<model::INumericType>(lhs.GetTypeId(), true);
+    for (size_t i = 0; i < lhs.GetNumRows(); ++i) {
+        if (lhs.IsNullOrEmpty(i) || rhs.IsNullOrEmpty(i)) {
             continue;
         }
+        std::byte const* l = lhs.GetValue(i);
+        std::byte const* r = rhs.GetValue(i);
         auto res = std::unique_ptr<std::byte[]>(num_type->Allocate());
         num_type->ValueFromStr(res.get(), "0");
         if (ac_alg_->GetBinOperation() == +Binop::Division &&
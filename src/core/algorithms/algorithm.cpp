@@ -75,7 +75,24 @@ unsigned long long Algorithm::Execute() {
         throw std::logic_error("All options need to be set before execution.");
     progress_.ResetProgress();
     ResetState();
-    auto time_ms = ExecuteInternal();
+    /* The token is reset after the execution and not before it, so that a stop requested just
+     * before the execution or while it starts is not lost */
+    if (time_limit_ != std::chrono::milliseconds::zero()) {
+        LimitExecutionTime(time_limit_);
+    }
+    memory_budget_.SetLimit(util::MemoryBudget::kUnlimited);
+    memory_budget_.ResetPeak();
+    metrics_.Reset();
+    util::Metrics::Scope metrics_scope(&metrics_);
+    unsigned long long time_ms;
+    try {
+        time_ms = ExecuteInternal();
+    } catch (...) {
+        cancellation_.Reset();
+        throw;
+    }
+    complete_ = !cancellation_.Stopped();
+    cancellation_.Reset();
     for (auto const& opt_name : available_options_) {
         possible_options_.at(opt_name)->Unset();
     }
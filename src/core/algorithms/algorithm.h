@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <filesystem>
 #include <string_view>
 #include <typeindex>
@@ -14,6 +15,9 @@
 #include "config/option.h"
 #include "model/table/idataset_stream.h"
 #include "parser/csv_parser/csv_parser.h"
+#include "util/cancellation_token.h"
+#include "util/memory_budget.h"
+#include "util/metrics.h"
 #include "util/progress.h"
 
 namespace algos {
@@ -30,6 +34,14 @@ private:
 
     bool data_loaded_ = false;
 
+    util::CancellationToken mutable cancellation_;
+    std::chrono::milliseconds time_limit_{0};
+    bool complete_ = true;
+
+    util::MemoryBudget mutable memory_budget_{&util::MemoryBudget::Process()};
+
+    util::Metrics mutable metrics_;
+
     // Clear the necessary fields for Execute to run repeatedly with different
     // configuration parameters on the same dataset.
     virtual void ResetState() = 0;
@@ -52,6 +64,37 @@ protected:
         progress_.ToNextProgressPhase();
     }
 
+    // Mining loops should check it and return what they have found so far once it is true
+    bool StopRequested() const noexcept {
+        return cancellation_.StopRequested();
+    }
+
+    // For the parts of an algorithm that check for a stop on their own
+    util::CancellationToken& GetCancellationToken() const noexcept {
+        return cancellation_;
+    }
+
+    // Stops the current execution earlier than the limit set by SetTimeLimit, for algorithms
+    // that have a time limit option of their own
+    void LimitExecutionTime(std::chrono::milliseconds time_limit) noexcept {
+        cancellation_.LimitDeadline(util::CancellationToken::Clock::now() + time_limit);
+    }
+
+    // Large structures reserve their memory here, see util::MemoryBudget
+    util::MemoryBudget& GetMemoryBudget() const noexcept {
+        return memory_budget_;
+    }
+
+    // For algorithms with the kMemLimitMbOpt option, the limit is lifted before every execution
+    void LimitMemory(size_t limit_bytes) noexcept {
+        memory_budget_.SetLimit(limit_bytes);
+    }
+
+    // Makes `nested`, which is run as a part of this algorithm, stop together with it
+    void PropagateCancellationTo(Algorithm& nested) noexcept {
+        nested.cancellation_.SetParent(&cancellation_);
+    }
+
     void MakeOptionsAvailable(std::vector<std::string_view> const& option_names);
 
     template <typename T>
@@ -91,6 +134,36 @@ public:
 
     void SetOption(std::string_view option_name, boost::any const& value = {});
 
+    // Asks the current execution to stop as soon as possible, it then returns the dependencies
+    // found so far and IsComplete() is false. May be called from any thread.
+    // NOTE: a request made while the algorithm is not executed stops the next execution.
+    void Cancel() noexcept {
+        cancellation_.Cancel();
+    }
+
+    // Stops every following execution once it has run for `time_limit`. Zero removes the limit
+    void SetTimeLimit(std::chrono::milliseconds time_limit) noexcept {
+        time_limit_ = time_limit;
+    }
+
+    // Whether the last execution finished without being stopped
+    bool IsComplete() const noexcept {
+        return complete_;
+    }
+
+    // The most memory in bytes the accounted structures (caches, lattice levels, matrices) took
+    // at once during the last execution
+    size_t GetPeakMemoryUsage() const noexcept {
+        return memory_budget_.GetPeak();
+    }
+
+    // Counters, timers and histograms of the last execution, see util::Metrics. They are zeroed
+    // when an execution starts and recorded by the algorithm itself as well as by the model
+    // classes it uses, so they can be read once Execute returns or polled while it runs
+    util::Metrics& GetMetrics() const noexcept {
+        return metrics_;
+    }
+
     [[nodiscard]] std::unordered_set<std::string_view> GetNeededOptions() const;
 
     void UnsetOption(std::string_view option_name) noexcept;
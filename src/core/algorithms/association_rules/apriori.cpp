@@ -126,7 +126,8 @@ unsigned long long Apriori::FindFrequent() {
     auto start_time = std::chrono::system_clock::now();
 
     CreateFirstLevelCandidates();
-    while (!candidates_.empty()) {
+    /* Rules are generated from the levels that were counted before the stop */
+    while (!candidates_.empty() && !StopRequested()) {
         unsigned candidates_count = 0;
         for (auto const& [parent, candidate_children] : candidates_) {
             candidates_count += candidate_children.size();
@@ -157,7 +158,7 @@ unsigned long long Apriori::GenerateAllRules() {
     UpdatePath(path, root_.children);
     unsigned long long frequent_count = 0;
 
-    while (!path.empty()) {
+    while (!path.empty() && !StopRequested()) {
         auto curr_node = path.front();
         path.pop();
 
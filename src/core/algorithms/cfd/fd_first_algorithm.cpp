@@ -223,6 +223,7 @@ FDFirstAlgorithm::ExpandMiningFd(MinerNode<PartitionTIdList> const& inode, int i
 void FDFirstAlgorithm::FdsFirstDFS(Itemset const& prefix, PIdListMiners const& items,
                                    Substrategy ss) {
     for (int ix = static_cast<int>(items.size()) - 1; ix >= 0; ix--) {
+        if (StopRequested()) return;
         MinerNode<PartitionTIdList> const& inode = items[ix];
         Itemset const iset = Join(prefix, inode.item);
         auto const insect = ConstructIntersection(iset, inode.candidates);
@@ -1,9 +1,9 @@
 #include "algorithms/dd/split/split.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
-#include <deque>
 #include <limits>
 #include <list>
 #include <regex>
@@ -13,10 +13,12 @@
 
 #include <easylogging++.h>
 
+#include "config/mem_limit/option.h"
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
 #include "model/table/column_index.h"
+#include "model/table/relation_loader.h"
 #include "model/types/numeric_type.h"
 #include "util/levenshtein_distance.h"
 
@@ -36,20 +38,20 @@ void Split::RegisterOptions() {
     RegisterOption(Option{&difference_table_, kDifferenceTable, kDDifferenceTable, default_table});
     RegisterOption(Option{&num_rows_, kNumRows, kDNumRows, 0U});
     RegisterOption(Option{&num_columns_, kNumColumns, kDNUmColumns, 0U});
+    RegisterOption(config::kMemLimitMbOpt(&mem_limit_mb_));
 }
 
 void Split::MakeExecuteOptsAvailable() {
     using namespace config::names;
 
-    MakeOptionsAvailable({kDifferenceTable, kNumRows, kNumColumns});
+    MakeOptionsAvailable({kDifferenceTable, kNumRows, kNumColumns, kMemLimitMB});
 }
 
 void Split::LoadDataInternal() {
-    relation_ = ColumnLayoutRelationData::CreateFrom(*input_table_, false);  // nulls are
-                                                                             // ignored
-    input_table_->Reset();
-    typed_relation_ = model::ColumnLayoutTypedRelationData::CreateFrom(*input_table_,
-                                                                       false);  // nulls are ignored
+    model::LoadedRelations relations = model::LoadRelations(*input_table_, false);  // nulls are
+                                                                                     // ignored
+    relation_ = std::move(relations.relation);
+    typed_relation_ = std::move(relations.typed_relation);
 }
 
 void Split::SetLimits() {
@@ -71,6 +73,7 @@ void Split::ParseDifferenceTable() {
 unsigned long long Split::ExecuteInternal() {
     SetLimits();
     ParseDifferenceTable();
+    LimitMemory(size_t{mem_limit_mb_} << 20);
 
     auto const start_time = std::chrono::system_clock::now();
     LOG(DEBUG) << "Start";
@@ -241,7 +244,11 @@ double Split::CalculateDistance(model::ColumnIndex column_index,
         throw std::runtime_error("Some of the value coordinates are empty.");
     }
     double dif = 0;
-    if (column.GetType().IsMetrizable()) {
+    if (column.IsHeapType()) {
+        /* Levenshtein distance as in StringType::Dist */
+        dif = util::LevenshteinDistance(column.GetStringValue(tuple_pair.first),
+                                        column.GetStringValue(tuple_pair.second));
+    } else if (column.GetType().IsMetrizable()) {
         std::byte const* first_value = column.GetValue(tuple_pair.first);
         std::byte const* second_value = column.GetValue(tuple_pair.second);
         auto const& type = static_cast<model::IMetrizableType const&>(column.GetType());
@@ -250,10 +257,21 @@ double Split::CalculateDistance(model::ColumnIndex column_index,
     return dif;
 }
 
+inline double Split::GetDistance(model::ColumnIndex column_index, std::size_t first_index,
+                                 std::size_t second_index) {
+    if (!distances_.empty()) {
+        return distances_[column_index][first_index][second_index];
+    }
+    if (first_index == second_index) {
+        return 0;
+    }
+    return CalculateDistance(column_index, std::minmax(first_index, second_index));
+}
+
 // must be inline for optimization (gcc 11.4.0)
 inline bool Split::CheckDF(DF const& dif_func, std::pair<std::size_t, std::size_t> tuple_pair) {
     for (model::ColumnIndex column_index = 0; column_index < num_columns_; column_index++) {
-        double const dif = distances_[column_index][tuple_pair.first][tuple_pair.second];
+        double const dif = GetDistance(column_index, tuple_pair.first, tuple_pair.second);
         if (dif < dif_func[column_index].lower_bound || dif > dif_func[column_index].upper_bound) {
             return false;
         }
@@ -285,18 +303,43 @@ void Split::InsertDistance(model::ColumnIndex column_index, std::size_t first_in
     }
 }
 
+void Split::CalculateMinMaxDistances() {
+    for (model::ColumnIndex column_index = 0; column_index < num_columns_; column_index++) {
+        double max_dif = 0, min_dif = std::numeric_limits<double>::max();
+        for (std::size_t i = 0; i < num_rows_; i++) {
+            for (std::size_t j = i + 1; j < num_rows_; j++) {
+                double const dif = CalculateDistance(column_index, {i, j});
+                max_dif = std::max(max_dif, dif);
+                min_dif = std::min(min_dif, dif);
+            }
+        }
+        min_max_dif_[column_index] = {min_dif, max_dif};
+    }
+}
+
 void Split::CalculateAllDistances() {
+    min_max_dif_ = std::vector<model::DFConstraint>(num_columns_, {0, 0});
+
+    std::size_t const matrices_bytes = std::size_t{num_columns_} * num_rows_ * num_rows_ *
+                                       sizeof(double);
+    distances_memory_ = util::MemoryReservation::TryMake(GetMemoryBudget(), matrices_bytes);
+    if (!distances_memory_) {
+        LOG(WARNING) << "Distance matrices would take " << (matrices_bytes >> 20)
+                     << "MB, which exceeds the memory limit. Distances will be calculated on "
+                        "demand, which is slower";
+        CalculateMinMaxDistances();
+        return;
+    }
     distances_ = std::vector<std::vector<std::vector<double>>>(
             num_columns_,
             std::vector<std::vector<double>>(num_rows_, std::vector<double>(num_rows_, 0)));
-    min_max_dif_ = std::vector<model::DFConstraint>(num_columns_, {0, 0});
 
     for (model::ColumnIndex column_index = 0; column_index < num_columns_; column_index++) {
         std::shared_ptr<model::PLI const> pli =
                 relation_->GetColumnData(column_index).GetPliOwnership();
-        std::deque<model::PLI::Cluster> const& index = pli->GetIndex();
-        std::shared_ptr<std::vector<int> const> probing_table = pli->CalculateAndGetProbingTable();
-        model::PLI::Cluster const& pt = *probing_table.get();
+        model::ClusterIndex const& index = pli->GetIndex();
+        model::PLI::ProbingTablePtr probing_table = pli->CalculateAndGetProbingTable();
+        model::PLI::ProbingTable const pt = *probing_table;
 
         double max_dif = 0, min_dif = std::numeric_limits<double>::max();
         for (std::size_t i = 0; i < index.size(); i++) {
@@ -353,7 +396,6 @@ std::vector<DF> Split::SearchSpace(model::ColumnIndex index) {
     std::size_t dif_num_rows = difference_typed_relation_->GetNumRows();
 
     model::TypedColumnData const& dif_column = difference_typed_relation_->GetColumnData(index);
-    model::Type const& type = dif_column.GetType();
 
     auto pair_compare = [](model::DFConstraint const& first_pair,
                            model::DFConstraint const& second_pair) {
@@ -372,19 +414,7 @@ std::vector<DF> Split::SearchSpace(model::ColumnIndex index) {
     for (std::size_t row_index = 0; row_index < dif_num_rows; row_index++) {
         model::TypeId type_id = dif_column.GetValueTypeId(row_index);
         if (type_id == +model::TypeId::kString) {
-            std::string df_str;
-            if (dif_column.IsMixed()) {
-                model::MixedType const* mixed_type = dif_column.GetIfMixed();
-                std::byte const* df_string = dif_column.GetValue(row_index);
-                std::unique_ptr<model::Type> t = mixed_type->RetrieveType(df_string);
-                std::byte const* df_string_value = mixed_type->RetrieveValue(df_string);
-                model::StringType const* str_type = static_cast<model::StringType const*>(t.get());
-                df_str = str_type->ValueToString(df_string_value);
-            } else {
-                model::StringType const& str_type = static_cast<model::StringType const&>(type);
-                std::byte const* df_string = dif_column.GetValue(row_index);
-                df_str = str_type.ValueToString(df_string);
-            }
+            std::string const df_str(dif_column.GetStringValue(row_index));
 
             std::smatch matches;
             if (std::regex_match(df_str, matches, df_regex)) {
@@ -9,11 +9,13 @@
 
 #include "algorithms/algorithm.h"
 #include "algorithms/dd/dd.h"
+#include "config/mem_limit/type.h"
 #include "config/tabular_data/input_table_type.h"
 #include "enums.h"
 #include "model/table/column_index.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/column_layout_typed_relation_data.h"
+#include "util/memory_budget.h"
 
 namespace algos::dd {
 
@@ -28,6 +30,7 @@ private:
     std::shared_ptr<model::ColumnLayoutTypedRelationData> typed_relation_;
     unsigned num_rows_;
     model::ColumnIndex num_columns_;
+    config::MemLimitMBType mem_limit_mb_;
 
     bool has_dif_table_;
 
@@ -38,7 +41,10 @@ private:
     unsigned const num_dfs_per_column_ = 5;
 
     std::vector<model::DFConstraint> min_max_dif_;
+    /* Empty if the matrices don't fit into the memory limit, the distances are then calculated
+     * every time they are needed */
     std::vector<std::vector<std::vector<double>>> distances_;
+    util::MemoryReservation distances_memory_;
     std::vector<std::pair<std::size_t, std::size_t>> tuple_pairs_;
     std::list<DD> dd_collection_;
 
@@ -48,15 +54,20 @@ private:
 
     void ResetState() final {
         dd_collection_.clear();
+        distances_.clear();
+        distances_memory_.Reset();
     }
 
     double CalculateDistance(model::ColumnIndex column_index,
                              std::pair<std::size_t, std::size_t> tuple_pair);
+    double GetDistance(model::ColumnIndex column_index, std::size_t first_index,
+                       std::size_t second_index);
     void InsertDistance(model::ColumnIndex column_index, std::size_t first_index,
                         std::size_t second_index, double& min_dif, double& max_dif);
     bool CheckDF(DF const& dep, std::pair<std::size_t, std::size_t> tuple_pair);
     bool VerifyDD(DD const& dep);
     void CalculateAllDistances();
+    void CalculateMinMaxDistances();
     bool IsFeasible(DF const& d);
     std::vector<DF> SearchSpace(std::vector<model::ColumnIndex>& indices);
     std::vector<DF> SearchSpace(model::ColumnIndex index);
@@ -119,7 +119,8 @@ void Aid::CreateNegativeCover() {
         }
 
         // TODO: probably add other criteria of termination
-        if (IsNegativeCoverGrowthSmall(index, curr_ratio)) {
+        // The result is approximate anyway, so a stopped run inverts what it has sampled
+        if (IsNegativeCoverGrowthSmall(index, curr_ratio) || StopRequested()) {
             break;
         }
 
@@ -39,6 +39,7 @@ unsigned long long Depminer::ExecuteInternal() {
     auto const lhs_time = std::chrono::system_clock::now();
     // 1
     for (auto const& column : schema_->GetColumns()) {
+        if (StopRequested()) break;
         LhsForColumn(column, c_max_cets);
         AddProgress(progress_step_);
     }
@@ -124,7 +125,7 @@ void Depminer::LhsForColumn(std::unique_ptr<Column> const& column,
     }
 
     // 4
-    while (!level.empty()) {
+    while (!level.empty() && !StopRequested()) {
         std::unordered_set<Vertical> level_copy = level;
         // 5
         for (auto const& l : level) {
@@ -1,28 +1,26 @@
 #include "dfd.h"
 
-#include <boost/asio.hpp>
 #include <easylogging++.h>
 
 #include "config/max_lhs/option.h"
+#include "config/mem_limit/option.h"
 #include "config/thread_number/option.h"
 #include "lattice_traversal/lattice_traversal.h"
 #include "model/table/column_layout_relation_data.h"
+#include "model/table/pli_cache.h"
 #include "model/table/position_list_index.h"
 #include "model/table/relational_schema.h"
+#include "util/parallel_for.h"
 
 namespace algos {
 
 DFD::DFD(std::optional<ColumnLayoutRelationDataManager> relation_manager)
     : PliBasedFDAlgorithm({kDefaultPhaseName}, relation_manager) {
-    RegisterOptions();
-}
-
-void DFD::RegisterOptions() {
-    RegisterOption(config::kThreadNumberOpt(&number_of_threads_));
+    RegisterOption(config::kMemLimitMbOpt(&mem_limit_mb_));
 }
 
 void DFD::MakeExecuteOptsAvailableFDInternal() {
-    MakeOptionsAvailable({config::kThreadNumberOpt.GetName()});
+    MakeOptionsAvailable({config::kThreadNumberOpt.GetName(), config::kMemLimitMbOpt.GetName()});
 }
 
 void DFD::ResetStateFd() {
@@ -30,8 +28,12 @@ void DFD::ResetStateFd() {
 }
 
 unsigned long long DFD::ExecuteInternal() {
-    auto partition_storage = std::make_unique<PartitionStorage>(
-            relation_.get(), CachingMethod::kAllCaching, CacheEvictionMethod::kMedainUsage);
+    size_t const mem_limit_bytes = size_t{mem_limit_mb_} << 20;
+    LimitMemory(mem_limit_bytes);
+    auto pli_cache = std::make_unique<model::PLICache>(
+            relation_.get(), CachingMethod::kAllCaching,
+            model::CreateEvictionPolicy(CacheEvictionMethod::kMedainUsage), mem_limit_bytes,
+            model::PLICache::kDefaultNaryIntersectionSize, &GetMemoryBudget());
     RelationalSchema const* const schema = relation_->GetSchema();
 
     auto start_time = std::chrono::system_clock::now();
@@ -49,37 +51,36 @@ unsigned long long DFD::ExecuteInternal() {
     }
 
     double progress_step = 100.0 / schema->GetNumColumns();
-    boost::asio::thread_pool search_space_pool(number_of_threads_);
-
-    for (auto& rhs : schema->GetColumns()) {
-        boost::asio::post(
-                search_space_pool, [this, &rhs, schema, progress_step, &partition_storage]() {
-                    ColumnData const& rhs_data = relation_->GetColumnData(rhs->GetIndex());
-                    model::PositionListIndex const* const rhs_pli = rhs_data.GetPositionListIndex();
-
-                    /* if all the rows have the same value, then we register FD with empty LHS
-                     * if we have minimal FD like []->RHS, it is impossible to find smaller FD with
-                     * this RHS, so we register it and move to the next RHS
-                     * */
-                    if (rhs_pli->GetNepAsLong() == relation_->GetNumTuplePairs()) {
-                        RegisterFd(*(schema->empty_vertical_), *rhs);
-                        AddProgress(progress_step);
-                        return;
-                    }
-
-                    auto search_space = LatticeTraversal(rhs.get(), relation_.get(),
-                                                         unique_columns_, partition_storage.get());
-                    auto const minimal_deps = search_space.FindLHSs();
-
-                    for (auto const& minimal_dependency_lhs : minimal_deps) {
-                        RegisterFd(minimal_dependency_lhs, *rhs);
-                    }
+    auto const& columns = schema->GetColumns();
+    util::ParallelForeach(
+            columns.begin(), columns.end(), threads_num_,
+            [this, schema, progress_step, &pli_cache](std::unique_ptr<Column> const& rhs) {
+                if (StopRequested()) {
+                    return;
+                }
+                ColumnData const& rhs_data = relation_->GetColumnData(rhs->GetIndex());
+                model::PositionListIndex const* const rhs_pli = rhs_data.GetPositionListIndex();
+
+                /* if all the rows have the same value, then we register FD with empty LHS
+                 * if we have minimal FD like []->RHS, it is impossible to find smaller FD with
+                 * this RHS, so we register it and move to the next RHS
+                 * */
+                if (rhs_pli->GetNepAsLong() == relation_->GetNumTuplePairs()) {
+                    RegisterFd(*(schema->empty_vertical_), *rhs);
                     AddProgress(progress_step);
-                    LOG(INFO) << static_cast<int>(GetProgress().second);
-                });
-    }
-
-    search_space_pool.join();
+                    return;
+                }
+
+                auto search_space = LatticeTraversal(rhs.get(), relation_.get(), unique_columns_,
+                                                     pli_cache.get(), GetCancellationToken());
+                auto const minimal_deps = search_space.FindLHSs();
+
+                for (auto const& minimal_dependency_lhs : minimal_deps) {
+                    RegisterFd(minimal_dependency_lhs, *rhs);
+                }
+                AddProgress(progress_step);
+                LOG(INFO) << static_cast<int>(GetProgress().second);
+            });
     SetProgress(100);
 
     auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -100,7 +100,7 @@ std::unordered_set<Vertical> LatticeObservations::GetUncheckedSubsets(
 
 std::unordered_set<Vertical> LatticeObservations::GetUncheckedSupersets(
         Vertical const& node, unsigned int rhs_index, ColumnOrder const& column_order) const {
-    auto flipped_indices = node.GetColumnIndices().flip();
+    auto flipped_indices = ~node.GetColumnIndices();
     std::unordered_set<Vertical> unchecked_supersets;
 
     flipped_indices[rhs_index] = false;
@@ -5,10 +5,11 @@
 
 #include "../column_order/column_order.h"
 #include "../lattice_observations/lattice_observations.h"
-#include "../partition_storage/partition_storage.h"
 #include "../pruning_maps/dependencies_map.h"
 #include "../pruning_maps/non_dependencies_map.h"
+#include "model/table/pli_cache.h"
 #include "model/table/vertical.h"
+#include "util/cancellation_token.h"
 
 class LatticeTraversal {
 private:
@@ -24,7 +25,8 @@ private:
 
     std::vector<Vertical> const& unique_columns_;
     ColumnLayoutRelationData const* const relation_;
-    PartitionStorage* const partition_storage_;
+    model::PLICache* const pli_cache_;
+    util::CancellationToken& cancellation_;
 
     std::random_device rd_;
     std::mt19937 gen_;
@@ -41,7 +43,9 @@ private:
 public:
     LatticeTraversal(Column const* const rhs, ColumnLayoutRelationData const* const relation,
                      std::vector<Vertical> const& unique_verticals,
-                     PartitionStorage* const partition_storage);
+                     model::PLICache* const pli_cache, util::CancellationToken& cancellation);
 
+    /* Stops early if `cancellation` asks to, then only the dependencies known to be minimal so
+     * far are returned */
     std::unordered_set<Vertical> FindLHSs();
 };
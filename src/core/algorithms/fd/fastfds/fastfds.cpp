@@ -4,8 +4,6 @@
 #include <mutex>
 #include <thread>
 
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/thread.hpp>
 #include <easylogging++.h>
@@ -20,13 +18,7 @@ namespace algos {
 using std::vector, std::set;
 
 FastFDs::FastFDs(std::optional<ColumnLayoutRelationDataManager> relation_manager)
-    : PliBasedFDAlgorithm({"Agree sets generation", "Finding minimal covers"}, relation_manager) {
-    RegisterOptions();
-}
-
-void FastFDs::RegisterOptions() {
-    RegisterOption(config::kThreadNumberOpt(&threads_num_));
-}
+    : PliBasedFDAlgorithm({"Agree sets generation", "Finding minimal covers"}, relation_manager) {}
 
 void FastFDs::MakeExecuteOptsAvailableFDInternal() {
     MakeOptionsAvailable({config::kThreadNumberOpt.GetName()});
@@ -57,6 +49,9 @@ unsigned long long FastFDs::ExecuteInternal() {
     }
 
     auto task = [this](std::unique_ptr<Column> const& column) {
+        if (StopRequested()) {
+            return;
+        }
         if (ColumnContainsOnlyEqualValues(*column)) {
             LOG(DEBUG) << "Registered FD: " << schema_->empty_vertical_->ToString() << "->"
                        << column->ToString();
@@ -75,19 +70,8 @@ unsigned long long FastFDs::ExecuteInternal() {
         }
     };
 
-    if (threads_num_ > 1) {
-        boost::asio::thread_pool pool(threads_num_);
-
-        for (std::unique_ptr<Column> const& column : schema_->GetColumns()) {
-            boost::asio::post(pool, [&column, task]() { return task(column); });
-        }
-
-        pool.join();
-    } else {
-        for (std::unique_ptr<Column> const& column : schema_->GetColumns()) {
-            task(column);
-        }
-    }
+    auto const& columns = schema_->GetColumns();
+    util::ParallelForeach(columns.begin(), columns.end(), threads_num_, task);
 
     SetProgress(kTotalProgressPercent);
 
@@ -107,7 +91,7 @@ bool FastFDs::ColumnContainsOnlyEqualValues(Column const& column) const {
 void FastFDs::FindCovers(Column const& attribute, vector<DiffSet> const& diff_sets_mod,
                          vector<DiffSet> const& cur_diff_sets, Vertical const& path,
                          set<Column, OrderingComparator> const& ordering) {
-    if (path.GetArity() > max_lhs_) {
+    if (path.GetArity() > max_lhs_ || StopRequested()) {
         return;
     }
 
@@ -42,7 +42,8 @@ unsigned long long FdMine::ExecuteInternal() {
     }
 
     // 2
-    while (!candidate_set_.empty()) {
+    /* The FDs of the levels that are done are valid, so a stopped run still reconstructs them */
+    while (!candidate_set_.empty() && !StopRequested()) {
         for (auto const& candidate : candidate_set_) {
             ComputeNonTrivialClosure(candidate);
             ObtainFDandKey(candidate);
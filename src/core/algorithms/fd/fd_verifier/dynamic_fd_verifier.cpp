@@ -4,8 +4,6 @@
 #include <memory>
 #include <stdexcept>
 
-#include <easylogging++.h>
-
 #include "config/equal_nulls/option.h"
 #include "config/indices/option.h"
 #include "config/indices/validate_index.h"
@@ -104,55 +102,58 @@ void DynamicFDVerifier::MakeExecuteOptsAvailable() {
 }
 
 void DynamicFDVerifier::LoadDataInternal() {
-    CreateFD();
     input_table_->Reset();
     table_data_ = std::make_shared<model::DynamicTableData>(*input_table_);
+    CreateFD();
     stats_calculator_ =
             std::make_unique<DynamicStatsCalculator>(table_data_, lhs_indices_, rhs_indices_);
-    VerifyFD();
+    stats_calculator_->CalculateStatistics(lhs_pli_.get(), rhs_pli_.get());
     SortHighlightsByProportionDescending();
 }
 
 unsigned long long DynamicFDVerifier::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
-    std::vector<std::pair<std::optional<size_t>, std::vector<int>>> lhs_inserts{}, rhs_inserts{};
-    std::unordered_set<size_t> deletes_and_updates_indices{delete_statement_indices_};
-    if (insert_statements_table_ != nullptr) {
-        while (insert_statements_table_->HasNextRow()) {
-            std::vector<std::string> row = insert_statements_table_->GetNextRow();
-            if (row.size() != input_table_->GetNumberOfColumns()) {
-                LOG(WARNING) << "Received row with size " << row.size() << ", but expected "
-                             << input_table_->GetNumberOfColumns();
-                continue;
-            }
-            lhs_inserts.emplace_back(std::nullopt, ParseRowForPLI(row.begin(), lhs_indices_));
-            rhs_inserts.emplace_back(std::nullopt, ParseRowForPLI(row.begin(), rhs_indices_));
-        }
-        insert_statements_table_->Reset();
+    /* Positions of the deleted and of the updated rows */
+    std::unordered_set<size_t> deletes_and_updates_rows;
+    for (size_t row_id : delete_statement_indices_) {
+        deletes_and_updates_rows.emplace(*table_data_->FindRow(row_id));
     }
     if (update_statements_table_ != nullptr) {
         while (update_statements_table_->HasNextRow()) {
             std::vector<std::string> row = update_statements_table_->GetNextRow();
-            if (row.size() != input_table_->GetNumberOfColumns() + 1) {
-                LOG(WARNING) << "Received row with size " << row.size() << ", but expected "
-                             << input_table_->GetNumberOfColumns() + 1;
-                continue;
-            }
             size_t row_id = std::stoull(row.front());
-            lhs_inserts.emplace_back(row_id, ParseRowForPLI(row.begin() + 1, lhs_indices_));
-            rhs_inserts.emplace_back(row_id, ParseRowForPLI(row.begin() + 1, rhs_indices_));
-            deletes_and_updates_indices.emplace(row_id);
+            if (delete_statement_indices_.contains(row_id)) {
+                throw config::ConfigurationError(
+                        "Attempt to update a deleted row during processing of update "
+                        "operations");
+            }
+            deletes_and_updates_rows.emplace(*table_data_->FindRow(row_id));
         }
         update_statements_table_->Reset();
     }
 
-    lhs_pli_->UpdateWith(lhs_inserts, deletes_and_updates_indices);
-    rhs_pli_->UpdateWith(rhs_inserts, std::move(deletes_and_updates_indices));
+    stats_calculator_->RemoveRows(lhs_pli_.get(), rhs_pli_.get(), deletes_and_updates_rows);
+
+    std::vector<size_t> const inserts_and_updates_rows = table_data_->Update(
+            insert_statements_table_, update_statements_table_, delete_statement_indices_);
+    std::vector<std::pair<size_t, std::vector<int>>> lhs_inserts, rhs_inserts;
+    lhs_inserts.reserve(inserts_and_updates_rows.size());
+    rhs_inserts.reserve(inserts_and_updates_rows.size());
+    for (size_t row : inserts_and_updates_rows) {
+        lhs_inserts.emplace_back(row, GetValueCodes(row, lhs_indices_));
+        rhs_inserts.emplace_back(row, GetValueCodes(row, rhs_indices_));
+    }
+    lhs_pli_->UpdateWith(lhs_inserts, deletes_and_updates_rows);
+    rhs_pli_->UpdateWith(rhs_inserts, deletes_and_updates_rows);
 
-    table_data_->Update(insert_statements_table_, update_statements_table_,
-                        delete_statement_indices_);
+    stats_calculator_->AddRows(lhs_pli_.get(), rhs_pli_.get(), inserts_and_updates_rows);
 
-    VerifyFD();
+    if (table_data_->NeedsCompaction()) {
+        std::vector<int> const new_rows = table_data_->Compact();
+        lhs_pli_->RemapRecords(new_rows);
+        rhs_pli_->RemapRecords(new_rows);
+        stats_calculator_->RebuildHighlights(lhs_pli_.get());
+    }
     SortHighlightsByProportionDescending();
 
     auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -160,49 +161,23 @@ unsigned long long DynamicFDVerifier::ExecuteInternal() {
     return elapsed_milliseconds.count();
 }
 
-void DynamicFDVerifier::VerifyFD() const {
-    std::unique_ptr<model::DynPLI const> intersection_pli = lhs_pli_->Intersect(rhs_pli_.get());
-    // stats calculator has init state after every Execute() call, will be fixed soon
-    if (lhs_pli_->GetNumCluster() == intersection_pli->GetNumCluster()) {
-        return;
-    }
-
-    stats_calculator_->CalculateStatistics(lhs_pli_.get(), rhs_pli_.get());
-}
-
 void DynamicFDVerifier::CreateFD() {
-    size_t const num_columns = input_table_->GetNumberOfColumns();
     std::vector<std::vector<int>> lhs_rows, rhs_rows;
-    std::vector<std::string> row;
-
-    while (input_table_->HasNextRow()) {
-        row = input_table_->GetNextRow();
-        if (row.size() != num_columns) {
-            continue;
-        }
-        lhs_rows.emplace_back(ParseRowForPLI(row.begin(), lhs_indices_));
-        rhs_rows.emplace_back(ParseRowForPLI(row.begin(), rhs_indices_));
+    for (size_t row = 0; row < table_data_->GetNumRowsTotal(); ++row) {
+        lhs_rows.emplace_back(GetValueCodes(row, lhs_indices_));
+        rhs_rows.emplace_back(GetValueCodes(row, rhs_indices_));
     }
 
     lhs_pli_ = model::DynPLI::CreateFor(lhs_rows);
     rhs_pli_ = model::DynPLI::CreateFor(rhs_rows);
 }
 
-std::vector<int> DynamicFDVerifier::ParseRowForPLI(
-        model::IDatasetStream::Row::iterator const& row_begin,
-        std::vector<unsigned int> const& indices) {
-    std::vector<int> result{};
+std::vector<int> DynamicFDVerifier::GetValueCodes(size_t row,
+                                                  config::IndicesType const& indices) const {
+    std::vector<int> result;
+    result.reserve(indices.size());
     for (size_t index : indices) {
-        std::string const& field = *(row_begin + index);
-        if (field.empty()) {
-            result.emplace_back(kNullValueId);
-        } else {
-            auto [iter, is_value_new] = value_dictionary_.try_emplace(field, next_value_id_);
-            if (is_value_new) {
-                next_value_id_++;
-            }
-            result.emplace_back(iter->second);
-        }
+        result.push_back(table_data_->GetValueCode(row, index));
     }
     return result;
 }
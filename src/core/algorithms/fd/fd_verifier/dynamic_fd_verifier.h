@@ -33,22 +33,14 @@ private:
     std::shared_ptr<model::DynamicTableData> table_data_;
     std::shared_ptr<DynamicStatsCalculator> stats_calculator_;
 
-    std::unordered_map<std::string, int> value_dictionary_{};
-    int next_value_id_ = 1;
-    static constexpr int kNullValueId = -1;
-
-    void VerifyFD() const;
     void CreateFD();
 
-    inline std::vector<int> ParseRowForPLI(model::IDatasetStream::Row::iterator const& row_begin,
-                                           std::vector<unsigned int> const& indices);
+    /* The values of a row as the PLIs see them: codes of the table's column dictionaries */
+    std::vector<int> GetValueCodes(size_t row, config::IndicesType const& indices) const;
     void RegisterOptions();
 
-    void ResetState() final {
-        if (stats_calculator_) {
-            stats_calculator_->ResetState();
-        }
-    }
+    /* The statistics are kept up to date by every batch of changes */
+    void ResetState() final {}
 
 protected:
     void LoadDataInternal() override;
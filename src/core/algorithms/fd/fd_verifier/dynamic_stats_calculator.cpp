@@ -2,63 +2,146 @@
 
 #include <algorithm>
 #include <cassert>
-#include <numeric>
 #include <unordered_map>
 
 #include <easylogging++.h>
 
 namespace algos::fd_verifier {
 
+void DynamicStatsCalculator::ClusterStats::AddRow(ClusterId rhs_id) {
+    unsigned& frequency = rhs_frequencies[rhs_id];
+    num_rhs_agreeing_pairs += 2 * frequency;
+    ++frequency;
+    ++size;
+}
+
+void DynamicStatsCalculator::ClusterStats::RemoveRow(ClusterId rhs_id) {
+    auto it = rhs_frequencies.find(rhs_id);
+    assert(it != rhs_frequencies.end());
+    unsigned& frequency = it->second;
+    --frequency;
+    num_rhs_agreeing_pairs -= 2 * frequency;
+    if (frequency == 0) {
+        rhs_frequencies.erase(it);
+    }
+    --size;
+}
+
+void DynamicStatsCalculator::Touch(ClusterId lhs_id) {
+    if (!touched_clusters_.insert(lhs_id).second) return;
+    auto it = cluster_stats_.find(lhs_id);
+    if (it == cluster_stats_.end() || !it->second.IsViolating()) return;
+    num_tuples_conflicting_on_rhs_ -= it->second.GetNumTuplesConflictingOnRhs();
+    num_error_rows_ -= it->second.size;
+    violating_clusters_.erase(lhs_id);
+}
+
+void DynamicStatsCalculator::AddToTotals(ClusterId lhs_id, ClusterStats const& stats) {
+    if (!stats.IsViolating()) return;
+    num_tuples_conflicting_on_rhs_ += stats.GetNumTuplesConflictingOnRhs();
+    num_error_rows_ += stats.size;
+    violating_clusters_.insert(lhs_id);
+}
+
+void DynamicStatsCalculator::UpdateError() {
+    size_t num_rows = table_data_->GetNumRowsActual();
+    if (num_rows < 2) {
+        error_ = 0;
+        return;
+    }
+    error_ = (double)num_tuples_conflicting_on_rhs_ / (num_rows * num_rows - num_rows);
+}
+
+void DynamicStatsCalculator::RebuildHighlights(model::DynPLI const* lhs_pli) {
+    highlights_.clear();
+    highlights_.reserve(violating_clusters_.size());
+    for (ClusterId lhs_id : violating_clusters_) {
+        ClusterStats const& stats = cluster_stats_.at(lhs_id);
+        model::DynPLI::Cluster rows = lhs_pli->GetCluster(lhs_id);
+        for (int& row : rows) {
+            row = table_data_->GetRowId(row);
+        }
+        highlights_.emplace_back(rows, stats.rhs_frequencies.size(),
+                                 CalculateNumMostFrequentRhsValue(stats.rhs_frequencies));
+    }
+}
+
 void DynamicStatsCalculator::CalculateStatistics(model::DynPLI const* lhs_pli,
                                                  model::DynPLI const* rhs_pli) {
-    model::DynPLI::ClusterCollection const& lhs_clusters = lhs_pli->GetClusters();
-    std::shared_ptr<std::vector<int> const> pt_shared = rhs_pli->GetCachedProbingTable();
-    std::vector<int> const& rhs_pt = *pt_shared;
-    size_t num_tuples_conflicting_on_rhs = 0;
-
-    for (auto const& [_, cluster] : lhs_clusters) {
-        if (cluster.size() == 1) continue;
-        Frequencies frequencies = model::DynPLI::CreateFrequencies(cluster, rhs_pt);
-        size_t num_distinct_rhs_values = CalculateNumDistinctRhsValues(frequencies, cluster.size());
-        if (num_distinct_rhs_values == 1) continue;
-        num_tuples_conflicting_on_rhs +=
-                CalculateNumTuplesConflictingOnRhsInCluster(frequencies, cluster.size());
-        num_error_rows_ += cluster.size();
-        highlights_.emplace_back(cluster, num_distinct_rhs_values,
-                                 CalculateNumMostFrequentRhsValue(frequencies));
+    std::vector<model::DynPLI::Cluster> const& lhs_clusters = lhs_pli->GetClusters();
+    std::vector<ClusterId> const& rhs_pt = rhs_pli->GetProbingTable();
+    cluster_stats_.clear();
+    violating_clusters_.clear();
+    num_tuples_conflicting_on_rhs_ = 0;
+    num_error_rows_ = 0;
+
+    for (ClusterId lhs_id = 0; lhs_id < static_cast<ClusterId>(lhs_clusters.size()); ++lhs_id) {
+        model::DynPLI::Cluster const& cluster = lhs_clusters[lhs_id];
+        if (cluster.size() < 2) continue;
+        ClusterStats& stats = cluster_stats_[lhs_id];
+        for (int row : cluster) {
+            stats.AddRow(rhs_pt[row]);
+        }
+        AddToTotals(lhs_id, stats);
     }
 
-    assert(!highlights_.empty());
-    size_t num_rows = table_data_->GetNumRowsActual();
-    error_ = (double)num_tuples_conflicting_on_rhs / (num_rows * num_rows - num_rows);
+    UpdateError();
+    RebuildHighlights(lhs_pli);
 }
 
-size_t DynamicStatsCalculator::CalculateNumMostFrequentRhsValue(Frequencies const& frequencies) {
-    // Only singletons in cluster
-    if (frequencies.empty()) {
-        return 1;
+void DynamicStatsCalculator::RemoveRows(model::DynPLI const* lhs_pli,
+                                        model::DynPLI const* rhs_pli,
+                                        std::unordered_set<size_t> const& rows) {
+    touched_clusters_.clear();
+    rebuilt_clusters_.clear();
+    for (size_t row : rows) {
+        ClusterId const lhs_id = lhs_pli->GetClusterId(row);
+        Touch(lhs_id);
+        if (auto it = cluster_stats_.find(lhs_id); it != cluster_stats_.end()) {
+            it->second.RemoveRow(rhs_pli->GetClusterId(row));
+        }
     }
-    auto comp = [](auto const& a, auto const& b) { return a.second < b.second; };
-    return std::max_element(frequencies.begin(), frequencies.end(), comp)->second;
 }
 
-size_t DynamicStatsCalculator::CalculateNumTuplesConflictingOnRhsInCluster(
-        Frequencies const& frequencies, size_t cluster_size) {
-    size_t num_tuples_conflicting_on_rhs = cluster_size * (cluster_size - 1);
-    for (auto const& [_, number_of_values] : frequencies) {
-        if (number_of_values > 1) {
-            num_tuples_conflicting_on_rhs -= number_of_values * (number_of_values - 1);
+void DynamicStatsCalculator::AddRows(model::DynPLI const* lhs_pli, model::DynPLI const* rhs_pli,
+                                     std::vector<size_t> const& rows) {
+    std::vector<ClusterId> const& rhs_pt = rhs_pli->GetProbingTable();
+    for (size_t row : rows) {
+        ClusterId const lhs_id = lhs_pli->GetClusterId(row);
+        Touch(lhs_id);
+        if (rebuilt_clusters_.contains(lhs_id)) continue;
+        if (auto it = cluster_stats_.find(lhs_id); it != cluster_stats_.end()) {
+            it->second.AddRow(rhs_pt[row]);
+            continue;
+        }
+        /* The cluster had at most one row before the batch, so it consists of the rows added by
+         * the batch and of that one */
+        model::DynPLI::Cluster const& cluster = lhs_pli->GetCluster(lhs_id);
+        if (cluster.size() < 2) continue;
+        ClusterStats& stats = cluster_stats_[lhs_id];
+        for (int cluster_row : cluster) {
+            stats.AddRow(rhs_pt[cluster_row]);
         }
+        rebuilt_clusters_.insert(lhs_id);
     }
-    return num_tuples_conflicting_on_rhs;
+
+    for (ClusterId lhs_id : touched_clusters_) {
+        auto it = cluster_stats_.find(lhs_id);
+        if (it == cluster_stats_.end()) continue;
+        if (it->second.size < 2) {
+            cluster_stats_.erase(it);
+        } else {
+            AddToTotals(lhs_id, it->second);
+        }
+    }
+
+    UpdateError();
+    RebuildHighlights(lhs_pli);
 }
 
-size_t DynamicStatsCalculator::CalculateNumDistinctRhsValues(Frequencies const& frequencies,
-                                                             size_t cluster_size) {
-    size_t num_non_singleton_rhs_values = std::accumulate(
-            frequencies.begin(), frequencies.end(), 0U,
-            [](unsigned total, auto const& freq_iter) { return total + freq_iter.second; });
-    return frequencies.size() + cluster_size - num_non_singleton_rhs_values;
+size_t DynamicStatsCalculator::CalculateNumMostFrequentRhsValue(Frequencies const& frequencies) {
+    auto comp = [](auto const& a, auto const& b) { return a.second < b.second; };
+    return std::max_element(frequencies.begin(), frequencies.end(), comp)->second;
 }
 
 void DynamicStatsCalculator::SortHighlights(HighlightCompareFunction const& compare) {
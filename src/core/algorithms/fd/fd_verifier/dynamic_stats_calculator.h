@@ -3,6 +3,8 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "algorithms/fd/fd_verifier/highlight.h"
@@ -12,37 +14,73 @@
 
 namespace algos::fd_verifier {
 
+/* Maintains the statistics of an FD over a table that changes by batches. Every batch costs time
+ * proportional to its size, except for the highlights, which are rebuilt from the violating
+ * clusters */
 class DynamicStatsCalculator {
 private:
-    using ClusterIndex = model::DynPLI::Cluster::value_type;
-    using Frequencies = std::unordered_map<ClusterIndex, unsigned>;
+    using ClusterId = model::DynPLI::ClusterId;
+    using Frequencies = std::unordered_map<ClusterId, unsigned>;
+
+    /* Statistics of an LHS cluster of at least two rows */
+    struct ClusterStats {
+        size_t size = 0;
+        /* Rows of the cluster by their RHS clusters */
+        Frequencies rhs_frequencies;
+        /* Ordered pairs of rows of the cluster that agree on RHS */
+        size_t num_rhs_agreeing_pairs = 0;
+
+        void AddRow(ClusterId rhs_id);
+        void RemoveRow(ClusterId rhs_id);
+
+        bool IsViolating() const {
+            return rhs_frequencies.size() > 1;
+        }
+
+        size_t GetNumTuplesConflictingOnRhs() const {
+            return size * (size - 1) - num_rhs_agreeing_pairs;
+        }
+    };
 
     std::shared_ptr<model::DynamicTableData> table_data_;
     config::IndicesType lhs_indices_;
     config::IndicesType rhs_indices_;
 
+    std::unordered_map<ClusterId, ClusterStats> cluster_stats_;
+    std::unordered_set<ClusterId> violating_clusters_;
+    /* LHS clusters changed by the current batch */
+    std::unordered_set<ClusterId> touched_clusters_;
+    /* LHS clusters whose statistics were built from scratch during the current batch */
+    std::unordered_set<ClusterId> rebuilt_clusters_;
+
+    size_t num_tuples_conflicting_on_rhs_ = 0;
     size_t num_error_rows_ = 0;
     long double error_ = 0;
     std::vector<Highlight> highlights_;
 
-    static size_t CalculateNumDistinctRhsValues(Frequencies const& frequencies,
-                                                size_t cluster_size);
-
-    static size_t CalculateNumTuplesConflictingOnRhsInCluster(Frequencies const& frequencies,
-                                                              size_t cluster_size);
+    /* Takes the contribution of the cluster out of the totals before its first change in a
+     * batch */
+    void Touch(ClusterId lhs_id);
+    void AddToTotals(ClusterId lhs_id, ClusterStats const& stats);
+    void UpdateError();
 
     static size_t CalculateNumMostFrequentRhsValue(Frequencies const& frequencies);
 
 public:
     using HighlightCompareFunction = std::function<bool(Highlight const& h1, Highlight const& h2)>;
 
+    /* Calculates the statistics of the whole table */
     void CalculateStatistics(model::DynPLI const* lhs_pli, model::DynPLI const* rhs_pli);
 
-    void ResetState() {
-        highlights_.clear();
-        num_error_rows_ = 0;
-        error_ = 0;
-    }
+    /* Starts a batch, must be called before the rows are deleted or updated in the PLIs */
+    void RemoveRows(model::DynPLI const* lhs_pli, model::DynPLI const* rhs_pli,
+                    std::unordered_set<size_t> const& rows);
+    /* Finishes a batch, must be called after the rows are inserted or updated in the PLIs and in
+     * the table */
+    void AddRows(model::DynPLI const* lhs_pli, model::DynPLI const* rhs_pli,
+                 std::vector<size_t> const& rows);
+    /* Highlights list the ids of rows, so they are rebuilt when the table is compacted */
+    void RebuildHighlights(model::DynPLI const* lhs_pli);
 
     bool FDHolds() const {
         return highlights_.empty();
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 #include "config/equal_nulls/option.h"
 #include "config/indices/option.h"
@@ -10,6 +11,7 @@
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
+#include "model/table/relation_loader.h"
 
 namespace algos::fd_verifier {
 
@@ -36,13 +38,12 @@ void FDVerifier::MakeExecuteOptsAvailable() {
 }
 
 void FDVerifier::LoadDataInternal() {
-    relation_ = ColumnLayoutRelationData::CreateFrom(*input_table_, is_null_equal_null_);
-    input_table_->Reset();
-    if (relation_->GetColumnData().empty()) {
+    model::LoadedRelations relations = model::LoadRelations(*input_table_, is_null_equal_null_);
+    if (relations.relation->GetColumnData().empty()) {
         throw std::runtime_error("Got an empty dataset: FD verifying is meaningless.");
     }
-    typed_relation_ =
-            model::ColumnLayoutTypedRelationData::CreateFrom(*input_table_, is_null_equal_null_);
+    relation_ = std::move(relations.relation);
+    typed_relation_ = std::move(relations.typed_relation);
 }
 
 unsigned long long FDVerifier::ExecuteInternal() {
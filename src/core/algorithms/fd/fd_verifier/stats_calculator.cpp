@@ -31,6 +31,10 @@ model::CompareResult CompareTypesInCol(model::TypedColumnData const& col,
         return model::CompareResult::kGreater;
     }
 
+    if (col.IsHeapType()) {
+        return model::StringType::Compare(col.GetStringValue(i1), col.GetStringValue(i2));
+    }
+
     std::byte const* v1 = col.GetValue(i1);
     std::byte const* v2 = col.GetValue(i2);
 
@@ -59,12 +63,12 @@ void StatsCalculator::PrintStatistics() const {
 }
 
 void StatsCalculator::CalculateStatistics(model::PLI const* lhs_pli, model::PLI const* rhs_pli) {
-    std::deque<model::PLI::Cluster> const& lhs_clusters = lhs_pli->GetIndex();
-    std::shared_ptr<model::PLI::Cluster const> pt_shared = rhs_pli->CalculateAndGetProbingTable();
-    model::PLI::Cluster const& pt = *pt_shared.get();
+    model::ClusterIndex const& lhs_clusters = lhs_pli->GetIndex();
+    model::PLI::ProbingTablePtr pt_shared = rhs_pli->CalculateAndGetProbingTable();
+    model::PLI::ProbingTable const pt = *pt_shared;
     size_t num_tuples_conflicting_on_rhs = 0.;
 
-    for (auto& cluster : lhs_clusters) {
+    for (model::PLI::ClusterView cluster : lhs_clusters) {
         std::unordered_map<ClusterIndex, unsigned> frequencies =
                 model::PLI::CreateFrequencies(cluster, pt);
         size_t num_distinct_rhs_values = CalculateNumDistinctRhsValues(frequencies, cluster.size());
@@ -74,7 +78,7 @@ void StatsCalculator::CalculateStatistics(model::PLI const* lhs_pli, model::PLI
         num_tuples_conflicting_on_rhs +=
                 CalculateNumTuplesConflictingOnRhsInCluster(frequencies, cluster.size());
         num_error_rows_ += cluster.size();
-        highlights_.emplace_back(std::move(cluster), num_distinct_rhs_values,
+        highlights_.emplace_back(model::PLI::Cluster(cluster), num_distinct_rhs_values,
                                  CalculateNumMostFrequentRhsValue(frequencies));
     }
     assert(!highlights_.empty());
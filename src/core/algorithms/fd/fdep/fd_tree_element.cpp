@@ -1,57 +1,69 @@
 #include "fd_tree_element.h"
 
-#include "boost/dynamic_bitset.hpp"
+#include <boost/dynamic_bitset.hpp>
 
-FDTreeElement::FDTreeElement(size_t max_attribute_number)
-    : max_attribute_number_(max_attribute_number) {
+#include "model/table/column_set.h"
+
+template <typename AttributeSet>
+FDTreeElement<AttributeSet>::FDTreeElement(size_t max_attribute_number)
+    : rhs_attributes_(max_attribute_number + 1),
+      max_attribute_number_(max_attribute_number),
+      is_fd_(max_attribute_number + 1) {
     children_.resize(max_attribute_number);
 }
 
-bool FDTreeElement::CheckFd(size_t index) const {
-    return this->is_fd_[index];
+template <typename AttributeSet>
+bool FDTreeElement<AttributeSet>::CheckFd(size_t index) const {
+    return this->is_fd_.test(index);
 }
 
-FDTreeElement* FDTreeElement::GetChild(size_t index) const {
+template <typename AttributeSet>
+FDTreeElement<AttributeSet>* FDTreeElement<AttributeSet>::GetChild(size_t index) const {
     return this->children_[index].get();
 }
 
-void FDTreeElement::AddRhsAttribute(size_t index) {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::AddRhsAttribute(size_t index) {
     this->rhs_attributes_.set(index);
 }
 
-std::bitset<FDTreeElement::kMaxAttrNum> const& FDTreeElement::GetRhsAttributes() const {
+template <typename AttributeSet>
+AttributeSet const& FDTreeElement<AttributeSet>::GetRhsAttributes() const {
     return this->rhs_attributes_;
 }
 
-void FDTreeElement::MarkAsLast(size_t index) {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::MarkAsLast(size_t index) {
     this->is_fd_.set(index);
 }
 
-bool FDTreeElement::IsFinalNode(size_t attr_num) const {
-    if (!this->rhs_attributes_[attr_num]) {
+template <typename AttributeSet>
+bool FDTreeElement<AttributeSet>::IsFinalNode(size_t attr_num) const {
+    if (!this->rhs_attributes_.test(attr_num)) {
         return false;
     }
     for (size_t attr = 0; attr < this->max_attribute_number_; ++attr) {
-        if (children_[attr] && children_[attr]->GetRhsAttributes()[attr_num]) {
+        if (children_[attr] && children_[attr]->GetRhsAttributes().test(attr_num)) {
             return false;
         }
     }
     return true;
 }
 
-bool FDTreeElement::ContainsGeneralization(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
-                                           size_t current_attr) const {
-    if (this->is_fd_[attr_num - 1]) {
+template <typename AttributeSet>
+bool FDTreeElement<AttributeSet>::ContainsGeneralization(AttributeSet const& lhs, size_t attr_num,
+                                                         size_t current_attr) const {
+    if (this->is_fd_.test(attr_num - 1)) {
         return true;
     }
 
-    size_t next_set_attr = lhs._Find_next(current_attr);
-    if (next_set_attr == kMaxAttrNum) {
+    size_t next_set_attr = lhs.find_next(current_attr);
+    if (next_set_attr == AttributeSet::npos) {
         return false;
     }
     bool found = false;
     if (this->children_[next_set_attr - 1] &&
-        this->children_[next_set_attr - 1]->GetRhsAttributes()[attr_num]) {
+        this->children_[next_set_attr - 1]->GetRhsAttributes().test(attr_num)) {
         found = this->children_[next_set_attr - 1]->ContainsGeneralization(lhs, attr_num,
                                                                            next_set_attr);
     }
@@ -62,23 +74,24 @@ bool FDTreeElement::ContainsGeneralization(std::bitset<kMaxAttrNum> const& lhs,
     return this->ContainsGeneralization(lhs, attr_num, next_set_attr);
 }
 
-bool FDTreeElement::GetGeneralizationAndDelete(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
-                                               size_t current_attr,
-                                               std::bitset<kMaxAttrNum>& spec_lhs) {
-    if (this->is_fd_[attr_num - 1]) {
+template <typename AttributeSet>
+bool FDTreeElement<AttributeSet>::GetGeneralizationAndDelete(AttributeSet const& lhs,
+                                                             size_t attr_num, size_t current_attr,
+                                                             AttributeSet& spec_lhs) {
+    if (this->is_fd_.test(attr_num - 1)) {
         this->is_fd_.reset(attr_num - 1);
         this->rhs_attributes_.reset(attr_num);
         return true;
     }
 
-    size_t next_set_attr = lhs._Find_next(current_attr);
-    if (next_set_attr == kMaxAttrNum) {
+    size_t next_set_attr = lhs.find_next(current_attr);
+    if (next_set_attr == AttributeSet::npos) {
         return false;
     }
 
     bool found = false;
     if (this->children_[next_set_attr - 1] &&
-        this->children_[next_set_attr - 1]->GetRhsAttributes()[attr_num]) {
+        this->children_[next_set_attr - 1]->GetRhsAttributes().test(attr_num)) {
         found = this->children_[next_set_attr - 1]->GetGeneralizationAndDelete(
                 lhs, attr_num, next_set_attr, spec_lhs);
         if (found) {
@@ -95,21 +108,22 @@ bool FDTreeElement::GetGeneralizationAndDelete(std::bitset<kMaxAttrNum> const& l
     return found;
 }
 
-bool FDTreeElement::GetSpecialization(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
-                                      size_t current_attr,
-                                      std::bitset<kMaxAttrNum>& spec_lhs_out) const {
-    if (!this->rhs_attributes_[attr_num]) {
+template <typename AttributeSet>
+bool FDTreeElement<AttributeSet>::GetSpecialization(AttributeSet const& lhs, size_t attr_num,
+                                                    size_t current_attr,
+                                                    AttributeSet& spec_lhs_out) const {
+    if (!this->rhs_attributes_.test(attr_num)) {
         return false;
     }
 
     bool found = false;
     size_t attr = (current_attr > 1 ? current_attr : 1);
-    size_t next_set_attr = lhs._Find_next(current_attr);
+    size_t next_set_attr = lhs.find_next(current_attr);
 
-    if (next_set_attr == kMaxAttrNum) {
+    if (next_set_attr == AttributeSet::npos) {
         while (!found && attr <= this->max_attribute_number_) {
             if (this->children_[attr - 1] &&
-                this->children_[attr - 1]->GetRhsAttributes()[attr_num]) {
+                this->children_[attr - 1]->GetRhsAttributes().test(attr_num)) {
                 found = this->children_[attr - 1]->GetSpecialization(lhs, attr_num, current_attr,
                                                                      spec_lhs_out);
             }
@@ -122,14 +136,15 @@ bool FDTreeElement::GetSpecialization(std::bitset<kMaxAttrNum> const& lhs, size_
     }
 
     while (!found && attr < next_set_attr) {
-        if (this->children_[attr - 1] && this->children_[attr - 1]->GetRhsAttributes()[attr_num]) {
+        if (this->children_[attr - 1] &&
+            this->children_[attr - 1]->GetRhsAttributes().test(attr_num)) {
             found = this->children_[attr - 1]->GetSpecialization(lhs, attr_num, current_attr,
                                                                  spec_lhs_out);
         }
         ++attr;
     }
     if (!found && this->children_[next_set_attr - 1] &&
-        this->children_[next_set_attr - 1]->GetRhsAttributes()[attr_num]) {
+        this->children_[next_set_attr - 1]->GetRhsAttributes().test(attr_num)) {
         found = this->children_[next_set_attr - 1]->GetSpecialization(lhs, attr_num, next_set_attr,
                                                                       spec_lhs_out);
     }
@@ -139,21 +154,24 @@ bool FDTreeElement::GetSpecialization(std::bitset<kMaxAttrNum> const& lhs, size_
     return found;
 }
 
-void FDTreeElement::AddMostGeneralDependencies() {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::AddMostGeneralDependencies() {
     for (size_t i = 1; i <= this->max_attribute_number_; ++i) {
         this->rhs_attributes_.set(i);
     }
 
     for (size_t i = 0; i < this->max_attribute_number_; ++i) {
-        this->is_fd_[i] = true;
+        this->is_fd_.set(i);
     }
 }
 
-void FDTreeElement::AddFunctionalDependency(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num) {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::AddFunctionalDependency(AttributeSet const& lhs,
+                                                          size_t attr_num) {
     FDTreeElement* current_node = this;
     this->AddRhsAttribute(attr_num);
 
-    for (size_t i = lhs._Find_first(); i != kMaxAttrNum; i = lhs._Find_next(i)) {
+    for (size_t i = lhs.find_first(); i != AttributeSet::npos; i = lhs.find_next(i)) {
         if (current_node->children_[i - 1] == nullptr) {
             current_node->children_[i - 1] =
                     std::make_unique<FDTreeElement>(this->max_attribute_number_);
@@ -166,8 +184,9 @@ void FDTreeElement::AddFunctionalDependency(std::bitset<kMaxAttrNum> const& lhs,
     current_node->MarkAsLast(attr_num - 1);
 }
 
-void FDTreeElement::FilterSpecializations() {
-    std::bitset<kMaxAttrNum> active_path;
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::FilterSpecializations() {
+    AttributeSet active_path(max_attribute_number_ + 1);
     auto filtered_tree = std::make_unique<FDTreeElement>(this->max_attribute_number_);
 
     this->FilterSpecializationsHelper(*filtered_tree, active_path);
@@ -176,8 +195,9 @@ void FDTreeElement::FilterSpecializations() {
     this->is_fd_ = filtered_tree->is_fd_;
 }
 
-void FDTreeElement::FilterSpecializationsHelper(FDTreeElement& filtered_tree,
-                                                std::bitset<kMaxAttrNum>& active_path) {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::FilterSpecializationsHelper(FDTreeElement& filtered_tree,
+                                                              AttributeSet& active_path) {
     for (size_t attr = 1; attr <= this->max_attribute_number_; ++attr) {
         if (this->children_[attr - 1]) {
             active_path.set(attr);
@@ -187,36 +207,38 @@ void FDTreeElement::FilterSpecializationsHelper(FDTreeElement& filtered_tree,
     }
 
     for (size_t attr = 1; attr <= this->max_attribute_number_; ++attr) {
-        std::bitset<kMaxAttrNum> spec_lhs_out;
-        if (this->is_fd_[attr - 1] &&
+        AttributeSet spec_lhs_out(max_attribute_number_ + 1);
+        if (this->is_fd_.test(attr - 1) &&
             !filtered_tree.GetSpecialization(active_path, attr, 0, spec_lhs_out)) {
             filtered_tree.AddFunctionalDependency(active_path, attr);
         }
     }
 }
 
-void FDTreeElement::PrintDep(std::string const& file_name,
-                             std::vector<std::string>& column_names) const {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::PrintDep(std::string const& file_name,
+                                           std::vector<std::string>& column_names) const {
     std::ofstream file;
     file.open(file_name);
-    std::bitset<kMaxAttrNum> active_path;
+    AttributeSet active_path(max_attribute_number_ + 1);
     PrintDependencies(active_path, file, column_names);
     file.close();
 }
 
-void FDTreeElement::PrintDependencies(std::bitset<kMaxAttrNum>& active_path, std::ofstream& file,
-                                      std::vector<std::string>& column_names) const {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::PrintDependencies(AttributeSet& active_path, std::ofstream& file,
+                                                    std::vector<std::string>& column_names) const {
     std::string column_id;
     if (std::isdigit(column_names[0][0])) {
         column_id = "column";
     }
     std::string out;
     for (size_t attr = 1; attr <= this->max_attribute_number_; ++attr) {
-        if (this->is_fd_[attr - 1]) {
+        if (this->is_fd_.test(attr - 1)) {
             out = "{";
 
-            for (size_t i = active_path._Find_first(); i != kMaxAttrNum;
-                 i = active_path._Find_next(i)) {
+            for (size_t i = active_path.find_first(); i != AttributeSet::npos;
+                 i = active_path.find_next(i)) {
                 if (!column_id.empty())
                     out += column_id + std::to_string(std::stoi(column_names[i - 1]) + 1) + ",";
                 else
@@ -243,23 +265,26 @@ void FDTreeElement::PrintDependencies(std::bitset<kMaxAttrNum>& active_path, std
     }
 }
 
-void FDTreeElement::FillFdCollection(RelationalSchema const& scheme, std::list<FD>& fd_collection,
-                                     unsigned int max_lhs) const {
-    std::bitset<kMaxAttrNum> active_path;
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::FillFdCollection(RelationalSchema const& scheme,
+                                                   std::list<FD>& fd_collection,
+                                                   unsigned int max_lhs) const {
+    AttributeSet active_path(max_attribute_number_ + 1);
     this->TransformTreeFdCollection(active_path, fd_collection, scheme, max_lhs);
 }
 
-void FDTreeElement::TransformTreeFdCollection(std::bitset<kMaxAttrNum>& active_path,
-                                              std::list<FD>& fd_collection,
-                                              RelationalSchema const& scheme,
-                                              unsigned int max_lhs) const {
+template <typename AttributeSet>
+void FDTreeElement<AttributeSet>::TransformTreeFdCollection(AttributeSet& active_path,
+                                                            std::list<FD>& fd_collection,
+                                                            RelationalSchema const& scheme,
+                                                            unsigned int max_lhs) const {
     if (active_path.count() > max_lhs) return;
 
     for (size_t attr = 1; attr <= this->max_attribute_number_; ++attr) {
-        if (this->is_fd_[attr - 1]) {
+        if (this->is_fd_.test(attr - 1)) {
             boost::dynamic_bitset<> lhs_bitset(this->max_attribute_number_);
-            for (size_t i = active_path._Find_first(); i != kMaxAttrNum;
-                 i = active_path._Find_next(i)) {
+            for (size_t i = active_path.find_first(); i != AttributeSet::npos;
+                 i = active_path.find_next(i)) {
                 lhs_bitset.set(i - 1);
             }
             Vertical lhs(&scheme, lhs_bitset);
@@ -277,3 +302,11 @@ void FDTreeElement::TransformTreeFdCollection(std::bitset<kMaxAttrNum>& active_p
         }
     }
 }
+
+template class FDTreeElement<model::ColumnSet<1>>;
+
+template class FDTreeElement<model::ColumnSet<2>>;
+
+template class FDTreeElement<model::ColumnSet<4>>;
+
+template class FDTreeElement<boost::dynamic_bitset<>>;
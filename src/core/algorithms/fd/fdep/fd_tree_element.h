@@ -1,6 +1,5 @@
 #pragma once
 
-#include <bitset>
 #include <list>
 #include <memory>
 #include <vector>
@@ -12,10 +11,12 @@
 #include "algorithms/fd/fd.h"
 #include "model/table/relational_schema.h"
 
+// Attributes are numbered from 1, so an AttributeSet holds max_attribute_number + 1 bits. It is a
+// model::ColumnSet, or boost::dynamic_bitset<> for schemas too wide for it, see
+// model::DispatchColumnSet.
+template <typename AttributeSet>
 class FDTreeElement {
 public:
-    // The maximum number of columns in the dataset. Using in std::bitset template.
-    static constexpr int kMaxAttrNum = 256;
     explicit FDTreeElement(size_t max_attribute_number);
 
     FDTreeElement(FDTreeElement const&) = delete;
@@ -31,13 +32,13 @@ public:
 
     [[nodiscard]] FDTreeElement* GetChild(size_t index) const;
 
-    void AddFunctionalDependency(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num);
+    void AddFunctionalDependency(AttributeSet const& lhs, size_t attr_num);
 
     // Searching for generalization of functional dependency in cover-trees.
-    bool GetGeneralizationAndDelete(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
-                                    size_t current_attr, std::bitset<kMaxAttrNum>& spec_lhs);
+    bool GetGeneralizationAndDelete(AttributeSet const& lhs, size_t attr_num, size_t current_attr,
+                                    AttributeSet& spec_lhs);
 
-    [[nodiscard]] bool ContainsGeneralization(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
+    [[nodiscard]] bool ContainsGeneralization(AttributeSet const& lhs, size_t attr_num,
                                               size_t current_attr) const;
 
     // Printing found dependencies in output file.
@@ -48,13 +49,13 @@ public:
 
 private:
     std::vector<std::unique_ptr<FDTreeElement>> children_;
-    std::bitset<kMaxAttrNum> rhs_attributes_;
+    AttributeSet rhs_attributes_;
     size_t max_attribute_number_;
-    std::bitset<kMaxAttrNum> is_fd_;
+    AttributeSet is_fd_;
 
     void AddRhsAttribute(size_t index);
 
-    [[nodiscard]] std::bitset<kMaxAttrNum> const& GetRhsAttributes() const;
+    [[nodiscard]] AttributeSet const& GetRhsAttributes() const;
 
     void MarkAsLast(size_t index);
 
@@ -62,18 +63,16 @@ private:
     [[nodiscard]] bool IsFinalNode(size_t attr_num) const;
 
     // Searching for specialization of functional dependency in cover-trees.
-    bool GetSpecialization(std::bitset<kMaxAttrNum> const& lhs, size_t attr_num,
-                           size_t current_attr, std::bitset<kMaxAttrNum>& spec_lhs_out) const;
+    bool GetSpecialization(AttributeSet const& lhs, size_t attr_num, size_t current_attr,
+                           AttributeSet& spec_lhs_out) const;
 
-    void FilterSpecializationsHelper(FDTreeElement& filtered_tree,
-                                     std::bitset<kMaxAttrNum>& active_path);
+    void FilterSpecializationsHelper(FDTreeElement& filtered_tree, AttributeSet& active_path);
 
     // Helper function for PrintDep.
-    void PrintDependencies(std::bitset<kMaxAttrNum>& active_path, std::ofstream& file,
+    void PrintDependencies(AttributeSet& active_path, std::ofstream& file,
                            std::vector<std::string>& column_names) const;
 
     void TransformTreeFdCollection(
-            std::bitset<kMaxAttrNum>& active_path, std::list<FD>& fd_collection,
-            RelationalSchema const& scheme,
+            AttributeSet& active_path, std::list<FD>& fd_collection, RelationalSchema const& scheme,
             unsigned int max_lhs = std::numeric_limits<unsigned int>::max()) const;
 };
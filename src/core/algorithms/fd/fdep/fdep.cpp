@@ -1,10 +1,12 @@
 #include "algorithms/fd/fdep/fdep.h"
 
 #include <chrono>
+#include <string_view>
 
 #include "config/equal_nulls/option.h"
 #include "config/tabular_data/input_table/option.h"
 #include "model/table/column_layout_relation_data.h"
+#include "model/table/column_set.h"
 
 // #ifndef PRINT_FDS
 // #define PRINT_FDS
@@ -35,100 +37,120 @@ void FDep::LoadDataInternal() {
         schema_->AppendColumn(column_names_[i]);
     }
 
-    std::vector<std::string> next_line;
-    while (input_table_->HasNextRow()) {
-        next_line = input_table_->GetNextRow();
-        if (next_line.empty()) break;
-        tuples_.emplace_back(std::vector<size_t>(number_attributes_));
+    model::DatasetBatch batch;
+    while (input_table_->GetNextBatch(model::DatasetBatch::kDefaultNumRows, batch) != 0) {
+        size_t const first_tuple = tuples_.size();
+        tuples_.resize(first_tuple + batch.GetNumRows(), std::vector<size_t>(number_attributes_));
         for (size_t i = 0; i < number_attributes_; ++i) {
-            tuples_.back()[i] = std::hash<std::string>{}(next_line[i]);
+            model::DatasetBatch::Column const& column = batch.GetColumn(i);
+            for (size_t row_index = 0; row_index < column.size(); ++row_index) {
+                tuples_[first_tuple + row_index][i] =
+                        std::hash<std::string_view>{}(column[row_index]);
+            }
         }
     }
 }
 
-void FDep::ResetStateFd() {
-    // Consider creating them here instead.
-    neg_cover_tree_.reset();
-    pos_cover_tree_.reset();
-}
-
 unsigned long long FDep::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
 
-    BuildNegativeCover();
+    // Attributes are numbered from 1 in the cover trees.
+    model::DispatchColumnSet(number_attributes_ + 1, [this](auto attribute_set_type) {
+        DiscoverFds<typename decltype(attribute_set_type)::type>();
+    });
 
-    this->tuples_.shrink_to_fit();
+    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now() - start_time);
 
-    this->pos_cover_tree_ = std::make_unique<FDTreeElement>(this->number_attributes_);
-    this->pos_cover_tree_->AddMostGeneralDependencies();
+    return elapsed_milliseconds.count();
+}
 
-    std::bitset<FDTreeElement::kMaxAttrNum> active_path;
-    CalculatePositiveCover(*this->neg_cover_tree_, active_path);
+template <typename AttributeSet>
+void FDep::DiscoverFds() {
+    std::unique_ptr<FDTreeElement<AttributeSet>> neg_cover_tree =
+            BuildNegativeCover<AttributeSet>();
+    if (neg_cover_tree == nullptr) {
+        return;
+    }
 
-    pos_cover_tree_->FillFdCollection(*this->schema_, FdList(), max_lhs_);
+    this->tuples_.shrink_to_fit();
 
-    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - start_time);
+    auto pos_cover_tree = std::make_unique<FDTreeElement<AttributeSet>>(this->number_attributes_);
+    pos_cover_tree->AddMostGeneralDependencies();
+
+    AttributeSet active_path(this->number_attributes_ + 1);
+    CalculatePositiveCover(*pos_cover_tree, *neg_cover_tree, active_path);
+
+    pos_cover_tree->FillFdCollection(*this->schema_, FdList(), max_lhs_);
 
 #ifdef PRINT_FDS
-    pos_cover_tree_->printDep("recent_call_result.txt", this->column_names_);
+    pos_cover_tree->PrintDep("recent_call_result.txt", this->column_names_);
 #endif
-
-    return elapsed_milliseconds.count();
 }
 
-void FDep::BuildNegativeCover() {
-    this->neg_cover_tree_ = std::make_unique<FDTreeElement>(this->number_attributes_);
+template <typename AttributeSet>
+std::unique_ptr<FDTreeElement<AttributeSet>> FDep::BuildNegativeCover() const {
+    auto neg_cover_tree = std::make_unique<FDTreeElement<AttributeSet>>(this->number_attributes_);
     for (auto i = this->tuples_.begin(); i != this->tuples_.end(); ++i) {
-        for (auto j = i + 1; j != this->tuples_.end(); ++j) AddViolatedFDs(*i, *j);
+        if (StopRequested()) {
+            return nullptr;
+        }
+        for (auto j = i + 1; j != this->tuples_.end(); ++j) AddViolatedFDs(*neg_cover_tree, *i, *j);
     }
 
-    this->neg_cover_tree_->FilterSpecializations();
+    neg_cover_tree->FilterSpecializations();
+    return neg_cover_tree;
 }
 
-void FDep::AddViolatedFDs(std::vector<size_t> const& t1, std::vector<size_t> const& t2) {
-    std::bitset<FDTreeElement::kMaxAttrNum> equal_attr((2 << this->number_attributes_) - 1);
-    equal_attr.reset(0);
-    std::bitset<FDTreeElement::kMaxAttrNum> diff_attr;
+template <typename AttributeSet>
+void FDep::AddViolatedFDs(FDTreeElement<AttributeSet>& neg_cover_tree,
+                          std::vector<size_t> const& t1, std::vector<size_t> const& t2) const {
+    AttributeSet equal_attr(this->number_attributes_ + 1);
+    AttributeSet diff_attr(this->number_attributes_ + 1);
 
     for (size_t attr = 0; attr < this->number_attributes_; ++attr) {
-        diff_attr[attr + 1] = (t1[attr] != t2[attr]);
+        bool const differ = t1[attr] != t2[attr];
+        equal_attr.set(attr + 1, !differ);
+        diff_attr.set(attr + 1, differ);
     }
 
-    equal_attr &= (~diff_attr);
-    for (size_t attr = diff_attr._Find_first(); attr != FDTreeElement::kMaxAttrNum;
-         attr = diff_attr._Find_next(attr)) {
-        this->neg_cover_tree_->AddFunctionalDependency(equal_attr, attr);
+    for (size_t attr = diff_attr.find_first(); attr != AttributeSet::npos;
+         attr = diff_attr.find_next(attr)) {
+        neg_cover_tree.AddFunctionalDependency(equal_attr, attr);
     }
 }
 
-void FDep::CalculatePositiveCover(FDTreeElement const& neg_cover_subtree,
-                                  std::bitset<FDTreeElement::kMaxAttrNum>& active_path) {
+template <typename AttributeSet>
+void FDep::CalculatePositiveCover(FDTreeElement<AttributeSet>& pos_cover_tree,
+                                  FDTreeElement<AttributeSet> const& neg_cover_subtree,
+                                  AttributeSet& active_path) const {
     for (size_t attr = 1; attr <= this->number_attributes_; ++attr) {
         if (neg_cover_subtree.CheckFd(attr - 1)) {
-            this->SpecializePositiveCover(active_path, attr);
+            this->SpecializePositiveCover(pos_cover_tree, active_path, attr);
         }
     }
 
     for (size_t attr = 1; attr <= this->number_attributes_; ++attr) {
         if (neg_cover_subtree.GetChild(attr - 1)) {
             active_path.set(attr);
-            this->CalculatePositiveCover(*neg_cover_subtree.GetChild(attr - 1), active_path);
+            this->CalculatePositiveCover(pos_cover_tree, *neg_cover_subtree.GetChild(attr - 1),
+                                         active_path);
             active_path.reset(attr);
         }
     }
 }
 
-void FDep::SpecializePositiveCover(std::bitset<FDTreeElement::kMaxAttrNum> const& lhs,
-                                   size_t const& a) {
-    std::bitset<FDTreeElement::kMaxAttrNum> spec_lhs;
+template <typename AttributeSet>
+void FDep::SpecializePositiveCover(FDTreeElement<AttributeSet>& pos_cover_tree,
+                                   AttributeSet const& lhs, size_t const& a) const {
+    AttributeSet spec_lhs(this->number_attributes_ + 1);
 
-    while (this->pos_cover_tree_->GetGeneralizationAndDelete(lhs, a, 0, spec_lhs)) {
+    while (pos_cover_tree.GetGeneralizationAndDelete(lhs, a, 0, spec_lhs)) {
         for (size_t attr = this->number_attributes_; attr > 0; --attr) {
             if (!lhs.test(attr) && (attr != a)) {
                 spec_lhs.set(attr);
-                if (!this->pos_cover_tree_->ContainsGeneralization(spec_lhs, a, 0)) {
-                    this->pos_cover_tree_->AddFunctionalDependency(spec_lhs, a);
+                if (!pos_cover_tree.ContainsGeneralization(spec_lhs, a, 0)) {
+                    pos_cover_tree.AddFunctionalDependency(spec_lhs, a);
                 }
                 spec_lhs.reset(attr);
             }
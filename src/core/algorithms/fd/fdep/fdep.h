@@ -26,33 +26,41 @@ private:
     std::vector<std::string> column_names_;
     size_t number_attributes_{};
 
-    std::unique_ptr<FDTreeElement> neg_cover_tree_{};
-    std::unique_ptr<FDTreeElement> pos_cover_tree_{};
-
     std::vector<std::vector<size_t>> tuples_;
 
     void RegisterOptions();
 
     void LoadDataInternal() final;
 
-    void ResetStateFd() final;
+    void ResetStateFd() final {}
     unsigned long long ExecuteInternal() final;
 
-    // Building negative cover via violated dependencies
-    void BuildNegativeCover();
+    // Mining FDs with cover trees over the attribute set type picked by the schema width.
+    template <typename AttributeSet>
+    void DiscoverFds();
+
+    // Building negative cover via violated dependencies.
+    // Returns nullptr if stopped: an incomplete negative cover gives invalid FDs
+    template <typename AttributeSet>
+    std::unique_ptr<FDTreeElement<AttributeSet>> BuildNegativeCover() const;
 
     // Iterating over all pairs t1 and t2 of the relation
     // Adding violated FDs to negative cover tree.
-    void AddViolatedFDs(std::vector<size_t> const& t1, std::vector<size_t> const& t2);
+    template <typename AttributeSet>
+    void AddViolatedFDs(FDTreeElement<AttributeSet>& neg_cover_tree, std::vector<size_t> const& t1,
+                        std::vector<size_t> const& t2) const;
 
     // Converting negative cover tree into positive cover tree
-    void CalculatePositiveCover(FDTreeElement const& neg_cover_subtree,
-                                std::bitset<FDTreeElement::kMaxAttrNum>& active_path);
+    template <typename AttributeSet>
+    void CalculatePositiveCover(FDTreeElement<AttributeSet>& pos_cover_tree,
+                                FDTreeElement<AttributeSet> const& neg_cover_subtree,
+                                AttributeSet& active_path) const;
 
     // Specializing general dependencies for not to be followed from violated dependencies of
     // negative cover tree.
-    void SpecializePositiveCover(std::bitset<FDTreeElement::kMaxAttrNum> const& lhs,
-                                 size_t const& a);
+    template <typename AttributeSet>
+    void SpecializePositiveCover(FDTreeElement<AttributeSet>& pos_cover_tree,
+                                 AttributeSet const& lhs, size_t const& a) const;
 };
 
 }  // namespace algos
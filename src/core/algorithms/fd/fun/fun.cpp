@@ -174,7 +174,7 @@ unsigned long long FUN::ExecuteInternal() {
         }
     }
 
-    while (!l_k.empty()) {
+    while (!l_k.empty() && !StopRequested()) {
         ComputeClosure(l_k_minus_1, l_k);
         ComputeQuasiClosure(l_k_minus_1, l_k);
         DisplayFD(l_k_minus_1);
@@ -4,16 +4,21 @@
 #include <memory>
 #include <utility>
 
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
 #include <boost/dynamic_bitset.hpp>
-#include <boost/thread/future.hpp>
 
 #include "algorithms/fd/hycommon/util/pli_util.h"
 #include "efficiency.h"
+#include "util/metrics.h"
+#include "util/parallel_for.h"
 
 namespace {
 
+void CountSampledPairs(size_t num_pairs) {
+    if (util::Metrics* metrics = util::Metrics::Current()) {
+        metrics->Counter("sampled_pairs").Add(num_pairs);
+    }
+}
+
 class ClusterComparator {
 private:
     algos::hy::Rows* sort_keys_;
@@ -84,8 +89,8 @@ void Sampler::RunWindowImpl(Efficiency& efficiency, model::PositionListIndex con
     unsigned comparisons = 0;
     unsigned const window = efficiency.GetWindow();
 
-    for (model::PLI::Cluster const& cluster : pli.GetIndex()) {
-        boost::dynamic_bitset<> equal_attrs(num_attributes);
+    boost::dynamic_bitset<> equal_attrs(num_attributes);
+    for (model::PLI::ClusterView cluster : pli.GetIndex()) {
         for (size_t i = 0; window < cluster.size() && i < cluster.size() - window; ++i) {
             int const pivot_id = cluster[i];
             int const partner_id = cluster[i + window];
@@ -103,6 +108,7 @@ void Sampler::RunWindowImpl(Efficiency& efficiency, model::PositionListIndex con
 
     efficiency.SetViolations(num_new_violations);
     efficiency.SetComparisons(comparisons);
+    CountSampledPairs(comparisons);
 }
 
 std::vector<boost::dynamic_bitset<>> Sampler::RunWindowRet(Efficiency& efficiency,
@@ -131,26 +137,25 @@ void Sampler::ProcessComparisonSuggestions(IdPairs const& comparison_suggestions
 
         agree_sets_->Add(std::move(equal_attrs));
     }
+    CountSampledPairs(comparison_suggestions.size());
 }
 
 void Sampler::SortClustersParallel() {
     ColumnSlider column_slider(plis_->size());
-    std::vector<boost::unique_future<void>> sort_futures;
+    std::vector<std::pair<model::PLI*, ClusterComparator>> sorts;
+    sorts.reserve(plis_->size());
     for (model::PLI* pli : *plis_) {
-        ClusterComparator cluster_comparator(compressed_records_.get(),
-                                             column_slider.GetLeftNeighbor(),
-                                             column_slider.GetRightNeighbor());
-        auto sort = [pli, cluster_comparator]() {
-            for (model::PLI::Cluster& cluster : pli->GetIndex()) {
-                std::sort(cluster.begin(), cluster.end(), cluster_comparator);
-            }
-        };
-        boost::packaged_task<void> task(std::move(sort));
-        sort_futures.push_back(task.get_future());
-        boost::asio::post(*pool_, std::move(task));
+        sorts.emplace_back(pli, ClusterComparator(compressed_records_.get(),
+                                                  column_slider.GetLeftNeighbor(),
+                                                  column_slider.GetRightNeighbor()));
         column_slider.ToNextColumn();
     }
-    boost::wait_for_all(sort_futures.begin(), sort_futures.end());
+    util::ParallelForeach(sorts.begin(), sorts.end(), threads_num_, [](auto const& sort) {
+        auto const& [pli, cluster_comparator] = sort;
+        for (model::ClusterIndex::Cluster cluster : pli->GetIndex()) {
+            std::sort(cluster.begin(), cluster.end(), cluster_comparator);
+        }
+    });
 }
 
 void Sampler::SortClustersSeq() {
@@ -159,7 +164,7 @@ void Sampler::SortClustersSeq() {
         ClusterComparator cluster_comparator(compressed_records_.get(),
                                              column_slider.GetLeftNeighbor(),
                                              column_slider.GetRightNeighbor());
-        for (model::PLI::Cluster& cluster : pli->GetIndex()) {
+        for (model::ClusterIndex::Cluster cluster : pli->GetIndex()) {
             std::sort(cluster.begin(), cluster.end(), cluster_comparator);
         }
         column_slider.ToNextColumn();
@@ -176,30 +181,21 @@ void Sampler::SortClusters() {
 }
 
 void Sampler::InitializeEfficiencyQueueParallel() {
-    using EfficiencyAndMatches = std::pair<Efficiency, std::vector<boost::dynamic_bitset<>>>;
-    std::vector<boost::unique_future<EfficiencyAndMatches>> futures;
+    std::vector<Efficiency> efficiencies;
+    efficiencies.reserve(plis_->size());
     for (size_t attr = 0; attr < plis_->size(); ++attr) {
-        auto run_window = [attr, this]() {
-            Efficiency efficiency(attr);
-            return std::make_pair(efficiency, RunWindowRet(efficiency, *(*plis_)[attr]));
-        };
-        boost::packaged_task<EfficiencyAndMatches> task(std::move(run_window));
-        futures.push_back(task.get_future());
-        boost::asio::post(*pool_, std::move(task));
+        efficiencies.emplace_back(attr);
     }
-
-    // TODO(polyntsov): this waiting causes significant overhead on some datasets (on flight_1k
-    // it's probably the highest one). However removing this waiting fully removes overhead on
-    // these problematic datasets, it adds overhead on all other datasets :/
-    // It seems that all problematic datasets spend most of the time on the validation phase, so
-    // multithreading here may add some overhead, but I don't really understand how the explicit
-    // waiting causes it. Further investigation is needed.
-    boost::wait_for_all(futures.begin(), futures.end());
-
-    for (auto& future : futures) {
-        auto [efficiency, matches] = future.get();
-
-        for (auto& match : matches) {
+    std::vector<std::vector<boost::dynamic_bitset<>>> matches(plis_->size());
+    util::ParallelForeach(efficiencies.begin(), efficiencies.end(), threads_num_,
+                          [this, &matches](Efficiency& efficiency) {
+                              size_t const attr = efficiency.GetAttr();
+                              matches[attr] = RunWindowRet(efficiency, *(*plis_)[attr]);
+                          });
+
+    /* Merging in the order of attributes keeps the result independent of the scheduling */
+    for (Efficiency const& efficiency : efficiencies) {
+        for (auto& match : matches[efficiency.GetAttr()]) {
             agree_sets_->Add(std::move(match));
         }
 
@@ -247,11 +243,6 @@ ColumnCombinationList Sampler::GetAgreeSets(IdPairs const& comparison_suggestion
     ProcessComparisonSuggestions(comparison_suggestions);
 
     if (efficiency_queue_.empty()) {
-        if (threads_num_ > 1) {
-            assert(pool_ == nullptr);
-            pool_ = std::make_unique<boost::asio::thread_pool>(threads_num_);
-        }
-
         InitializeEfficiencyQueue();
     } else {
         double const threshold_decrease = 0.9;
@@ -296,11 +287,6 @@ Sampler::Sampler(PLIsPtr plis, RowsPtr pli_records, config::ThreadNumType thread
       agree_sets_(std::make_unique<AllColumnCombinations>(plis_->size())),
       threads_num_(threads) {}
 
-Sampler::~Sampler() {
-    assert(threads_num_ != 0);
-    if (threads_num_ != 1 && pool_ != nullptr) {
-        pool_->join();
-    }
-}
+Sampler::~Sampler() = default;
 
 }  // namespace algos::hy
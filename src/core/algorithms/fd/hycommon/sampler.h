@@ -12,12 +12,6 @@
 #include "model/table/position_list_index.h"
 #include "types.h"
 
-namespace boost::asio {
-// Forward declare thread_pool to avoid including boost::asio::thread_pool implementation since
-// it's not needed here and to avoid transitevly pollute all other files with it
-class thread_pool;
-}  // namespace boost::asio
-
 namespace algos::hy {
 
 class Sampler {
@@ -30,7 +24,6 @@ private:
     std::priority_queue<Efficiency> efficiency_queue_;
     std::unique_ptr<AllColumnCombinations> agree_sets_;
     config::ThreadNumType threads_num_;
-    std::unique_ptr<boost::asio::thread_pool> pool_;
 
     void ProcessComparisonSuggestions(IdPairs const& comparison_suggestions);
     void SortClustersSeq();
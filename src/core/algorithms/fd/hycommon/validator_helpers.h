@@ -10,6 +10,7 @@
 #include <easylogging++.h>
 
 #include "types.h"
+#include "util/metrics.h"
 
 #define UNORDERED_FLAT_MAP_AVAILABLE (BOOST_VERSION >= 108100)
 
@@ -30,6 +31,15 @@ template <typename VertexAndAgreeSet>
 std::vector<VertexAndAgreeSet> CollectCurrentChildren(
         std::vector<VertexAndAgreeSet> const& cur_level_vertices, size_t num_attributes);
 
+// Adds the validations of a level to the metrics of the running algorithm
+template <typename InstanceValidations>
+void CountValidations(InstanceValidations const& result) {
+    if (util::Metrics* metrics = util::Metrics::Current()) {
+        metrics->Validations().Add(result.CountValidations());
+        metrics->Histogram("level_validations").Record(result.CountValidations());
+    }
+}
+
 template <typename VertexAndAgreeSet, typename InstanceValidations>
 void LogLevel(std::vector<VertexAndAgreeSet> const& cur_level_vertices,
               InstanceValidations const& result, size_t candidates, size_t current_level_number,
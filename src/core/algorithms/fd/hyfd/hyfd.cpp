@@ -26,7 +26,9 @@ unsigned long long HyFD::ExecuteInternal() {
     LOG(TRACE) << "Executing";
     auto const start_time = std::chrono::system_clock::now();
 
-    auto [plis, pli_records, og_mapping] = Preprocess(relation_.get());
+    ::util::Metrics& metrics = GetMetrics();
+    auto [plis, pli_records, og_mapping] = ::util::TimedCall(
+            metrics.Timer("preprocessing"), [this] { return Preprocess(relation_.get()); });
     auto const plis_shared = std::make_shared<PLIs>(std::move(plis));
     auto const pli_records_shared = std::make_shared<Rows>(std::move(pli_records));
 
@@ -35,16 +37,22 @@ unsigned long long HyFD::ExecuteInternal() {
     auto const positive_cover_tree =
             std::make_shared<fd_tree::FDTree>(GetRelation().GetNumColumns());
     Inductor inductor(positive_cover_tree);
-    Validator validator(positive_cover_tree, plis_shared, pli_records_shared);
+    Validator validator(positive_cover_tree, plis_shared, pli_records_shared,
+                        GetCancellationToken());
 
     IdPairs comparison_suggestions;
 
-    while (true) {
-        auto non_fds = sampler.GetNonFDs(comparison_suggestions);
+    ::util::MetricTimer& sampling_time = metrics.Timer("sampling");
+    ::util::MetricTimer& induction_time = metrics.Timer("induction");
+    ::util::MetricTimer& validation_time = metrics.ValidationTime();
+    while (!StopRequested()) {
+        auto non_fds = ::util::TimedCall(
+                sampling_time, [&] { return sampler.GetNonFDs(comparison_suggestions); });
 
-        inductor.UpdateFdTree(std::move(non_fds));
+        ::util::TimedCall(induction_time, [&] { inductor.UpdateFdTree(std::move(non_fds)); });
 
-        comparison_suggestions = validator.ValidateAndExtendCandidates();
+        comparison_suggestions = ::util::TimedCall(
+                validation_time, [&validator] { return validator.ValidateAndExtendCandidates(); });
 
         if (comparison_suggestions.empty()) {
             break;
@@ -54,6 +62,12 @@ unsigned long long HyFD::ExecuteInternal() {
     }
 
     auto fds = positive_cover_tree->FillFDs();
+    if (GetCancellationToken().Stopped()) {
+        /* The levels the validator has not finished hold unchecked candidates */
+        std::erase_if(fds, [level = validator.GetLevelNum()](RawFD const& fd) {
+            return fd.lhs_.count() >= level;
+        });
+    }
     RegisterFDs(std::move(fds), og_mapping);
 
     SetProgress(kTotalProgressPercent);
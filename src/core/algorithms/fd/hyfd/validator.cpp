@@ -184,7 +184,7 @@ Validator::FDValidations Validator::ProcessFirstLevel(LhsPair const& lhs_pair) {
         for (auto const& cluster : (*plis_)[lhs_attr]->GetIndex()) {
             size_t const cluster_id = (*compressed_records_)[cluster[0]][attr];
             if (algos::hy::PLIUtil::IsSingletonCluster(cluster_id) ||
-                std::any_of(cluster.cbegin(), cluster.cend(), [this, attr, cluster_id](int id) {
+                std::any_of(cluster.begin(), cluster.end(), [this, attr, cluster_id](int id) {
                     return (*compressed_records_)[id][attr] != cluster_id;
                 })) {
                 vertex->RemoveFd(attr);
@@ -243,6 +243,7 @@ Validator::FDValidations Validator::GetValidations(LhsPair const& lhsPair) {
 Validator::FDValidations Validator::ValidateAndExtendSeq(std::vector<LhsPair> const& vertices) {
     FDValidations result;
     for (auto const& vertex : vertices) {
+        if (cancellation_.StopRequested()) break;
         result.Add(GetValidations(vertex));
     }
 
@@ -264,6 +265,9 @@ algos::hy::IdPairs Validator::ValidateAndExtendCandidates() {
     algos::hy::IdPairs comparison_suggestions;
     while (!cur_level_vertices.empty()) {
         auto const result = ValidateAndExtendSeq(cur_level_vertices);
+        if (cancellation_.StopRequested()) {
+            return {};
+        }
 
         comparison_suggestions.insert(comparison_suggestions.end(),
                                       result.ComparisonSuggestions().begin(),
@@ -276,6 +280,7 @@ algos::hy::IdPairs Validator::ValidateAndExtendCandidates() {
                 algos::hy::CollectCurrentChildren(cur_level_vertices, num_attributes);
         size_t candidates = AddExtendedCandidatesFromInvalid(
                 next_level, *fds_, result.InvalidInstances(), num_attributes);
+        algos::hy::CountValidations(result);
         algos::hy::LogLevel(cur_level_vertices, result, candidates, current_level_number_, "FD");
 
         size_t const num_invalid_fds = result.InvalidInstances().size();
@@ -9,6 +9,7 @@
 #include "algorithms/fd/raw_fd.h"
 #include "model/table/position_list_index.h"
 #include "types.h"
+#include "util/cancellation_token.h"
 
 namespace algos::hyfd {
 
@@ -24,6 +25,7 @@ private:
     hy::RowsPtr compressed_records_;
 
     unsigned current_level_number_ = 0;
+    util::CancellationToken& cancellation_;
 
     FDValidations ProcessZeroLevel(LhsPair const& lhsPair);
     FDValidations ProcessFirstLevel(LhsPair const& lhs_pair);
@@ -33,17 +35,20 @@ private:
 
     FDValidations ValidateAndExtendSeq(std::vector<LhsPair> const& vertices);
 
-    [[nodiscard]] unsigned GetLevelNum() const {
-        return current_level_number_;
-    }
-
 public:
     Validator(std::shared_ptr<fd_tree::FDTree> fds, hy::PLIsPtr plis,
-              hy::RowsPtr compressed_records) noexcept
+              hy::RowsPtr compressed_records, util::CancellationToken& cancellation) noexcept
         : fds_(std::move(fds)),
           plis_(std::move(plis)),
-          compressed_records_(std::move(compressed_records)) {}
+          compressed_records_(std::move(compressed_records)),
+          cancellation_(cancellation) {}
+
+    /* FDs with fewer LHS attributes than this are validated */
+    [[nodiscard]] unsigned GetLevelNum() const {
+        return current_level_number_;
+    }
 
+    /* Stops early if `cancellation` asks to, the level being validated is not counted then */
     hy::IdPairs ValidateAndExtendCandidates();
 };
 
@@ -1,7 +1,10 @@
 #include "pli_based_fd_algorithm.h"
 
 #include "config/equal_nulls/option.h"
+#include "config/names_and_descriptions.h"
+#include "config/option.h"
 #include "config/tabular_data/input_table/option.h"
+#include "config/thread_number/option.h"
 
 namespace algos {
 
@@ -12,15 +15,20 @@ PliBasedFDAlgorithm::PliBasedFDAlgorithm(
       relation_manager_(relation_manager.has_value()
                                 ? *relation_manager
                                 : ColumnLayoutRelationDataManager{
-                                          &input_table_, &is_null_equal_null_, &relation_}) {
+                                          &input_table_, &is_null_equal_null_, &relation_,
+                                          &threads_num_, &compress_plis_, &snapshot_path_}) {
+    RegisterOption(config::kThreadNumberOpt(&threads_num_));
     if (relation_manager.has_value()) return;
     RegisterRelationManagerOptions();
-    MakeOptionsAvailable({config::kTableOpt.GetName(), config::kEqualNullsOpt.GetName()});
+    MakeOptionsAvailable({config::kTableOpt.GetName(), config::kEqualNullsOpt.GetName(),
+                          config::kThreadNumberOpt.GetName(), config::names::kSnapshot});
 }
 
 void PliBasedFDAlgorithm::RegisterRelationManagerOptions() {
     RegisterOption(config::kTableOpt(&input_table_));
     RegisterOption(config::kEqualNullsOpt(&is_null_equal_null_));
+    using config::names::kSnapshot, config::descriptions::kDSnapshot;
+    RegisterOption(config::Option{&snapshot_path_, kSnapshot, kDSnapshot, std::filesystem::path{}});
 }
 
 void PliBasedFDAlgorithm::LoadDataInternal() {
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <filesystem>
 #include <optional>
 
 #include "config/equal_nulls/type.h"
 #include "config/tabular_data/input_table_type.h"
+#include "config/thread_number/type.h"
 #include "fd_algorithm.h"
 #include "model/table/column_layout_relation_data.h"
 
@@ -16,19 +18,40 @@ public:
         config::InputTable* input_table_;
         config::EqNullsType* is_null_equal_null_;
         std::shared_ptr<ColumnLayoutRelationData>* relation_;
+        // Threads used to load the relation, loading is sequential if not given
+        config::ThreadNumType const* threads_num_;
+        // Whether the column PLIs are compressed while loading, they are not if not given
+        bool const* compress_plis_;
+        // Snapshot of the relation, none if not given or empty
+        std::filesystem::path const* snapshot_path_;
 
     public:
-        ColumnLayoutRelationDataManager(
-                config::InputTable* input_table, config::EqNullsType* is_null_equal_null,
-                std::shared_ptr<ColumnLayoutRelationData>* relation_ptr) noexcept
+        ColumnLayoutRelationDataManager(config::InputTable* input_table,
+                                        config::EqNullsType* is_null_equal_null,
+                                        std::shared_ptr<ColumnLayoutRelationData>* relation_ptr,
+                                        config::ThreadNumType const* threads_num = nullptr,
+                                        bool const* compress_plis = nullptr,
+                                        std::filesystem::path const* snapshot_path =
+                                                nullptr) noexcept
             : input_table_(input_table),
               is_null_equal_null_(is_null_equal_null),
-              relation_(relation_ptr) {}
+              relation_(relation_ptr),
+              threads_num_(threads_num),
+              compress_plis_(compress_plis),
+              snapshot_path_(snapshot_path) {}
 
         std::shared_ptr<ColumnLayoutRelationData> GetRelation() const {
-            if (*relation_ == nullptr)
-                *relation_ =
-                        ColumnLayoutRelationData::CreateFrom(**input_table_, *is_null_equal_null_);
+            if (*relation_ != nullptr) return *relation_;
+            unsigned const threads = threads_num_ == nullptr ? 1 : *threads_num_;
+            // PLIs read from a snapshot are mapped, so they are not compressed
+            if (snapshot_path_ != nullptr && !snapshot_path_->empty()) {
+                *relation_ = ColumnLayoutRelationData::CreateWithSnapshot(
+                        **input_table_, *snapshot_path_, *is_null_equal_null_, threads);
+            } else {
+                *relation_ = ColumnLayoutRelationData::CreateFrom(
+                        **input_table_, *is_null_equal_null_, threads,
+                        compress_plis_ != nullptr && *compress_plis_);
+            }
             return *relation_;
         }
     };
@@ -36,12 +59,19 @@ public:
 private:
     config::InputTable input_table_;
     config::EqNullsType is_null_equal_null_;
+    std::filesystem::path snapshot_path_;
     ColumnLayoutRelationDataManager const relation_manager_;
 
     void RegisterRelationManagerOptions();
 
 protected:
     std::shared_ptr<ColumnLayoutRelationData> relation_;
+    // Set before loading when the algorithm loads the relation itself, algorithms that run in
+    // parallel also make it available for execution
+    config::ThreadNumType threads_num_ = 1;
+    // Registered as an option by the algorithms that only walk the column PLIs with
+    // ForEachCluster and intersect them, see ColumnLayoutRelationData::CreateFrom
+    bool compress_plis_ = false;
 
     void LoadDataInternal() final;
 
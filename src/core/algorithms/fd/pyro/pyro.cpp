@@ -9,6 +9,7 @@
 #include "algorithms/fd/pyrocommon/core/fd_g1_strategy.h"
 #include "config/error/option.h"
 #include "config/max_lhs/option.h"
+#include "config/mem_limit/option.h"
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/thread_number/option.h"
@@ -31,13 +32,14 @@ void Pyro::RegisterOptions() {
     DESBORDANTE_OPTION_USING;
 
     RegisterOption(config::kErrorOpt(&parameters_.max_ucc_error));
-    RegisterOption(config::kThreadNumberOpt(&parameters_.parallelism));
     RegisterOption(Option{&parameters_.seed, kSeed, kDSeed, 0});
+    RegisterOption(config::kMemLimitMbOpt(&parameters_.mem_limit_mb));
 }
 
 void Pyro::MakeExecuteOptsAvailableFDInternal() {
     using namespace config::names;
-    MakeOptionsAvailable({config::kErrorOpt.GetName(), config::kThreadNumberOpt.GetName(), kSeed});
+    MakeOptionsAvailable({config::kErrorOpt.GetName(), config::kThreadNumberOpt.GetName(), kSeed,
+                          config::kMemLimitMbOpt.GetName()});
 }
 
 void Pyro::ResetStateFd() {
@@ -46,12 +48,14 @@ void Pyro::ResetStateFd() {
 
 unsigned long long Pyro::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
+    LimitMemory(size_t{parameters_.mem_limit_mb} << 20);
 
+    parameters_.parallelism = threads_num_;
     auto schema = relation_->GetSchema();
 
     auto profiling_context = std::make_unique<ProfilingContext>(
             parameters_, relation_.get(), ucc_consumer_, fd_consumer_, caching_method_,
-            eviction_method_, caching_method_value_);
+            eviction_method_, GetCancellationToken(), GetMemoryBudget());
 
     std::function<bool(DependencyCandidate const&, DependencyCandidate const&)> launch_pad_order;
     if (parameters_.launch_pad_order == "arity") {
@@ -74,12 +78,12 @@ unsigned long long Pyro::ExecuteInternal() {
         search_spaces_.push_back(std::make_unique<SearchSpace>(next_id++, std::move(strategy),
                                                                schema, launch_pad_order));
     }
-    unsigned long long init_time_millis = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                  std::chrono::system_clock::now() - start_time)
-                                                  .count();
+    auto const init_time = std::chrono::system_clock::now() - start_time;
+    GetMetrics().Timer("initialization").Record(init_time);
+    unsigned long long init_time_millis =
+            std::chrono::duration_cast<std::chrono::milliseconds>(init_time).count();
 
     start_time = std::chrono::system_clock::now();
-    unsigned int total_error_calc_count = 0;
     unsigned long long total_ascension = 0;
     unsigned long long total_trickle = 0;
     double progress_step = 100.0 / search_spaces_.size();
@@ -87,7 +91,8 @@ unsigned long long Pyro::ExecuteInternal() {
     auto const work_on_search_space =
             [this, &progress_step](std::list<std::unique_ptr<SearchSpace>>& search_spaces,
                                    ProfilingContext* profiling_context, int id) {
-                while (true) {
+                util::Metrics::Scope metrics_scope(&GetMetrics());
+                while (!StopRequested()) {
                     std::unique_ptr<SearchSpace> polled_space;
                     {
                         std::scoped_lock<std::mutex> lock(search_spaces_mutex);
@@ -116,16 +121,22 @@ unsigned long long Pyro::ExecuteInternal() {
     }
 
     SetProgress(100);
-    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - start_time);
+    auto const search_time = std::chrono::system_clock::now() - start_time;
+    GetMetrics().Timer("search").Record(search_time);
+    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(search_time);
 
-    LOG(INFO) << boost::format{"FdG1 error calculation: %1% ms"} % (FdG1Strategy::nanos_ / 1000000);
+    auto to_millis = [](std::chrono::nanoseconds time) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(time).count();
+    };
+    util::MetricTimer::Value const validations = GetMetrics().ValidationTime().Get();
+    LOG(INFO) << boost::format{"FdG1 error calculation: %1% ms"} % to_millis(validations.total);
     LOG(INFO) << "Init time: " << init_time_millis << "ms";
     LOG(INFO) << "Time: " << elapsed_milliseconds.count() << " milliseconds";
-    LOG(INFO) << "Error calculation count: " << total_error_calc_count;
+    LOG(INFO) << "Error calculation count: " << validations.count;
     LOG(INFO) << "Total ascension time: " << total_ascension << "ms";
     LOG(INFO) << "Total trickle time: " << total_trickle << "ms";
-    LOG(INFO) << "Total intersection time: " << model::PositionListIndex::micros_ / 1000 << "ms";
+    LOG(INFO) << "Total intersection time: "
+              << to_millis(GetMetrics().PliIntersectionTime().Get().total) << "ms";
     LOG(INFO) << "HASH: " << PliBasedFDAlgorithm::Fletcher16();
     return elapsed_milliseconds.count();
 }
@@ -16,7 +16,6 @@ private:
 
     CachingMethod caching_method_ = CachingMethod::kCoin;
     CacheEvictionMethod eviction_method_ = CacheEvictionMethod::kDefault;
-    double caching_method_value_;
 
     pyro::Parameters parameters_;
 
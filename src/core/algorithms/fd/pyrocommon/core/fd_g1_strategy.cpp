@@ -4,15 +4,14 @@
 
 #include <easylogging++.h>
 
-#include "../model/pli_cache.h"
+#include "model/table/pli_cache.h"
 #include "search_space.h"
+#include "util/metrics.h"
 
-unsigned long long FdG1Strategy::nanos_ = 0;
-
-double FdG1Strategy::CalculateG1(model::PositionListIndex* lhs_pli) const {
+double FdG1Strategy::CalculateG1(model::PositionListIndex const* lhs_pli) const {
     unsigned long long num_violations = 0;
     std::unordered_map<int, int> value_counts;
-    std::vector<int> const& probing_table = context_->GetColumnLayoutRelationData()
+    model::PLI::ProbingTable const probing_table = context_->GetColumnLayoutRelationData()
                                                     ->GetColumnData(rhs_->GetIndex())
                                                     .GetProbingTable();
 
@@ -62,6 +61,9 @@ void FdG1Strategy::EnsureInitialized(SearchSpace* search_space) const {
 }
 
 double FdG1Strategy::CalculateError(Vertical const& lhs) const {
+    util::Metrics* metrics = util::Metrics::Current();
+    util::ScopedTimer timer(metrics != nullptr ? &metrics->ValidationTime() : nullptr);
+    if (metrics != nullptr) metrics->Validations().Add();
     double error = 0;
     if (lhs.GetArity() == 0) {
         auto rhs_pli = context_->GetPliCache()->Get(static_cast<Vertical>(*rhs_));
@@ -71,15 +73,11 @@ double FdG1Strategy::CalculateError(Vertical const& lhs) const {
         }
         error = CalculateG1(rhs_pli->GetNip());
     } else {
-        auto lhs_pli = context_->GetPliCache()->GetOrCreateFor(lhs, context_);
-        auto lhs_pli_pointer =
-                std::holds_alternative<model::PositionListIndex*>(lhs_pli)
-                        ? std::get<model::PositionListIndex*>(lhs_pli)
-                        : std::get<std::unique_ptr<model::PositionListIndex>>(lhs_pli).get();
+        auto lhs_pli = context_->GetPliCache()->GetOrCreateFor(lhs);
         auto joint_pli = context_->GetPliCache()->Get(lhs.Union(static_cast<Vertical>(*rhs_)));
         error = joint_pli == nullptr
-                        ? CalculateG1(lhs_pli_pointer)
-                        : CalculateG1(lhs_pli_pointer->GetNepAsLong() - joint_pli->GetNepAsLong());
+                        ? CalculateG1(lhs_pli.get())
+                        : CalculateG1(lhs_pli->GetNepAsLong() - joint_pli->GetNepAsLong());
     }
     calc_count_++;
     return error;
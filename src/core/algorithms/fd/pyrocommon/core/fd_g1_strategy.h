@@ -8,13 +8,11 @@ class FdG1Strategy : public DependencyStrategy {
 private:
     Column const* rhs_;
 
-    double CalculateG1(model::PositionListIndex* lhs_pli) const;
+    double CalculateG1(model::PositionListIndex const* lhs_pli) const;
     double CalculateG1(double num_violating_tuple_pairs) const;
     model::ConfidenceInterval CalculateG1(model::ConfidenceInterval const& num_violations) const;
 
 public:
-    static unsigned long long nanos_;
-
     FdG1Strategy(Column const* rhs, double max_error, double deviation)
         : DependencyStrategy(max_error, deviation), rhs_(rhs) {}
 
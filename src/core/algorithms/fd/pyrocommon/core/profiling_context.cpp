@@ -5,22 +5,35 @@
 #include <easylogging++.h>
 
 #include "../model/list_agree_set_sample.h"
-#include "../model/pli_cache.h"
+#include "model/table/pli_cache.h"
 #include "model/table/vertical_map.h"
+#include "util/metrics.h"
 
 using std::shared_ptr;
 
+namespace {
+
+void CountSampledPairs(model::AgreeSetSample const& sample) {
+    if (util::Metrics* metrics = util::Metrics::Current()) {
+        metrics->Counter("sampled_pairs").Add(sample.GetSampleSize());
+    }
+}
+
+}  // namespace
+
 ProfilingContext::ProfilingContext(algos::pyro::Parameters parameters,
                                    ColumnLayoutRelationData* relation_data,
                                    std::function<void(PartialKey const&)> const& ucc_consumer,
                                    std::function<void(PartialFD const&)> const& fd_consumer,
                                    CachingMethod const& caching_method,
                                    CacheEvictionMethod const& eviction_method,
-                                   double caching_method_value)
+                                   util::CancellationToken& cancellation,
+                                   util::MemoryBudget& memory_budget)
     : parameters_(std::move(parameters)),
       relation_data_(relation_data),
       random_(parameters_.seed == 0 ? std::mt19937() : std::mt19937(parameters_.seed)),
-      custom_random_(parameters_.seed == 0 ? CustomRandom() : CustomRandom(parameters_.seed)) {
+      custom_random_(parameters_.seed == 0 ? CustomRandom() : CustomRandom(parameters_.seed)),
+      cancellation_(cancellation) {
     ucc_consumer_ = ucc_consumer;
     fd_consumer_ = fd_consumer;
     // TODO: тут проявляется косяк, что unique_ptr<PLI> приходится отбирать у CLRD.
@@ -41,13 +54,11 @@ ProfilingContext::ProfilingContext(algos::pyro::Parameters parameters,
     } else {
         agree_set_samples_ = nullptr;
     }
-    double max_entropy = GetMaximumEntropy(relation_data_);
     pli_cache_ = std::make_unique<model::PLICache>(
-            relation_data_, caching_method, eviction_method, caching_method_value,
-            GetMinEntropy(relation_data_), GetMeanEntropy(relation_data_),
-            GetMedianEntropy(relation_data_), SetMaximumEntropy(relation_data_, caching_method),
-            GetMedianGini(relation_data_), GetMedianInvertedEntropy(relation_data_));
-    pli_cache_->SetMaximumEntropy(max_entropy);
+            relation_data_, caching_method, model::CreateEvictionPolicy(eviction_method),
+            size_t{parameters_.mem_limit_mb} << 20, parameters_.nary_intersection_size,
+            &memory_budget);
+    pli_cache_->SetCoin([this] { return NextDouble() < parameters_.caching_probability; });
     // TODO: partialFDScoring - for FD registration
 }
 
@@ -138,14 +149,12 @@ double ProfilingContext::SetMaximumEntropy(ColumnLayoutRelationData const* relat
 
 model::AgreeSetSample const* ProfilingContext::CreateFocusedSample(Vertical const& focus,
                                                                    double boost_factor) {
-    auto pli = pli_cache_->GetOrCreateFor(focus, this);
-    auto pli_pointer = std::holds_alternative<model::PositionListIndex*>(pli)
-                               ? std::get<model::PositionListIndex*>(pli)
-                               : std::get<std::unique_ptr<model::PositionListIndex>>(pli).get();
+    auto pli = pli_cache_->GetOrCreateFor(focus);
     std::unique_ptr<model::ListAgreeSetSample> sample = model::ListAgreeSetSample::CreateFocusedFor(
-            relation_data_, focus, pli_pointer, parameters_.sample_size * boost_factor,
+            relation_data_, focus, pli.get(), parameters_.sample_size * boost_factor,
             custom_random_);
     LOG(TRACE) << boost::format{"Creating sample focused on: %1%"} % focus.ToString();
+    CountSampledPairs(*sample);
     auto sample_ptr = sample.get();
     agree_set_samples_->Put(focus, std::move(sample));
     return sample_ptr;
@@ -158,6 +167,7 @@ model::AgreeSetSample const* ProfilingContext::CreateColumnFocusedSample(
             relation_data_, focus, restriction_pli, parameters_.sample_size * boost_factor,
             custom_random_);
     LOG(TRACE) << boost::format{"Creating sample focused on: %1%"} % focus.ToString();
+    CountSampledPairs(*sample);
     auto sample_ptr = sample.get();
     agree_set_samples_->Put(focus, std::move(sample));
     return sample_ptr;
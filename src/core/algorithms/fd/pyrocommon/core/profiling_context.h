@@ -10,7 +10,9 @@
 #include "caching_method.h"
 #include "dependency_consumer.h"
 #include "parameters.h"
+#include "util/cancellation_token.h"
 #include "util/custom_random.h"
+#include "util/memory_budget.h"
 
 namespace model {
 
@@ -31,6 +33,7 @@ private:
     ColumnLayoutRelationData* relation_data_;
     std::mt19937 random_;
     CustomRandom custom_random_;
+    util::CancellationToken& cancellation_;
 
     model::AgreeSetSample const* CreateColumnFocusedSample(
             Vertical const& focus, model::PositionListIndex const* restriction_pli,
@@ -43,7 +46,8 @@ public:
                      std::function<void(PartialKey const&)> const& ucc_consumer,
                      std::function<void(PartialFD const&)> const& fd_consumer,
                      CachingMethod const& caching_method,
-                     CacheEvictionMethod const& eviction_method, double caching_method_value);
+                     CacheEvictionMethod const& eviction_method,
+                     util::CancellationToken& cancellation, util::MemoryBudget& memory_budget);
 
     // Non-const as RandomGenerator state gets changed
     model::AgreeSetSample const* CreateFocusedSample(Vertical const& focus, double boost_factor);
@@ -65,6 +69,11 @@ public:
         return parameters_;
     }
 
+    // Search spaces stop discovering once it asks to
+    util::CancellationToken& GetCancellation() const {
+        return cancellation_;
+    }
+
     ColumnLayoutRelationData const* GetColumnLayoutRelationData() const {
         return relation_data_;
     }
@@ -9,7 +9,8 @@
 
 void SearchSpace::Discover() {
     LOG(TRACE) << "Discovering in: " << static_cast<std::string>(*strategy_);
-    while (true) {  // на второй итерации дропается
+    // на второй итерации дропается
+    while (!context_->GetCancellation().StopRequested()) {
         auto now = std::chrono::system_clock::now();
         std::optional<DependencyCandidate> launch_pad = PollLaunchPad();
         if (!launch_pad.has_value()) break;
@@ -36,6 +36,10 @@ public:
         return population_size_ == sample_size_;
     }
 
+    unsigned int GetSampleSize() const {
+        return sample_size_;
+    }
+
     virtual ~AgreeSetSample() = default;
 
 protected:
@@ -73,7 +73,7 @@ std::unique_ptr<T> AgreeSetSample::CreateFocusedFor(ColumnLayoutRelationData con
     unsigned long long restriction_nep = restriction_pli->GetNepAsLong();
     sample_size = std::min(static_cast<unsigned long long>(sample_size), restriction_nep);
     if (sample_size >= restriction_nep) {
-        for (auto& cluster : restriction_pli->GetIndex()) {
+        for (auto cluster : restriction_pli->GetIndex()) {
             for (unsigned int i = 0; i < cluster.size(); i++) {
                 int tuple_index_1 = cluster[i];
                 for (unsigned int j = i + 1; j < cluster.size(); j++) {
@@ -116,7 +116,7 @@ std::unique_ptr<T> AgreeSetSample::CreateFocusedFor(ColumnLayoutRelationData con
             /*if (cluster_index >= cluster_sizes.size()) {
                 cluster_index = cluster_sizes.size() - 1;
             }*/
-            auto& cluster = restriction_pli->GetIndex()[cluster_index];
+            auto cluster = restriction_pli->GetIndex()[cluster_index];
 
             int tuple_index_1 = random.NextInt(cluster.size());
             int tuple_index_2 = random.NextInt(cluster.size());
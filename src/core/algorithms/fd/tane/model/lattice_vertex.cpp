@@ -11,8 +11,8 @@ void LatticeVertex::AddRhsCandidates(vector<std::unique_ptr<Column>> const& cand
 }
 
 bool LatticeVertex::ComesBeforeAndSharePrefixWith(LatticeVertex const& that) const {
-    dynamic_bitset<> this_indices = vertical_.GetColumnIndices();
-    dynamic_bitset<> that_indices = that.vertical_.GetColumnIndices();
+    dynamic_bitset<> const& this_indices = vertical_.GetColumnIndices();
+    dynamic_bitset<> const& that_indices = that.vertical_.GetColumnIndices();
 
     int this_index = this_indices.find_first();
     int that_index = that_indices.find_first();
@@ -31,9 +31,9 @@ bool LatticeVertex::operator>(LatticeVertex const& that) const {
     if (vertical_.GetArity() != that.vertical_.GetArity())
         return vertical_.GetArity() > that.vertical_.GetArity();
 
-    dynamic_bitset this_indices = vertical_.GetColumnIndices();
+    dynamic_bitset<> const& this_indices = vertical_.GetColumnIndices();
     int this_index = this_indices.find_first();
-    dynamic_bitset that_indices = that.vertical_.GetColumnIndices();
+    dynamic_bitset<> const& that_indices = that.vertical_.GetColumnIndices();
     int that_index = that_indices.find_first();
 
     int result;
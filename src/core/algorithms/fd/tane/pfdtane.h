@@ -4,6 +4,7 @@
 #include "enums.h"
 #include "model/table/column_data.h"
 #include "model/table/position_list_index.h"
+#include "model/table/probing_table_cache.h"
 #include "tane_common.h"
 
 namespace algos {
@@ -21,9 +22,9 @@ private:
 public:
     PFDTane(std::optional<ColumnLayoutRelationDataManager> relation_manager = std::nullopt);
     static config::ErrorType CalculateZeroAryPFDError(ColumnData const* rhs);
-    static config::ErrorType CalculatePFDError(model::PositionListIndex const* x_pli,
-                                               model::PositionListIndex const* xa_pli,
-                                               ErrorMeasure error_measure);
+    static config::ErrorType CalculatePFDError(
+            model::PositionListIndex const* x_pli, model::PositionListIndex const* xa_pli,
+            ErrorMeasure error_measure, model::ProbingTableCache* probing_tables = nullptr);
 };
 
 }  // namespace algos
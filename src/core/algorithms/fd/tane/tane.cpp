@@ -1,6 +1,7 @@
 #include "tane.h"
 
 #include "config/error/option.h"
+#include "config/names.h"
 #include "fd/pli_based_fd_algorithm.h"
 #include "model/table/column_data.h"
 
@@ -10,7 +11,7 @@ Tane::Tane(std::optional<ColumnLayoutRelationDataManager> relation_manager)
     : tane::TaneCommon(relation_manager) {}
 
 void Tane::MakeExecuteOptsAvailableFDInternal() {
-    MakeOptionsAvailable({config::kErrorOpt.GetName()});
+    MakeOptionsAvailable({config::kErrorOpt.GetName(), config::names::kMemLimitMB});
 }
 
 config::ErrorType Tane::CalculateZeroAryFdError(ColumnData const* rhs) {
@@ -4,16 +4,22 @@
 #include <iomanip>
 #include <list>
 #include <memory>
+#include <memory_resource>
+#include <string>
 
 #include <easylogging++.h>
 
 #include "config/error/option.h"
+#include "config/names_and_descriptions.h"
+#include "config/option.h"
 #include "fd/pli_based_fd_algorithm.h"
 #include "fd/tane/model/lattice_level.h"
 #include "fd/tane/model/lattice_vertex.h"
 #include "model/table/column_data.h"
 #include "model/table/column_layout_relation_data.h"
+#include "model/table/column_set.h"
 #include "model/table/relational_schema.h"
+#include "util/memory_budget.h"
 
 namespace algos {
 using boost::dynamic_bitset;
@@ -21,8 +27,27 @@ using boost::dynamic_bitset;
 namespace tane {
 
 TaneCommon::TaneCommon(std::optional<ColumnLayoutRelationDataManager> relation_manager)
-    : PliBasedFDAlgorithm({kDefaultPhaseName}, relation_manager) {
+    : PliBasedFDAlgorithm({kDefaultPhaseName}, relation_manager),
+      probing_tables_(model::ProbingTableCache::kDefaultCapacityBytes, &GetMemoryBudget()) {
     RegisterOption(config::kErrorOpt(&max_ucc_error_));
+    using config::names::kMemLimitMB, config::descriptions::kDLatticeMemLimitMB;
+    /* Unlike the common option, the limit is off unless it is given: the lattice can't be
+     * dropped, so a run that outgrows it fails instead of slowing down */
+    auto check_mem_limit = [](config::MemLimitMBType value) {
+        constexpr config::MemLimitMBType min_limit_mb = 16u;
+        if (value != 0 && value < min_limit_mb) {
+            throw config::ConfigurationError("Memory limit must be at least " +
+                                             std::to_string(min_limit_mb) + "MB");
+        }
+    };
+    RegisterOption(config::Option{&mem_limit_mb_, kMemLimitMB, kDLatticeMemLimitMB,
+                                  config::MemLimitMBType{0}}
+                           .SetValueCheck(check_mem_limit));
+    if (relation_manager.has_value()) return;
+    /* Column PLIs are only intersected and walked with ForEachCluster here */
+    using config::names::kCompressPlis, config::descriptions::kDCompressPlis;
+    RegisterOption(config::Option{&compress_plis_, kCompressPlis, kDCompressPlis, false});
+    MakeOptionsAvailable({kCompressPlis});
 }
 
 double TaneCommon::CalculateUccError(model::PositionListIndex const* pli,
@@ -31,15 +56,16 @@ double TaneCommon::CalculateUccError(model::PositionListIndex const* pli,
 }
 
 void TaneCommon::RegisterAndCountFd(Vertical const& lhs, Column const* rhs) {
-    dynamic_bitset<> lhs_bitset = lhs.GetColumnIndices();
     PliBasedFDAlgorithm::RegisterFd(lhs, *rhs);
 }
 
 void TaneCommon::Prune(model::LatticeLevel* level) {
     RelationalSchema const* schema = relation_->GetSchema();
     std::list<model::LatticeVertex*> key_vertices;
+    /* Siblings are looked up by editing this copy of the vertex indices in place */
+    dynamic_bitset<> sibling_indices;
     for (auto& [map_key, vertex] : level->GetVertices()) {
-        Vertical columns = vertex->GetVertical();  // Originally it's a ColumnCombination
+        Vertical const& columns = vertex->GetVertical();  // Originally it's a ColumnCombination
 
         if (vertex->GetIsKeyCandidate()) {
             double ucc_error = CalculateUccError(vertex->GetPositionListIndex(), relation_.get());
@@ -47,20 +73,22 @@ void TaneCommon::Prune(model::LatticeLevel* level) {
 
                 vertex->SetKeyCandidate(false);
                 if (ucc_error == 0) {
+                    dynamic_bitset<> const& column_indices = columns.GetColumnIndices();
                     for (std::size_t rhs_index = vertex->GetRhsCandidates().find_first();
                          rhs_index != boost::dynamic_bitset<>::npos;
                          rhs_index = vertex->GetRhsCandidates().find_next(rhs_index)) {
-                        Vertical rhs = static_cast<Vertical>(*schema->GetColumn((int)rhs_index));
-                        if (!columns.Contains(rhs)) {
+                        if (!column_indices[rhs_index]) {
                             bool is_rhs_candidate = true;
-                            for (auto const& column : columns.GetColumns()) {
-                                Vertical sibling =
-                                        columns.Without(static_cast<Vertical>(*column)).Union(rhs);
-                                auto sibling_vertex =
-                                        level->GetLatticeVertex(sibling.GetColumnIndices());
+                            sibling_indices = column_indices;
+                            sibling_indices.set(rhs_index);
+                            for (std::size_t column_index = column_indices.find_first();
+                                 column_index != boost::dynamic_bitset<>::npos;
+                                 column_index = column_indices.find_next(column_index)) {
+                                sibling_indices.reset(column_index);
+                                auto sibling_vertex = level->GetLatticeVertex(sibling_indices);
+                                sibling_indices.set(column_index);
                                 if (sibling_vertex == nullptr ||
-                                    !sibling_vertex->GetConstRhsCandidates()
-                                             [rhs.GetColumnIndices().find_first()]) {
+                                    !sibling_vertex->GetConstRhsCandidates()[rhs_index]) {
                                     is_rhs_candidate = false;
                                     break;
                                 }
@@ -87,35 +115,50 @@ void TaneCommon::Prune(model::LatticeLevel* level) {
     }
 }
 
-void TaneCommon::ComputeDependencies(model::LatticeLevel* level) {
+void TaneCommon::ComputeDependencies(model::LatticeLevel* level,
+                                     std::pmr::memory_resource* pli_memory) {
+    model::DispatchColumnSet(relation_->GetNumColumns(), [&](auto column_set_type) {
+        using ColumnSetType = typename decltype(column_set_type)::type;
+        ComputeDependencies<ColumnSetType>(level, pli_memory);
+    });
+}
+
+template <typename ColumnSetType>
+void TaneCommon::ComputeDependencies(model::LatticeLevel* level,
+                                     std::pmr::memory_resource* pli_memory) {
     RelationalSchema const* schema = relation_->GetSchema();
+    util::MetricCounter& validations = GetMetrics().Validations();
     for (auto& [key_map, xa_vertex] : level->GetVertices()) {
+        if (StopRequested()) {
+            return;
+        }
         if (xa_vertex->GetIsInvalid()) {
             continue;
         }
-        Vertical xa = xa_vertex->GetVertical();
         // Calculate XA PLI
         if (xa_vertex->GetPositionListIndex() == nullptr) {
             auto parent_pli_1 = xa_vertex->GetParents()[0]->GetPositionListIndex();
             auto parent_pli_2 = xa_vertex->GetParents()[1]->GetPositionListIndex();
-            xa_vertex->AcquirePositionListIndex(parent_pli_1->Intersect(parent_pli_2));
+            xa_vertex->AcquirePositionListIndex(
+                    parent_pli_1->Intersect(parent_pli_2, probing_tables_, pli_memory));
         }
 
-        dynamic_bitset<> xa_indices = xa.GetColumnIndices();
-        dynamic_bitset<> a_candidates = xa_vertex->GetRhsCandidates();
+        ColumnSetType const xa_indices(xa_vertex->GetVertical().GetColumnIndices());
+        /* A copy: the candidates of the vertex shrink as its FDs are found */
+        ColumnSetType const a_candidates(xa_vertex->GetConstRhsCandidates());
         auto xa_pli = xa_vertex->GetPositionListIndex();
         for (auto const& x_vertex : xa_vertex->GetParents()) {
             Vertical const& lhs = x_vertex->GetVertical();
 
             // Find index of A in XA.
-            dynamic_bitset<> differing_bits = xa_indices ^ lhs.GetColumnIndices();
-            std::size_t a_index = differing_bits.find_first();
-            if (!a_candidates[a_index]) {
+            std::size_t a_index = (xa_indices ^ ColumnSetType(lhs.GetColumnIndices())).find_first();
+            if (!a_candidates.test(a_index)) {
                 continue;
             }
             auto x_pli = x_vertex->GetPositionListIndex();
 
             // Check X -> A
+            validations.Add();
             config::ErrorType error = CalculateFdError(x_pli, xa_pli);
             if (error <= max_fd_error_) {
                 Column const* rhs = schema->GetColumns()[a_index].get();
@@ -133,6 +176,14 @@ void TaneCommon::ComputeDependencies(model::LatticeLevel* level) {
 unsigned long long TaneCommon::ExecuteInternal() {
     long apriori_millis = 0;
     max_fd_error_ = max_ucc_error_;
+    if (mem_limit_mb_ != 0) {
+        size_t const limit_bytes = size_t{mem_limit_mb_} << 20;
+        LimitMemory(limit_bytes);
+        /* The lattice can't give way to the tables, so they get at most a half of the limit */
+        probing_tables_.SetCapacityBytes(limit_bytes / 2);
+    } else {
+        probing_tables_.SetCapacityBytes(model::ProbingTableCache::kDefaultCapacityBytes);
+    }
     RelationalSchema const* schema = relation_->GetSchema();
 
     LOG(DEBUG) << schema->GetName() << " has " << relation_->GetNumColumns() << " columns, "
@@ -150,6 +201,12 @@ unsigned long long TaneCommon::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
     double progress_step = 100.0 / (schema->GetNumColumns() + 1);
 
+    /* Lattice PLIs live for a level or two, their clusters are recycled through this pool.
+     * It must outlive the levels. The levels can't be dropped, so with mem_limit given the
+     * execution fails with util::MemoryLimitError if they don't fit, after the probing tables
+     * have given way */
+    util::BudgetedResource budgeted_memory(GetMemoryBudget());
+    std::pmr::unsynchronized_pool_resource pli_memory(&budgeted_memory);
     // Initialize level 0
     std::vector<std::unique_ptr<model::LatticeLevel>> levels;
     auto level0 = std::make_unique<model::LatticeLevel>(0);
@@ -220,8 +277,12 @@ unsigned long long TaneCommon::ExecuteInternal() {
     unsigned int max_arity =
             max_lhs_ == std::numeric_limits<unsigned int>::max() ? max_lhs_ : max_lhs_ + 1;
     for (unsigned int arity = 2; arity <= max_arity; arity++) {
+        /* The PLIs of the cleared level erase their tables from probing_tables_ */
         model::LatticeLevel::ClearLevelsBelow(levels, arity - 1);
-        model::LatticeLevel::GenerateNextLevel(levels);
+        {
+            util::ScopedTimer timer(&GetMetrics().Timer("level_generation"));
+            model::LatticeLevel::GenerateNextLevel(levels);
+        }
 
         model::LatticeLevel* level = levels[arity].get();
         LOG(TRACE) << "Checking " << level->GetVertices().size() << " " << arity
@@ -230,13 +291,25 @@ unsigned long long TaneCommon::ExecuteInternal() {
             break;
         }
 
-        ComputeDependencies(level);
+        model::ProbingTableCache::PinGuard parent_tables(probing_tables_);
+        for (auto const& [map_key, parent] : levels[arity - 1]->GetVertices()) {
+            if (parent->GetPositionListIndex() != nullptr) {
+                parent_tables.Add(*parent->GetPositionListIndex());
+            }
+        }
+        {
+            util::ScopedTimer timer(&GetMetrics().Timer("dependency_computation"));
+            ComputeDependencies(level, &pli_memory);
+        }
 
-        if (arity == max_arity) {
+        if (arity == max_arity || StopRequested()) {
             break;
         }
 
-        Prune(level);
+        {
+            util::ScopedTimer timer(&GetMetrics().Timer("pruning"));
+            Prune(level);
+        }
         // TODO: printProfilingData
         AddProgress(progress_step);
     }
@@ -248,9 +321,11 @@ unsigned long long TaneCommon::ExecuteInternal() {
     apriori_millis += elapsed_milliseconds.count();
 
     LOG(DEBUG) << "Time: " << apriori_millis << " milliseconds";
-    LOG(DEBUG) << "Intersection time: " << model::PositionListIndex::micros_ / 1000 << "ms";
-    LOG(DEBUG) << "Total intersections: " << model::PositionListIndex::intersection_count_
-               << std::endl;
+    util::MetricTimer::Value const intersections = GetMetrics().PliIntersectionTime().Get();
+    LOG(DEBUG) << "Intersection time: "
+               << std::chrono::duration_cast<std::chrono::milliseconds>(intersections.total).count()
+               << "ms";
+    LOG(DEBUG) << "Total intersections: " << intersections.count << std::endl;
     LOG(DEBUG) << "Total FD count: " << fd_collection_.Size();
     LOG(DEBUG) << "HASH: " << Fletcher16();
     return apriori_millis;
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <memory_resource>
+
 #include "algorithms/fd/pli_based_fd_algorithm.h"
 #include "algorithms/fd/tane/model/lattice_level.h"
 #include "config/error/type.h"
+#include "config/mem_limit/type.h"
 #include "model/table/column_data.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/position_list_index.h"
+#include "model/table/probing_table_cache.h"
 
 namespace algos::tane {
 
@@ -13,12 +17,20 @@ class TaneCommon : public PliBasedFDAlgorithm {
 protected:
     config::ErrorType max_fd_error_;
     config::ErrorType max_ucc_error_;
+    config::MemLimitMBType mem_limit_mb_;
+    /* Tables of lattice PLIs, each of them is probed once per child */
+    model::ProbingTableCache probing_tables_;
 
 private:
-    void ResetStateFd() final {}
+    void ResetStateFd() final {
+        probing_tables_.Clear();
+    }
 
     void Prune(model::LatticeLevel* level);
-    void ComputeDependencies(model::LatticeLevel* level);
+    void ComputeDependencies(model::LatticeLevel* level, std::pmr::memory_resource* pli_memory);
+    /* Parent indices are xor-ed with the vertex ones without allocating on narrow schemas */
+    template <typename ColumnSetType>
+    void ComputeDependencies(model::LatticeLevel* level, std::pmr::memory_resource* pli_memory);
     unsigned long long ExecuteInternal() final;
     virtual config::ErrorType CalculateZeroAryFdError(ColumnData const* rhs) = 0;
     virtual config::ErrorType CalculateFdError(model::PositionListIndex const* lhs_pli,
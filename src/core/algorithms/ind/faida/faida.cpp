@@ -118,7 +118,7 @@ unsigned long long Faida::ExecuteInternal() {
     LOG(DEBUG) << "Found " << last_result.size() << " INDs on level " << level_num;
     RegisterInds(last_result);
 
-    while (!last_result.empty() && ++level_num != max_arity_) {
+    while (!last_result.empty() && ++level_num != max_arity_ && !StopRequested()) {
         candidates = faida::apriori_candidate_generator::CreateCombinedCandidates(last_result);
         if (candidates.empty()) {
             LOG(DEBUG) << "\nNo candidates on level " << level_num;
@@ -61,6 +61,10 @@ public:
     [[nodiscard]] std::string GetColumnName(size_t index) const override {
         return this->stream_->GetColumnName(column_indices_[index]);
     }
+
+    size_t GetNextBatch(size_t max_rows, DatasetBatch& batch) override {
+        return IDatasetStream::GetNextBatch(max_rows, batch);
+    }
 };
 
 }  // namespace model
@@ -34,6 +34,7 @@ void Mind::MakeLoadOptsAvailable() {
      * In the future we should give the user the ability to choose the algorithm.
      */
     auind_algo_ = CreateAlgorithmInstance<INDAlgorithm>(AlgorithmType::spider);
+    PropagateCancellationTo(*auind_algo_);
 }
 
 void Mind::MakeExecuteOptsAvailable() {
@@ -202,6 +203,8 @@ bool Mind::TestCandidate(RawIND const& raw_ind) {
  */
 void Mind::MineUnaryINDs() {
     auind_algo_->Execute();
+    /* A stopped unary algorithm finds nothing, the stop has to be noticed here too */
+    if (StopRequested()) return;
     for (const IND& ind : auind_algo_->INDList()) {
         RegisterIND(ind);
     }
@@ -232,7 +235,8 @@ void Mind::MineNaryINDs() {
      * Stop INDs mining if no new dependencies were found at the previous lattice level
      * (from this condition it follows that no more dependencies can be found).
      */
-    while (prev_it != INDList().end() && INDList().back().GetArity() != max_arity_) {
+    while (prev_it != INDList().end() && INDList().back().GetArity() != max_arity_ &&
+           !StopRequested()) {
         for (auto p_it = prev_it; p_it != INDList().end(); ++p_it) {
             std::for_each(std::next(p_it), INDList().end(), [&](const IND& q) {
                 std::optional<RawIND> candidate_opt =
@@ -246,6 +250,7 @@ void Mind::MineNaryINDs() {
         prev_it = std::prev(INDList().end()); /*< last element of the previous lattice level */
         prev_raw_inds.clear();
         for (RawIND const& candidate : candidates) {
+            if (StopRequested()) return;
             if (TestCandidate(candidate)) {
                 RegisterIND(candidate.lhs, candidate.rhs);
                 prev_raw_inds.insert(candidate);
@@ -17,6 +17,7 @@
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/thread_number/option.h"
+#include "util/cancellation_token.h"
 #include "util/timed_invoke.h"
 
 namespace algos {
@@ -61,15 +62,19 @@ std::vector<Attribute> InitAttributes(std::vector<model::ColumnDomain> const& do
     return attrs;
 }
 
+/* Returns no attributes if stopped: refs that have not been intersected with every value yet are
+ * not sound */
 template <typename Attribute>
 std::vector<Attribute> GetProcessedAttributes(std::vector<model::ColumnDomain> const& domains,
-                                              config::EqNullsType is_null_equal_null) {
+                                              config::EqNullsType is_null_equal_null,
+                                              util::CancellationToken& cancellation) {
     using AttributeRW = std::reference_wrapper<Attribute>;
     std::vector attrs = InitAttributes<Attribute>(domains);
     std::priority_queue<AttributeRW, std::vector<AttributeRW>, std::greater<Attribute>> attr_pq(
             attrs.begin(), attrs.end());
     boost::dynamic_bitset<> ids_bitset(attrs.size());
     while (!attr_pq.empty()) {
+        if (cancellation.StopRequested()) return {};
         AttributeRW attr_rw = attr_pq.top();
         std::string const& value = attr_rw.get().GetCurrentValue();
         do {
@@ -103,7 +108,8 @@ std::vector<Attribute> GetProcessedAttributes(std::vector<model::ColumnDomain> c
 
 void Spider::MineINDs() {
     using spider::INDAttribute;
-    std::vector const attrs = GetProcessedAttributes<INDAttribute>(domains_, is_null_equal_null_);
+    std::vector const attrs = GetProcessedAttributes<INDAttribute>(domains_, is_null_equal_null_,
+                                                                   GetCancellationToken());
     for (auto const& dep : attrs) {
         for (AttributeIndex ref_id : dep.GetRefIds()) {
             RegisterIND(dep.ToCC(), attrs[ref_id].ToCC());
@@ -113,7 +119,8 @@ void Spider::MineINDs() {
 
 void Spider::MineAINDs() {
     using spider::AINDAttribute;
-    std::vector const attrs = GetProcessedAttributes<AINDAttribute>(domains_, is_null_equal_null_);
+    std::vector const attrs = GetProcessedAttributes<AINDAttribute>(domains_, is_null_equal_null_,
+                                                                   GetCancellationToken());
     for (auto const& dep : attrs) {
         for (AttributeIndex ref_id : dep.GetRefIds(max_ind_error_)) {
             RegisterIND(dep.ToCC(), attrs[ref_id].ToCC());
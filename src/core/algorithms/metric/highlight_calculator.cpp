@@ -79,9 +79,9 @@ void HighlightCalculator::BruteCalculateHighlights(
 }
 
 void HighlightCalculator::CalculateHighlightsForStrings(
-        std::vector<IndexedPoint<std::byte const*>> const& indexed_points,
+        std::vector<IndexedStringPoint> const& indexed_points,
         std::vector<Highlight>&& cluster_highlights,
-        DistanceFunction<std::byte const*> const& dist_func) {
+        DistanceFunction<std::string_view> const& dist_func) {
     BruteCalculateHighlights(indexed_points, std::move(cluster_highlights), dist_func);
 }
 
@@ -31,9 +31,9 @@ public:
             std::vector<Highlight>&& cluster_highlights);
 
     void CalculateHighlightsForStrings(
-            std::vector<IndexedPoint<std::byte const*>> const& indexed_points,
+            std::vector<IndexedStringPoint> const& indexed_points,
             std::vector<Highlight>&& cluster_highlights,
-            DistanceFunction<std::byte const*> const& dist_func);
+            DistanceFunction<std::string_view> const& dist_func);
 
     void CalculateMultidimensionalHighlights(
             std::vector<IndexedPoint<std::vector<long double>>> const& indexed_points,
@@ -16,6 +16,8 @@
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
+#include "model/table/relation_loader.h"
+#include "util/levenshtein_distance.h"
 
 namespace algos::metric {
 
@@ -127,13 +129,12 @@ void MetricVerifier::MakeExecuteOptsAvailable() {
 }
 
 void MetricVerifier::LoadDataInternal() {
-    relation_ = ColumnLayoutRelationData::CreateFrom(*input_table_, is_null_equal_null_);
-    input_table_->Reset();
-    if (relation_->GetColumnData().empty()) {
+    model::LoadedRelations relations = model::LoadRelations(*input_table_, is_null_equal_null_);
+    if (relations.relation->GetColumnData().empty()) {
         throw std::runtime_error("Got an empty dataset: metric FD verifying is meaningless.");
     }
-    typed_relation_ =
-            model::ColumnLayoutTypedRelationData::CreateFrom(*input_table_, is_null_equal_null_);
+    relation_ = std::move(relations.relation);
+    typed_relation_ = std::move(relations.typed_relation);
 }
 
 void MetricVerifier::ResetState() {
@@ -175,12 +176,12 @@ std::string MetricVerifier::GetStringValue(config::IndicesType const& index_vec,
         return "EMPTY";
     }
     if (index_vec.size() == 1) {
-        return col.GetType().ValueToString(col.GetData()[row_index]);
+        return col.GetDataAsString(row_index);
     }
     std::string value("(");
     for (size_t j = 0; j < index_vec.size(); ++j) {
         model::TypedColumnData const& coord_col = typed_relation_->GetColumnData(index_vec[j]);
-        value += coord_col.GetType().ValueToString(coord_col.GetData()[row_index]);
+        value += coord_col.GetDataAsString(row_index);
         if (j == index_vec.size() - 1) {
             break;
         }
@@ -258,14 +259,13 @@ ClusterFunction MetricVerifier::GetClusterFunctionForOneDimension() {
     }
 
     assert(col.GetTypeId() == +model::TypeId::kString);
-    auto const& type = static_cast<model::StringType const&>(col.GetType());
 
-    std::function<ClusterFunction(DistanceFunction<std::byte const*>)> verify_func;
+    std::function<ClusterFunction(DistanceFunction<std::string_view>)> verify_func;
     if (algo_ == +MetricAlgo::brute) {
         verify_func = [this](auto dist_func) {
-            return CalculateClusterFunction<IndexedOneDimensionalPoint>(
+            return CalculateClusterFunction<IndexedStringPoint>(
                     [this](auto const& cluster) {
-                        return points_calculator_->CalculateIndexedPoints(cluster);
+                        return points_calculator_->CalculateIndexedStringPoints(cluster);
                     },
                     [this, dist_func](auto const& points) {
                         return this->BruteVerifyCluster(points, dist_func);
@@ -278,28 +278,29 @@ ClusterFunction MetricVerifier::GetClusterFunctionForOneDimension() {
         };
     } else {
         verify_func = [this](auto const& dist_func) {
-            return CalculateApproxClusterFunction<std::byte const*>(
+            return CalculateApproxClusterFunction<std::string_view>(
                     [this](auto const& cluster) {
-                        return points_calculator_->CalculatePoints(cluster);
+                        return points_calculator_->CalculateStringPoints(cluster);
                     },
                     dist_func);
         };
     }
 
     if (metric_ == +Metric::levenshtein) {
-        return verify_func(
-                [&type](std::byte const* l, std::byte const* r) { return type.Dist(l, r); });
+        return verify_func([](std::string_view l, std::string_view r) {
+            return static_cast<long double>(util::LevenshteinDistance(l, r));
+        });
     }
 
-    return [this, &type, verify_func](model::PLI::Cluster const& cluster) {
+    return [this, verify_func](model::PLI::ClusterView cluster) {
         std::unordered_map<std::string, util::QGramVector> q_gram_map;
-        return verify_func(GetCosineDistFunction(type, q_gram_map))(cluster);
+        return verify_func(GetCosineDistFunction(q_gram_map))(cluster);
     };
 }
 
 ClusterFunction MetricVerifier::GetClusterFunctionForSeveralDimensions() {
     if (algo_ == +MetricAlgo::calipers) {
-        return [this](model::PLI::Cluster const& cluster) {
+        return [this](model::PLI::ClusterView cluster) {
             auto result = points_calculator_->CalculateMultidimensionalPointsForCalipers(cluster);
             if (!CheckMFDFailIfHasNulls(result.has_nulls) &&
                 CalipersCompareNumericValues(result.points)) {
@@ -341,12 +342,11 @@ ClusterFunction MetricVerifier::GetClusterFunction() {
     return GetClusterFunctionForSeveralDimensions();
 }
 
-DistanceFunction<std::byte const*> MetricVerifier::GetCosineDistFunction(
-        model::StringType const& type,
+DistanceFunction<std::string_view> MetricVerifier::GetCosineDistFunction(
         std::unordered_map<std::string, util::QGramVector>& q_gram_map) const {
-    return [this, &type, &q_gram_map](std::byte const* a, std::byte const* b) -> long double {
-        std::string str1 = type.ValueToString(a);
-        std::string str2 = type.ValueToString(b);
+    return [this, &q_gram_map](std::string_view a, std::string_view b) -> long double {
+        std::string str1(a);
+        std::string str2(b);
         if (str1.length() < q_ || str2.length() < q_) {
             throw std::runtime_error(
                     "q-gram length should not exceed the minimum string length "
@@ -362,7 +362,7 @@ template <typename T>
 ClusterFunction MetricVerifier::CalculateClusterFunction(
         IndexedPointsFunction<T> points_func, CompareFunction<T> compare_func,
         HighlightFunction<T> highlight_func) const {
-    return [this, points_func, compare_func, highlight_func](model::PLI::Cluster const& cluster) {
+    return [this, points_func, compare_func, highlight_func](model::PLI::ClusterView cluster) {
         auto result = points_func(cluster);
         if (!CheckMFDFailIfHasNulls(result.has_nulls) && compare_func(result.points)) {
             return true;
@@ -375,7 +375,7 @@ ClusterFunction MetricVerifier::CalculateClusterFunction(
 template <typename T>
 ClusterFunction MetricVerifier::CalculateApproxClusterFunction(
         PointsFunction<T> points_func, DistanceFunction<T> dist_func) const {
-    return [points_func, dist_func, this](model::PLI::Cluster const& cluster) {
+    return [points_func, dist_func, this](model::PLI::ClusterView cluster) {
         auto result = points_func(cluster);
         return !CheckMFDFailIfHasNulls(result.has_nulls) &&
                ApproxVerifyCluster(result.points, dist_func);
@@ -6,6 +6,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -41,12 +42,11 @@ private:
     bool metric_fd_holds_ = false;
 
     std::shared_ptr<model::ColumnLayoutTypedRelationData> typed_relation_;
-    std::shared_ptr<ColumnLayoutRelationData> relation_;  // temporarily parsing twice
+    std::shared_ptr<ColumnLayoutRelationData> relation_;
     std::unique_ptr<PointsCalculator> points_calculator_;
     std::unique_ptr<HighlightCalculator> highlight_calculator_;
 
-    DistanceFunction<std::byte const*> GetCosineDistFunction(
-            model::StringType const& type,
+    DistanceFunction<std::string_view> GetCosineDistFunction(
             std::unordered_map<std::string, util::QGramVector>& q_gram_map) const;
 
     bool CheckMFDFailIfHasNulls(bool has_nulls) const {
@@ -48,8 +48,8 @@ long double PointsCalculator::GetCoordinate(bool& has_values, ClusterIndex row_i
 
     has_values = true;
     return col.GetType().GetTypeId() == +model::TypeId::kInt
-                   ? (long double)model::Type::GetValue<model::Int>(col.GetData()[row_index])
-                   : model::Type::GetValue<model::Double>(col.GetData()[row_index]);
+                   ? (long double)col.GetValues<model::Int>()[row_index]
+                   : col.GetValues<model::Double>()[row_index];
 }
 
 template <typename T>
@@ -69,7 +69,7 @@ T PointsCalculator::GetPoint(ClusterIndex row_index, bool& has_values, bool& has
 }
 
 IndexedPointsCalculationResult<IndexedVector>
-PointsCalculator::CalculateMultidimensionalIndexedPoints(model::PLI::Cluster const& cluster) const {
+PointsCalculator::CalculateMultidimensionalIndexedPoints(model::PLI::ClusterView cluster) const {
     std::vector<IndexedVector> points;
     std::vector<Highlight> cluster_highlights;
     bool has_nulls_in_cluster = false;
@@ -93,10 +93,9 @@ PointsCalculator::CalculateMultidimensionalIndexedPoints(model::PLI::Cluster con
 }
 
 IndexedPointsCalculationResult<IndexedOneDimensionalPoint> PointsCalculator::CalculateIndexedPoints(
-        model::PLI::Cluster const& cluster) const {
+        model::PLI::ClusterView cluster) const {
     model::TypedColumnData const& col = typed_relation_->GetColumnData(rhs_indices_[0]);
-    std::vector<std::byte const*> const& data = col.GetData();
-    std::vector<IndexedPoint<std::byte const*>> points;
+    std::vector<IndexedOneDimensionalPoint> points;
     std::vector<Highlight> cluster_highlights;
     bool has_nulls_in_cluster = false;
     for (auto i : cluster) {
@@ -109,14 +108,35 @@ IndexedPointsCalculationResult<IndexedOneDimensionalPoint> PointsCalculator::Cal
             cluster_highlights.emplace_back(i, i, 0.0);
             continue;
         }
-        points.emplace_back(data[i], i);
+        points.emplace_back(col.GetValue(i), i);
+    }
+    return {std::move(points), std::move(cluster_highlights), has_nulls_in_cluster};
+}
+
+IndexedPointsCalculationResult<IndexedStringPoint> PointsCalculator::CalculateIndexedStringPoints(
+        model::PLI::ClusterView cluster) const {
+    model::TypedColumnData const& col = typed_relation_->GetColumnData(rhs_indices_[0]);
+    std::vector<IndexedStringPoint> points;
+    std::vector<Highlight> cluster_highlights;
+    bool has_nulls_in_cluster = false;
+    for (auto i : cluster) {
+        if (col.IsNull(i)) {
+            has_nulls_in_cluster = true;
+            cluster_highlights.emplace_back(i, i, GetDistFromNull());
+            continue;
+        }
+        if (col.IsEmpty(i)) {
+            cluster_highlights.emplace_back(i, i, 0.0);
+            continue;
+        }
+        points.emplace_back(col.GetStringValue(i), i);
     }
     return {std::move(points), std::move(cluster_highlights), has_nulls_in_cluster};
 }
 
 template <typename T>
 PointsCalculationResult<T> PointsCalculator::CalculateMultidimensionalPoints(
-        model::PLI::Cluster const& cluster, AssignmentFunction<T> const& assignment_func) const {
+        model::PLI::ClusterView cluster, AssignmentFunction<T> const& assignment_func) const {
     std::vector<T> points;
     bool has_nulls_in_cluster = false;
     for (auto i : cluster) {
@@ -136,21 +156,20 @@ PointsCalculationResult<T> PointsCalculator::CalculateMultidimensionalPoints(
 }
 
 PointsCalculationResult<util::Point> PointsCalculator::CalculateMultidimensionalPointsForCalipers(
-        model::PLI::Cluster const& cluster) const {
+        model::PLI::ClusterView cluster) const {
     return CalculateMultidimensionalPoints<util::Point>(cluster, AssignToPoint);
 }
 
 PointsCalculationResult<std::vector<long double>>
 PointsCalculator::CalculateMultidimensionalPointsForApprox(
-        model::PLI::Cluster const& cluster) const {
+        model::PLI::ClusterView cluster) const {
     return CalculateMultidimensionalPoints<std::vector<long double>>(cluster, AssignToVector);
 }
 
-PointsCalculationResult<std::byte const*> PointsCalculator::CalculatePoints(
-        model::PLI::Cluster const& cluster) const {
+PointsCalculationResult<std::string_view> PointsCalculator::CalculateStringPoints(
+        model::PLI::ClusterView cluster) const {
     model::TypedColumnData const& col = typed_relation_->GetColumnData(rhs_indices_[0]);
-    std::vector<std::byte const*> const& data = col.GetData();
-    std::vector<std::byte const*> points;
+    std::vector<std::string_view> points;
     bool has_nulls_in_cluster = false;
     for (auto i : cluster) {
         if (col.IsNull(i)) {
@@ -163,7 +182,7 @@ PointsCalculationResult<std::byte const*> PointsCalculator::CalculatePoints(
         if (col.IsEmpty(i)) {
             continue;
         }
-        points.emplace_back(data[i]);
+        points.emplace_back(col.GetStringValue(i));
     }
     return {std::move(points), has_nulls_in_cluster};
 }
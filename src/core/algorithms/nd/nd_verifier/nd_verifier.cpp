@@ -88,7 +88,7 @@ void NDVerifier::ResetState() {
 void NDVerifier::AddVCToValues(
         std::shared_ptr<std::vector<util::ValueCombination>> values,
         std::shared_ptr<std::vector<size_t>> row,
-        std::vector<std::pair<model::TypeId, std::byte const*>> const& typed_data,
+        std::vector<util::ValueCombination::TypedValue> const& typed_data,
         bool is_null) const {
     util::ValueCombination vc{typed_data};
 
@@ -117,20 +117,17 @@ NDVerifier::CombinedValuesType NDVerifier::CombineValues(
     auto row = std::make_shared<std::vector<size_t>>();
 
     for (size_t row_idx{0}; row_idx < typed_relation_->GetNumRows(); ++row_idx) {
-        std::vector<std::pair<model::TypeId, std::byte const*>> typed_data;
+        std::vector<util::ValueCombination::TypedValue> typed_data;
         bool was_null = false;
         for (auto col_idx_pt{col_idxs.begin()}; col_idx_pt != col_idxs.end(); ++col_idx_pt) {
             model::TypedColumnData const& col_data = typed_relation_->GetColumnData(*col_idx_pt);
-            std::vector<std::byte const*> const& byte_data = col_data.GetData();
-            auto type_id = col_data.GetTypeId();
 
-            std::byte const* bytes_ptr = byte_data[row_idx];
-            if (bytes_ptr == nullptr) {
+            if (!col_data.IsMixed() && col_data.IsNullOrEmpty(row_idx)) {
                 LOG(INFO) << "WARNING: Cell (" << *col_idx_pt << ", " << row_idx << ") is empty";
                 was_null = true;
             }
 
-            typed_data.emplace_back(std::move(type_id), bytes_ptr);
+            typed_data.emplace_back(&col_data, row_idx);
         }
 
         AddVCToValues(values, row, typed_data, was_null);
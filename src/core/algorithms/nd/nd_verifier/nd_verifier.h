@@ -46,7 +46,7 @@ private:
 
     void AddVCToValues(std::shared_ptr<std::vector<util::ValueCombination>> values,
                        std::shared_ptr<std::vector<size_t>> row,
-                       std::vector<std::pair<model::TypeId, std::byte const*>> const& typed_data,
+                       std::vector<util::ValueCombination::TypedValue> const& typed_data,
                        bool is_null) const;
 
 protected:
@@ -5,7 +5,7 @@
 #include <string>
 
 #include "model/types/create_type.h"
-#include "model/types/mixed_type.h"
+#include "model/types/builtin.h"
 
 namespace algos::nd_verifier::util {
 
@@ -13,21 +13,28 @@ using namespace model;
 
 bool ValueCombination::CompareValues(ValueCombination::TypedValue a,
                                      ValueCombination::TypedValue b) {
-    if (a.first != b.first) {
+    auto const& [a_column, a_row] = a;
+    auto const& [b_column, b_row] = b;
+    TypeId const type_id = a_column->GetTypeId();
+    if (type_id != b_column->GetTypeId()) {
         return false;
     }
-    if (a.second == nullptr && b.second == nullptr) {
+    if (!HasValue(a) && !HasValue(b)) {
         return true;
-    } else if (a.second == nullptr || b.second == nullptr) {
+    } else if (!HasValue(a) || !HasValue(b)) {
         return false;
     }
-    auto type = CreateType(a.first, false);
-    if (a.first == +(TypeId::kMixed)) {
-        if (MixedType::RetrieveTypeId(a.second) != MixedType::RetrieveTypeId(b.second)) {
+    if (a_column->IsHeapType()) {
+        return a_column->GetStringValue(a_row) == b_column->GetStringValue(b_row);
+    }
+    auto type = CreateType(type_id, false);
+    if (type_id == +(TypeId::kMixed)) {
+        if (a_column->GetValueTypeId(a_row) != b_column->GetValueTypeId(b_row)) {
             return false;
         }
     }
-    return type->Compare(a.second, b.second) == CompareResult::kEqual;
+    return type->Compare(a_column->GetValue(a_row), b_column->GetValue(b_row)) ==
+           CompareResult::kEqual;
 }
 
 std::string ValueCombination::ToString() const {
@@ -37,9 +44,8 @@ std::string ValueCombination::ToString() const {
         if (pt != typed_data_.begin()) {
             sstream << ", ";
         }
-        if (pt->second != nullptr) {
-            auto type = CreateType(pt->first, false);
-            sstream << type->ValueToString(pt->second);
+        if (HasValue(*pt)) {
+            sstream << pt->first->GetDataAsString(pt->second);
         }
     }
     sstream << ')';
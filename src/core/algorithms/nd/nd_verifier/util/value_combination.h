@@ -7,18 +7,26 @@
 #include <string>
 #include <vector>
 
-#include "model/types/builtin.h"
+#include "model/table/typed_column_data.h"
 
 namespace algos::nd_verifier::util {
 
 class ValueCombination {
-private:
-    using TypedValue = std::pair<model::TypeId, std::byte const*>;
+public:
+    /* A cell given by its column and row, String columns have no value objects to point to */
+    using TypedValue = std::pair<model::TypedColumnData const*, size_t>;
 
+private:
     std::vector<TypedValue> typed_data_;
 
     bool CompareValues(TypedValue a, TypedValue b);
 
+    /* Nulls and empties of non-mixed columns hold no value */
+    static bool HasValue(TypedValue value) {
+        auto const& [column, row] = value;
+        return column->IsMixed() || !column->IsNullOrEmpty(row);
+    }
+
 public:
     ValueCombination(std::vector<TypedValue> typed_data) : typed_data_(typed_data) {}
 
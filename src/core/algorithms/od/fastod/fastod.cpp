@@ -15,10 +15,6 @@ Fastod::Fastod() : Algorithm({}) {
     PrepareOptions();
 }
 
-bool Fastod::IsTimeUp() const {
-    return time_limit_seconds_ > 0 && timer_.GetElapsedSeconds() >= time_limit_seconds_;
-}
-
 void Fastod::CCPut(AttributeSet const& key, AttributeSet attribute_set) {
     cc_[key] = std::move(attribute_set);
 }
@@ -50,7 +46,6 @@ void Fastod::LoadDataInternal() {
 }
 
 void Fastod::ResetState() {
-    is_complete_ = false;
     level_ = 1;
 
     result_asc_.clear();
@@ -66,6 +61,9 @@ void Fastod::ResetState() {
 }
 
 unsigned long long Fastod::ExecuteInternal() {
+    if (time_limit_seconds_ > 0) {
+        LimitExecutionTime(std::chrono::seconds(time_limit_seconds_));
+    }
     size_t const elapsed_milliseconds = util::TimedInvoke(&Fastod::Discover, this);
 
     for (auto const& od : result_asc_) {
@@ -94,10 +92,6 @@ void Fastod::PrintStatistics() const {
                << "OCD=" << ocd_count;
 }
 
-bool Fastod::IsComplete() const {
-    return is_complete_;
-}
-
 std::vector<fastod::AscCanonicalOD> const& Fastod::GetAscendingDependencies() const {
     return result_asc_;
 }
@@ -113,13 +107,15 @@ std::vector<fastod::SimpleCanonicalOD> const& Fastod::GetSimpleDependencies() co
 void Fastod::Initialize() {
     timer_.Start();
 
-    schema_ = AttributeSet(data_->GetColumnCount(), (1 << data_->GetColumnCount()) - 1);
+    schema_ = AttributeSet(data_->GetColumnCount());
+    for (model::ColumnIndex i = 0; i < data_->GetColumnCount(); ++i) schema_.Set(i);
 
     AttributeSet empty_set(data_->GetColumnCount());
     CCPut(std::move(empty_set), schema_);
 
     for (model::ColumnIndex i = 0; i < data_->GetColumnCount(); ++i)
-        context_in_current_level_.emplace(data_->GetColumnCount(), 1 << i);
+        context_in_current_level_.emplace(
+                fastod::CreateAttributeSet({i}, data_->GetColumnCount()));
 }
 
 void Fastod::ComputeODs() {
@@ -135,8 +131,7 @@ void Fastod::ComputeODs() {
             del_attrs.push_back(fastod::DeleteAttribute(context, column));
         }
 
-        if (IsTimeUp()) {
-            is_complete_ = false;
+        if (StopRequested()) {
             return;
         }
 
@@ -157,8 +152,7 @@ void Fastod::ComputeODs() {
     for (AttributeSet const& context : context_in_current_level_) {
         auto const& del_attrs = deleted_attrs[delete_index++];
 
-        if (IsTimeUp()) {
-            is_complete_ = false;
+        if (StopRequested()) {
             return;
         }
 
@@ -213,8 +207,7 @@ void Fastod::CalculateNextLevel() {
     }
 
     for (auto const& [prefix, single_attributes] : prefix_blocks) {
-        if (IsTimeUp()) {
-            is_complete_ = false;
+        if (StopRequested()) {
             return;
         }
 
@@ -253,14 +246,14 @@ void Fastod::Discover() {
     while (!context_in_current_level_.empty()) {
         ComputeODs();
 
-        if (IsTimeUp()) {
+        if (StopRequested()) {
             break;
         }
 
         PruneLevels();
         CalculateNextLevel();
 
-        if (IsTimeUp()) {
+        if (StopRequested()) {
             break;
         }
 
@@ -269,10 +262,10 @@ void Fastod::Discover() {
 
     timer_.Stop();
 
-    if (IsComplete()) {
-        LOG(DEBUG) << "FastOD finished successfully";
+    if (GetCancellationToken().Stopped()) {
+        LOG(DEBUG) << "FastOD was stopped before finishing";
     } else {
-        LOG(DEBUG) << "FastOD finished with a time-out";
+        LOG(DEBUG) << "FastOD finished successfully";
     }
 
     PrintStatistics();
@@ -29,7 +29,6 @@ private:
     using Timer = fastod::Timer;
 
     config::TimeLimitSecondsType time_limit_seconds_ = 0u;
-    bool is_complete_ = true;
     size_t level_ = 1;
 
     std::vector<AscCanonicalOD> result_asc_;
@@ -57,8 +56,6 @@ private:
     void RegisterOptions();
     void MakeLoadOptionsAvailable();
 
-    bool IsTimeUp() const;
-
     void Initialize();
     void ComputeODs();
     void PruneLevels();
@@ -177,7 +174,6 @@ public:
     Fastod();
 
     void PrintStatistics() const;
-    bool IsComplete() const;
 
     std::vector<AscCanonicalOD> const& GetAscendingDependencies() const;
     std::vector<DescCanonicalOD> const& GetDescendingDependencies() const;
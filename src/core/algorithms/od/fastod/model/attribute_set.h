@@ -1,144 +1,220 @@
 #pragma once
 
-#include <bitset>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 #include <functional>
-#include <stdexcept>
+#include <limits>
 #include <string>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/functional/hash.hpp>
 
 #include "model/table/column_index.h"
 
 namespace algos::fastod {
 
+/// Attributes below kWordBits are kept in an inline word, so that on schemas that fit into it
+/// (the usual case) sets are compared and hashed with one word operation. The rest are kept in
+/// extra words, which are inline too for up to kInlineExtraWords of them, so sets of schemas of up
+/// to 256 columns are copied without touching the heap.
 class AttributeSet {
 private:
-    static constexpr model::ColumnIndex kBitsNum = 64;
+    using Word = std::uint64_t;
 
-    std::bitset<kBitsNum> bitset_;
+    static constexpr model::ColumnIndex kWordBits = std::numeric_limits<Word>::digits;
+    static constexpr size_t kInlineExtraWords = 3;
 
-    explicit AttributeSet(std::bitset<kBitsNum> bitset) noexcept : bitset_(std::move(bitset)) {}
+    Word word_ = 0;
+    boost::container::small_vector<Word, kInlineExtraWords> extra_words_;
 
-public:
-    AttributeSet() noexcept = default;
+    static constexpr model::ColumnIndex ExtraWordsFor(model::ColumnIndex attribute_count) noexcept {
+        return attribute_count <= kWordBits ? 0 : (attribute_count - 1) / kWordBits;
+    }
+
+    static constexpr Word BitMask(model::ColumnIndex n) noexcept {
+        return Word{1} << (n % kWordBits);
+    }
+
+    Word& WordOf(model::ColumnIndex n) {
+        return n < kWordBits ? word_ : extra_words_.at(n / kWordBits - 1);
+    }
 
-    explicit AttributeSet([[maybe_unused]] model::ColumnIndex attribute_count) {
-        if (attribute_count >= kBitsNum) {
-            throw std::invalid_argument("Maximum possible number of attributes is " +
-                                        std::to_string(kBitsNum - 1));
+    Word GetWord(model::ColumnIndex index) const noexcept {
+        if (index == 0) return word_;
+        return index <= extra_words_.size() ? extra_words_[index - 1] : 0;
+    }
+
+    model::ColumnIndex WordCount() const noexcept {
+        return extra_words_.size() + 1;
+    }
+
+    /* Sets of one schema have the same number of words, but a default-constructed set may meet
+     * a sized one */
+    template <typename Operation>
+    AttributeSet& Apply(AttributeSet const& b, Operation operation) {
+        if (extra_words_.size() < b.extra_words_.size()) {
+            extra_words_.resize(b.extra_words_.size(), 0);
+        }
+        word_ = operation(word_, b.word_);
+        for (model::ColumnIndex i = 0; i < extra_words_.size(); ++i) {
+            extra_words_[i] = operation(extra_words_[i], b.GetWord(i + 1));
         }
+        return *this;
     }
 
-    explicit AttributeSet([[maybe_unused]] model::ColumnIndex attribute_count,
-                          model::ColumnIndex value)
-        : bitset_(value) {
-        if (attribute_count >= kBitsNum) {
-            throw std::invalid_argument("Maximum possible number of attributes is " +
-                                        std::to_string(kBitsNum - 1));
+    model::ColumnIndex FindFrom(model::ColumnIndex index, Word word) const noexcept {
+        while (word == 0) {
+            if (++index == WordCount()) return Size();
+            word = GetWord(index);
         }
+        return index * kWordBits + std::countr_zero(word);
     }
 
-    AttributeSet& operator&=(AttributeSet const& b) noexcept {
-        bitset_ &= b.bitset_;
-        return *this;
+public:
+    AttributeSet() noexcept = default;
+
+    explicit AttributeSet(model::ColumnIndex attribute_count)
+        : extra_words_(ExtraWordsFor(attribute_count), 0) {}
+
+    AttributeSet& operator&=(AttributeSet const& b) {
+        return Apply(b, std::bit_and<Word>{});
     }
 
-    AttributeSet& operator|=(AttributeSet const& b) noexcept {
-        bitset_ |= b.bitset_;
-        return *this;
+    AttributeSet& operator|=(AttributeSet const& b) {
+        return Apply(b, std::bit_or<Word>{});
     }
 
-    AttributeSet& operator^=(AttributeSet const& b) noexcept {
-        bitset_ ^= b.bitset_;
-        return *this;
+    AttributeSet& operator^=(AttributeSet const& b) {
+        return Apply(b, std::bit_xor<Word>{});
     }
 
-    AttributeSet operator~() const noexcept {
-        AttributeSet as(~bitset_);
+    AttributeSet operator~() const {
+        AttributeSet as(*this);
+        as.word_ = ~as.word_;
+        for (Word& word : as.extra_words_) {
+            word = ~word;
+        }
         return as;
     }
 
     AttributeSet& Set(model::ColumnIndex n, bool value = true) {
-        bitset_.set(n, value);
+        if (value) {
+            WordOf(n) |= BitMask(n);
+        } else {
+            WordOf(n) &= ~BitMask(n);
+        }
         return *this;
     }
 
     AttributeSet& Reset(model::ColumnIndex n) {
-        bitset_.reset(n);
-        return *this;
+        return Set(n, false);
     }
 
     bool Test(model::ColumnIndex n) const noexcept {
-        return bitset_.test(n);
+        return (GetWord(n / kWordBits) & BitMask(n)) != 0;
     }
 
     bool All() const noexcept {
-        return bitset_.all();
+        auto is_full = [](Word word) { return word == std::numeric_limits<Word>::max(); };
+        return is_full(word_) && std::all_of(extra_words_.begin(), extra_words_.end(), is_full);
     }
 
     bool Any() const noexcept {
-        return bitset_.any();
+        return word_ != 0 || std::any_of(extra_words_.begin(), extra_words_.end(),
+                                          [](Word word) { return word != 0; });
     }
 
     bool None() const noexcept {
-        return bitset_.none();
+        return !Any();
     }
 
     model::ColumnIndex Count() const noexcept {
-        return bitset_.count();
+        model::ColumnIndex count = std::popcount(word_);
+        for (Word word : extra_words_) {
+            count += std::popcount(word);
+        }
+        return count;
     }
 
+    /// Number of attributes the set can hold, returned by FindFirst and FindNext when there are
+    /// no more attributes in the set
     model::ColumnIndex Size() const noexcept {
-        return bitset_.size();
+        return WordCount() * kWordBits;
     }
 
     model::ColumnIndex FindFirst() const noexcept {
-        return bitset_._Find_first();
+        return FindFrom(0, word_);
     }
 
     model::ColumnIndex FindNext(model::ColumnIndex pos) const noexcept {
-        return bitset_._Find_next(pos);
+        ++pos;
+        if (pos >= Size()) return Size();
+        return FindFrom(pos / kWordBits, GetWord(pos / kWordBits) & ~(BitMask(pos) - 1));
     }
 
     std::string ToString() const;
     void Iterate(std::function<void(model::ColumnIndex)> callback) const;
 
-    friend AttributeSet operator&(AttributeSet const& b1, AttributeSet const& b2) noexcept;
-    friend AttributeSet operator|(AttributeSet const& b1, AttributeSet const& b2) noexcept;
-    friend AttributeSet operator^(AttributeSet const& b1, AttributeSet const& b2) noexcept;
+    friend AttributeSet operator&(AttributeSet const& b1, AttributeSet const& b2);
+    friend AttributeSet operator|(AttributeSet const& b1, AttributeSet const& b2);
+    friend AttributeSet operator^(AttributeSet const& b1, AttributeSet const& b2);
     friend bool operator==(AttributeSet const& b1, AttributeSet const& b2) noexcept;
     friend bool operator!=(AttributeSet const& b1, AttributeSet const& b2) noexcept;
     friend bool operator<(AttributeSet const& b1, AttributeSet const& b2) noexcept;
 
     friend struct std::hash<AttributeSet>;
     friend struct boost::hash<AttributeSet>;
+
+private:
+    /* Extra words that are zero don't affect the hash, so a set of a narrow schema hashes to its
+     * word */
+    size_t Hash() const noexcept {
+        size_t hash = word_;
+        for (model::ColumnIndex i = 0; i < extra_words_.size(); ++i) {
+            if (extra_words_[i] != 0) {
+                boost::hash_combine(hash, i);
+                boost::hash_combine(hash, extra_words_[i]);
+            }
+        }
+        return hash;
+    }
 };
 
-inline AttributeSet operator&(AttributeSet const& b1, AttributeSet const& b2) noexcept {
-    AttributeSet as(b1.bitset_ & b2.bitset_);
-    return as;
+inline AttributeSet operator&(AttributeSet const& b1, AttributeSet const& b2) {
+    AttributeSet as(b1);
+    return as &= b2;
 }
 
-inline AttributeSet operator|(AttributeSet const& b1, AttributeSet const& b2) noexcept {
-    AttributeSet as(b1.bitset_ | b2.bitset_);
-    return as;
+inline AttributeSet operator|(AttributeSet const& b1, AttributeSet const& b2) {
+    AttributeSet as(b1);
+    return as |= b2;
 }
 
-inline AttributeSet operator^(AttributeSet const& b1, AttributeSet const& b2) noexcept {
-    AttributeSet as(b1.bitset_ ^ b2.bitset_);
-    return as;
+inline AttributeSet operator^(AttributeSet const& b1, AttributeSet const& b2) {
+    AttributeSet as(b1);
+    return as ^= b2;
 }
 
 inline bool operator==(AttributeSet const& b1, AttributeSet const& b2) noexcept {
-    return b1.bitset_ == b2.bitset_;
+    if (b1.word_ != b2.word_) return false;
+    model::ColumnIndex const word_count = std::max(b1.WordCount(), b2.WordCount());
+    for (model::ColumnIndex i = 1; i < word_count; ++i) {
+        if (b1.GetWord(i) != b2.GetWord(i)) return false;
+    }
+    return true;
 }
 
 inline bool operator!=(AttributeSet const& b1, AttributeSet const& b2) noexcept {
     return !(b1 == b2);
 }
 
+/// Compares sets as numbers with the attribute n being the n-th bit
 inline bool operator<(AttributeSet const& b1, AttributeSet const& b2) noexcept {
-    return b1.bitset_.to_ullong() < b2.bitset_.to_ullong();
+    for (model::ColumnIndex i = std::max(b1.WordCount(), b2.WordCount()); i-- > 1;) {
+        if (b1.GetWord(i) != b2.GetWord(i)) return b1.GetWord(i) < b2.GetWord(i);
+    }
+    return b1.word_ < b2.word_;
 }
 
 }  // namespace algos::fastod
@@ -146,14 +222,14 @@ inline bool operator<(AttributeSet const& b1, AttributeSet const& b2) noexcept {
 template <>
 struct std::hash<algos::fastod::AttributeSet> {
     size_t operator()(algos::fastod::AttributeSet const& x) const noexcept {
-        return x.bitset_.to_ullong();
+        return x.Hash();
     }
 };
 
 template <>
 struct boost::hash<algos::fastod::AttributeSet> {
     size_t operator()(algos::fastod::AttributeSet const& x) const noexcept {
-        return x.bitset_.to_ullong();
+        return x.Hash();
     }
 };
 
@@ -184,11 +260,11 @@ inline AttributeSet DeleteAttribute(AttributeSet const& value, model::ColumnInde
     return value_copy.Reset(attribute);
 }
 
-inline AttributeSet Intersect(AttributeSet const& value1, AttributeSet const& value2) noexcept {
+inline AttributeSet Intersect(AttributeSet const& value1, AttributeSet const& value2) {
     return value1 & value2;
 }
 
-inline AttributeSet Difference(AttributeSet const& value1, AttributeSet const& value2) noexcept {
+inline AttributeSet Difference(AttributeSet const& value1, AttributeSet const& value2) {
     return value1 & (~value2);
 }
 
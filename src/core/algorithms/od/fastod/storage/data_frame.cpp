@@ -100,6 +100,8 @@ DataFrame DataFrame::FromInputTable(config::InputTable input_table,
 void DataFrame::RecognizeAttributesWithRanges() {
     double constexpr accept_factor = 0.001;
 
+    attrs_with_ranges_ = AttributeSet(data_ranges_.size());
+
     for (size_t i = 0; i < data_ranges_.size(); ++i) {
         const size_t items_count = data_[i].size();
         const size_t ranges_count = data_ranges_[i].size();
@@ -112,11 +114,12 @@ void DataFrame::RecognizeAttributesWithRanges() {
 
 std::vector<std::pair<std::byte const*, int>> DataFrame::CreateIndexedColumnData(
         model::TypedColumnData const& column) {
-    const std::vector<std::byte const*> data = column.GetData();
-    std::vector<std::pair<std::byte const*, int>> indexed_column_data(data.size());
+    std::vector<std::pair<std::byte const*, int>> indexed_column_data(column.GetNumRows());
+    /* String values are compared by their index, see CompareData */
+    bool const is_heap_type = column.IsHeapType();
 
-    for (size_t i = 0; i < data.size(); ++i) {
-        indexed_column_data[i] = std::make_pair(data[i], i);
+    for (size_t i = 0; i < indexed_column_data.size(); ++i) {
+        indexed_column_data[i] = std::make_pair(is_heap_type ? nullptr : column.GetValue(i), i);
     }
 
     return indexed_column_data;
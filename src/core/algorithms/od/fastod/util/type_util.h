@@ -39,6 +39,10 @@ model::CompareResult CompareData(DataFrame::DataAndIndex const& left,
                        ? mixed_type->Compare(left.first, right.first)
                        : CompareDataAsStrings(left.first, right.first, mixed_type);
     } else {
+        if (column.IsHeapType()) {
+            return model::StringType::Compare(column.GetStringValue(left.second),
+                                              column.GetStringValue(right.second));
+        }
         model::Type const& type = column.GetType();
         return type.Compare(left.first, right.first);
     }
@@ -58,31 +58,32 @@ void Order::CreateSingleColumnSortedPartitions() {
             continue;
         }
         single_attributes_.push_back({i});
-        std::vector<IndexedByteData> indexed_byte_data = GetIndexedByteData(data[i], null_rows);
-        std::unique_ptr<model::Type> type = model::CreateType(data[i].GetTypeId(), true);
+        model::TypedColumnData const& column = data[i];
+        std::vector<model::TupleIndex> indices = GetNonNullIndices(column, null_rows);
+        std::unique_ptr<model::Type> type = model::CreateType(column.GetTypeId(), true);
         std::unique_ptr<model::MixedType> mixed_type =
                 model::CreateSpecificType<model::MixedType>(model::TypeId::kMixed, true);
-        auto less = [&type, &mixed_type](IndexedByteData const& l, IndexedByteData const& r) {
-            if (type->GetTypeId() == +(model::TypeId::kMixed)) {
-                return mixed_type->CompareAsStrings(l.data, r.data) == model::CompareResult::kLess;
+        auto compare = [&column, &type, &mixed_type](model::TupleIndex l, model::TupleIndex r) {
+            if (column.IsHeapType()) {
+                return model::StringType::Compare(column.GetStringValue(l),
+                                                  column.GetStringValue(r));
             }
-            return type->Compare(l.data, r.data) == model::CompareResult::kLess;
-        };
-        auto equal = [&type, &mixed_type](IndexedByteData const& l, IndexedByteData const& r) {
             if (type->GetTypeId() == +(model::TypeId::kMixed)) {
-                return mixed_type->CompareAsStrings(l.data, r.data) == model::CompareResult::kEqual;
+                return mixed_type->CompareAsStrings(column.GetValue(l), column.GetValue(r));
             }
-            return type->Compare(l.data, r.data) == model::CompareResult::kEqual;
+            return type->Compare(column.GetValue(l), column.GetValue(r));
         };
-        std::sort(indexed_byte_data.begin(), indexed_byte_data.end(), less);
+        std::sort(indices.begin(), indices.end(), [&compare](auto l, auto r) {
+            return compare(l, r) == model::CompareResult::kLess;
+        });
         SortedPartition::EquivalenceClasses equivalence_classes;
         equivalence_classes.reserve(typed_relation_->GetNumRows());
-        equivalence_classes.push_back({indexed_byte_data.front().index});
-        for (size_t k = 1; k < indexed_byte_data.size(); ++k) {
-            if (equal(indexed_byte_data[k - 1], indexed_byte_data[k])) {
-                equivalence_classes.back().insert(indexed_byte_data[k].index);
+        equivalence_classes.push_back({indices.front()});
+        for (size_t k = 1; k < indices.size(); ++k) {
+            if (compare(indices[k - 1], indices[k]) == model::CompareResult::kEqual) {
+                equivalence_classes.back().insert(indices[k]);
             } else {
-                equivalence_classes.push_back({indexed_byte_data[k].index});
+                equivalence_classes.push_back({indices[k]});
             }
         }
         equivalence_classes.shrink_to_fit();
@@ -143,6 +144,7 @@ void Order::ComputeDependencies(ListLattice::LatticeLevel const& lattice_level)
     }
     UpdateCandidateSets();
     for (Node const& node : lattice_level) {
+        if (StopRequested()) return;
         CandidatePairs candidate_pairs = lattice_->ObtainCandidates(node);
         for (auto const& [lhs, rhs] : candidate_pairs) {
             if (!InUnorderedMap(candidate_sets_, lhs, rhs)) {
@@ -361,7 +363,7 @@ unsigned long long Order::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
     CreateSingleColumnSortedPartitions();
     lattice_ = std::make_unique<ListLattice>(candidate_sets_, single_attributes_);
-    while (!lattice_->IsEmpty()) {
+    while (!lattice_->IsEmpty() && !StopRequested()) {
         ComputeDependencies(lattice_->GetLatticeLevel());
         lattice_->Prune(candidate_sets_);
         lattice_->GenerateNextLevel(candidate_sets_);
@@ -73,19 +73,18 @@ std::unordered_set<model::TupleIndex> GetNullIndices(
     return null_rows;
 }
 
-std::vector<IndexedByteData> GetIndexedByteData(
+std::vector<model::TupleIndex> GetNonNullIndices(
         model::TypedColumnData const& data,
         std::unordered_set<model::TupleIndex> const& null_rows) {
-    std::vector<IndexedByteData> indexed_byte_data;
-    indexed_byte_data.reserve(data.GetNumRows());
-    std::vector<std::byte const*> const& byte_data = data.GetData();
-    for (size_t k = 0; k < byte_data.size(); ++k) {
+    std::vector<model::TupleIndex> indices;
+    indices.reserve(data.GetNumRows());
+    for (size_t k = 0; k < data.GetNumRows(); ++k) {
         if (null_rows.find(k) != null_rows.end()) {
             continue;
         }
-        indexed_byte_data.emplace_back(k, byte_data[k]);
+        indices.push_back(k);
     }
-    return indexed_byte_data;
+    return indices;
 }
 
 }  // namespace algos::order
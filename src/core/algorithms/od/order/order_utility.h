@@ -21,11 +21,6 @@ using CandidateSets =
 using OrderDependencies =
         std::unordered_map<AttributeList, std::unordered_set<AttributeList, ListHash>, ListHash>;
 
-struct IndexedByteData {
-    model::TupleIndex index;
-    std::byte const* data;
-};
-
 void PrintOD(AttributeList const& lhs, AttributeList const& rhs);
 Prefixes GetPrefixes(Node const& node);
 AttributeList MaxPrefix(AttributeList const& attribute_list);
@@ -35,6 +30,6 @@ bool AreDisjoint(AttributeList const& a, AttributeList const& b);
 bool StartsWith(AttributeList const& rhs_candidate, AttributeList const& rhs);
 std::unordered_set<model::TupleIndex> GetNullIndices(
         std::vector<model::TypedColumnData> const& data);
-std::vector<IndexedByteData> GetIndexedByteData(
+std::vector<model::TupleIndex> GetNonNullIndices(
         model::TypedColumnData const& data, std::unordered_set<model::TupleIndex> const& null_rows);
 }  // namespace algos::order
@@ -1,11 +1,14 @@
 #include "typo_miner.h"
 
+#include <utility>
+
 #include "config/equal_nulls/option.h"
 #include "config/error/option.h"
 #include "config/exceptions.h"
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 #include "config/tabular_data/input_table/option.h"
+#include "model/table/relation_loader.h"
 
 namespace {
 using namespace algos;
@@ -35,6 +38,8 @@ TypoMiner::TypoMiner(GetPrecise get_precise, GetApprox get_approx)
           relation_manager_(MakeRelationManager()) {
     RegisterOptions();
     MakeOptionsAvailable({config::kTableOpt.GetName(), config::kEqualNullsOpt.GetName()});
+    PropagateCancellationTo(*precise_algo_);
+    PropagateCancellationTo(*approx_algo_);
 }
 
 void TypoMiner::RegisterOptions() {
@@ -109,11 +114,12 @@ void TypoMiner::AddSpecificNeededOptions(
 }
 
 void TypoMiner::LoadDataInternal() {
-    relation_ = relation_manager_.GetRelation();
-    input_table_->Reset();
-    typed_relation_ =
-            model::ColumnLayoutTypedRelationData::CreateFrom(*input_table_, is_null_equal_null_);
+    model::LoadedRelations relations = model::LoadRelations(*input_table_, is_null_equal_null_);
+    relation_ = std::move(relations.relation);
+    typed_relation_ = std::move(relations.typed_relation);
 
+    /* PLI based algorithms get the relation through relation_manager_ and do not read the table,
+     * others parse it themselves */
     for (Algorithm* algo : {precise_algo_.get(), approx_algo_.get()}) {
         input_table_->Reset();
         algo->LoadData();
@@ -126,14 +132,17 @@ unsigned long long TypoMiner::ExecuteInternal() {
     precise_algo_->Execute();
     approx_algo_->Execute();
 
-    std::list<FD>& precise_fds = precise_algo_->FdList();
-    std::list<FD>& approx_fds = approx_algo_->FdList();
+    /* The difference of incomplete FD lists would give false typo candidates */
+    if (!StopRequested()) {
+        std::list<FD>& precise_fds = precise_algo_->FdList();
+        std::list<FD>& approx_fds = approx_algo_->FdList();
 
-    precise_fds.sort(FDLess);
-    approx_fds.sort(FDLess);
+        precise_fds.sort(FDLess);
+        approx_fds.sort(FDLess);
 
-    std::set_difference(approx_fds.begin(), approx_fds.end(), precise_fds.begin(),
-                        precise_fds.end(), std::back_inserter(approx_fds_), FDLess);
+        std::set_difference(approx_fds.begin(), approx_fds.end(), precise_fds.begin(),
+                            precise_fds.end(), std::back_inserter(approx_fds_), FDLess);
+    }
 
     auto const elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now() - start_time);
@@ -152,7 +161,7 @@ std::vector<model::PLI::Cluster> TypoMiner::FindClustersWithTypos(FD const& typo
     std::vector<model::PLI::Cluster> clusters;
     std::shared_ptr<model::PLI const> intersection_pli;
     std::vector<Column const*> const lhs_columns = typos_fd.GetLhs().GetColumns();
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             relation_->GetColumnData(typos_fd.GetRhs().GetIndex()).GetProbingTable();
     auto const sort_cluster = [this, &typos_fd](model::PLI::Cluster& cluster) {
         std::map<int, unsigned> const frequency_map =
@@ -184,7 +193,7 @@ std::vector<model::PLI::Cluster> TypoMiner::FindClustersWithTypos(FD const& typo
         }
     }
 
-    for (model::PLI::Cluster const& cluster : intersection_pli->GetIndex()) {
+    for (model::PLI::ClusterView cluster : intersection_pli->GetIndex()) {
         int cluster_rhs_value = -1;
 
         /* Check if fd has wrong rhs values in this cluster */
@@ -207,7 +216,7 @@ std::vector<model::PLI::Cluster> TypoMiner::FindClustersWithTypos(FD const& typo
              * So I decided to leave it as it is until we know for sure that this place causes
              * performance problems.
              */
-            clusters.push_back(cluster);
+            clusters.emplace_back(cluster);
 
             if (sort_clusters) {
                 sort_cluster(clusters.back());
@@ -221,7 +230,7 @@ std::vector<model::PLI::Cluster> TypoMiner::FindClustersWithTypos(FD const& typo
 std::vector<TypoMiner::SquashedElement> TypoMiner::SquashCluster(
         FD const& squash_on, model::PLI::Cluster const& cluster) const {
     std::vector<SquashedElement> squashed;
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             relation_->GetColumnData(squash_on.GetRhs().GetIndex()).GetProbingTable();
 
     if (cluster.empty()) {
@@ -273,7 +282,7 @@ std::vector<model::PLI::Cluster::value_type> TypoMiner::FindLinesWithTypos(
         FD const& typos_fd, model::PLI::Cluster const& cluster) const {
     Column const& col = typos_fd.GetRhs();
     model::TypedColumnData const& col_data = typed_relation_->GetColumnData(col.GetIndex());
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             relation_->GetColumnData(col.GetIndex()).GetProbingTable();
     model::Type const& type = col_data.GetType();
 
@@ -291,7 +300,6 @@ std::vector<model::PLI::Cluster::value_type> TypoMiner::FindLinesWithTypos(
 
     std::vector<model::PLI::Cluster::value_type> typos;
     unsigned long num_of_close_values = 0;
-    std::vector<std::byte const*> const& data = col_data.GetData();
 
     for (model::PLI::Cluster::value_type tuple_index : cluster) {
         /* Temporary ignoring NULL or empty values. Maybe it should be decided by some parameter
@@ -301,7 +309,7 @@ std::vector<model::PLI::Cluster::value_type> TypoMiner::FindLinesWithTypos(
         if (most_freq_value == probing_table[tuple_index] || col_data.IsNullOrEmpty(tuple_index)) {
             continue;
         }
-        if (radius_ == -1 || ValuesAreClose(data[most_freq_index], data[tuple_index], type)) {
+        if (radius_ == -1 || ValuesAreClose(col_data, most_freq_index, tuple_index)) {
             num_of_close_values++;
             typos.push_back(tuple_index);
         }
@@ -334,7 +342,7 @@ std::vector<TypoMiner::ClusterTyposPair> TypoMiner::FindClustersAndLinesWithTypo
 unsigned TypoMiner::GetMostFrequentValueIndex(Column const& cluster_col,
                                               model::PLI::Cluster const& cluster) const {
     assert(!cluster.empty());
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             relation_->GetColumnData(cluster_col.GetIndex()).GetProbingTable();
     std::unordered_map<int, unsigned> frequencies =
             model::PLI::CreateFrequencies(cluster, probing_table);
@@ -358,7 +366,7 @@ unsigned TypoMiner::GetMostFrequentValueIndex(Column const& cluster_col,
 std::map<int, unsigned> TypoMiner::CreateFrequencyMap(Column const& cluster_col,
                                                       model::PLI::Cluster const& cluster) const {
     std::map<int, unsigned> frequency_map;
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             relation_->GetColumnData(cluster_col.GetIndex()).GetProbingTable();
     std::unordered_map<int, unsigned> frequencies =
             model::PLI::CreateFrequencies(cluster, probing_table);
@@ -10,6 +10,7 @@
 #include "model/table/idataset_stream.h"
 #include "parser/csv_parser/csv_parser.h"
 #include "types.h"
+#include "util/levenshtein_distance.h"
 
 namespace algos {
 
@@ -47,9 +48,16 @@ private:
     unsigned GetMostFrequentValueIndex(Column const& cluster_col,
                                        model::PLI::Cluster const& cluster) const;
 
-    bool ValuesAreClose(std::byte const* l, std::byte const* r, model::Type const& type) const {
+    bool ValuesAreClose(model::TypedColumnData const& col_data, size_t l, size_t r) const {
+        model::Type const& type = col_data.GetType();
         assert(type.IsMetrizable());
-        return static_cast<model::IMetrizableType const&>(type).Dist(l, r) < radius_;
+        if (col_data.IsHeapType()) {
+            /* StringType::Dist, but on the text, as String columns keep no String objects */
+            return util::LevenshteinDistance(col_data.GetStringValue(l),
+                                             col_data.GetStringValue(r)) < radius_;
+        }
+        auto const& metrizable_type = static_cast<model::IMetrizableType const&>(type);
+        return metrizable_type.Dist(col_data.GetValue(l), col_data.GetValue(r)) < radius_;
     }
 
     template <typename GetPrecise, typename GetApprox>
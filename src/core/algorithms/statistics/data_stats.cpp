@@ -1,23 +1,35 @@
 #include "algorithms/statistics/data_stats.h"
 
+#include <algorithm>
+#include <cassert>
+#include <numeric>
 #include <set>
 
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
 #include <boost/thread.hpp>
 
 #include "config/equal_nulls/option.h"
 #include "config/tabular_data/input_table/option.h"
 #include "config/thread_number/option.h"
+#include "util/parallel_for.h"
 
 namespace algos {
 
 namespace fs = std::filesystem;
 namespace mo = model;
 
+namespace {
+
+Statistic MakeStringStatistic(std::string_view value, mo::Type const& type) {
+    auto const& string_type = static_cast<mo::StringType const&>(type);
+    return Statistic(string_type.MakeValue(mo::String(value)), &type, false);
+}
+
+}  // namespace
+
 DataStats::DataStats() : Algorithm({"Calculating statistics"}) {
     RegisterOptions();
-    MakeOptionsAvailable({config::kTableOpt.GetName(), config::kEqualNullsOpt.GetName()});
+    MakeOptionsAvailable({config::kTableOpt.GetName(), config::kEqualNullsOpt.GetName(),
+                          config::kThreadNumberOpt.GetName()});
 }
 
 void DataStats::RegisterOptions() {
@@ -39,14 +51,22 @@ Statistic DataStats::GetMin(size_t index, mo::CompareResult order) const {
     if (!mo::Type::IsOrdered(col.GetTypeId())) return {};
 
     mo::Type const& type = col.GetType();
-    std::vector<std::byte const*> const& data = col.GetData();
+    if (col.IsHeapType()) {
+        std::vector<std::string_view> const data = DeleteNullAndEmptyStrings(index);
+        if (data.empty()) return {};
+        return MakeStringStatistic(order == mo::CompareResult::kLess
+                                           ? *std::ranges::min_element(data)
+                                           : *std::ranges::max_element(data),
+                                   type);
+    }
     std::byte const* result = nullptr;
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
         if (col.IsNullOrEmpty(i)) continue;
+        std::byte const* value = col.GetValue(i);
         if (result != nullptr) {
-            if (type.Compare(data[i], result) == order) result = data[i];
+            if (type.Compare(value, result) == order) result = value;
         } else {
-            result = data[i];
+            result = value;
         }
     }
     return Statistic(result, &type, true);
@@ -61,11 +81,10 @@ Statistic DataStats::GetSum(size_t index) const {
     mo::TypedColumnData const& col = col_data_[index];
     if (!col.IsNumeric()) return {};
 
-    std::vector<std::byte const*> const& data = col.GetData();
     auto const& type = static_cast<mo::INumericType const&>(col.GetType());
     std::byte* sum(type.MakeValueOfInt(0));
-    for (size_t i = 0; i < data.size(); ++i) {
-        if (!col.IsNullOrEmpty(i)) type.Add(sum, data[i], sum);
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        if (!col.IsNullOrEmpty(i)) type.Add(sum, col.GetValue(i), sum);
     }
     return Statistic(sum, &type, false);
 };
@@ -91,7 +110,6 @@ Statistic DataStats::CalculateCentralMoment(size_t index, int number,
                                             bool bessel_correction) const {
     mo::TypedColumnData const& col = col_data_[index];
     if (!col.IsNumeric()) return {};
-    std::vector<std::byte const*> const& data = col.GetData();
     mo::DoubleType double_type;
 
     Statistic avg = GetAvg(index);
@@ -100,9 +118,9 @@ Statistic DataStats::CalculateCentralMoment(size_t index, int number,
     std::byte* sum_of_difs = double_type.MakeValueOfInt(0);
     std::byte* dif = double_type.Allocate();
     std::byte* double_num = double_type.Allocate();
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
         if (col.IsNullOrEmpty(i)) continue;
-        mo::DoubleType::MakeFrom(data[i], col.GetType(), double_num);
+        mo::DoubleType::MakeFrom(col.GetValue(i), col.GetType(), double_num);
         double_type.Add(double_num, neg_avg, dif);
         double_type.Power(dif, number, dif);
         double_type.Add(sum_of_difs, dif, sum_of_difs);
@@ -179,16 +197,24 @@ inline static size_t CountDistinctInSortedData(std::vector<std::byte const*> con
     return distinct;
 }
 
+inline static size_t CountDistinctInSortedStrings(std::vector<std::string_view> const& data) {
+    size_t distinct = data.size() == 0 ? 0 : 1;
+    for (size_t i = 0; i + 1 < data.size(); ++i) {
+        if (data[i] != data[i + 1]) ++distinct;
+    }
+    return distinct;
+}
+
 size_t DataStats::MixedDistinct(size_t index) const {
     mo::TypedColumnData const& col = col_data_[index];
-    std::vector<std::byte const*> const& data = col.GetData();
     mo::MixedType mixed_type(is_null_equal_null_);
 
     std::vector<std::vector<std::byte const*>> values_by_type_id(mo::TypeId::_size());
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
         if (col.IsNullOrEmpty(i)) continue;
-        values_by_type_id[mixed_type.RetrieveTypeId(data[i])._to_index()].push_back(data[i]);
+        std::byte const* value = col.GetValue(i);
+        values_by_type_id[mixed_type.RetrieveTypeId(value)._to_index()].push_back(value);
     }
 
     size_t result = 0;
@@ -206,6 +232,11 @@ size_t DataStats::Distinct(size_t index) {
         all_stats_[index].distinct = MixedDistinct(index);
         return all_stats_[index].distinct;
     }
+    if (col.IsHeapType()) {
+        std::vector<std::string_view> data = DeleteNullAndEmptyStrings(index);
+        std::sort(data.begin(), data.end());
+        return all_stats_[index].distinct = CountDistinctInSortedStrings(data);
+    }
     auto const& type = col.GetType();
 
     std::vector<std::byte const*> data = DeleteNullAndEmpties(index);
@@ -237,18 +268,53 @@ std::vector<std::byte const*> DataStats::DeleteNullAndEmpties(size_t index) cons
     if (type_id == +mo::TypeId::kNull || type_id == +mo::TypeId::kEmpty ||
         type_id == +mo::TypeId::kUndefined)
         return {};
-    std::vector<std::byte const*> const& data = col.GetData();
     std::vector<std::byte const*> res;
-    res.reserve(data.size());
-    for (size_t i = 0; i < data.size(); ++i) {
-        if (!col.IsNullOrEmpty(i)) res.push_back(data[i]);
+    res.reserve(col.GetNumRows() - col.GetNumNulls() - col.GetNumEmpties());
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        if (!col.IsNullOrEmpty(i)) res.push_back(col.GetValue(i));
+    }
+    return res;
+}
+
+std::vector<std::string_view> DataStats::DeleteNullAndEmptyStrings(size_t index) const {
+    mo::TypedColumnData const& col = col_data_[index];
+    assert(col.IsHeapType());
+    std::vector<std::string_view> res;
+    res.reserve(col.GetNumRows() - col.GetNumNulls() - col.GetNumEmpties());
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        if (!col.IsNullOrEmpty(i)) res.push_back(col.GetStringValue(i));
     }
     return res;
 }
 
+Statistic DataStats::GetStringQuantile(double part, size_t index, bool calc_all) {
+    mo::TypedColumnData const& col = col_data_[index];
+    mo::Type const& type = col.GetType();
+    std::vector<std::string_view> data = DeleteNullAndEmptyStrings(index);
+    if (data.empty()) return {};
+    size_t quantile = data.size() * part;
+
+    if (calc_all && !all_stats_[index].quantile25.HasValue()) {
+        std::sort(data.begin(), data.end());
+        all_stats_[index].quantile25 =
+                MakeStringStatistic(data[(size_t)(data.size() * 0.25)], type);
+        all_stats_[index].quantile50 = MakeStringStatistic(data[(size_t)(data.size() * 0.5)], type);
+        all_stats_[index].quantile75 =
+                MakeStringStatistic(data[(size_t)(data.size() * 0.75)], type);
+        all_stats_[index].min = MakeStringStatistic(data[0], type);
+        all_stats_[index].max = MakeStringStatistic(data.back(), type);
+        all_stats_[index].distinct = CountDistinctInSortedStrings(data);
+    } else {
+        std::nth_element(data.begin(), data.begin() + quantile, data.end());
+    }
+
+    return MakeStringStatistic(data[quantile], type);
+}
+
 Statistic DataStats::GetQuantile(double part, size_t index, bool calc_all) {
     mo::TypedColumnData const& col = col_data_[index];
     if (!mo::Type::IsOrdered(col.GetTypeId())) return {};
+    if (col.IsHeapType()) return GetStringQuantile(part, index, calc_all);
     mo::Type const& type = col.GetType();
     std::vector<std::byte const*> data = DeleteNullAndEmpties(index);
     int quantile = data.size() * part;
@@ -301,13 +367,11 @@ Statistic DataStats::CountIfInBinaryRelationWithZero(size_t index, mo::CompareRe
     auto const& type = static_cast<mo::INumericType const&>(col.GetType());
     std::byte* zero = type.MakeValueOfInt(0);
     mo::IntType int_type;
-    std::vector<std::byte const*> const& data = col_data_[index].GetData();
-
-    auto pred = [&zero, &type, &res](std::byte const* el) {
-        return el && type.Compare(el, zero) == res;
-    };
 
-    size_t count = CountIf(pred, data);
+    size_t count = 0;
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        if (!col.IsNullOrEmpty(i) && type.Compare(col.GetValue(i), zero) == res) count++;
+    }
     type.Free(zero);
 
     return Statistic(int_type.MakeValue(count), &int_type, false);
@@ -329,13 +393,12 @@ Statistic DataStats::GetSumOfSquares(size_t index) const {
     if (!col.IsNumeric()) return {};
 
     auto const& type = static_cast<mo::INumericType const&>(col.GetType());
-    std::vector<std::byte const*> const& data = col.GetData();
     std::byte* res = type.MakeValueOfInt(0);
     std::byte* square = type.Allocate();
 
-    for (size_t i = 0; i < data.size(); i++) {
+    for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
-        type.Power(data[i], 2, square);
+        type.Power(col.GetValue(i), 2, square);
         type.Add(res, square, res);
     }
 
@@ -350,22 +413,22 @@ Statistic DataStats::GetGeometricMean(size_t index) const {
     if (!col.IsNumeric()) return {};
 
     auto const& type = static_cast<mo::INumericType const&>(col.GetType());
-    std::vector<std::byte const*> const data = col.GetData();
     mo::DoubleType double_type;
     std::byte* res = double_type.MakeValueOfInt(1);
     std::byte* temp = double_type.Allocate();
     std::byte* zero = type.MakeValueOfInt(0);
     long double num_values_reciprocal = 1.0L / static_cast<long double>(NumberOfValues(index));
 
-    for (size_t i = 0; i < data.size(); i++) {
+    for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
-        if (type.Compare(data[i], zero) == mo::CompareResult::kLess) {
+        std::byte const* value = col.GetValue(i);
+        if (type.Compare(value, zero) == mo::CompareResult::kLess) {
             double_type.Free(temp);
             double_type.Free(res);
             type.Free(zero);
             return {};
         }
-        mo::DoubleType::MakeFrom(data[i], type, temp);
+        mo::DoubleType::MakeFrom(value, type, temp);
         double_type.Power(temp, num_values_reciprocal, temp);
         double_type.Mul(res, temp, res);
     }
@@ -383,7 +446,6 @@ Statistic DataStats::GetMeanAD(size_t index) const {
 
     // Convert each summand to DoubleType
     auto const& col_type = static_cast<mo::INumericType const&>(col.GetType());
-    std::vector<std::byte const*> const data = col.GetData();
     mo::DoubleType double_type;
     std::byte* difference = double_type.MakeValue(0);  // data[i] - comparable
     std::byte* temp = double_type.Allocate();          // For converting data[i] to double
@@ -392,10 +454,10 @@ Statistic DataStats::GetMeanAD(size_t index) const {
     std::byte const* comparable = mo::DoubleType::MakeFrom(avg_stat.GetData(), *avg_stat.GetType());
 
     // Calculating the sum of |data[i] - comparable|
-    for (size_t i = 0; i < data.size(); i++) {
+    for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
 
-        mo::DoubleType::MakeFrom(data[i], col_type, temp);
+        mo::DoubleType::MakeFrom(col.GetValue(i), col_type, temp);
         double_type.Sub(temp, comparable, difference);
         double_type.Abs(difference, difference);  // |data[i] - comparable|
         double_type.Add(res, difference, res);
@@ -500,7 +562,7 @@ Statistic DataStats::GetVocab(size_t index) const {
 
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
         vocab.insert(string_data.begin(), string_data.end());
     }
     std::string temp(vocab.begin(), vocab.end());
@@ -555,7 +617,7 @@ Statistic DataStats::CountIfInColumn(Pred pred, size_t index) const {
 
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
         for (size_t j = 0; j < string_data.size(); j++)
             if (pred(string_data[j])) count++;
     }
@@ -569,7 +631,7 @@ Statistic DataStats::GetNumberOfChars(size_t index) const {
     mo::TypedColumnData const& col = col_data_[index];
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
-    return GetStringSumOf(index, [](std::string const& line) { return line.size(); });
+    return GetStringSumOf(index, [](std::string_view line) { return line.size(); });
 }
 
 Statistic DataStats::GetAvgNumberOfChars(size_t index) const {
@@ -603,7 +665,7 @@ Statistic DataStats::GetStringMinOf(size_t index, Pred pred) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
 
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
         size_t const& size = pred(string_data);
 
         if (size < result) result = size;
@@ -623,7 +685,7 @@ Statistic DataStats::GetStringMaxOf(size_t index, Pred pred) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
 
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
         size_t const& size = pred(string_data);
 
         if (size > result) result = size;
@@ -643,7 +705,7 @@ Statistic DataStats::GetStringSumOf(size_t index, Pred pred) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
 
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
 
         result += pred(string_data);
     }
@@ -658,7 +720,7 @@ Statistic DataStats::GetMinNumberOfChars(size_t index) const {
     mo::TypedColumnData const& col = col_data_[index];
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
-    return GetStringMinOf(index, [](std::string const& line) { return line.size(); });
+    return GetStringMinOf(index, [](std::string_view line) { return line.size(); });
 }
 
 Statistic DataStats::GetMaxNumberOfChars(size_t index) const {
@@ -666,11 +728,11 @@ Statistic DataStats::GetMaxNumberOfChars(size_t index) const {
     mo::TypedColumnData const& col = col_data_[index];
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
-    return GetStringMaxOf(index, [](std::string const& line) { return line.size(); });
+    return GetStringMaxOf(index, [](std::string_view line) { return line.size(); });
 }
 
-std::vector<std::string> DataStats::GetWordsInString(std::string line) {
-    std::istringstream iss(line);
+std::vector<std::string> DataStats::GetWordsInString(std::string_view line) {
+    std::istringstream iss{std::string(line)};
     std::vector<std::string> words_in_row(std::istream_iterator<std::string>{iss},
                                           std::istream_iterator<std::string>());
     return words_in_row;
@@ -686,14 +748,14 @@ std::set<std::string> DataStats::GetWords(size_t index) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
         std::vector<std::string> words_in_row =
-                GetWordsInString(mo::Type::GetValue<std::string>(col.GetValue(i)));
+                GetWordsInString(col.GetStringValue(i));
         words.insert(words_in_row.begin(), words_in_row.end());
     }
 
     return words;
 }
 
-size_t DataStats::GetNumberOfWordsInString(std::string line) {
+size_t DataStats::GetNumberOfWordsInString(std::string_view line) {
     size_t count = 0;
 
     for (size_t i = 0; i < line.size(); i++) {
@@ -710,7 +772,7 @@ Statistic DataStats::GetMinNumberOfWords(size_t index) const {
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
     return GetStringMinOf(index,
-                          [](std::string const& line) { return GetNumberOfWordsInString(line); });
+                          [](std::string_view line) { return GetNumberOfWordsInString(line); });
 }
 
 Statistic DataStats::GetMaxNumberOfWords(size_t index) const {
@@ -719,7 +781,7 @@ Statistic DataStats::GetMaxNumberOfWords(size_t index) const {
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
     return GetStringMaxOf(index,
-                          [](std::string const& line) { return GetNumberOfWordsInString(line); });
+                          [](std::string_view line) { return GetNumberOfWordsInString(line); });
 }
 
 Statistic DataStats::GetNumberOfWords(size_t index) const {
@@ -728,7 +790,7 @@ Statistic DataStats::GetNumberOfWords(size_t index) const {
     if (col.GetTypeId() != +mo::TypeId::kString) return {};
 
     return GetStringSumOf(index,
-                          [](std::string const& line) { return GetNumberOfWordsInString(line); });
+                          [](std::string_view line) { return GetNumberOfWordsInString(line); });
 }
 
 std::vector<char> DataStats::GetTopKChars(size_t index, size_t k) const {
@@ -740,7 +802,7 @@ std::vector<char> DataStats::GetTopKChars(size_t index, size_t k) const {
 
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
-        auto const& string_data = mo::Type::GetValue<std::string>(col.GetValue(i));
+        std::string_view const string_data = col.GetStringValue(i);
         for (char const symbol : string_data) {
             if (count_chars.find(symbol) != count_chars.end()) {
                 count_chars[symbol]++;
@@ -776,7 +838,7 @@ std::vector<std::string> DataStats::GetTopKWords(size_t index, size_t k) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
         std::vector<std::string> words_in_row =
-                GetWordsInString(mo::Type::GetValue<std::string>(col.GetValue(i)));
+                GetWordsInString(col.GetStringValue(i));
         for (std::string const& word : words_in_row) {
             if (count_words.find(word) != count_words.end()) {
                 count_words[word]++;
@@ -853,7 +915,7 @@ Statistic DataStats::CountIfInColumnForWords(Pred pred, size_t index) const {
     for (size_t i = 0; i < col.GetNumRows(); i++) {
         if (col.IsNullOrEmpty(i)) continue;
         std::vector<std::string> words_in_row =
-                GetWordsInString(mo::Type::GetValue<std::string>(col.GetValue(i)));
+                GetWordsInString(col.GetStringValue(i));
         for (size_t j = 0; j < words_in_row.size(); j++)
             if (pred(words_in_row[j])) count++;
     }
@@ -914,14 +976,9 @@ unsigned long long DataStats::ExecuteInternal() {
         AddProgress(percent_per_col);
     };
 
-    if (threads_num_ > 1) {
-        boost::asio::thread_pool pool(threads_num_);
-        for (size_t i = 0; i < all_stats_.size(); ++i)
-            boost::asio::post(pool, [i, task]() { return task(i); });
-        pool.join();
-    } else {
-        for (size_t i = 0; i < all_stats_.size(); ++i) task(i);
-    }
+    std::vector<size_t> indices(all_stats_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    util::ParallelForeach(indices.begin(), indices.end(), threads_num_, task);
 
     SetProgress(kTotalProgressPercent);
     auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -982,7 +1039,7 @@ std::string DataStats::ToString() const {
 }
 
 void DataStats::LoadDataInternal() {
-    col_data_ = mo::CreateTypedColumnData(*input_table_, is_null_equal_null_);
+    col_data_ = mo::CreateTypedColumnData(*input_table_, is_null_equal_null_, threads_num_);
     all_stats_ = std::vector<ColumnStats>{col_data_.size()};
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <set>
+#include <string>
+#include <string_view>
 
 #include "algorithms/fd/fd_algorithm.h"
 #include "algorithms/statistics/statistic.h"
@@ -35,10 +37,12 @@ class DataStats : public Algorithm {
     // checks if all the letters in a word a are lowercase
     static bool IsEntirelyLowercase(std::string word);
     // Returns the amount of words in a string
-    static size_t GetNumberOfWordsInString(std::string line);
+    static size_t GetNumberOfWordsInString(std::string_view line);
     // Returns a vector of words in a string
-    static std::vector<std::string> GetWordsInString(std::string line);
+    static std::vector<std::string> GetWordsInString(std::string_view line);
 
+    // Returns quantile of a String or BigInt column, see GetQuantile.
+    Statistic GetStringQuantile(double part, size_t index, bool calc_all);
     // Calculates values via a certain predivate and returns the minimal of them
     template <class Pred>
     Statistic GetStringMinOf(size_t index, Pred pred) const;
@@ -116,6 +120,8 @@ public:
     Statistic GetQuantile(double part, size_t index, bool calc_all = false);
     // Deletes null and empty values in the column.
     std::vector<std::byte const*> DeleteNullAndEmpties(size_t index) const;
+    // Same for String and BigInt columns, whose values are not kept as objects of their type.
+    std::vector<std::string_view> DeleteNullAndEmptyStrings(size_t index) const;
     // Returns number of zeros in the column if it's numeric.
     Statistic GetNumberOfZeros(size_t index) const;
     // Returns number of negative numbers in the column if it's numeric.
@@ -35,8 +35,8 @@ hpiv::PLITable HPIValid::Preprocess(hpiv::ResultCollector& rc) {
     model::ColumnIndex const num_columns = relation_->GetNumColumns();
     auto plis = hy::util::BuildPLIs(relation_.get());
     for (model::ColumnIndex column_index = 0; column_index < num_columns; column_index++) {
-        std::deque<model::PLI::Cluster> const& index = plis[column_index]->GetIndex();
-        tab.plis.push_back(index);
+        model::ClusterIndex const& index = plis[column_index]->GetIndex();
+        tab.plis.emplace_back(index.begin(), index.end());
     }
     tab.inverse_mapping = hy::util::BuildInvertedPlis(plis);
 
@@ -46,7 +46,7 @@ hpiv::PLITable HPIValid::Preprocess(hpiv::ResultCollector& rc) {
 
 unsigned long long HPIValid::ExecuteInternal() {
     hpiv::Config cfg;
-    hpiv::ResultCollector rc(3600);
+    hpiv::ResultCollector rc(GetCancellationToken());
 
     rc.StartTimer(hpiv::timer::TimerName::total);
     hpiv::PLITable tab = Preprocess(rc);
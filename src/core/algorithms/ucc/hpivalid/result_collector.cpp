@@ -18,8 +18,8 @@ std::vector<std::string> description = {"Total Execution Time", "Cluster-Structu
                                         "Cluster Intersection (validation)"};
 }  // namespace timer
 
-ResultCollector::ResultCollector(double timeout)
-    : timeout_(timeout),
+ResultCollector::ResultCollector(util::CancellationToken& cancellation)
+    : cancellation_(cancellation),
       ucc_count_(0),
       diff_sets_final_(0),
       timers_(timer::TimerName::num_of_timers),
@@ -33,9 +33,7 @@ ResultCollector::ResultCollector(double timeout)
 bool ResultCollector::UCCFound(Edge const& ucc) {
     ucc_count_++;
     ucc_vector_.push_back(ucc);
-    return std::chrono::duration_cast<std::chrono::duration<double>>(
-                   clock::now() - timers_[timer::TimerName::total].begin)
-                   .count() <= timeout_;
+    return !cancellation_.StopRequested();
 }
 
 void ResultCollector::FinalHypergraph(Hypergraph const& hg) {
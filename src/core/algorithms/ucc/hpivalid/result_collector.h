@@ -9,6 +9,7 @@
 #include "algorithms/ucc/raw_ucc.h"
 #include "algorithms/ucc/ucc_algorithm.h"
 #include "model/table/column_layout_relation_data.h"
+#include "util/cancellation_token.h"
 
 // see algorithms/ucc/hpivalid/LICENSE
 
@@ -32,7 +33,7 @@ class ResultCollector {
     using clock = std::chrono::high_resolution_clock;
 
 private:
-    double timeout_;
+    util::CancellationToken& cancellation_;
     unsigned ucc_count_;
     unsigned diff_sets_final_;
 
@@ -48,15 +49,20 @@ private:
     std::vector<model::RawUCC> ucc_vector_;
 
 public:
-    explicit ResultCollector(double timeout);
+    explicit ResultCollector(util::CancellationToken& cancellation);
 
     //////////////////////////////////////////////////////////////////////////////
     // collecting information
 
     // Report that a UCC has been found.  The return value is false if
-    // the timeout is reached.
+    // the search has to be stopped.
     bool UCCFound(Edge const& ucc);
 
+    // Whether the search has to be stopped (cancelled or out of time).
+    bool StopRequested() {
+        return cancellation_.StopRequested();
+    }
+
     // Report the final hypergraph of difference sets.
     void FinalHypergraph(Hypergraph const& hg);
 
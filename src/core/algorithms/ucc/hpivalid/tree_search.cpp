@@ -244,12 +244,15 @@ inline bool TreeSearch::ExtendOrConfirmS(
         std::stack<std::deque<model::PLI::Cluster>>& intersection_stack,
         std::deque<Edge::size_type>& tointersect_queue) {
     rc_.CountTreeNode();
+    if (rc_.StopRequested()) {
+        throw timeout_;
+    }
     if (uncov.none()) {
         PullUpIntersections(intersection_stack, tointersect_queue);
 
         if (intersection_stack.top().empty()) {
             if (!rc_.UCCFound(s)) {
-                // timeout
+                // cancelled or out of time
                 throw timeout_;
             }
             return false;
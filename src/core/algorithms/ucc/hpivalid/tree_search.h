@@ -25,7 +25,7 @@ private:
     // the partial hypergraph of difference sets
     Hypergraph partial_hg_;
 
-    // exception to throw, when timeout happens
+    // exception to throw, when the search is stopped
     unsigned const timeout_ = 10;
 
     // a mapping from clusterid to record indices that is used for the
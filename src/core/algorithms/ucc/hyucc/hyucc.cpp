@@ -1,6 +1,7 @@
 #include "hyucc.h"
 
 #include <chrono>
+#include <vector>
 
 #include <easylogging++.h>
 
@@ -25,7 +26,9 @@ unsigned long long HyUCC::ExecuteInternal() {
     using namespace hyucc;
     auto const start_time = std::chrono::system_clock::now();
 
-    auto [plis, pli_records, og_mapping] = Preprocess(relation_.get());
+    ::util::Metrics& metrics = GetMetrics();
+    auto [plis, pli_records, og_mapping] = ::util::TimedCall(
+            metrics.Timer("preprocessing"), [this] { return Preprocess(relation_.get()); });
     auto const plis_shared = std::make_shared<PLIs>(std::move(plis));
     auto const pli_records_shared = std::make_shared<Rows>(std::move(pli_records));
 
@@ -33,19 +36,25 @@ unsigned long long HyUCC::ExecuteInternal() {
 
     auto ucc_tree = std::make_unique<UCCTree>(relation_->GetNumColumns());
     Inductor inductor(ucc_tree.get());
-    Validator validator(ucc_tree.get(), plis_shared, pli_records_shared, threads_num_);
+    Validator validator(ucc_tree.get(), plis_shared, pli_records_shared, threads_num_,
+                        GetCancellationToken());
 
     IdPairs comparison_suggestions;
 
-    while (true) {
+    ::util::MetricTimer& sampling_time = metrics.Timer("sampling");
+    ::util::MetricTimer& induction_time = metrics.Timer("induction");
+    ::util::MetricTimer& validation_time = metrics.ValidationTime();
+    while (!StopRequested()) {
         LOG(DEBUG) << "Sampling...";
-        NonUCCList non_uccs = sampler.GetNonUCCs(comparison_suggestions);
+        NonUCCList non_uccs = ::util::TimedCall(
+                sampling_time, [&] { return sampler.GetNonUCCs(comparison_suggestions); });
 
         LOG(DEBUG) << "Inducing...";
-        inductor.UpdateUCCTree(std::move(non_uccs));
+        ::util::TimedCall(induction_time, [&] { inductor.UpdateUCCTree(std::move(non_uccs)); });
 
         LOG(DEBUG) << "Validating...";
-        comparison_suggestions = validator.ValidateAndExtendCandidates();
+        comparison_suggestions = ::util::TimedCall(
+                validation_time, [&validator] { return validator.ValidateAndExtendCandidates(); });
 
         if (comparison_suggestions.empty()) {
             break;
@@ -53,6 +62,12 @@ unsigned long long HyUCC::ExecuteInternal() {
     }
 
     auto uccs = ucc_tree->FillUCCs();
+    if (GetCancellationToken().Stopped()) {
+        /* The levels the validator has not finished hold unchecked candidates */
+        std::erase_if(uccs, [level = validator.GetLevelNum()](model::RawUCC const& ucc) {
+            return ucc.count() >= level;
+        });
+    }
     RegisterUCCs(std::move(uccs), og_mapping);
 
     LOG(DEBUG) << "Mined UCCs:";
@@ -1,13 +1,9 @@
 #include "validator.h"
 
-#include <future>
-
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
-
 #include "fd/hycommon/efficiency_threshold.h"
 #include "fd/hycommon/validator_helpers.h"
 #include "ucc/hyucc/model/ucc_tree_vertex.h"
+#include "util/parallel_for.h"
 
 namespace {
 
@@ -53,7 +49,7 @@ using model::RawUCC;
 bool Validator::IsUnique(model::PLI const& pivot_pli, RawUCC const& ucc,
                          hy::IdPairs& comparison_suggestions) {
     std::vector<hy::ClusterId> indices = util::BitsetToIndices<hy::ClusterId>(ucc);
-    for (model::PLI::Cluster const& cluster : pivot_pli.GetIndex()) {
+    for (model::PLI::ClusterView cluster : pivot_pli.GetIndex()) {
         auto cluster_to_record =
                 hy::MakeClusterIdentifierToTMap<model::PLI::Cluster::value_type>(cluster.size());
         for (auto const record_id : cluster) {
@@ -107,6 +103,7 @@ Validator::UCCValidations Validator::ValidateAndExtendSeq(
         std::vector<LhsPair> const& current_level) {
     UCCValidations result;
     for (auto const& vertex_and_ucc : current_level) {
+        if (cancellation_.StopRequested()) break;
         if (!vertex_and_ucc.first->IsUCC()) {
             continue;
         }
@@ -117,28 +114,19 @@ Validator::UCCValidations Validator::ValidateAndExtendSeq(
 
 Validator::UCCValidations Validator::ValidateAndExtendParallel(
         std::vector<LhsPair> const& current_level) {
-    UCCValidations result;
-    boost::asio::thread_pool pool(threads_num_);
-    std::vector<std::future<UCCValidations>> validation_futures;
-
-    for (auto const& vertex_and_ucc : current_level) {
-        if (!vertex_and_ucc.first->IsUCC()) {
-            continue;
+    /* Validations are merged in the order of the level, as in the sequential version */
+    std::vector<UCCValidations> validations(current_level.size());
+    auto validate = [this, &current_level, &validations](LhsPair const& vertex_and_ucc) {
+        if (vertex_and_ucc.first->IsUCC() && !cancellation_.StopRequested()) {
+            validations[&vertex_and_ucc - current_level.data()] = GetValidations(vertex_and_ucc);
         }
+    };
+    util::ParallelForeach(current_level.begin(), current_level.end(), threads_num_, validate);
 
-        std::packaged_task<UCCValidations()> task(
-                [this, &vertex_and_ucc]() { return GetValidations(vertex_and_ucc); });
-        validation_futures.push_back(task.get_future());
-        boost::asio::post(pool, std::move(task));
-    }
-
-    pool.join();
-
-    for (auto& future : validation_futures) {
-        assert(future.valid());
-        result.Add(future.get());
+    UCCValidations result;
+    for (UCCValidations const& validation : validations) {
+        result.Add(validation);
     }
-
     return result;
 }
 
@@ -165,6 +153,9 @@ hy::IdPairs Validator::ValidateAndExtendCandidates() {
     hy::IdPairs comparison_suggestions;
     while (!current_level.empty()) {
         UCCValidations result = ValidateAndExtend(current_level);
+        if (cancellation_.StopRequested()) {
+            return {};
+        }
         comparison_suggestions.insert(comparison_suggestions.end(),
                                       result.ComparisonSuggestions().begin(),
                                       result.ComparisonSuggestions().end());
@@ -173,6 +164,7 @@ hy::IdPairs Validator::ValidateAndExtendCandidates() {
         size_t candidates = AddExtendedCandidatesFromInvalid(
                 next_level, *tree_, result.InvalidInstances(), num_attributes);
 
+        CountValidations(result);
         LogLevel(current_level, result, candidates, current_level_number_, "UCC");
 
         size_t const num_invalid_uccs = result.InvalidInstances().size();
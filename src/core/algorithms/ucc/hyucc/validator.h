@@ -10,6 +10,7 @@
 #include "fd/hycommon/primitive_validations.h"
 #include "fd/hycommon/types.h"
 #include "model/table/position_list_index.h"
+#include "util/cancellation_token.h"
 
 namespace algos::hyucc {
 
@@ -22,6 +23,7 @@ private:
     hy::RowsPtr compressed_records_;
     unsigned current_level_number_ = 1;
     config::ThreadNumType threads_num_ = 1;
+    util::CancellationToken& cancellation_;
 
     bool IsUnique(model::PLI const& pivot_pli, model::RawUCC const& ucc,
                   hy::IdPairs& comparison_suggestions);
@@ -32,12 +34,19 @@ private:
 
 public:
     Validator(UCCTree* tree, hy::PLIsPtr plis, hy::RowsPtr compressed_records,
-              config::ThreadNumType threads_num) noexcept
+              config::ThreadNumType threads_num, util::CancellationToken& cancellation) noexcept
         : tree_(tree),
           plis_(std::move(plis)),
           compressed_records_(std::move(compressed_records)),
-          threads_num_(threads_num) {}
+          threads_num_(threads_num),
+          cancellation_(cancellation) {}
 
+    /* UCCs with fewer attributes than this are validated */
+    [[nodiscard]] unsigned GetLevelNum() const {
+        return current_level_number_;
+    }
+
+    /* Stops early if `cancellation` asks to, the level being validated is not counted then */
     hy::IdPairs ValidateAndExtendCandidates();
 };
 
@@ -9,6 +9,7 @@
 #include "algorithms/fd/pyrocommon/core/key_g1_strategy.h"
 #include "config/error/option.h"
 #include "config/max_lhs/option.h"
+#include "config/mem_limit/option.h"
 #include "config/names_and_descriptions.h"
 #include "config/option_using.h"
 
@@ -29,11 +30,13 @@ void PyroUCC::RegisterOptions() {
     RegisterOption(config::kErrorOpt(&parameters_.max_ucc_error));
     RegisterOption(config::kMaxLhsOpt(&parameters_.max_lhs));
     RegisterOption(Option{&parameters_.seed, kSeed, kDSeed, 0});
+    RegisterOption(config::kMemLimitMbOpt(&parameters_.mem_limit_mb));
 }
 
 void PyroUCC::MakeExecuteOptsAvailable() {
     using namespace config::names;
-    MakeOptionsAvailable({config::kMaxLhsOpt.GetName(), config::kErrorOpt.GetName(), kSeed});
+    MakeOptionsAvailable({config::kMaxLhsOpt.GetName(), config::kErrorOpt.GetName(), kSeed,
+                          config::kMemLimitMbOpt.GetName()});
 }
 
 void PyroUCC::LoadDataInternal() {
@@ -50,12 +53,13 @@ void PyroUCC::ResetUCCAlgorithmState() {
 
 unsigned long long PyroUCC::ExecuteInternal() {
     auto start_time = std::chrono::system_clock::now();
+    LimitMemory(size_t{parameters_.mem_limit_mb} << 20);
 
     auto schema = relation_->GetSchema();
 
     auto profiling_context = std::make_unique<ProfilingContext>(
             parameters_, relation_.get(), ucc_consumer_, fd_consumer_, caching_method_,
-            eviction_method_, caching_method_value_);
+            eviction_method_, GetCancellationToken(), GetMemoryBudget());
 
     std::function<bool(DependencyCandidate const&, DependencyCandidate const&)> launch_pad_order;
     if (parameters_.launch_pad_order == "arity") {
@@ -74,9 +78,10 @@ unsigned long long PyroUCC::ExecuteInternal() {
         throw std::runtime_error("Unknown key error measure.");
     }
     search_space_ = std::make_unique<SearchSpace>(0, std::move(strategy), schema, launch_pad_order);
-    unsigned long long init_time_millis = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                  std::chrono::system_clock::now() - start_time)
-                                                  .count();
+    auto const init_time = std::chrono::system_clock::now() - start_time;
+    GetMetrics().Timer("initialization").Record(init_time);
+    unsigned long long init_time_millis =
+            std::chrono::duration_cast<std::chrono::milliseconds>(init_time).count();
 
     start_time = std::chrono::system_clock::now();
 
@@ -85,12 +90,17 @@ unsigned long long PyroUCC::ExecuteInternal() {
     search_space_->Discover();
     SetProgress(100);
 
-    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now() - start_time);
+    auto const search_time = std::chrono::system_clock::now() - start_time;
+    GetMetrics().Timer("search").Record(search_time);
+    auto elapsed_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(search_time);
 
     LOG(INFO) << "Init time: " << init_time_millis << "ms";
     LOG(INFO) << "Time: " << elapsed_milliseconds.count() << " milliseconds";
-    LOG(INFO) << "Total intersection time: " << model::PositionListIndex::micros_ / 1000 << "ms";
+    LOG(INFO) << "Total intersection time: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         GetMetrics().PliIntersectionTime().Get().total)
+                         .count()
+              << "ms";
     return elapsed_milliseconds.count();
 }
 
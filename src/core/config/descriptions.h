@@ -102,6 +102,15 @@ constexpr auto kDIgnoreConstantCols =
 constexpr auto kDGraphData = "Path to dot-file with graph";
 constexpr auto kDGfdData = "Path to file with GFD";
 constexpr auto kDMemLimitMB = "memory limit im MBs";
+constexpr auto kDLatticeMemLimitMB =
+        "memory limit for the lattice in MBs, the execution fails if the lattice does not fit. "
+        "0 means no limit";
+constexpr auto kDSnapshot =
+        "path of a binary snapshot of the encoded table. It is read instead of the table if it "
+        "was made from the same file, otherwise it is written there. No snapshot if empty";
+constexpr auto kDCompressPlis =
+        "compress the position list indexes of the columns while loading the table. Takes less "
+        "memory, and intersecting the indexes takes longer";
 constexpr auto kDDifferenceTable = "CSV table containing difference limits for each column";
 constexpr auto kDNumRows = "Use only first N rows of the table";
 constexpr auto kDNUmColumns = "Use only first N columns of the table";
@@ -56,6 +56,8 @@ constexpr auto kIgnoreConstantCols = "ignore_constant_cols";
 constexpr auto kGraphData = "graph";
 constexpr auto kGfdData = "gfd";
 constexpr auto kMemLimitMB = "mem_limit";
+constexpr auto kCompressPlis = "compress_plis";
+constexpr auto kSnapshot = "snapshot";
 constexpr auto kDifferenceTable = "difference_table";
 constexpr auto kNumRows = "num_rows";
 constexpr auto kNumColumns = "num_columns";
@@ -1,18 +1,8 @@
 #include "agree_set_factory.h"
 
 #include <atomic>
-#include <condition_variable>
-#include <shared_mutex>
-#include <thread>
 #include <unordered_set>
 
-#include <boost/asio/post.hpp>
-#include <boost/asio/thread_pool.hpp>
-#include <boost/thread/shared_mutex.hpp>
-
-#define BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
-#include <boost/thread.hpp>
-#include <boost/thread/future.hpp>
 #include <easylogging++.h>
 
 #include "identifier_set.h"
@@ -61,8 +51,34 @@ AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAgreeSets() const {
     return agree_sets;
 }
 
-AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingVectorOfIdSets() const {
+template <typename ColumnSetType>
+AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::ToAgreeSets(
+        std::unordered_set<ColumnSetType> const& column_sets) const {
     SetOfAgreeSets agree_sets;
+    agree_sets.reserve(column_sets.size());
+    for (ColumnSetType const& column_set : column_sets) {
+        agree_sets.insert(relation_->GetSchema()->GetVertical(ToBitset(column_set)));
+    }
+    return agree_sets;
+}
+
+template <typename ColumnSetType>
+ColumnSetType AgreeSetFactory::GetAgreeColumns(int const tuple1_index,
+                                               int const tuple2_index) const {
+    vector<ColumnData> const& columns_data = relation_->GetColumnData();
+    ColumnSetType agree_set_indices(columns_data.size());
+
+    for (size_t i = 0; i < columns_data.size(); ++i) {
+        int const value = columns_data[i].GetProbingTableValue(tuple1_index);
+        if (value != 0 && value == columns_data[i].GetProbingTableValue(tuple2_index)) {
+            agree_set_indices.set(i);
+        }
+    }
+
+    return agree_set_indices;
+}
+
+AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingVectorOfIdSets() const {
     vector<IdentifierSet> identifier_sets;
     SetOfVectors const max_representation = GenPliMaxRepresentation();
 
@@ -91,26 +107,28 @@ AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingVectorOfIdSets() cons
 
     // compute agree sets using identifier sets
     // using vector of identifier sets
-    if (!identifier_sets.empty()) {
-        size_t const size = identifier_sets.size();
-        size_t const pairs_num = (size_t)(size * (size - 1) / 2);
-        double const percent_per_idset =
-                (pairs_num == 0) ? algos::FDAlgorithm::kTotalProgressPercent
-                                 : algos::FDAlgorithm::kTotalProgressPercent / pairs_num;
-        auto back_it = std::prev(identifier_sets.end());
-        for (auto p = identifier_sets.begin(); p != back_it; ++p) {
-            for (auto q = std::next(p); q != identifier_sets.end(); ++q) {
-                agree_sets.insert(p->Intersect(*q));
-                AddProgress(percent_per_idset);
+    return DispatchColumnSet(relation_->GetNumColumns(), [&](auto column_set_type) {
+        using ColumnSetType = typename decltype(column_set_type)::type;
+        std::unordered_set<ColumnSetType> agree_sets;
+        if (!identifier_sets.empty()) {
+            size_t const size = identifier_sets.size();
+            size_t const pairs_num = (size_t)(size * (size - 1) / 2);
+            double const percent_per_idset =
+                    (pairs_num == 0) ? algos::FDAlgorithm::kTotalProgressPercent
+                                     : algos::FDAlgorithm::kTotalProgressPercent / pairs_num;
+            auto back_it = std::prev(identifier_sets.end());
+            for (auto p = identifier_sets.begin(); p != back_it; ++p) {
+                for (auto q = std::next(p); q != identifier_sets.end(); ++q) {
+                    agree_sets.insert(p->template IntersectColumns<ColumnSetType>(*q));
+                    AddProgress(percent_per_idset);
+                }
             }
         }
-    }
-
-    return agree_sets;
+        return ToAgreeSets(agree_sets);
+    });
 }
 
 AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingMapOfIdSets() const {
-    SetOfAgreeSets agree_sets;
     std::unordered_map<int, IdentifierSet> identifier_sets;
     SetOfVectors const max_representation = GenPliMaxRepresentation();
 
@@ -138,127 +156,98 @@ AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingMapOfIdSets() const {
                     ? algos::FDAlgorithm::kTotalProgressPercent
                     : algos::FDAlgorithm::kTotalProgressPercent / max_representation.size();
 
-    if (config_.threads_num > 1) {
-        /* Not as fast and simple as it can be, need to use concurrent unordered_set.
-         * Without concurrent data structure need to create separate unordered_set<AgreeSet>
-         * for each thread, and as a consequence it is necessary to ensure the thread safety
-         * of threads_agree_sets initialization or to manually parallelize for loop over the
-         * max_representation. Leads to the bulky code with synchronization primitives or to
-         * the copying of util::ParallelForeach code.
-         */
-        std::map<std::thread::id, std::unordered_set<AgreeSet>> threads_agree_sets;
-        std::condition_variable map_init_cv;
-        bool map_initialized = false;
-        std::mutex map_init_mutex;
-        /* Need to know the exact number of threads used by util::ParallelForeach to identify
-         * when threads_agree_sets is initialized (when its size equals to the number
-         * of used threads).
-         * NOTE: if ParallelForeach fails to create exactly actual_threads_num threads when
-         *       threads_agree_sets.size() always will be not equal to actual_threads_num leading
-         *       to the infinite wait on cv.
-         */
-        unsigned short const actual_threads_num =
-                std::min(max_representation.size(), (size_t)config_.threads_num);
-        auto task = [&identifier_sets, &agree_sets, percent_per_cluster, actual_threads_num,
-                     &map_init_mutex, this, &threads_agree_sets, &map_init_cv,
-                     &map_initialized](SetOfVectors::value_type const& cluster) {
-            std::thread::id const thread_id = std::this_thread::get_id();
-
-            if (!map_initialized) {
-                std::unique_lock lock(map_init_mutex);
-                threads_agree_sets.insert({thread_id, std::unordered_set<AgreeSet>()});
-                if (threads_agree_sets.size() != actual_threads_num) {
-                    map_init_cv.wait(lock, [&map_initialized]() { return map_initialized; });
-                } else {
-                    map_initialized = true;
-                    map_init_cv.notify_all();
+    return DispatchColumnSet(relation_->GetNumColumns(), [&](auto column_set_type) {
+        using ColumnSetType = typename decltype(column_set_type)::type;
+        using SetOfColumnSets = std::unordered_set<ColumnSetType>;
+        SetOfColumnSets agree_sets;
+
+        if (config_.threads_num > 1) {
+            /* Every thread collects agree sets into its own set, the sets are merged afterwards */
+            std::vector<SetOfColumnSets> threads_agree_sets(config_.threads_num);
+            auto task = [&identifier_sets, percent_per_cluster, this, &threads_agree_sets](
+                                unsigned thread_index, SetOfVectors::value_type const& cluster) {
+                SetOfColumnSets& thread_agree_sets = threads_agree_sets[thread_index];
+                auto back_it = std::prev(cluster.cend());
+                for (auto p = cluster.cbegin(); p != back_it; ++p) {
+                    for (auto q = std::next(p); q != cluster.end(); ++q) {
+                        IdentifierSet const& id_set1 = identifier_sets.at(*p);
+                        IdentifierSet const& id_set2 = identifier_sets.at(*q);
+                        thread_agree_sets.insert(
+                                id_set1.template IntersectColumns<ColumnSetType>(id_set2));
+                    }
                 }
-            }
+                AddProgress(percent_per_cluster);
+            };
 
-            auto back_it = std::prev(cluster.cend());
-            for (auto p = cluster.cbegin(); p != back_it; ++p) {
-                for (auto q = std::next(p); q != cluster.end(); ++q) {
-                    IdentifierSet const& id_set1 = identifier_sets.at(*p);
-                    IdentifierSet const& id_set2 = identifier_sets.at(*q);
-                    threads_agree_sets[thread_id].insert(id_set1.Intersect(id_set2));
-                }
-            }
-            AddProgress(percent_per_cluster);
-        };
+            util::ParallelForeachByWorker(max_representation.begin(), max_representation.end(),
+                                          config_.threads_num, task);
 
-        util::ParallelForeach(max_representation.begin(), max_representation.end(),
-                              config_.threads_num, task);
-
-        for (auto& [thread_id, thread_as] : threads_agree_sets) {
-            agree_sets.insert(std::make_move_iterator(thread_as.begin()),
-                              std::make_move_iterator(thread_as.end()));
-        }
-    } else {
-        for (auto const& cluster : max_representation) {
-            auto back_it = std::prev(cluster.end());
-            for (auto p = cluster.begin(); p != back_it; ++p) {
-                for (auto q = std::next(p); q != cluster.end(); ++q) {
-                    IdentifierSet const& id_set1 = identifier_sets.at(*p);
-                    IdentifierSet const& id_set2 = identifier_sets.at(*q);
-                    agree_sets.insert(id_set1.Intersect(id_set2));
+            for (SetOfColumnSets& thread_agree_sets : threads_agree_sets) {
+                agree_sets.merge(thread_agree_sets);
+            }
+        } else {
+            for (auto const& cluster : max_representation) {
+                auto back_it = std::prev(cluster.end());
+                for (auto p = cluster.begin(); p != back_it; ++p) {
+                    for (auto q = std::next(p); q != cluster.end(); ++q) {
+                        IdentifierSet const& id_set1 = identifier_sets.at(*p);
+                        IdentifierSet const& id_set2 = identifier_sets.at(*q);
+                        agree_sets.insert(
+                                id_set1.template IntersectColumns<ColumnSetType>(id_set2));
+                    }
                 }
+                AddProgress(percent_per_cluster);
             }
-            AddProgress(percent_per_cluster);
         }
-    }
 
-    return agree_sets;
+        return ToAgreeSets(agree_sets);
+    });
 }
 
 AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingMcAndGetAgreeSets() const {
-    SetOfAgreeSets agree_sets;
     SetOfVectors const max_representation = GenPliMaxRepresentation();
 
     // Compute agree sets from maximal representation using GetAgreeSet()
     // ~3300 ms on CIPublicHighway700 (Debug build), ~250 ms (Release)
-    for (auto const& cluster : max_representation) {
-        for (auto p = cluster.begin(); p != cluster.end(); ++p) {
-            for (auto q = std::next(p); q != cluster.end(); ++q) {
-                agree_sets.insert(GetAgreeSet(*p, *q));
+    return DispatchColumnSet(relation_->GetNumColumns(), [&](auto column_set_type) {
+        using ColumnSetType = typename decltype(column_set_type)::type;
+        std::unordered_set<ColumnSetType> agree_sets;
+        for (auto const& cluster : max_representation) {
+            for (auto p = cluster.begin(); p != cluster.end(); ++p) {
+                for (auto q = std::next(p); q != cluster.end(); ++q) {
+                    agree_sets.insert(GetAgreeColumns<ColumnSetType>(*p, *q));
+                }
             }
         }
-    }
-
-    return agree_sets;
+        return ToAgreeSets(agree_sets);
+    });
 }
 
 AgreeSetFactory::SetOfAgreeSets AgreeSetFactory::GenAsUsingGetAgreeSets() const {
-    SetOfAgreeSets agree_sets;
     vector<ColumnData> const& columns_data = relation_->GetColumnData();
 
     // Compute agree sets from stripped partitions (simplest method by Wyss)
     // ~40436 ms on CIPublicHighway700 (Debug build)
-    for (ColumnData const& column_data : columns_data) {
-        PositionListIndex const* const pli = column_data.GetPositionListIndex();
-        for (vector<int> const& cluster : pli->GetIndex()) {
-            for (auto p = cluster.begin(); p != cluster.end(); ++p) {
-                for (auto q = std::next(p); q != cluster.end(); ++q) {
-                    agree_sets.insert(GetAgreeSet(*p, *q));
+    return DispatchColumnSet(relation_->GetNumColumns(), [&](auto column_set_type) {
+        using ColumnSetType = typename decltype(column_set_type)::type;
+        std::unordered_set<ColumnSetType> agree_sets;
+        for (ColumnData const& column_data : columns_data) {
+            PositionListIndex const* const pli = column_data.GetPositionListIndex();
+            for (PositionListIndex::ClusterView cluster : pli->GetIndex()) {
+                for (auto p = cluster.begin(); p != cluster.end(); ++p) {
+                    for (auto q = std::next(p); q != cluster.end(); ++q) {
+                        agree_sets.insert(GetAgreeColumns<ColumnSetType>(*p, *q));
+                    }
                 }
             }
         }
-    }
-
-    return agree_sets;
+        return ToAgreeSets(agree_sets);
+    });
 }
 
 AgreeSet AgreeSetFactory::GetAgreeSet(int const tuple1_index, int const tuple2_index) const {
-    std::vector<int> const tuple1 = relation_->GetTuple(tuple1_index);
-    std::vector<int> const tuple2 = relation_->GetTuple(tuple2_index);
-    boost::dynamic_bitset<> agree_set_indices(relation_->GetNumColumns());
-
-    for (size_t i = 0; i < agree_set_indices.size(); ++i) {
-        if (tuple1[i] != 0 && tuple1[i] == tuple2[i]) {
-            agree_set_indices.set(i);
-        }
-    }
-
-    return relation_->GetSchema()->GetVertical(agree_set_indices);
+    return relation_->GetSchema()->GetVertical(
+            GetAgreeColumns<boost::dynamic_bitset<>>(tuple1_index, tuple2_index));
 }
 
 AgreeSetFactory::SetOfVectors AgreeSetFactory::GenPliMaxRepresentation() const {
@@ -310,8 +299,10 @@ AgreeSetFactory::SetOfVectors AgreeSetFactory::GenMcUsingCalculateSupersets() co
         return max_representation;
     }
 
-    max_representation.insert(not_empty_pli->GetPositionListIndex()->GetIndex().begin(),
-                              not_empty_pli->GetPositionListIndex()->GetIndex().end());
+    for (PositionListIndex::ClusterView cluster :
+         not_empty_pli->GetPositionListIndex()->GetIndex()) {
+        max_representation.emplace(cluster);
+    }
 
     for (auto p = std::next(not_empty_pli); p != columns_data.end(); ++p) {
         PositionListIndex const* pli = p->GetPositionListIndex();
@@ -376,8 +367,9 @@ set<vector<int>, AgreeSetFactory::VectorComp> AgreeSetFactory::GenSortedEqvClass
 
     // Fill sorted_partitions
     for (ColumnData const& data : columns_data) {
-        std::deque<vector<int>> const& index = data.GetPositionListIndex()->GetIndex();
-        sorted_eqv_classes.insert(index.begin(), index.end());
+        for (PositionListIndex::ClusterView cluster : data.GetPositionListIndex()->GetIndex()) {
+            sorted_eqv_classes.emplace(cluster);
+        }
     }
 
     return sorted_eqv_classes;
@@ -418,14 +410,7 @@ AgreeSetFactory::SetOfVectors AgreeSetFactory::GenMcUsingHandlePartition() const
     return max_representation;
 }
 
-/* This code has false positive helgrind data race error in the unique_future-packaged_task
- * interaction. Also it is slow due to the way it enforces thread safety on index and
- * max_representation access (shared_mutex.lock/unlock). Need to fix it first with
- * concurrency hash map, check out libcds.
- */
 AgreeSetFactory::SetOfVectors AgreeSetFactory::GenMcParallel() const {
-    throw std::runtime_error("MCParallel max representation method is not implemented yet.");
-#if 0
     if (config_.threads_num == 1) {
         LOG(WARNING) << "Using parallel max representation generation"
                         " method with 1 thread specified";
@@ -436,56 +421,44 @@ AgreeSetFactory::SetOfVectors AgreeSetFactory::GenMcParallel() const {
         if (lhs.size() != rhs.size()) {
             return lhs.size() > rhs.size();
         }
-        return std::lexicographical_compare(lhs.begin(), lhs.end(),
-                                            rhs.begin(), rhs.end(),
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
                                             std::greater<int>());
     };
-    auto sorted_eqv_classes = genSortedEqvClasses(greater);
+    auto sorted_eqv_classes = GenSortedEqvClasses(greater);
+    // Same as in GenMcUsingHandlePartition()
     std::unordered_map<int, unordered_set<size_t>> index;
 
-    boost::asio::thread_pool pool(config_.threads_num);
-    boost::shared_mutex mutex;
-    auto handle_partition = [this, &index, &max_representation, &mutex]
-                            (vector<int>&& cur_eqv_class, size_t const eqv_class_index) {
-        boost::shared_lock read_lock(mutex);
-        bool is_subset = isSubset(cur_eqv_class, index);
-        if (!is_subset) {
-            read_lock.unlock();
-            // At every moment in time only one thread can modify index and max_representation
-            boost::unique_lock write_lock(mutex);
-
-            for (int tuple_index : cur_eqv_class) {
-                index[tuple_index].insert(eqv_class_index);
-            }
-            max_representation.insert(std::move(cur_eqv_class));
-        }
+    /* Distinct equivalence classes of the same size can't be subsets of each other, so they are
+     * checked against the index of the larger ones in parallel, without locking, and are added to
+     * the index afterwards */
+    vector<vector<int>> same_size_eqv_classes;
+    vector<char> is_subset;
+    auto check_eqv_class = [this, &index, &is_subset,
+                            &same_size_eqv_classes](vector<int> const& eqv_class) {
+        is_subset[&eqv_class - same_size_eqv_classes.data()] = IsSubset(eqv_class, index);
     };
-
-    using Task = boost::packaged_task<void>;
-    std::vector<boost::unique_future<Task::result_type>> futures;
     size_t eqv_class_index = 0;
-    size_t cur_size = 0;
-    for (auto it = sorted_eqv_classes.begin();
-         it != sorted_eqv_classes.end();
-         ++eqv_class_index) {
-        if (cur_size != it->size()) {
-            cur_size = it->size();
-            boost::wait_for_all(futures.begin(), futures.end());
-            futures.clear();
+    for (auto it = sorted_eqv_classes.begin(); it != sorted_eqv_classes.end();) {
+        size_t const size = it->size();
+        same_size_eqv_classes.clear();
+        while (it != sorted_eqv_classes.end() && it->size() == size) {
+            same_size_eqv_classes.push_back(std::move(sorted_eqv_classes.extract(it++).value()));
         }
 
-        Task t([eqv_class = std::move(sorted_eqv_classes.extract(it++).value()),
-                eqv_class_index, &handle_partition] () mutable
-                { handle_partition(std::move(eqv_class), eqv_class_index); }
-        );
-        futures.push_back(t.get_future());
-        boost::asio::post(pool, std::move(t));
-    }
+        is_subset.assign(same_size_eqv_classes.size(), false);
+        util::ParallelForeach(same_size_eqv_classes.begin(), same_size_eqv_classes.end(),
+                              config_.threads_num, check_eqv_class);
 
-    pool.join();
+        for (size_t i = 0; i < same_size_eqv_classes.size(); ++i, ++eqv_class_index) {
+            if (is_subset[i]) continue;
+            for (int tuple_index : same_size_eqv_classes[i]) {
+                index[tuple_index].insert(eqv_class_index);
+            }
+            max_representation.insert(std::move(same_size_eqv_classes[i]));
+        }
+    }
 
     return max_representation;
-#endif
 }
 
 bool AgreeSetFactory::IsSubset(vector<int> const& eqv_class,
@@ -546,13 +519,13 @@ void AgreeSetFactory::HandleEqvClass(vector<int>& eqv_class,
 
 void AgreeSetFactory::CalculateSupersets(
         std::unordered_set<std::vector<int>, boost::hash<std::vector<int>>>& max_representation,
-        std::deque<vector<int>> const& partition) const {
+        ClusterIndex const& partition) const {
     SetOfVectors to_add_to_mc;
     auto hash = [beg = max_representation.begin()](SetOfVectors::const_iterator it) {
         return std::distance<SetOfVectors::const_iterator>(beg, it);
     };
     unordered_set<SetOfVectors::const_iterator, decltype(hash)> to_delete_from_mc(1, hash);
-    set<std::deque<vector<int>>::const_iterator> to_exclude_from_partition;
+    set<ClusterIndex::const_iterator> to_exclude_from_partition;
 
     for (auto it = max_representation.begin(); it != max_representation.end(); ++it) {
         for (auto p = partition.begin();
@@ -561,19 +534,20 @@ void AgreeSetFactory::CalculateSupersets(
                 continue;
             }
 
-            if (it->size() >= p->size() &&
-                std::includes(it->begin(), it->end(), p->begin(), p->end())) {
-                to_add_to_mc.erase(*p);
+            PositionListIndex::ClusterView const cluster = *p;
+            if (it->size() >= cluster.size() &&
+                std::includes(it->begin(), it->end(), cluster.begin(), cluster.end())) {
+                to_add_to_mc.erase(vector<int>(cluster));
                 to_exclude_from_partition.insert(p);
                 break;
             }
 
-            if (p->size() >= it->size() &&
-                std::includes(p->begin(), p->end(), it->begin(), it->end())) {
+            if (cluster.size() >= it->size() &&
+                std::includes(cluster.begin(), cluster.end(), it->begin(), it->end())) {
                 to_delete_from_mc.insert(it);
             }
 
-            to_add_to_mc.insert(*p);
+            to_add_to_mc.emplace(cluster);
         }
     }
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <deque>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -9,7 +8,9 @@
 #include <boost/functional/hash.hpp>
 
 #include "algorithms/fd/fd_algorithm.h"
+#include "model/table/cluster_index.h"
 #include "model/table/column_layout_relation_data.h"
+#include "model/table/column_set.h"
 #include "model/table/vertical.h"
 #include "util/custom_hashes.h"
 
@@ -105,8 +106,10 @@ enum class MCGenMethod {
                                *     max_representation.
                                */
     kParallel                 /*< Algorithm is the same as in kUsingHandlePartition method.
-                               *  Uses thread pool of config_.threads_num threads to perform
-                               *  'handlePartition' part on equivalence classes of the same size.
+                               *  Performs 'handlePartition' part on equivalence classes of the
+                               *  same size on config_.threads_num threads: such classes can't be
+                               *  subsets of each other, so they are checked against the index
+                               *  at once and added to it afterwards.
                                */
 };
 
@@ -157,6 +160,13 @@ public:
     AgreeSet GetAgreeSet(int const tuple1_index, int const tuple2_index) const;
 
 private:
+    /* Agree sets are collected as ColumnSetType and turned into Verticals once deduplicated, so
+     * that every pair of tuples doesn't allocate with narrow schemas. See DispatchColumnSet */
+    template <typename ColumnSetType>
+    ColumnSetType GetAgreeColumns(int tuple1_index, int tuple2_index) const;
+    template <typename ColumnSetType>
+    SetOfAgreeSets ToAgreeSets(std::unordered_set<ColumnSetType> const& column_sets) const;
+
     /* Implementations of generation agree sets algorithms */
     SetOfAgreeSets GenAsUsingVectorOfIdSets() const;
     SetOfAgreeSets GenAsUsingMapOfIdSets() const;
@@ -171,7 +181,7 @@ private:
 
     void CalculateSupersets(
             std::unordered_set<std::vector<int>, boost::hash<std::vector<int>>>& max_representation,
-            std::deque<std::vector<int>> const& partition) const;
+            ClusterIndex const& partition) const;
     /* From Metanome: `handleList`.
      * Extremely slow for anything big eqv_class,
      * I think it is not usable at all
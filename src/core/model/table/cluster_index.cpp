@@ -0,0 +1,44 @@
+/** \file
+ * \brief Cluster index
+ *
+ * ClusterIndex methods definition
+ */
+#include "cluster_index.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace model {
+
+void ClusterIndex::SortClusters() {
+    assert(!is_view_);
+    std::vector<unsigned> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    auto first_position = [this](unsigned cluster_index) {
+        return positions_[offsets_[cluster_index]];
+    };
+    if (std::is_sorted(order.begin(), order.end(), [&](unsigned lhs, unsigned rhs) {
+            return first_position(lhs) < first_position(rhs);
+        })) {
+        return;
+    }
+    /* Row ids are unique across clusters, so first row ids give a strict order */
+    std::sort(order.begin(), order.end(), [&](unsigned lhs, unsigned rhs) {
+        return first_position(lhs) < first_position(rhs);
+    });
+
+    std::pmr::vector<int> positions(GetResource());
+    std::pmr::vector<unsigned> offsets(GetResource());
+    positions.reserve(positions_.size());
+    offsets.reserve(offsets_.size());
+    offsets.push_back(0);
+    for (unsigned cluster_index : order) {
+        positions.insert(positions.end(), positions_.begin() + offsets_[cluster_index],
+                         positions_.begin() + offsets_[cluster_index + 1]);
+        offsets.push_back(positions.size());
+    }
+    positions_ = std::move(positions);
+    offsets_ = std::move(offsets);
+}
+
+}  // namespace model
@@ -0,0 +1,320 @@
+/** \file
+ * \brief Cluster index
+ *
+ * Definition of the ClusterIndex class, the flat storage of PositionListIndex clusters.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace model {
+
+///
+/// \brief read-only or mutable view of one cluster in a ClusterIndex
+///
+/// \note Behaves like std::span and can be explicitly converted to std::vector<int>, so clusters
+///       can still be copied into containers of vectors, e.g. `std::set<std::vector<int>>`.
+///
+template <typename T>
+class ClusterView : public std::span<T> {
+public:
+    using std::span<T>::span;
+
+    constexpr ClusterView(std::span<T> span) noexcept : std::span<T>(span) {}
+
+    explicit operator std::vector<int>() const {
+        return std::vector<int>(this->begin(), this->end());
+    }
+};
+
+///
+/// \brief clusters of a PositionListIndex in compressed sparse row layout
+///
+/// Row ids of all clusters are stored back to back in one array, and cluster i occupies
+/// [offsets_[i], offsets_[i + 1]) in it. An index therefore costs two allocations however many
+/// clusters it has, and iterating over it walks memory sequentially. Both arrays are allocated
+/// from a std::pmr::memory_resource, so an algorithm can serve all of its PLIs from its own pool.
+///
+/// An index can also be a read-only view of the arrays stored elsewhere, e.g. in a mapped
+/// snapshot, see View. Only the const methods may be called on a view.
+///
+class ClusterIndex {
+public:
+    using Cluster = ClusterView<int>;
+    using ConstCluster = ClusterView<int const>;
+
+    /// random access iterator over clusters, dereferences to a view
+    template <bool IsConst>
+    class Iterator {
+        using Position = std::conditional_t<IsConst, int const, int>;
+
+        template <bool>
+        friend class Iterator;
+
+        Position* positions_ = nullptr;
+        unsigned const* offset_ = nullptr;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        /* Views are returned by value, so for legacy algorithms this is an input iterator */
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ClusterView<Position>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;
+        using pointer = void;
+
+        Iterator() = default;
+
+        Iterator(Position* positions, unsigned const* offset) noexcept
+            : positions_(positions), offset_(offset) {}
+
+        template <bool OtherIsConst>
+            requires(IsConst && !OtherIsConst)
+        Iterator(Iterator<OtherIsConst> const& other) noexcept
+            : positions_(other.positions_), offset_(other.offset_) {}
+
+        reference operator*() const noexcept {
+            return {positions_ + offset_[0], positions_ + offset_[1]};
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        Iterator& operator++() noexcept {
+            ++offset_;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator copy = *this;
+            ++offset_;
+            return copy;
+        }
+
+        Iterator& operator--() noexcept {
+            --offset_;
+            return *this;
+        }
+
+        Iterator operator--(int) noexcept {
+            Iterator copy = *this;
+            --offset_;
+            return copy;
+        }
+
+        Iterator& operator+=(difference_type n) noexcept {
+            offset_ += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) noexcept {
+            offset_ -= n;
+            return *this;
+        }
+
+        friend Iterator operator+(Iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator+(difference_type n, Iterator it) noexcept {
+            return it += n;
+        }
+
+        friend Iterator operator-(Iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(Iterator const& lhs, Iterator const& rhs) noexcept {
+            return lhs.offset_ - rhs.offset_;
+        }
+
+        friend bool operator==(Iterator const& lhs, Iterator const& rhs) noexcept {
+            return lhs.offset_ == rhs.offset_;
+        }
+
+        friend auto operator<=>(Iterator const& lhs, Iterator const& rhs) noexcept {
+            return lhs.offset_ <=> rhs.offset_;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using value_type = ConstCluster;
+    using size_type = std::size_t;
+
+private:
+    std::pmr::vector<int> positions_;
+    /* offsets_.size() == size() + 1, offsets_.front() == 0 */
+    std::pmr::vector<unsigned> offsets_;
+    /* Used instead of the vectors by a view, the owner keeps the arrays alive */
+    bool is_view_ = false;
+    std::span<int const> view_positions_;
+    std::span<unsigned const> view_offsets_;
+    std::shared_ptr<void const> view_owner_;
+
+    [[nodiscard]] std::span<unsigned const> GetOffsets() const noexcept {
+        return is_view_ ? view_offsets_ : std::span<unsigned const>(offsets_);
+    }
+
+public:
+    explicit ClusterIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : positions_(resource), offsets_(1, 0, resource) {}
+
+    /// copy clusters built elsewhere, e.g. by a hash-based grouping
+    template <typename Clusters>
+    static ClusterIndex FromClusters(
+            Clusters const& clusters,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        ClusterIndex index(resource);
+        size_t num_positions = 0;
+        for (auto const& cluster : clusters) {
+            num_positions += cluster.size();
+        }
+        index.Reserve(num_positions, clusters.size());
+        for (auto const& cluster : clusters) {
+            index.Append(cluster.begin(), cluster.end());
+        }
+        return index;
+    }
+
+    /// view of clusters stored elsewhere in the layout of GetPositions and of the cluster
+    /// offsets, `offsets` must start with 0 and end with positions.size()
+    /// \param owner keeps the arrays alive while the view or its copies exist
+    static ClusterIndex View(std::span<int const> positions, std::span<unsigned const> offsets,
+                             std::shared_ptr<void const> owner) {
+        assert(!offsets.empty() && offsets.front() == 0 && offsets.back() == positions.size());
+        ClusterIndex index;
+        index.is_view_ = true;
+        index.view_positions_ = positions;
+        index.view_offsets_ = offsets;
+        index.view_owner_ = std::move(owner);
+        return index;
+    }
+
+    [[nodiscard]] bool IsView() const noexcept {
+        return is_view_;
+    }
+
+    void Reserve(size_t num_positions, size_t num_clusters) {
+        assert(!is_view_);
+        positions_.reserve(num_positions);
+        offsets_.reserve(num_clusters + 1);
+    }
+
+    /// append a cluster with row ids [first, last)
+    template <typename It>
+    void Append(It first, It last) {
+        assert(!is_view_);
+        positions_.insert(positions_.end(), first, last);
+        offsets_.push_back(positions_.size());
+    }
+
+    /// append one row id to the cluster that is being built, see CloseCluster
+    void AppendPosition(int position) {
+        assert(!is_view_);
+        positions_.push_back(position);
+    }
+
+    /// finish the cluster of row ids appended since the previous cluster
+    void CloseCluster() {
+        assert(!is_view_);
+        assert(positions_.size() > offsets_.back());
+        offsets_.push_back(positions_.size());
+    }
+
+    /// append a cluster of `size` row ids to be filled in later through GetPositions
+    /// \return index of the first row id of the new cluster
+    size_t AppendCluster(size_t size) {
+        assert(!is_view_);
+        size_t const first = positions_.size();
+        positions_.resize(first + size);
+        offsets_.push_back(positions_.size());
+        return first;
+    }
+
+    /// sort clusters by their first row id, the canonical order of PLI clusters
+    void SortClusters();
+
+    [[nodiscard]] size_t size() const noexcept {
+        return GetOffsets().size() - 1;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /// total number of row ids in all clusters
+    [[nodiscard]] size_t GetNumPositions() const noexcept {
+        return GetPositions().size();
+    }
+
+    /// row ids of all clusters, cluster after cluster
+    [[nodiscard]] std::span<int const> GetPositions() const noexcept {
+        return is_view_ ? view_positions_ : std::span<int const>(positions_);
+    }
+
+    [[nodiscard]] std::span<int> GetPositions() noexcept {
+        assert(!is_view_);
+        return positions_;
+    }
+
+    /// memory allocated for the clusters, none for a view
+    [[nodiscard]] size_t GetBytes() const noexcept {
+        return positions_.capacity() * sizeof(int) + offsets_.capacity() * sizeof(unsigned);
+    }
+
+    [[nodiscard]] std::pmr::memory_resource* GetResource() const noexcept {
+        return positions_.get_allocator().resource();
+    }
+
+    [[nodiscard]] iterator begin() noexcept {
+        assert(!is_view_);
+        return {positions_.data(), offsets_.data()};
+    }
+
+    [[nodiscard]] iterator end() noexcept {
+        assert(!is_view_);
+        return {positions_.data(), offsets_.data() + size()};
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return {GetPositions().data(), GetOffsets().data()};
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return {GetPositions().data(), GetOffsets().data() + size()};
+    }
+
+    [[nodiscard]] Cluster operator[](size_t cluster_index) noexcept {
+        return begin()[cluster_index];
+    }
+
+    [[nodiscard]] ConstCluster operator[](size_t cluster_index) const noexcept {
+        return begin()[cluster_index];
+    }
+
+    [[nodiscard]] ConstCluster front() const noexcept {
+        return *begin();
+    }
+
+    [[nodiscard]] ConstCluster back() const noexcept {
+        return begin()[size() - 1];
+    }
+
+    friend bool operator==(ClusterIndex const& lhs, ClusterIndex const& rhs) {
+        return std::ranges::equal(lhs.GetOffsets(), rhs.GetOffsets()) &&
+               std::ranges::equal(lhs.GetPositions(), rhs.GetPositions());
+    }
+};
+
+}  // namespace model
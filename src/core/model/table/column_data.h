@@ -21,7 +21,7 @@ public:
     }
 
     // Инвариант: конструктором гарантируется, что в ColumnData.PLI есть закешированная ProbingTable
-    std::vector<int> const& GetProbingTable() const {
+    model::PLI::ProbingTable GetProbingTable() const {
         return *position_list_index_->GetCachedProbingTable();
     }
 
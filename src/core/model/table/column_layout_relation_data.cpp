@@ -4,11 +4,200 @@
 //
 #include "column_layout_relation_data.h"
 
-#include <map>
+#include <algorithm>
+#include <cassert>
+#include <functional>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <utility>
 
-#include <easylogging++.h>
+#include "model/table/relation_snapshot.h"
+#include "util/parallel_for.h"
+
+namespace {
+
+/* Transparent hashing lets batch values be looked up without building a std::string */
+struct StringHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+/* A part of the table encoded with its own dictionary. Value ids are assigned in the order the
+ * values first appear in the part, starting from 1, so the dictionary of a part that is the
+ * whole table is exactly the dictionary of the table */
+struct EncodedChunk {
+    std::unordered_map<std::string, int, StringHash, std::equal_to<>> value_dictionary;
+    /* values[id - 1] is the value encoded with id */
+    std::vector<std::string const*> values;
+    std::vector<std::vector<int>> column_vectors;
+    size_t num_rows = 0;
+};
+
+void EncodeChunk(model::IDatasetStream& data_stream, size_t num_columns, EncodedChunk& chunk) {
+    int const null_value_id = ColumnLayoutRelationData::kNullValueId;
+    chunk.column_vectors.resize(num_columns);
+    model::DatasetBatch batch;
+
+    while (data_stream.GetNextBatch(model::DatasetBatch::kDefaultNumRows, batch) != 0) {
+        /* Row by row, so that value ids are assigned in the order values appear in the table */
+        for (size_t row_index = 0; row_index < batch.GetNumRows(); ++row_index) {
+            for (size_t index = 0; index < num_columns; ++index) {
+                std::string_view const field = batch.GetValue(row_index, index);
+                if (field.empty()) {
+                    chunk.column_vectors[index].push_back(null_value_id);
+                } else {
+                    auto location = chunk.value_dictionary.find(field);
+                    int value_id;
+                    if (location == chunk.value_dictionary.end()) {
+                        value_id = static_cast<int>(chunk.values.size()) + 1;
+                        location = chunk.value_dictionary.emplace(field, value_id).first;
+                        chunk.values.push_back(&location->first);
+                    } else {
+                        value_id = location->second;
+                    }
+                    chunk.column_vectors[index].push_back(value_id);
+                }
+            }
+        }
+        chunk.num_rows += batch.GetNumRows();
+    }
+}
+
+/* Merges the dictionaries of consecutive parts of the table and rewrites their columns with the
+ * merged ids. Parts are merged in table order, so every value gets the same id the serial
+ * encoding of the whole table would give it */
+std::vector<std::vector<int>> MergeChunks(std::vector<EncodedChunk>& chunks, size_t num_columns,
+                                          unsigned threads) {
+    std::unordered_map<std::string_view, int> value_dictionary;
+    std::vector<std::vector<int>> id_maps(chunks.size());
+    int next_value_id = 1;
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        EncodedChunk const& chunk = chunks[chunk_index];
+        std::vector<int>& id_map = id_maps[chunk_index];
+        id_map.reserve(chunk.values.size() + 1);
+        id_map.push_back(ColumnLayoutRelationData::kNullValueId);
+        for (std::string const* value : chunk.values) {
+            auto [location, inserted] = value_dictionary.try_emplace(*value, next_value_id);
+            if (inserted) {
+                next_value_id++;
+            }
+            id_map.push_back(location->second);
+        }
+    }
+
+    std::vector<size_t> row_offsets(chunks.size() + 1, 0);
+    for (size_t chunk_index = 0; chunk_index < chunks.size(); ++chunk_index) {
+        row_offsets[chunk_index + 1] = row_offsets[chunk_index] + chunks[chunk_index].num_rows;
+    }
+    std::vector<std::vector<int>> column_vectors(num_columns,
+                                                 std::vector<int>(row_offsets.back()));
+
+    std::vector<size_t> chunk_indices(chunks.size());
+    std::iota(chunk_indices.begin(), chunk_indices.end(), 0);
+    util::ParallelForeach(
+            chunk_indices.begin(), chunk_indices.end(), threads, [&](size_t chunk_index) {
+                std::vector<int> const& id_map = id_maps[chunk_index];
+                EncodedChunk& chunk = chunks[chunk_index];
+                for (size_t index = 0; index < num_columns; ++index) {
+                    auto out = column_vectors[index].begin() + row_offsets[chunk_index];
+                    for (int value_id : chunk.column_vectors[index]) {
+                        *out++ = value_id == ColumnLayoutRelationData::kNullValueId
+                                         ? value_id
+                                         : id_map[value_id];
+                    }
+                    chunk.column_vectors[index] = {};
+                }
+            });
+    return column_vectors;
+}
+
+/* Same ids as EncodeChunk gives for a stream of these rows. The dictionary only refers to the
+ * values, so nothing is copied */
+std::vector<std::vector<int>> EncodeColumns(std::vector<std::vector<std::string>> const& columns) {
+    int const null_value_id = ColumnLayoutRelationData::kNullValueId;
+    size_t const num_rows = columns.empty() ? 0 : columns.front().size();
+    std::unordered_map<std::string_view, int> value_dictionary;
+    std::vector<std::vector<int>> column_vectors(columns.size(), std::vector<int>(num_rows));
+    int next_value_id = 1;
+    for (size_t row_index = 0; row_index < num_rows; ++row_index) {
+        for (size_t index = 0; index < columns.size(); ++index) {
+            std::string const& field = columns[index][row_index];
+            if (field.empty()) {
+                column_vectors[index][row_index] = null_value_id;
+            } else {
+                auto [location, inserted] = value_dictionary.try_emplace(field, next_value_id);
+                if (inserted) {
+                    next_value_id++;
+                }
+                column_vectors[index][row_index] = location->second;
+            }
+        }
+    }
+    return column_vectors;
+}
+
+/* Probing table read from a snapshot, that keeps the mapping alive */
+struct MappedTable {
+    std::shared_ptr<void const> file;
+    model::PLI::ProbingTable table;
+};
+
+/* The file, how it is parsed and how nulls are compared. The column names are hashed too, they
+ * tell apart tables of streams that report no format */
+std::uint64_t ChecksumSource(model::IDatasetStream const& data_stream, bool is_null_eq_null) {
+    std::filesystem::path const source_path = data_stream.GetSourcePath();
+    if (source_path.empty()) {
+        throw std::runtime_error("Snapshots can only be made of tables read from files");
+    }
+    std::uint64_t checksum = model::snapshot::ChecksumFile(source_path);
+    checksum = model::snapshot::ChecksumBytes(checksum, data_stream.GetSourceFormat());
+    checksum = model::snapshot::ChecksumBytes(checksum, is_null_eq_null ? "1" : "0");
+    for (size_t i = 0; i < data_stream.GetNumberOfColumns(); ++i) {
+        std::string const column_name = data_stream.GetColumnName(i);
+        /* So that the names can't be split differently */
+        checksum = model::snapshot::ChecksumBytes(checksum, std::string_view("\0", 1));
+        checksum = model::snapshot::ChecksumBytes(checksum, column_name);
+    }
+    return checksum;
+}
+
+std::unique_ptr<ColumnLayoutRelationData> Assemble(std::string const& relation_name,
+                                                   std::vector<std::string> const& column_names,
+                                                   std::vector<std::vector<int>> column_vectors,
+                                                   bool is_null_eq_null, unsigned threads,
+                                                   bool compress_plis) {
+    size_t const num_columns = column_names.size();
+    auto schema = std::make_unique<RelationalSchema>(relation_name);
+    std::vector<std::unique_ptr<model::PositionListIndex>> plis(num_columns);
+    std::vector<size_t> column_indices(num_columns);
+    std::iota(column_indices.begin(), column_indices.end(), 0);
+    util::ParallelForeach(column_indices.begin(), column_indices.end(), threads, [&](size_t i) {
+        plis[i] = model::PositionListIndex::CreateFor(column_vectors[i], is_null_eq_null);
+        if (compress_plis) {
+            plis[i]->Compress();
+        }
+    });
+
+    std::vector<ColumnData> column_data;
+    for (size_t i = 0; i < num_columns; ++i) {
+        auto column = Column(schema.get(), column_names[i], i);
+        schema->AppendColumn(std::move(column));
+        column_data.emplace_back(schema->GetColumn(i), std::move(plis[i]));
+    }
+
+    schema->Init();
+
+    return std::make_unique<ColumnLayoutRelationData>(std::move(schema), std::move(column_data));
+}
+
+}  // namespace
 
 std::vector<int> ColumnLayoutRelationData::GetTuple(int tuple_index) const {
     int num_columns = schema_->GetNumColumns();
@@ -20,48 +209,137 @@ std::vector<int> ColumnLayoutRelationData::GetTuple(int tuple_index) const {
 }
 
 std::unique_ptr<ColumnLayoutRelationData> ColumnLayoutRelationData::CreateFrom(
-        model::IDatasetStream& data_stream, bool is_null_eq_null) {
-    auto schema = std::make_unique<RelationalSchema>(data_stream.GetRelationName());
-    std::unordered_map<std::string, int> value_dictionary;
-    int next_value_id = 1;
-    int const null_value_id = kNullValueId;
+        model::IDatasetStream& data_stream, bool is_null_eq_null, unsigned threads,
+        bool compress_plis) {
+    assert(threads != 0);
     size_t const num_columns = data_stream.GetNumberOfColumns();
-    std::vector<std::vector<int>> column_vectors = std::vector<std::vector<int>>(num_columns);
-    std::vector<std::string> row;
+    std::vector<std::vector<int>> column_vectors;
 
-    while (data_stream.HasNextRow()) {
-        row = data_stream.GetNextRow();
+    std::vector<std::unique_ptr<model::IDatasetStream>> parts;
+    if (threads > 1) {
+        parts = data_stream.SplitIntoChunks(threads);
+    }
+    if (parts.size() <= 1) {
+        EncodedChunk chunk;
+        EncodeChunk(parts.empty() ? data_stream : *parts.front(), num_columns, chunk);
+        column_vectors = std::move(chunk.column_vectors);
+    } else {
+        std::vector<EncodedChunk> chunks(parts.size());
+        std::vector<size_t> chunk_indices(parts.size());
+        std::iota(chunk_indices.begin(), chunk_indices.end(), 0);
+        util::ParallelForeach(chunk_indices.begin(), chunk_indices.end(), threads,
+                              [&](size_t chunk_index) {
+                                  EncodeChunk(*parts[chunk_index], num_columns,
+                                              chunks[chunk_index]);
+                              });
+        column_vectors = MergeChunks(chunks, num_columns, threads);
+    }
 
-        if (row.size() != num_columns) {
-            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
-                         << num_columns << ", got " << row.size() << ")";
-            continue;
-        }
+    std::vector<std::string> column_names;
+    for (size_t i = 0; i < num_columns; ++i) {
+        column_names.push_back(data_stream.GetColumnName(i));
+    }
+    return Assemble(data_stream.GetRelationName(), column_names, std::move(column_vectors),
+                    is_null_eq_null, threads, compress_plis);
+}
 
-        for (size_t index = 0; index < row.size(); ++index) {
-            std::string const& field = row[index];
-            if (field.empty()) {
-                column_vectors[index].push_back(null_value_id);
-            } else {
-                auto location = value_dictionary.find(field);
-                int value_id;
-                if (location == value_dictionary.end()) {
-                    value_dictionary[field] = next_value_id;
-                    value_id = next_value_id;
-                    next_value_id++;
-                } else {
-                    value_id = location->second;
-                }
-                column_vectors[index].push_back(value_id);
-            }
+std::unique_ptr<ColumnLayoutRelationData> ColumnLayoutRelationData::CreateFrom(
+        std::string const& relation_name, std::vector<std::string> const& column_names,
+        std::vector<std::vector<std::string>> const& columns, bool is_null_eq_null,
+        unsigned threads, bool compress_plis) {
+    assert(threads != 0);
+    assert(column_names.size() == columns.size());
+    return Assemble(relation_name, column_names, EncodeColumns(columns), is_null_eq_null,
+                    threads, compress_plis);
+}
+
+std::unique_ptr<ColumnLayoutRelationData> ColumnLayoutRelationData::CreateWithSnapshot(
+        model::IDatasetStream& data_stream, std::filesystem::path const& snapshot_path,
+        bool is_null_eq_null, unsigned threads) {
+    std::uint64_t const checksum = ChecksumSource(data_stream, is_null_eq_null);
+    if (std::filesystem::exists(snapshot_path)) {
+        try {
+            return ReadSnapshot(snapshot_path, checksum, is_null_eq_null);
+        } catch (std::runtime_error const&) {
+            /* Made from another table or with another setting, it is replaced */
         }
     }
+    auto relation = CreateFrom(data_stream, is_null_eq_null, threads);
+    relation->WriteSnapshot(snapshot_path, checksum, is_null_eq_null);
+    return relation;
+}
+
+void ColumnLayoutRelationData::WriteSnapshot(std::filesystem::path const& path,
+                                             std::uint64_t source_checksum,
+                                             bool is_null_eq_null) const {
+    using model::snapshot::SnapshotWriter;
+    SnapshotWriter writer(path, model::snapshot::Kind::kColumnLayout, source_checksum,
+                          is_null_eq_null);
+    writer.WriteString(schema_->GetName());
+    writer.Write<std::uint64_t>(GetNumColumns());
+    for (ColumnData const& column_data : column_data_) {
+        model::PositionListIndex const& pli = *column_data.GetPositionListIndex();
+        writer.WriteString(column_data.GetColumn()->GetName());
+        writer.Write(pli.GetSize());
+        writer.Write(pli.GetEntropy());
+        writer.Write(pli.GetNepAsLong());
+        writer.Write(pli.GetRelationSize());
+        writer.Write(pli.GetOriginalRelationSize());
+        writer.Write(pli.GetInvertedEntropy());
+        writer.Write(pli.GetGiniImpurity());
+        writer.WriteArray(pli.GetNullCluster());
+        /* Clusters are stored in the layout of model::ClusterIndex, so that they can be read
+         * without a copy */
+        std::vector<unsigned> offsets = {0};
+        std::vector<int> positions;
+        positions.reserve(pli.GetSize());
+        pli.ForEachCluster([&offsets, &positions](model::PLI::ClusterView cluster) {
+            positions.insert(positions.end(), cluster.begin(), cluster.end());
+            offsets.push_back(positions.size());
+        });
+        writer.WriteArray(offsets);
+        writer.WriteArray(positions);
+        writer.WriteArray(column_data.GetProbingTable());
+    }
+    writer.Finish();
+}
+
+std::unique_ptr<ColumnLayoutRelationData> ColumnLayoutRelationData::ReadSnapshot(
+        std::filesystem::path const& path, std::uint64_t source_checksum, bool is_null_eq_null) {
+    using model::snapshot::SnapshotReader;
+    SnapshotReader reader(path, model::snapshot::Kind::kColumnLayout, source_checksum,
+                          is_null_eq_null);
+    auto schema = std::make_unique<RelationalSchema>(std::string(reader.ReadString()));
+    auto const num_columns = reader.Read<std::uint64_t>();
+    /* Clusters and probing tables refer to the mapped file, which they keep alive */
+    std::shared_ptr<void const> const file = reader.GetFile();
 
     std::vector<ColumnData> column_data;
     for (size_t i = 0; i < num_columns; ++i) {
-        auto column = Column(schema.get(), data_stream.GetColumnName(i), i);
-        schema->AppendColumn(std::move(column));
-        auto pli = model::PositionListIndex::CreateFor(column_vectors[i], is_null_eq_null);
+        schema->AppendColumn(Column(schema.get(), std::string(reader.ReadString()), i));
+        auto const size = reader.Read<unsigned int>();
+        auto const entropy = reader.Read<double>();
+        auto const nep = reader.Read<unsigned long long>();
+        auto const relation_size = reader.Read<unsigned int>();
+        auto const original_relation_size = reader.Read<unsigned int>();
+        auto const inverted_entropy = reader.Read<double>();
+        auto const gini_impurity = reader.Read<double>();
+        auto null_cluster = reader.ReadArray<int>();
+        auto const offsets = reader.ViewArray<unsigned>();
+        auto const positions = reader.ViewArray<int>();
+        auto const probing_table = reader.ViewArray<int>();
+        if (probing_table.size() != original_relation_size || offsets.empty() ||
+            offsets.front() != 0 || offsets.back() != positions.size() ||
+            !std::ranges::is_sorted(offsets)) {
+            throw std::runtime_error("Snapshot " + path.string() + " is corrupted");
+        }
+
+        auto pli = std::make_unique<model::PositionListIndex>(
+                model::ClusterIndex::View(positions, offsets, file), std::move(null_cluster),
+                size, entropy, nep, relation_size, original_relation_size, inverted_entropy,
+                gini_impurity);
+        auto mapped_table = std::make_shared<MappedTable const>(file, probing_table);
+        pli->CacheProbingTable({mapped_table, &mapped_table->table});
         column_data.emplace_back(schema->GetColumn(i), std::move(pli));
     }
 
@@ -6,6 +6,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
 #include <vector>
 
 #include "column_data.h"
@@ -28,6 +31,42 @@ public:
 
     [[nodiscard]] std::vector<int> GetTuple(int tuple_index) const;
 
+    /* With threads > 1 streams that support IDatasetStream::SplitIntoChunks are encoded in
+     * parallel, and the position list indexes of the columns are built concurrently. The result
+     * does not depend on the number of threads.
+     * With compress_plis every column PLI is compressed as soon as it is built, see
+     * model::PositionListIndex::Compress, so the uncompressed ones never coexist. The probing
+     * tables of the columns are kept as they are. Only for algorithms that walk the clusters of
+     * column PLIs with ForEachCluster */
     static std::unique_ptr<ColumnLayoutRelationData> CreateFrom(model::IDatasetStream& data_stream,
-                                                                bool is_null_eq_null);
+                                                                bool is_null_eq_null,
+                                                                unsigned threads = 1,
+                                                                bool compress_plis = false);
+    /* Encodes a table that is already in memory, columns[i] holds the values of the column
+     * named column_names[i]. Gives the same relation as CreateFrom of a stream of these rows */
+    static std::unique_ptr<ColumnLayoutRelationData> CreateFrom(
+            std::string const& relation_name, std::vector<std::string> const& column_names,
+            std::vector<std::vector<std::string>> const& columns, bool is_null_eq_null,
+            unsigned threads = 1, bool compress_plis = false);
+
+    /* Reads the relation from the snapshot at snapshot_path if it was made from the same file
+     * as data_stream reads, parsed the same way, and with the same is_null_eq_null. Otherwise
+     * creates the relation from data_stream and writes the snapshot there. The PLIs and probing
+     * tables of a read relation refer to the mapped snapshot.
+     * Throws std::runtime_error if data_stream is not read from a file, see
+     * model::IDatasetStream::GetSourcePath */
+    static std::unique_ptr<ColumnLayoutRelationData> CreateWithSnapshot(
+            model::IDatasetStream& data_stream, std::filesystem::path const& snapshot_path,
+            bool is_null_eq_null, unsigned threads = 1);
+
+    /* Write the relation to a binary snapshot that ReadSnapshot can load without parsing the
+     * table again. source_checksum identifies the table (see model::snapshot::ChecksumFile),
+     * is_null_eq_null must be the value the relation was created with */
+    void WriteSnapshot(std::filesystem::path const& path, std::uint64_t source_checksum,
+                       bool is_null_eq_null) const;
+    /* Throws std::runtime_error if the snapshot was made from another table or with another
+     * is_null_eq_null. The PLIs and probing tables refer to the mapped snapshot */
+    static std::unique_ptr<ColumnLayoutRelationData> ReadSnapshot(
+            std::filesystem::path const& path, std::uint64_t source_checksum,
+            bool is_null_eq_null);
 };
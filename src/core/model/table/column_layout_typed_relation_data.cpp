@@ -1,42 +1,154 @@
 #include "column_layout_typed_relation_data.h"
 
-#include <easylogging++.h>
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model/table/relation_loader.h"
+#include "model/table/relation_snapshot.h"
+#include "util/parallel_for.h"
 
 namespace model {
 
+namespace {
+
+/* Text of a value that the type of the value parses back to exactly the same value */
+std::string ValueToSnapshotString(TypedColumnData const& column, size_t index) {
+    if (column.GetValueTypeId(index) != +TypeId::kDouble) {
+        return column.GetDataAsString(index);
+    }
+    /* DoubleType::ValueToString rounds, the shortest round-trip form does not */
+    std::byte const* value = column.GetValue(index);
+    if (MixedType const* mixed = column.GetIfMixed(); mixed != nullptr) {
+        value = mixed->RetrieveValue(value);
+    }
+    std::array<char, 32> text;
+    auto const result = std::to_chars(text.data(), text.data() + text.size(),
+                                      Type::GetValue<Double>(value));
+    return {text.data(), result.ptr};
+}
+
+}  // namespace
+
 std::unique_ptr<ColumnLayoutTypedRelationData> ColumnLayoutTypedRelationData::CreateFrom(
-        IDatasetStream& data_stream, bool is_null_eq_null) {
-    auto schema = std::make_unique<RelationalSchema>(data_stream.GetRelationName());
-    size_t const num_columns = data_stream.GetNumberOfColumns();
-
-    std::vector<std::vector<std::string>> columns(num_columns);
-    std::vector<std::string> row;
-
-    /* Parsing is very similar to ColumnLayoutRelationData::CreateFrom().
-     * Maybe we need column-based parsing in addition to row-based in CSVParser
-     * (now IDatasetStream) */
-    while (data_stream.HasNextRow()) {
-        row = data_stream.GetNextRow();
-
-        if (row.size() != num_columns) {
-            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
-                         << num_columns << ", got " << row.size() << ")";
-            continue;
-        }
+        IDatasetStream& data_stream, bool is_null_eq_null, unsigned threads,
+        TypeInferenceSample const& sample) {
+    std::vector<std::string> column_names;
+    for (size_t i = 0; i < data_stream.GetNumberOfColumns(); ++i) {
+        column_names.push_back(data_stream.GetColumnName(i));
+    }
+    return CreateFrom(data_stream.GetRelationName(), column_names, ReadColumns(data_stream),
+                      is_null_eq_null, threads, sample);
+}
+
+std::unique_ptr<ColumnLayoutTypedRelationData> ColumnLayoutTypedRelationData::CreateFrom(
+        std::string const& relation_name, std::vector<std::string> const& column_names,
+        std::vector<std::vector<std::string>> columns, bool is_null_eq_null, unsigned threads,
+        TypeInferenceSample const& sample) {
+    assert(threads != 0);
+    assert(column_names.size() == columns.size());
+    auto schema = std::make_unique<RelationalSchema>(relation_name);
+    size_t const num_columns = column_names.size();
+    for (size_t i = 0; i < num_columns; ++i) {
+        schema->AppendColumn(Column(schema.get(), column_names[i], i));
+    }
+
+    /* TypedColumnData has no empty state, so the columns are built aside and moved in order */
+    std::vector<std::optional<TypedColumnData>> typed_columns(num_columns);
+    std::vector<size_t> column_indices(num_columns);
+    std::iota(column_indices.begin(), column_indices.end(), 0);
+    util::ParallelForeach(column_indices.begin(), column_indices.end(), threads, [&](size_t i) {
+        typed_columns[i].emplace(model::TypedColumnDataFactory::CreateFrom(
+                schema->GetColumn(i), std::move(columns[i]), is_null_eq_null, sample));
+    });
+
+    std::vector<TypedColumnData> column_data;
+    column_data.reserve(num_columns);
+    for (std::optional<TypedColumnData>& typed_column : typed_columns) {
+        column_data.push_back(std::move(*typed_column));
+    }
+
+    schema->Init();
+
+    return std::make_unique<ColumnLayoutTypedRelationData>(std::move(schema),
+                                                           std::move(column_data));
+}
 
-        for (size_t index = 0; index < row.size(); ++index) {
-            std::string& field = row[index];
-            columns[index].push_back(std::move(field));
+void ColumnLayoutTypedRelationData::WriteSnapshot(std::filesystem::path const& path,
+                                                  std::uint64_t source_checksum,
+                                                  bool is_null_eq_null) const {
+    snapshot::SnapshotWriter writer(path, snapshot::Kind::kColumnLayoutTyped, source_checksum,
+                                    is_null_eq_null);
+    writer.WriteString(schema_->GetName());
+    writer.Write<std::uint64_t>(GetNumColumns());
+    for (TypedColumnData const& column_data : column_data_) {
+        writer.WriteString(column_data.GetColumn()->GetName());
+        writer.Write(column_data.GetTypeId()._to_integral());
+        /* Values are stored as one string with the end offset of every value */
+        std::vector<char> value_type_ids;
+        std::vector<std::uint64_t> value_ends;
+        std::string values;
+        for (size_t i = 0; i < column_data.GetNumRows(); ++i) {
+            value_type_ids.push_back(column_data.GetValueTypeId(i)._to_integral());
+            values += ValueToSnapshotString(column_data, i);
+            value_ends.push_back(values.size());
         }
+        writer.WriteArray(value_type_ids);
+        writer.WriteArray(value_ends);
+        writer.WriteString(values);
     }
+    writer.Finish();
+}
+
+std::unique_ptr<ColumnLayoutTypedRelationData> ColumnLayoutTypedRelationData::ReadSnapshot(
+        std::filesystem::path const& path, std::uint64_t source_checksum, bool is_null_eq_null) {
+    snapshot::SnapshotReader reader(path, snapshot::Kind::kColumnLayoutTyped, source_checksum,
+                                    is_null_eq_null);
+    auto schema = std::make_unique<RelationalSchema>(std::string(reader.ReadString()));
+    auto const num_columns = reader.Read<std::uint64_t>();
+
+    auto const to_type_id = [&path](char value) {
+        auto const type_id = TypeId::_from_integral_nothrow(value);
+        if (!type_id) {
+            throw std::runtime_error("Snapshot " + path.string() + " is corrupted");
+        }
+        return *type_id;
+    };
 
     std::vector<TypedColumnData> column_data;
     for (size_t i = 0; i < num_columns; ++i) {
-        Column column(schema.get(), data_stream.GetColumnName(i), i);
-        schema->AppendColumn(std::move(column));
-        TypedColumnData typed_column_data = model::TypedColumnDataFactory::CreateFrom(
-                schema->GetColumn(i), std::move(columns[i]), is_null_eq_null);
-        column_data.emplace_back(std::move(typed_column_data));
+        schema->AppendColumn(Column(schema.get(), std::string(reader.ReadString()), i));
+        TypeId const type_id = to_type_id(reader.Read<char>());
+        std::vector<char> const raw_value_type_ids = reader.ReadArray<char>();
+        std::vector<std::uint64_t> const value_ends = reader.ReadArray<std::uint64_t>();
+        std::string_view const values = reader.ReadString();
+        if (value_ends.size() != raw_value_type_ids.size()) {
+            throw std::runtime_error("Snapshot " + path.string() + " is corrupted");
+        }
+
+        std::vector<TypeId> value_type_ids;
+        std::vector<std::string> unparsed;
+        value_type_ids.reserve(raw_value_type_ids.size());
+        unparsed.reserve(value_ends.size());
+        std::uint64_t value_begin = 0;
+        for (size_t row = 0; row < value_ends.size(); ++row) {
+            if (value_ends[row] < value_begin || value_ends[row] > values.size()) {
+                throw std::runtime_error("Snapshot " + path.string() + " is corrupted");
+            }
+            value_type_ids.push_back(to_type_id(raw_value_type_ids[row]));
+            unparsed.emplace_back(values.substr(value_begin, value_ends[row] - value_begin));
+            value_begin = value_ends[row];
+        }
+
+        column_data.push_back(TypedColumnDataFactory::CreateFrom(schema->GetColumn(i),
+                                                                 std::move(unparsed),
+                                                                 is_null_eq_null, type_id,
+                                                                 value_type_ids));
     }
 
     schema->Init();
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
 #include "idataset_stream.h"
 #include "relation_data.h"
 #include "typed_column_data.h"
@@ -20,8 +25,29 @@ public:
         }
     }
 
+    /* Column types are deduced concurrently with threads > 1, sample tells how to guess them
+     * before the full pass (see TypeInferenceSample) */
+    static std::unique_ptr<ColumnLayoutTypedRelationData> CreateFrom(
+            model::IDatasetStream& data_stream, bool is_null_eq_null, unsigned threads = 1,
+            TypeInferenceSample const& sample = {});
+    /* Builds the relation of a table that is already in memory, columns[i] holds the values of
+     * the column named column_names[i] */
     static std::unique_ptr<ColumnLayoutTypedRelationData> CreateFrom(
-            model::IDatasetStream& data_stream, bool is_null_eq_null);
+            std::string const& relation_name, std::vector<std::string> const& column_names,
+            std::vector<std::vector<std::string>> columns, bool is_null_eq_null,
+            unsigned threads = 1, TypeInferenceSample const& sample = {});
+
+    /* Write the relation to a binary snapshot that ReadSnapshot can load without parsing the
+     * table and deducing column types again. source_checksum identifies the table (see
+     * model::snapshot::ChecksumFile), is_null_eq_null must be the value the relation was
+     * created with */
+    void WriteSnapshot(std::filesystem::path const& path, std::uint64_t source_checksum,
+                       bool is_null_eq_null) const;
+    /* Throws std::runtime_error if the snapshot was made from another table or with another
+     * is_null_eq_null */
+    static std::unique_ptr<ColumnLayoutTypedRelationData> ReadSnapshot(
+            std::filesystem::path const& path, std::uint64_t source_checksum,
+            bool is_null_eq_null);
 };
 
 }  // namespace model
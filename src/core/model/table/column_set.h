@@ -0,0 +1,259 @@
+/** \file
+ * \brief Fixed-width column set
+ *
+ * Definition of the ColumnSet class template, a set of column indices stored inline, and of
+ * DispatchColumnSet, which picks the narrowest ColumnSet for a schema.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace model {
+
+///
+/// \brief set of column indices of a schema with at most kWords * 64 columns
+///
+/// Words are stored inline, so set algebra doesn't allocate. The interface is the subset of the
+/// boost::dynamic_bitset<> one used on lattice traversal paths, so code templated on the set type
+/// accepts both, see DispatchColumnSet.
+///
+template <size_t kWords>
+class ColumnSet {
+public:
+    using Word = boost::dynamic_bitset<>::block_type;
+
+    static constexpr size_t npos = boost::dynamic_bitset<>::npos;
+    static constexpr size_t kWordBits = std::numeric_limits<Word>::digits;
+    static constexpr size_t kMaxColumns = kWords * kWordBits;
+
+private:
+    std::array<Word, kWords> words_{};
+    size_t size_ = 0;
+
+    static constexpr size_t WordIndex(size_t pos) noexcept {
+        return pos / kWordBits;
+    }
+
+    static constexpr Word BitMask(size_t pos) noexcept {
+        return Word{1} << (pos % kWordBits);
+    }
+
+    /* Scans words starting with the given one, which has the bits to skip masked out */
+    size_t FindFrom(size_t word_index, Word word) const noexcept {
+        while (word == 0) {
+            if (++word_index == kWords) return npos;
+            word = words_[word_index];
+        }
+        return word_index * kWordBits + std::countr_zero(word);
+    }
+
+public:
+    ColumnSet() noexcept = default;
+
+    explicit ColumnSet(size_t num_columns) noexcept : size_(num_columns) {
+        assert(num_columns <= kMaxColumns);
+    }
+
+    explicit ColumnSet(boost::dynamic_bitset<> const& bitset) : ColumnSet(bitset.size()) {
+        boost::to_block_range(bitset, words_.begin());
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    size_t count() const noexcept {
+        size_t count = 0;
+        for (Word word : words_) {
+            count += std::popcount(word);
+        }
+        return count;
+    }
+
+    bool any() const noexcept {
+        return std::any_of(words_.begin(), words_.end(), [](Word word) { return word != 0; });
+    }
+
+    bool none() const noexcept {
+        return !any();
+    }
+
+    bool test(size_t pos) const noexcept {
+        assert(pos < size_);
+        return (words_[WordIndex(pos)] & BitMask(pos)) != 0;
+    }
+
+    ColumnSet& set(size_t pos, bool value = true) noexcept {
+        assert(pos < size_);
+        if (value) {
+            words_[WordIndex(pos)] |= BitMask(pos);
+        } else {
+            words_[WordIndex(pos)] &= ~BitMask(pos);
+        }
+        return *this;
+    }
+
+    ColumnSet& reset(size_t pos) noexcept {
+        return set(pos, false);
+    }
+
+    ColumnSet& reset() noexcept {
+        words_.fill(0);
+        return *this;
+    }
+
+    ColumnSet& flip() noexcept {
+        for (Word& word : words_) {
+            word = ~word;
+        }
+        /* Bits past size_ stay zero, so that comparisons and hashing may look at whole words */
+        for (size_t i = WordIndex(size_); i < kWords; ++i) {
+            words_[i] &= i == WordIndex(size_) ? BitMask(size_) - 1 : 0;
+        }
+        return *this;
+    }
+
+    size_t find_first() const noexcept {
+        return FindFrom(0, words_[0]);
+    }
+
+    size_t find_next(size_t pos) const noexcept {
+        /* npos is the last position, as for boost::dynamic_bitset<> */
+        if (pos == npos || ++pos >= kMaxColumns) return npos;
+        return FindFrom(WordIndex(pos), words_[WordIndex(pos)] & ~(BitMask(pos) - 1));
+    }
+
+    bool is_subset_of(ColumnSet const& other) const noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            if ((words_[i] & ~other.words_[i]) != 0) return false;
+        }
+        return true;
+    }
+
+    bool intersects(ColumnSet const& other) const noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            if ((words_[i] & other.words_[i]) != 0) return true;
+        }
+        return false;
+    }
+
+    ColumnSet& operator&=(ColumnSet const& other) noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    ColumnSet& operator|=(ColumnSet const& other) noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i] |= other.words_[i];
+        }
+        return *this;
+    }
+
+    ColumnSet& operator^=(ColumnSet const& other) noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i] ^= other.words_[i];
+        }
+        return *this;
+    }
+
+    ColumnSet& operator-=(ColumnSet const& other) noexcept {
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i] &= ~other.words_[i];
+        }
+        return *this;
+    }
+
+    ColumnSet operator~() const noexcept {
+        ColumnSet result = *this;
+        return result.flip();
+    }
+
+    friend ColumnSet operator&(ColumnSet lhs, ColumnSet const& rhs) noexcept {
+        return lhs &= rhs;
+    }
+
+    friend ColumnSet operator|(ColumnSet lhs, ColumnSet const& rhs) noexcept {
+        return lhs |= rhs;
+    }
+
+    friend ColumnSet operator^(ColumnSet lhs, ColumnSet const& rhs) noexcept {
+        return lhs ^= rhs;
+    }
+
+    friend ColumnSet operator-(ColumnSet lhs, ColumnSet const& rhs) noexcept {
+        return lhs -= rhs;
+    }
+
+    friend bool operator==(ColumnSet const& lhs, ColumnSet const& rhs) noexcept {
+        return lhs.words_ == rhs.words_;
+    }
+
+    friend bool operator!=(ColumnSet const& lhs, ColumnSet const& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    /// same order as for boost::dynamic_bitset<> of the same size
+    friend bool operator<(ColumnSet const& lhs, ColumnSet const& rhs) noexcept {
+        return std::lexicographical_compare(lhs.words_.rbegin(), lhs.words_.rend(),
+                                            rhs.words_.rbegin(), rhs.words_.rend());
+    }
+
+    boost::dynamic_bitset<> ToBitset() const {
+        boost::dynamic_bitset<> bitset(words_.begin(),
+                                       words_.begin() + (size_ + kWordBits - 1) / kWordBits);
+        bitset.resize(size_);
+        return bitset;
+    }
+
+    size_t Hash() const noexcept {
+        return boost::hash_range(words_.begin(), words_.end());
+    }
+};
+
+/// \brief the column set type for `num_columns` columns
+///
+/// Calls `action` with std::type_identity of the narrowest ColumnSet that fits `num_columns`, or
+/// of boost::dynamic_bitset<> for wider schemas, and returns its result.
+template <typename Action>
+decltype(auto) DispatchColumnSet(size_t num_columns, Action&& action) {
+    if (num_columns <= ColumnSet<1>::kMaxColumns) {
+        return std::forward<Action>(action)(std::type_identity<ColumnSet<1>>{});
+    }
+    if (num_columns <= ColumnSet<2>::kMaxColumns) {
+        return std::forward<Action>(action)(std::type_identity<ColumnSet<2>>{});
+    }
+    if (num_columns <= ColumnSet<4>::kMaxColumns) {
+        return std::forward<Action>(action)(std::type_identity<ColumnSet<4>>{});
+    }
+    return std::forward<Action>(action)(std::type_identity<boost::dynamic_bitset<>>{});
+}
+
+template <size_t kWords>
+inline boost::dynamic_bitset<> ToBitset(ColumnSet<kWords> const& set) {
+    return set.ToBitset();
+}
+
+inline boost::dynamic_bitset<> const& ToBitset(boost::dynamic_bitset<> const& set) {
+    return set;
+}
+
+}  // namespace model
+
+template <size_t kWords>
+struct std::hash<model::ColumnSet<kWords>> {
+    size_t operator()(model::ColumnSet<kWords> const& set) const noexcept {
+        return set.Hash();
+    }
+};
@@ -0,0 +1,192 @@
+/** \file
+ * \brief Compressed cluster index
+ *
+ * CompressedClusterIndex methods definition
+ */
+#include "compressed_cluster_index.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+namespace model {
+
+namespace {
+
+/* Cluster sizes and first row ids are stored as LEB128 varints */
+void PutVarint(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint32_t GetVarint(std::uint8_t const*& pos) noexcept {
+    std::uint32_t value = 0;
+    unsigned shift = 0;
+    std::uint8_t byte;
+    do {
+        byte = *pos++;
+        value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while ((byte & 0x80) != 0);
+    return value;
+}
+
+size_t GetVarintBytes(std::uint32_t value) noexcept {
+    size_t bytes = 1;
+    for (; value >= 0x80; value >>= 7) {
+        ++bytes;
+    }
+    return bytes;
+}
+
+/* Gaps of kDelta are stored minus one, so consecutive row ids give zeros */
+struct Gaps {
+    bool ascending = true;
+    std::uint32_t max_gap = 0;
+};
+
+Gaps FindGaps(std::span<int const> cluster) noexcept {
+    Gaps gaps;
+    for (size_t i = 1; i < cluster.size(); ++i) {
+        if (cluster[i] <= cluster[i - 1]) {
+            gaps.ascending = false;
+            break;
+        }
+        gaps.max_gap = std::max(gaps.max_gap,
+                                static_cast<std::uint32_t>(cluster[i] - cluster[i - 1] - 1));
+    }
+    return gaps;
+}
+
+}  // namespace
+
+CompressedClusterIndex::CompressedClusterIndex(ClusterIndex const& index, unsigned relation_size)
+    : size_(index.size()), num_positions_(index.GetNumPositions()) {
+    bool const fits_uint16 = relation_size <= kMaxUInt16RelationSize;
+    for (ClusterIndex::ConstCluster cluster : index) {
+        Encode(cluster, fits_uint16);
+    }
+    data_.shrink_to_fit();
+}
+
+CompressedClusterIndex::Encoding CompressedClusterIndex::ChooseEncoding(
+        std::span<int const> cluster, bool fits_uint16) {
+    if (cluster.empty()) return Encoding::kUInt32;
+
+    Gaps const gaps = FindGaps(cluster);
+    if (gaps.ascending && gaps.max_gap == 0) return Encoding::kRun;
+
+    Encoding best = fits_uint16 ? Encoding::kUInt16 : Encoding::kUInt32;
+    size_t const best_bytes = cluster.size() * (fits_uint16 ? 2 : 4);
+    if (gaps.ascending) {
+        size_t const width = std::bit_width(gaps.max_gap);
+        size_t const delta_bytes = GetVarintBytes(cluster.front()) + 1 +
+                                   ((cluster.size() - 1) * width + 7) / 8;
+        /* Fixed width ids are faster to decode, so they win ties */
+        if (delta_bytes < best_bytes) best = Encoding::kDelta;
+    }
+    return best;
+}
+
+void CompressedClusterIndex::Encode(std::span<int const> cluster, bool fits_uint16) {
+    Encoding const encoding = ChooseEncoding(cluster, fits_uint16);
+    data_.push_back(static_cast<std::uint8_t>(encoding));
+    PutVarint(data_, cluster.size());
+
+    switch (encoding) {
+        case Encoding::kRun:
+            PutVarint(data_, cluster.front());
+            break;
+        case Encoding::kDelta: {
+            PutVarint(data_, cluster.front());
+            unsigned const width = std::bit_width(FindGaps(cluster).max_gap);
+            data_.push_back(static_cast<std::uint8_t>(width));
+            /* Less than 8 bits are pending before a gap is added, so 40 bits at most */
+            std::uint64_t pending = 0;
+            unsigned num_pending_bits = 0;
+            for (size_t i = 1; i < cluster.size(); ++i) {
+                pending |= static_cast<std::uint64_t>(cluster[i] - cluster[i - 1] - 1)
+                           << num_pending_bits;
+                num_pending_bits += width;
+                for (; num_pending_bits >= 8; num_pending_bits -= 8) {
+                    data_.push_back(static_cast<std::uint8_t>(pending));
+                    pending >>= 8;
+                }
+            }
+            if (num_pending_bits != 0) {
+                data_.push_back(static_cast<std::uint8_t>(pending));
+            }
+            break;
+        }
+        case Encoding::kUInt16:
+            for (int position : cluster) {
+                auto const value = static_cast<std::uint16_t>(position);
+                auto const* bytes = reinterpret_cast<std::uint8_t const*>(&value);
+                data_.insert(data_.end(), bytes, bytes + sizeof(value));
+            }
+            break;
+        case Encoding::kUInt32: {
+            auto const* bytes = reinterpret_cast<std::uint8_t const*>(cluster.data());
+            data_.insert(data_.end(), bytes, bytes + cluster.size_bytes());
+            break;
+        }
+    }
+}
+
+std::span<int const> CompressedClusterIndex::Decoder::Next() {
+    auto const encoding = static_cast<Encoding>(*pos_++);
+    size_t const size = GetVarint(pos_);
+    buffer_.resize(size);
+
+    switch (encoding) {
+        case Encoding::kRun:
+            std::iota(buffer_.begin(), buffer_.end(), static_cast<int>(GetVarint(pos_)));
+            break;
+        case Encoding::kDelta: {
+            int position = static_cast<int>(GetVarint(pos_));
+            unsigned const width = *pos_++;
+            std::uint64_t const mask = (std::uint64_t{1} << width) - 1;
+            std::uint64_t pending = 0;
+            unsigned num_pending_bits = 0;
+            buffer_[0] = position;
+            for (size_t i = 1; i < size; ++i) {
+                for (; num_pending_bits < width; num_pending_bits += 8) {
+                    pending |= static_cast<std::uint64_t>(*pos_++) << num_pending_bits;
+                }
+                position += static_cast<int>(pending & mask) + 1;
+                pending >>= width;
+                num_pending_bits -= width;
+                buffer_[i] = position;
+            }
+            break;
+        }
+        case Encoding::kUInt16:
+            for (size_t i = 0; i < size; ++i, pos_ += sizeof(std::uint16_t)) {
+                std::uint16_t value;
+                std::memcpy(&value, pos_, sizeof(value));
+                buffer_[i] = value;
+            }
+            break;
+        case Encoding::kUInt32:
+            std::memcpy(buffer_.data(), pos_, size * sizeof(int));
+            pos_ += size * sizeof(int);
+            break;
+    }
+    return buffer_;
+}
+
+ClusterIndex CompressedClusterIndex::Decode(std::pmr::memory_resource* resource) const {
+    ClusterIndex index(resource);
+    index.Reserve(num_positions_, size_);
+    ForEachCluster([&index](std::span<int const> cluster) {
+        index.Append(cluster.begin(), cluster.end());
+    });
+    return index;
+}
+
+}  // namespace model
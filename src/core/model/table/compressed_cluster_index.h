@@ -0,0 +1,99 @@
+/** \file
+ * \brief Compressed cluster index
+ *
+ * Definition of the CompressedClusterIndex class, a compact read-only storage of PLI clusters.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "model/table/cluster_index.h"
+
+namespace model {
+
+///
+/// \brief clusters of a PositionListIndex encoded in as few bytes as possible
+///
+/// A ClusterIndex spends 4 bytes on every row id, which is too much to keep the PLIs of all
+/// columns of a wide and long table in memory. Here every cluster is encoded on its own with the
+/// smallest of the following encodings:
+///  - kRun: ascending consecutive row ids, stored as the first one only;
+///  - kDelta: ascending row ids, stored as the first one and the gaps between neighbours, bit
+///    packed with the width of the largest gap;
+///  - kUInt16: row ids as 16-bit integers, only in relations of at most 65536 rows;
+///  - kUInt32: row ids as 32-bit integers.
+///
+/// Clusters are laid out back to back without an offset table, so they can only be read in
+/// order, see ForEachCluster. That is all intersecting PLIs and building probing tables need.
+///
+class CompressedClusterIndex {
+public:
+    enum class Encoding : std::uint8_t { kRun, kDelta, kUInt16, kUInt32 };
+
+    /// reads clusters one after another, decoding them into a reusable buffer
+    class Decoder {
+    private:
+        std::uint8_t const* pos_;
+        std::vector<int> buffer_;
+
+    public:
+        explicit Decoder(CompressedClusterIndex const& index) noexcept
+            : pos_(index.data_.data()) {}
+
+        /// decodes the next cluster, the view is valid until the next call
+        std::span<int const> Next();
+    };
+
+    static constexpr unsigned kMaxUInt16RelationSize = 1u << 16;
+
+private:
+    std::vector<std::uint8_t> data_;
+    size_t size_ = 0;
+    size_t num_positions_ = 0;
+
+    void Encode(std::span<int const> cluster, bool fits_uint16);
+
+public:
+    CompressedClusterIndex() = default;
+
+    /// encodes clusters of `index`, whose row ids are less than `relation_size`
+    CompressedClusterIndex(ClusterIndex const& index, unsigned relation_size);
+
+    /// calls `f(std::span<int const>)` for every cluster in order
+    template <typename F>
+    void ForEachCluster(F&& f) const {
+        Decoder decoder(*this);
+        for (size_t i = 0; i < size_; ++i) {
+            f(decoder.Next());
+        }
+    }
+
+    [[nodiscard]] ClusterIndex Decode(
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+    /// encoding that would be chosen for `cluster`
+    static Encoding ChooseEncoding(std::span<int const> cluster, bool fits_uint16);
+
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /// total number of row ids in all clusters
+    [[nodiscard]] size_t GetNumPositions() const noexcept {
+        return num_positions_;
+    }
+
+    /// memory taken by the encoded clusters
+    [[nodiscard]] size_t GetBytes() const noexcept {
+        return data_.capacity();
+    }
+};
+
+}  // namespace model
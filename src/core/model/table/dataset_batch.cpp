@@ -0,0 +1,58 @@
+/** \file
+ * \brief Dataset batch
+ *
+ * DatasetBatch methods definition
+ */
+#include "dataset_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace model {
+
+void DatasetBatch::Clear(size_t num_columns) {
+    columns_.resize(num_columns);
+    for (Column& column : columns_) {
+        column.clear();
+    }
+    num_rows_ = 0;
+    cur_block_ = 0;
+    cur_block_used_ = 0;
+}
+
+char* DatasetBatch::Allocate(size_t size) {
+    while (cur_block_ < blocks_.size()) {
+        Block& block = blocks_[cur_block_];
+        if (block.size - cur_block_used_ >= size) {
+            char* result = block.data.get() + cur_block_used_;
+            cur_block_used_ += size;
+            return result;
+        }
+        ++cur_block_;
+        cur_block_used_ = 0;
+    }
+    size_t const block_size = std::max(size, kBlockSize);
+    blocks_.push_back({std::make_unique_for_overwrite<char[]>(block_size), block_size});
+    cur_block_ = blocks_.size() - 1;
+    cur_block_used_ = size;
+    return blocks_.back().data.get();
+}
+
+DatasetBatch::Value DatasetBatch::Store(std::string_view value) {
+    if (value.empty()) {
+        return {};
+    }
+    char* data = Allocate(value.size());
+    std::memcpy(data, value.data(), value.size());
+    return {data, value.size()};
+}
+
+void DatasetBatch::AppendRowCopy(std::vector<std::string> const& row) {
+    assert(row.size() == columns_.size());
+    for (size_t column_index = 0; column_index < row.size(); ++column_index) {
+        columns_[column_index].push_back(Store(row[column_index]));
+    }
+    ++num_rows_;
+}
+
+}  // namespace model
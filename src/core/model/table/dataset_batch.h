@@ -0,0 +1,93 @@
+/** \file
+ * \brief Dataset batch
+ *
+ * Definition of the DatasetBatch class, a column-major chunk of rows pulled from an
+ * IDatasetStream with IDatasetStream::GetNextBatch.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace model {
+
+///
+/// \brief column-major batch of rows with values stored as string views
+///
+/// \note Values point either into the batch's own arena or into memory owned by the stream
+///       that filled the batch (e.g. the mapped file of MmapCSVParser). They stay valid until
+///       the batch is refilled or destroyed, so consumers must copy what they want to keep.
+///
+class DatasetBatch {
+public:
+    using Value = std::string_view;
+    using Column = std::vector<Value>;
+
+    /// number of rows loaders request per GetNextBatch call
+    static constexpr size_t kDefaultNumRows = 4096;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t kBlockSize = 1 << 16;
+
+    std::vector<Column> columns_;
+    size_t num_rows_ = 0;
+
+    /* arena for values that do not outlive the batch in the stream's own memory */
+    std::vector<Block> blocks_;
+    size_t cur_block_ = 0;
+    size_t cur_block_used_ = 0;
+
+    char* Allocate(size_t size);
+
+public:
+    /// drop all rows and prepare the batch for `num_columns` columns, keeping allocated memory
+    void Clear(size_t num_columns);
+
+    [[nodiscard]] size_t GetNumRows() const noexcept {
+        return num_rows_;
+    }
+
+    [[nodiscard]] size_t GetNumColumns() const noexcept {
+        return columns_.size();
+    }
+
+    [[nodiscard]] Column const& GetColumn(size_t column_index) const {
+        return columns_[column_index];
+    }
+
+    [[nodiscard]] Value GetValue(size_t row_index, size_t column_index) const {
+        return columns_[column_index][row_index];
+    }
+
+    /// copy `value` into the batch arena, the returned view lives as long as the batch contents
+    Value Store(std::string_view value);
+
+    ///
+    /// \brief append a row of values that already live long enough
+    ///
+    /// \param values  views into the batch arena (see Store) or into stream-owned memory
+    ///
+    template <typename Values>
+    void AppendRow(Values const& values) {
+        assert(values.size() == columns_.size());
+        size_t column_index = 0;
+        for (auto const& value : values) {
+            columns_[column_index++].emplace_back(value);
+        }
+        ++num_rows_;
+    }
+
+    /// append a row, copying its values into the batch arena
+    void AppendRowCopy(std::vector<std::string> const& row);
+};
+
+}  // namespace model
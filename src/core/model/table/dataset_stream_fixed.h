@@ -62,6 +62,11 @@ public:
         this->stream_->Reset();
         TryStoreNextRow();
     }
+
+    /* The wrapped stream is one row ahead, so batches have to be built from our rows */
+    size_t GetNextBatch(size_t max_rows, DatasetBatch& batch) override {
+        return IDatasetStream::GetNextBatch(max_rows, batch);
+    }
 };
 
 }  // namespace model
@@ -105,6 +105,10 @@ public:
     void Reset() override {
         stream_->Reset();
     }
+
+    size_t GetNextBatch(size_t max_rows, DatasetBatch& batch) override {
+        return stream_->GetNextBatch(max_rows, batch);
+    }
 };
 
 }  // namespace model
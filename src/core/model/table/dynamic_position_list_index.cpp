@@ -1,82 +1,104 @@
 #include "model/table/dynamic_position_list_index.h"
 
-#include <algorithm>
-#include <chrono>
-#include <cmath>
-#include <map>
+#include <cassert>
 #include <memory>
-#include <stack>
 #include <utility>
 
-#include <boost/dynamic_bitset.hpp>
-#include <easylogging++.h>
-
-namespace {
-// O(cluster)
-void ProcessDeleteToCluster(model::DynamicPositionListIndex::Cluster& cluster,
-                            std::unordered_set<size_t>& deleted_records_ids) {
-    auto records_pred = [&](size_t element) {
-        return static_cast<bool>(deleted_records_ids.erase(element));
-    };
-    std::erase_if(cluster, records_pred);
-}
+namespace model {
 
-}  // namespace
+DynamicPositionListIndex::ClusterId DynamicPositionListIndex::GetOrCreateClusterId(
+        ClusterValue const& value) {
+    auto [it, is_new] = cluster_ids_.try_emplace(value, kNoCluster);
+    if (!is_new) return it->second;
 
-namespace model {
+    if (free_cluster_ids_.empty()) {
+        it->second = clusters_.size();
+        clusters_.emplace_back();
+        cluster_values_.push_back(&it->first);
+    } else {
+        it->second = free_cluster_ids_.back();
+        free_cluster_ids_.pop_back();
+        cluster_values_[it->second] = &it->first;
+    }
+    return it->second;
+}
 
-DynamicPositionListIndex::DynamicPositionListIndex(ClusterCollection clusters, size_t size,
-                                                   size_t relation_size)
-    : clusters_(std::move(clusters)),
-      valid_records_number_(size),
-      next_record_id_(relation_size),
-      probing_table_cache_() {
-    ForceCacheProbingTable();
+void DynamicPositionListIndex::AddRecord(int record_id, ClusterId id) {
+    Cluster& cluster = clusters_[id];
+    row_clusters_[record_id] = id;
+    row_positions_[record_id] = cluster.size();
+    cluster.push_back(record_id);
+    ++valid_records_number_;
+}
+
+// O(1): the last record of the cluster takes the place of the removed one
+void DynamicPositionListIndex::RemoveRecord(int record_id) {
+    ClusterId const id = row_clusters_[record_id];
+    Cluster& cluster = clusters_[id];
+    int const moved_record_id = cluster.back();
+    cluster[row_positions_[record_id]] = moved_record_id;
+    row_positions_[moved_record_id] = row_positions_[record_id];
+    cluster.pop_back();
+    row_clusters_[record_id] = kNoCluster;
+    --valid_records_number_;
+
+    if (cluster.empty()) {
+        Cluster{}.swap(cluster);
+        cluster_ids_.erase(*cluster_values_[id]);
+        cluster_values_[id] = nullptr;
+        free_cluster_ids_.push_back(id);
+    }
 }
 
 std::unique_ptr<DynamicPositionListIndex> DynamicPositionListIndex::CreateFor(
-        std::vector<ClusterValue>& records) {
-    ClusterCollection clusters;
+        std::vector<ClusterValue> const& records) {
+    auto pli = std::make_unique<DynamicPositionListIndex>();
+    pli->row_clusters_.resize(records.size());
+    pli->row_positions_.resize(records.size());
     for (size_t record_id = 0; record_id < records.size(); ++record_id) {
-        ClusterValue const& value = records[record_id];
-        clusters[value].push_back(record_id);
+        pli->AddRecord(record_id, pli->GetOrCreateClusterId(records[record_id]));
     }
-
-    return std::make_unique<DynamicPositionListIndex>(std::move(clusters), records.size(),
-                                                      records.size());
+    return pli;
 }
 
 void DynamicPositionListIndex::UpdateWith(
-        std::vector<std::pair<std::optional<size_t>, ClusterValue>>& inserted_records,
-        std::unordered_set<size_t> deleted_records_ids) {
-    if (inserted_records.empty() && deleted_records_ids.empty()) {
-        return;
-    }
-    valid_records_number_ -= deleted_records_ids.size();
-    for (auto it = clusters_.begin(); it != clusters_.end();) {
-        auto& [cluster_value, cluster] = *it;
-        ProcessDeleteToCluster(cluster, deleted_records_ids);
-        if (cluster.empty()) {
-            it = clusters_.erase(it);
-        } else {
-            ++it;
+        std::vector<std::pair<size_t, ClusterValue>> const& inserted_records,
+        std::unordered_set<size_t> const& deleted_records_ids) {
+    for (size_t record_id : deleted_records_ids) {
+        if (record_id < row_clusters_.size() && row_clusters_[record_id] != kNoCluster) {
+            RemoveRecord(record_id);
         }
-        if (deleted_records_ids.empty()) break;
     }
-    for (auto const& [encoded_value_opt, cluster_value] : inserted_records) {
-        if (encoded_value_opt.has_value()) {
-            clusters_[cluster_value].emplace_back(*encoded_value_opt);
-        } else {
-            clusters_[cluster_value].emplace_back(next_record_id_++);
-            ++valid_records_number_;
+    for (auto const& [record_id, cluster_value] : inserted_records) {
+        if (record_id >= row_clusters_.size()) {
+            row_clusters_.resize(record_id + 1, kNoCluster);
+            row_positions_.resize(record_id + 1);
         }
+        assert(row_clusters_[record_id] == kNoCluster);
+        AddRecord(record_id, GetOrCreateClusterId(cluster_value));
     }
+}
 
-    ForceCacheProbingTable();
+void DynamicPositionListIndex::RemapRecords(std::vector<int> const& new_record_ids) {
+    assert(new_record_ids.size() == GetRelationSize());
+    std::vector<ClusterId> row_clusters(valid_records_number_, kNoCluster);
+    std::vector<unsigned> row_positions(valid_records_number_);
+    for (ClusterId id = 0; id < static_cast<ClusterId>(clusters_.size()); ++id) {
+        Cluster& cluster = clusters_[id];
+        for (unsigned position = 0; position < cluster.size(); ++position) {
+            int const record_id = new_record_ids[cluster[position]];
+            assert(record_id >= 0 && static_cast<size_t>(record_id) < valid_records_number_);
+            cluster[position] = record_id;
+            row_clusters[record_id] = id;
+            row_positions[record_id] = position;
+        }
+    }
+    row_clusters_ = std::move(row_clusters);
+    row_positions_ = std::move(row_positions);
 }
 
 std::unordered_map<int, unsigned> DynamicPositionListIndex::CreateFrequencies(
-        Cluster const& cluster, std::vector<int> const& probing_table) {
+        Cluster const& cluster, std::vector<ClusterId> const& probing_table) {
     std::unordered_map<int, unsigned> frequencies;
 
     for (int index : cluster) {
@@ -86,26 +108,9 @@ std::unordered_map<int, unsigned> DynamicPositionListIndex::CreateFrequencies(
     return frequencies;
 }
 
-std::shared_ptr<std::vector<int> const> DynamicPositionListIndex::CalculateAndGetProbingTable()
-        const {
-    // cluster values cache: used in the Probe() method
-    cluster_values_cache_.clear();
-    std::vector<int> probing_table = std::vector<int>(next_record_id_);
-    int next_cluster_id = 0;
-    for (auto& [value, cluster] : clusters_) {
-        int value_id = next_cluster_id++;
-        for (int position : cluster) {
-            probing_table[position] = value_id;
-        }
-        cluster_values_cache_.emplace_back(value);
-    }
-
-    return std::make_shared<std::vector<int>>(probing_table);
-}
-
 std::unique_ptr<DynamicPositionListIndex> DynamicPositionListIndex::Intersect(
         DynamicPositionListIndex const* that) const {
-    assert(this->next_record_id_ == that->next_record_id_);
+    assert(this->GetRelationSize() == that->GetRelationSize());
 
     if (this->valid_records_number_ > that->valid_records_number_) {
         return that->Probe(this);
@@ -116,45 +121,39 @@ std::unique_ptr<DynamicPositionListIndex> DynamicPositionListIndex::Intersect(
 
 std::unique_ptr<DynamicPositionListIndex> DynamicPositionListIndex::Probe(
         DynamicPositionListIndex const* that) const {
-    std::shared_ptr<std::vector<int> const> probing_table = that->GetCachedProbingTable();
-    std::vector<ClusterValue> const& cluster_values = that->GetClusterValuesCache();
-    assert(this->next_record_id_ == probing_table->size());
-    ClusterCollection new_clusters;
-    unsigned int new_size = 0;
-
-    std::unordered_map<int, std::pair<ClusterValue, Cluster>> partial_clusters;
-
-    for (auto const& [value, cluster] : clusters_) {
-        for (int position : cluster) {
-            int probing_table_value_id = (*probing_table)[position];
-            auto partial_cluster = partial_clusters.find(probing_table_value_id);
-            if (partial_cluster != partial_clusters.end()) {
-                auto& [key, positions] = partial_cluster->second;
-                positions.emplace_back(position);
-            } else {
-                ClusterValue key = value;
-                auto& cluster_value = cluster_values[probing_table_value_id];
-                key.insert(key.end(), cluster_value.begin(), cluster_value.end());
-                partial_clusters[probing_table_value_id] = {std::move(key), {position}};
+    std::vector<ClusterId> const& probing_table = that->GetProbingTable();
+    assert(this->GetRelationSize() == probing_table.size());
+    auto intersection = std::make_unique<DynamicPositionListIndex>();
+    intersection->row_clusters_.resize(GetRelationSize(), kNoCluster);
+    intersection->row_positions_.resize(GetRelationSize());
+
+    /* Clusters of the intersection that records of the current cluster went to, by the clusters
+     * of `that` */
+    std::unordered_map<ClusterId, ClusterId> partial_clusters;
+    for (ClusterId id = 0; id < static_cast<ClusterId>(clusters_.size()); ++id) {
+        for (int position : clusters_[id]) {
+            ClusterId const that_id = probing_table[position];
+            auto [it, is_new] = partial_clusters.try_emplace(that_id, kNoCluster);
+            if (is_new) {
+                ClusterValue value = GetClusterValue(id);
+                ClusterValue const& that_value = that->GetClusterValue(that_id);
+                value.insert(value.end(), that_value.begin(), that_value.end());
+                it->second = intersection->GetOrCreateClusterId(value);
             }
-        }
-
-        for (auto& [_, new_cluster] : partial_clusters) {
-            new_size += new_cluster.second.size();
-            new_clusters.emplace(std::move(new_cluster));
+            intersection->AddRecord(position, it->second);
         }
         partial_clusters.clear();
     }
 
-    return std::make_unique<DynamicPositionListIndex>(std::move(new_clusters), new_size,
-                                                      next_record_id_);
+    return intersection;
 }
 
 std::string DynamicPositionListIndex::ToString() const {
     std::string res = "[";
-    for (auto& cluster : clusters_) {
+    for (Cluster const& cluster : clusters_) {
+        if (cluster.empty()) continue;
         res.push_back('[');
-        for (int v : cluster.second) {
+        for (int v : cluster) {
             res.append(std::to_string(v) + ",");
         }
         if (res.find(',') != std::string::npos) res.erase(res.find_last_of(','));
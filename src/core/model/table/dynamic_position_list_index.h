@@ -1,75 +1,88 @@
 #pragma once
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
-#include "model/table/column.h"
-
-class ColumnLayoutRelationData;
-
-template <>
-struct std::hash<std::vector<int>> {
-    std::size_t operator()(std::vector<int> const& vec) const noexcept {
-        std::size_t secret = vec.size();
-        std::size_t hash = (1 << secret) ^ secret;
-        for (auto const& el : vec) {
-            hash ^= (el << secret) - (hash >> secret);
-        }
-        return hash;
-    }
-};
+#include <boost/functional/hash.hpp>
 
 namespace model {
+
+/* PLI of a table that is modified by batches of inserts, updates and deletes. Every batch costs
+ * time proportional to its size: clusters are looked up by their interned values, rows know their
+ * clusters and their positions in them, and the ids of deleted rows and of removed clusters are
+ * tombstoned instead of renumbering the rest. Singleton clusters are kept too */
 class DynamicPositionListIndex {
 public:
     using Cluster = std::vector<int>;
     using ClusterValue = std::vector<int>;
-    using ClusterCollection = std::unordered_map<ClusterValue, Cluster>;
+    using ClusterId = int;
+
+    /* Cluster id of the deleted rows */
+    static constexpr ClusterId kNoCluster = -1;
 
 private:
-    ClusterCollection clusters_;
-    size_t valid_records_number_;
-    size_t next_record_id_;
+    using ClusterIds = std::unordered_map<ClusterValue, ClusterId, boost::hash<ClusterValue>>;
 
-    std::shared_ptr<std::vector<int> const> probing_table_cache_;
-    mutable std::vector<ClusterValue> cluster_values_cache_;
+    /* Clusters by id, the clusters with ids from free_cluster_ids_ are empty */
+    std::vector<Cluster> clusters_;
+    /* Interned values of the clusters, point to the keys of cluster_ids_ */
+    std::vector<ClusterValue const*> cluster_values_;
+    ClusterIds cluster_ids_;
+    std::vector<ClusterId> free_cluster_ids_;
 
-public:
-    DynamicPositionListIndex(ClusterCollection clusters, size_t size, size_t relation_size);
+    /* Cluster id of every row, i.e. the probing table */
+    std::vector<ClusterId> row_clusters_;
+    /* Position of every row in its cluster */
+    std::vector<unsigned> row_positions_;
+    size_t valid_records_number_ = 0;
+
+    ClusterId GetOrCreateClusterId(ClusterValue const& value);
+    void AddRecord(int record_id, ClusterId id);
+    void RemoveRecord(int record_id);
 
+public:
     static std::unique_ptr<DynamicPositionListIndex> CreateFor(
-            std::vector<std::vector<int>>& records);
+            std::vector<ClusterValue> const& records);
 
-    void UpdateWith(std::vector<std::pair<std::optional<size_t>, ClusterValue>>& inserted_records,
-                    std::unordered_set<size_t> deleted_records_ids);
+    /* Deletes `deleted_records_ids`, then inserts `inserted_records`. Updated records must be
+     * among the deleted ones, ids not less than GetRelationSize() extend the relation */
+    void UpdateWith(std::vector<std::pair<size_t, ClusterValue>> const& inserted_records,
+                    std::unordered_set<size_t> const& deleted_records_ids);
 
-    static std::unordered_map<int, unsigned> CreateFrequencies(
-            Cluster const& cluster, std::vector<int> const& probing_table);
+    /* Renumbers the records after the table is compacted, new_record_ids[id] is the new id of the
+     * record with `id` or a negative number if the record is deleted */
+    void RemapRecords(std::vector<int> const& new_record_ids);
 
-    // Calculates PT -- heavy operation
-    std::shared_ptr<std::vector<int> const> CalculateAndGetProbingTable() const;
+    static std::unordered_map<int, unsigned> CreateFrequencies(
+            Cluster const& cluster, std::vector<ClusterId> const& probing_table);
 
-    // Returns cached PT or nullptr, if PT has not been cached yet
-    std::shared_ptr<std::vector<int> const> GetCachedProbingTable() const {
-        return probing_table_cache_;
-    };
+    /* Cluster ids of all the records ever inserted, kNoCluster for the deleted ones */
+    std::vector<ClusterId> const& GetProbingTable() const noexcept {
+        return row_clusters_;
+    }
 
-    // Calculates PT and cache it
-    void ForceCacheProbingTable() {
-        probing_table_cache_ = CalculateAndGetProbingTable();
-    };
+    ClusterId GetClusterId(size_t record_id) const {
+        return row_clusters_[record_id];
+    }
 
-    ClusterCollection const& GetClusters() const noexcept {
+    /* Clusters by id, the ones of removed clusters are empty */
+    std::vector<Cluster> const& GetClusters() const noexcept {
         return clusters_;
-    };
+    }
 
-    /* If you use this method and change index in any way, all other methods will become invalid */
-    ClusterCollection& GetClusters() noexcept {
-        return clusters_;
+    Cluster const& GetCluster(ClusterId id) const {
+        return clusters_[id];
+    }
+
+    ClusterValue const& GetClusterValue(ClusterId id) const {
+        return *cluster_values_[id];
     }
 
     unsigned int GetNumCluster() const {
-        return clusters_.size();
+        return clusters_.size() - free_cluster_ids_.size();
     }
 
     unsigned int GetSize() const {
@@ -77,11 +90,7 @@ public:
     }
 
     unsigned int GetRelationSize() const {
-        return next_record_id_;
-    }
-
-    std::vector<ClusterValue> const& GetClusterValuesCache() const {
-        return cluster_values_cache_;
+        return row_clusters_.size();
     }
 
     std::unique_ptr<DynamicPositionListIndex> Intersect(DynamicPositionListIndex const* that) const;
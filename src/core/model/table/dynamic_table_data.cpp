@@ -0,0 +1,154 @@
+#include "model/table/dynamic_table_data.h"
+
+#include <algorithm>
+
+#include <easylogging++.h>
+
+#include "config/exceptions.h"
+
+namespace model {
+
+DynamicTableData::ValueCode DynamicTableData::Column::Acquire(std::string_view value) {
+    auto it = codes.find(value);
+    if (it == codes.end()) {
+        ValueCode code;
+        if (free_codes.empty()) {
+            code = values.size();
+            values.push_back(nullptr);
+            counts.push_back(0);
+        } else {
+            code = free_codes.back();
+            free_codes.pop_back();
+        }
+        it = codes.emplace(value, code).first;
+        values[code] = &it->first;
+    }
+    ++counts[it->second];
+    return it->second;
+}
+
+void DynamicTableData::Column::Release(ValueCode code) {
+    if (--counts[code] != 0) return;
+    codes.erase(*values[code]);
+    values[code] = nullptr;
+    free_codes.push_back(code);
+}
+
+DynamicTableData::DynamicTableData(IDatasetStream& input_table) {
+    columns_.resize(input_table.GetNumberOfColumns());
+    std::vector<size_t> rows;
+    AppendRows(input_table, rows);
+}
+
+void DynamicTableData::AppendRows(IDatasetStream& table, std::vector<size_t>& changed_rows) {
+    DatasetBatch batch;
+    while (table.GetNextBatch(DatasetBatch::kDefaultNumRows, batch) != 0) {
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            Column& column = columns_[i];
+            for (DatasetBatch::Value value : batch.GetColumn(i)) {
+                column.cells.push_back(column.Acquire(value));
+            }
+        }
+        for (size_t row_index = 0; row_index < batch.GetNumRows(); ++row_index) {
+            changed_rows.push_back(row_ids_.size());
+            row_ids_.push_back(next_row_id_++);
+            deleted_rows_.push_back(false);
+        }
+    }
+}
+
+void DynamicTableData::UpdateRows(IDatasetStream& update_data, std::vector<size_t>& changed_rows) {
+    DatasetBatch batch;
+    while (update_data.GetNextBatch(DatasetBatch::kDefaultNumRows, batch) != 0) {
+        for (size_t row_index = 0; row_index < batch.GetNumRows(); ++row_index) {
+            size_t row_id = std::stoull(std::string(batch.GetValue(row_index, 0)));
+            std::optional<size_t> row = FindRow(row_id);
+            if (!row.has_value()) {
+                throw config::ConfigurationError(
+                        "Attempt to update a deleted row during processing of update "
+                        "operations");
+            }
+            for (size_t i = 1; i < batch.GetNumColumns(); ++i) {
+                Column& column = columns_[i - 1];
+                /* Acquiring first keeps the code of a value that is not changed */
+                ValueCode const old_code = column.cells[*row];
+                column.cells[*row] = column.Acquire(batch.GetValue(row_index, i));
+                column.Release(old_code);
+            }
+            changed_rows.push_back(*row);
+        }
+    }
+}
+
+void DynamicTableData::DeleteRow(size_t row) {
+    deleted_rows_.set(row);
+    ++num_deleted_rows_;
+    for (Column& column : columns_) {
+        column.Release(column.cells[row]);
+    }
+}
+
+std::optional<size_t> DynamicTableData::FindRow(size_t row_id) const {
+    auto it = std::lower_bound(row_ids_.begin(), row_ids_.end(), row_id);
+    if (it == row_ids_.end() || *it != row_id) return std::nullopt;
+    size_t const row = it - row_ids_.begin();
+    if (deleted_rows_.test(row)) return std::nullopt;
+    return row;
+}
+
+std::vector<size_t> DynamicTableData::Update(config::InputTable insert_data,
+                                             config::InputTable update_data,
+                                             std::unordered_set<size_t> const& delete_data) {
+    std::vector<size_t> changed_rows;
+    for (size_t row_id : delete_data) {
+        std::optional<size_t> row = FindRow(row_id);
+        assert(row.has_value());
+        DeleteRow(*row);
+    }
+    if (insert_data != nullptr) {
+        if (insert_data->GetNumberOfColumns() != columns_.size()) {
+            LOG(DEBUG) << "Got insert statements with " << insert_data->GetNumberOfColumns()
+                       << " columns, skipping...";
+        } else {
+            AppendRows(*insert_data, changed_rows);
+        }
+    }
+    if (update_data != nullptr) {
+        if (update_data->GetNumberOfColumns() != columns_.size() + 1) {
+            LOG(DEBUG) << "Got update statements with " << update_data->GetNumberOfColumns()
+                       << " columns, skipping...";
+        } else {
+            UpdateRows(*update_data, changed_rows);
+        }
+    }
+    return changed_rows;
+}
+
+std::vector<int> DynamicTableData::Compact() {
+    std::vector<int> new_rows(row_ids_.size(), kNoRow);
+    int num_rows = 0;
+    for (size_t row = 0; row < row_ids_.size(); ++row) {
+        if (!deleted_rows_.test(row)) {
+            new_rows[row] = num_rows;
+            row_ids_[num_rows++] = row_ids_[row];
+        }
+    }
+    row_ids_.resize(num_rows);
+    row_ids_.shrink_to_fit();
+
+    for (Column& column : columns_) {
+        for (size_t row = 0; row < column.cells.size(); ++row) {
+            if (new_rows[row] != kNoRow) {
+                column.cells[new_rows[row]] = column.cells[row];
+            }
+        }
+        column.cells.resize(num_rows);
+        column.cells.shrink_to_fit();
+    }
+
+    deleted_rows_ = boost::dynamic_bitset<>(num_rows);
+    num_deleted_rows_ = 0;
+    return new_rows;
+}
+
+}  // namespace model
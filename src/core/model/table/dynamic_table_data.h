@@ -1,95 +1,114 @@
 #pragma once
 
 #include <cassert>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-#include <easylogging++.h>
+#include <boost/dynamic_bitset.hpp>
 
-#include "config/exceptions.h"
 #include "config/tabular_data/input_table_type.h"
+#include "model/table/dataset_batch.h"
 
 namespace model {
 
+/* Table that is modified by batches of inserts, updates and deletes. Cells are kept as codes of
+ * per-column dictionaries and deleted rows are tombstoned until compaction drops them. Rows are
+ * addressed in two ways: row ids are assigned on insertion and never change, they are what the
+ * user sees, while positions are the indices of rows in the columns and change on compaction */
 struct DynamicTableData {
+public:
+    using ValueCode = int;
+
+    /* Position of the dropped rows in the result of Compact */
+    static constexpr int kNoRow = -1;
+
 private:
-    std::vector<std::vector<std::string>> columns_;
-    std::unordered_set<size_t> deleted_rows_{};
+    /* Transparent hashing lets batch values be looked up without building a std::string */
+    struct StringHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view value) const noexcept {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    /* The code of a value is freed once no row has it and is given to the next new value, so the
+     * dictionary holds only the values of the rows that are not deleted */
+    struct Column {
+        std::vector<ValueCode> cells;
+        std::unordered_map<std::string, ValueCode, StringHash, std::equal_to<>> codes;
+        /* values[code] points to the key of codes, nullptr for the free codes */
+        std::vector<std::string const*> values;
+        /* Number of rows with the value of every code */
+        std::vector<size_t> counts;
+        std::vector<ValueCode> free_codes;
+
+        ValueCode Acquire(std::string_view value);
+        void Release(ValueCode code);
+    };
+
+    std::vector<Column> columns_;
+    /* Row ids by positions, ascending */
+    std::vector<size_t> row_ids_;
+    boost::dynamic_bitset<> deleted_rows_;
+    size_t num_deleted_rows_ = 0;
+    size_t next_row_id_ = 0;
+
+    void AppendRows(IDatasetStream& table, std::vector<size_t>& changed_rows);
+    /* Every row of `update_data` is a row id followed by the new values */
+    void UpdateRows(IDatasetStream& update_data, std::vector<size_t>& changed_rows);
+    void DeleteRow(size_t row);
 
 public:
-    DynamicTableData(IDatasetStream& input_table) {
-        columns_.resize(input_table.GetNumberOfColumns());
-        while (input_table.HasNextRow()) {
-            std::vector<std::string> row = input_table.GetNextRow();
-            if (row.size() != columns_.size()) {
-                LOG(DEBUG) << "Got input table row with " << row.size() << " size, skipping...";
-                continue;
-            }
-            for (size_t i = 0; i < row.size(); ++i) {
-                columns_[i].push_back(std::move(row[i]));
-            }
-        };
-    }
+    explicit DynamicTableData(IDatasetStream& input_table);
 
     size_t GetNumRowsActual() const {
-        return columns_[0].size() - deleted_rows_.size();
+        return row_ids_.size() - num_deleted_rows_;
     }
 
+    /* Number of positions, including the ones of the deleted rows that are not compacted yet */
     size_t GetNumRowsTotal() const {
-        return columns_[0].size();
+        return row_ids_.size();
     }
 
-    std::string const& GetValue(size_t row_index, size_t col_index) const {
-        assert(col_index < columns_.size() && row_index < columns_[col_index].size());
-        return columns_[col_index][row_index];
+    std::string const& GetValue(size_t row, size_t col_index) const {
+        return *columns_[col_index].values[GetValueCode(row, col_index)];
     }
 
-    bool IsRowIndexValid(size_t row_index) {
-        return !(deleted_rows_.contains(row_index) || row_index >= GetNumRowsTotal());
+    ValueCode GetValueCode(size_t row, size_t col_index) const {
+        assert(col_index < columns_.size() && row < row_ids_.size() && !deleted_rows_.test(row));
+        return columns_[col_index].cells[row];
     }
 
-    void Update(config::InputTable insert_data, config::InputTable update_data,
-                std::unordered_set<size_t> const& delete_data) {
-        for (size_t row_id : delete_data) {
-            for (size_t i = 0; i < columns_.size(); ++i) {
-                columns_[i][row_id] = {};
-            }
-            deleted_rows_.emplace(row_id);
-        }
-        if (insert_data != nullptr) {
-            while (insert_data->HasNextRow()) {
-                std::vector<std::string> row = insert_data->GetNextRow();
-                if (row.size() != columns_.size()) {
-                    LOG(DEBUG) << "Got insert statement row with " << row.size()
-                               << " size, skipping...";
-                    continue;
-                }
-                for (size_t i = 0; i < row.size(); ++i) {
-                    columns_[i].push_back(std::move(row[i]));
-                }
-            }
-        }
-        if (update_data != nullptr) {
-            while (update_data->HasNextRow()) {
-                std::vector<std::string> row = update_data->GetNextRow();
-                if (row.size() != columns_.size() + 1) {
-                    LOG(DEBUG) << "Got update statement row with " << row.size()
-                               << " size, skipping...";
-                    continue;
-                }
-                size_t row_id = std::stoull(row.front());
-                if (deleted_rows_.contains(row_id)) {
-                    throw config::ConfigurationError(
-                            "Attempt to update a deleted row during processing of update "
-                            "operations");
-                }
-                for (size_t i = 1; i < row.size(); ++i) {
-                    columns_[i - 1][row_id] = std::move(row[i]);
-                }
-            }
-        }
+    size_t GetRowId(size_t row) const {
+        return row_ids_[row];
+    }
+
+    /* Position of the row with `row_id`, nullopt if there is no such row or it is deleted */
+    std::optional<size_t> FindRow(size_t row_id) const;
+
+    bool IsRowIndexValid(size_t row_id) const {
+        return FindRow(row_id).has_value();
     }
+
+    /* Deletes, inserts and updates rows, in this order. Returns the positions of the inserted and
+     * of the updated rows */
+    std::vector<size_t> Update(config::InputTable insert_data, config::InputTable update_data,
+                               std::unordered_set<size_t> const& delete_data);
+
+    /* Compaction pays off once at least half of the positions are taken by deleted rows */
+    bool NeedsCompaction() const {
+        return num_deleted_rows_ != 0 && num_deleted_rows_ >= GetNumRowsActual();
+    }
+
+    /* Drops the deleted rows. Returns the new positions of rows by the old ones, kNoRow for the
+     * dropped rows */
+    std::vector<int> Compact();
 };
 
 }  // namespace model
@@ -0,0 +1,35 @@
+#include "idataset_stream.h"
+
+#include <easylogging++.h>
+
+namespace model {
+
+size_t IDatasetStream::GetNextBatch(size_t max_rows, DatasetBatch& batch) {
+    size_t const num_columns = GetNumberOfColumns();
+    batch.Clear(num_columns);
+    while (batch.GetNumRows() < max_rows && HasNextRow()) {
+        Row row = GetNextRow();
+        if (row.size() != num_columns) {
+            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
+                         << num_columns << ", got " << row.size() << ")";
+            continue;
+        }
+        batch.AppendRowCopy(row);
+    }
+    return batch.GetNumRows();
+}
+
+std::vector<std::unique_ptr<IDatasetStream>> IDatasetStream::SplitIntoChunks(
+        [[maybe_unused]] size_t max_chunks) {
+    return {};
+}
+
+std::filesystem::path IDatasetStream::GetSourcePath() const {
+    return {};
+}
+
+std::string IDatasetStream::GetSourceFormat() const {
+    return {};
+}
+
+}  // namespace model
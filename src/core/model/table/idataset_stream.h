@@ -1,8 +1,12 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "dataset_batch.h"
+
 namespace model {
 
 class IDatasetStream {
@@ -16,6 +20,43 @@ public:
     [[nodiscard]] virtual std::string GetRelationName() const = 0;
     virtual void Reset() = 0;
     virtual ~IDatasetStream() = default;
+
+    ///
+    /// \brief replace the contents of `batch` with up to `max_rows` next rows
+    ///
+    /// \note Rows with a number of values other than GetNumberOfColumns() are skipped, so
+    ///       the result is 0 only when the stream is exhausted. The default implementation
+    ///       is built on GetNextRow(), streams override it to avoid allocating every row.
+    ///
+    /// @return number of rows in `batch`
+    ///
+    virtual size_t GetNextBatch(size_t max_rows, DatasetBatch& batch);
+
+    ///
+    /// \brief split the rest of the stream into parts that can be read concurrently
+    ///
+    /// \note Parts are record-aligned and cover the remaining rows in order. On success the
+    ///       stream itself is left exhausted. The default implementation does not split.
+    ///
+    /// @return at most `max_chunks` streams, or an empty vector if the stream can't be split
+    ///
+    virtual std::vector<std::unique_ptr<IDatasetStream>> SplitIntoChunks(size_t max_chunks);
+
+    ///
+    /// \brief file the stream reads the table from, e.g. to tell whether a snapshot of the
+    ///        table is up to date
+    ///
+    /// @return empty path if the table is not read from a file, which is the default
+    ///
+    [[nodiscard]] virtual std::filesystem::path GetSourcePath() const;
+
+    ///
+    /// \brief how the file of GetSourcePath() is split into rows and values, streams that read
+    ///        the same file into different tables return different formats
+    ///
+    /// @return empty string by default
+    ///
+    [[nodiscard]] virtual std::string GetSourceFormat() const;
 };
 
 }  // namespace model
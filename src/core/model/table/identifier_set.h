@@ -30,6 +30,9 @@ public:
 
     // Returns an intersection (agree_set(tuple, other.tuple)) of two IndetifierSets
     Vertical Intersect(IdentifierSet const& other) const;
+    // Same as Intersect, but as a ColumnSet or boost::dynamic_bitset<>, see DispatchColumnSet
+    template <typename ColumnSetType>
+    ColumnSetType IntersectColumns(IdentifierSet const& other) const;
 
 private:
     struct IdentifierSetValue {
@@ -42,8 +45,9 @@ private:
     int const tuple_index_;
 };
 
-inline Vertical IdentifierSet::Intersect(IdentifierSet const& other) const {
-    boost::dynamic_bitset<> intersection(relation_->GetNumColumns());
+template <typename ColumnSetType>
+ColumnSetType IdentifierSet::IntersectColumns(IdentifierSet const& other) const {
+    ColumnSetType intersection(relation_->GetNumColumns());
     auto p = data_.begin();
     auto q = other.data_.begin();
 
@@ -60,7 +64,12 @@ inline Vertical IdentifierSet::Intersect(IdentifierSet const& other) const {
         }
     }
 
-    return relation_->GetSchema()->GetVertical(intersection);
+    return intersection;
+}
+
+inline Vertical IdentifierSet::Intersect(IdentifierSet const& other) const {
+    return relation_->GetSchema()->GetVertical(
+            IntersectColumns<boost::dynamic_bitset<>>(other));
 }
 
 }  // namespace model
@@ -0,0 +1,304 @@
+/** \file
+ * \brief PLI cache
+ *
+ * PLICache methods definition
+ */
+#include "pli_cache.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+#include <easylogging++.h>
+
+#include "util/metrics.h"
+
+namespace model {
+
+namespace {
+
+/* The entropy and Gini based methods of Pyro are not implemented */
+bool IsSupported(CachingMethod caching_method) {
+    return caching_method == CachingMethod::kCoin || caching_method == CachingMethod::kNoCaching ||
+           caching_method == CachingMethod::kAllCaching;
+}
+
+constexpr char const* kUnsupportedCachingMethod =
+        "Only the kCoin, kNoCaching and kAllCaching caching methods are supported";
+
+}  // namespace
+
+PLICache::PLICache(ColumnLayoutRelationData* relation_data, CachingMethod caching_method,
+                   std::unique_ptr<PLICacheEvictionPolicy> eviction_policy,
+                   size_t memory_limit_bytes, unsigned nary_intersection_size,
+                   util::MemoryBudget* budget)
+    : relation_data_(relation_data),
+      index_(relation_data->GetSchema()),
+      probing_tables_(memory_limit_bytes / 4, budget),
+      eviction_policy_(std::move(eviction_policy)),
+      caching_method_(caching_method),
+      nary_intersection_size_(nary_intersection_size),
+      capacity_bytes_(memory_limit_bytes - memory_limit_bytes / 4),
+      budget_(budget) {
+    if (!IsSupported(caching_method)) {
+        throw std::invalid_argument(kUnsupportedCachingMethod);
+    }
+    for (auto& column_ptr : relation_data->GetSchema()->GetColumns()) {
+        index_.Put(static_cast<Vertical>(*column_ptr),
+                   relation_data->GetColumnData(column_ptr->GetIndex()).GetPliOwnership());
+    }
+}
+
+PLICache::~PLICache() {
+    if (budget_ != nullptr) {
+        budget_->Release(bytes_);
+    }
+}
+
+void PLICache::Touch(PositionListIndex& pli) {
+    pli.IncFreq();
+    if (auto it = entries_.find(&pli); it != entries_.end()) {
+        ++it->second.stats.uses;
+        it->second.stats.last_use = requests_;
+    }
+}
+
+std::shared_ptr<PositionListIndex> PLICache::Find(Vertical const& vertical) {
+    std::shared_ptr<PositionListIndex> pli = index_.Get(vertical);
+    if (pli != nullptr) {
+        Touch(*pli);
+    }
+    return pli;
+}
+
+PLICache::PLIPtr PLICache::Get(Vertical const& vertical) {
+    std::scoped_lock lock(mutex_);
+    ++requests_;
+    return Find(vertical);
+}
+
+std::vector<PLICache::PositionListIndexRank> PLICache::SelectOperands(
+        Vertical const& vertical, std::vector<CacheMap::Entry>& subset_entries,
+        std::vector<std::unique_ptr<Vertical>>& vertical_columns) {
+    // look for cached PLIs to construct the requested one
+    subset_entries = index_.GetSubsetEntries(vertical);
+    boost::optional<PositionListIndexRank> smallest_pli_rank;
+    std::vector<PositionListIndexRank> ranks;
+    ranks.reserve(subset_entries.size());
+    for (auto& [sub_vertical, sub_pli_ptr] : subset_entries) {
+        // TODO: избавиться от таких const_cast, которые сбрасывают константность
+        PositionListIndexRank pli_rank(&sub_vertical,
+                                       std::const_pointer_cast<PositionListIndex>(sub_pli_ptr),
+                                       sub_vertical.GetArity());
+        ranks.push_back(pli_rank);
+        if (!smallest_pli_rank || smallest_pli_rank->pli_->GetSize() > pli_rank.pli_->GetSize() ||
+            (smallest_pli_rank->pli_->GetSize() == pli_rank.pli_->GetSize() &&
+             smallest_pli_rank->added_arity_ < pli_rank.added_arity_)) {
+            smallest_pli_rank = pli_rank;
+        }
+    }
+    assert(smallest_pli_rank);  // check if smallest_pli_rank is initialized
+
+    std::vector<PositionListIndexRank> operands;
+    boost::dynamic_bitset<> cover(relation_data_->GetNumColumns());
+    boost::dynamic_bitset<> cover_tester(relation_data_->GetNumColumns());
+    if (smallest_pli_rank) {
+        operands.push_back(*smallest_pli_rank);
+        cover |= smallest_pli_rank->vertical_->GetColumnIndices();
+
+        while (cover.count() < vertical.GetArity() && !ranks.empty()) {
+            boost::optional<PositionListIndexRank> best_rank;
+            // erase ranks with low added_arity_
+            ranks.erase(std::remove_if(ranks.begin(), ranks.end(),
+                                       [&cover_tester, &cover](auto& rank) {
+                                           cover_tester.reset();
+                                           cover_tester |= rank.vertical_->GetColumnIndices();
+                                           cover_tester -= cover;
+                                           rank.added_arity_ = cover_tester.count();
+                                           return rank.added_arity_ < 2;
+                                       }),
+                        ranks.end());
+
+            for (auto& rank : ranks) {
+                if (!best_rank || best_rank->added_arity_ < rank.added_arity_ ||
+                    (best_rank->added_arity_ == rank.added_arity_ &&
+                     best_rank->pli_->GetSize() > rank.pli_->GetSize())) {
+                    best_rank = rank;
+                }
+            }
+
+            if (best_rank) {
+                operands.push_back(*best_rank);
+                cover |= best_rank->vertical_->GetColumnIndices();
+            }
+        }
+    }
+
+    // TODO: конкретные костыли, надо делать Column : Vertical
+    for (auto& column : vertical.GetColumns()) {
+        if (!cover[column->GetIndex()]) {
+            vertical_columns.push_back(std::make_unique<Vertical>(static_cast<Vertical>(*column)));
+            Vertical const* column_vertical = vertical_columns.back().get();
+            operands.emplace_back(column_vertical, index_.Get(*column_vertical), 1);
+        }
+    }
+    for (PositionListIndexRank& operand : operands) {
+        Touch(*operand.pli_);
+    }
+    // sort operands by ascending order
+    std::sort(operands.begin(), operands.end(),
+              [](auto& el1, auto& el2) { return el1.pli_->GetSize() < el2.pli_->GetSize(); });
+    return operands;
+}
+
+// obtains or calculates a PositionListIndex using cache
+PLICache::PLIPtr PLICache::GetOrCreateFor(Vertical const& vertical) {
+    /* Operands point to verticals of these two */
+    std::vector<CacheMap::Entry> subset_entries;
+    std::vector<std::unique_ptr<Vertical>> vertical_columns;
+    std::vector<PositionListIndexRank> operands;
+    {
+        std::scoped_lock lock(mutex_);
+        ++requests_;
+        LOG(DEBUG) << boost::format{"PLI for %1% requested: "} % vertical.ToString();
+
+        // is PLI already cached?
+        util::Metrics* metrics = util::Metrics::Current();
+        if (std::shared_ptr<PositionListIndex> pli = Find(vertical); pli != nullptr) {
+            ++hits_;
+            if (metrics != nullptr) metrics->PliCacheHits().Add();
+            LOG(DEBUG) << boost::format{"Served from PLI cache."};
+            return pli;
+        }
+        ++misses_;
+        if (metrics != nullptr) metrics->PliCacheMisses().Add();
+        operands = SelectOperands(vertical, subset_entries, vertical_columns);
+    }
+
+    if (operands.empty()) {
+        throw std::logic_error("Current implementation assumes operands.size() > 0");
+    }
+
+    /* Operands are owned here, so they are intersected without the lock even if they get evicted
+     * meanwhile */
+    PLIPtr intersection_pli;
+    if (operands.size() >= nary_intersection_size_) {
+        PositionListIndexRank const& base_pli_rank = operands[0];
+        intersection_pli = CachingProcess(
+                vertical, base_pli_rank.pli_->ProbeAll(vertical.Without(*base_pli_rank.vertical_),
+                                                       *relation_data_));
+    } else {
+        Vertical current_vertical = *operands.front().vertical_;
+        intersection_pli = operands.front().pli_;
+
+        for (size_t i = 1; i < operands.size(); i++) {
+            current_vertical = current_vertical.Union(*operands[i].vertical_);
+            intersection_pli = CachingProcess(
+                    current_vertical,
+                    intersection_pli->Intersect(operands[i].pli_.get(), probing_tables_));
+        }
+    }
+
+    LOG(DEBUG) << boost::format{"Calculated from %1% sub-PLIs (saved %2% intersections)."} %
+                          operands.size() % (vertical.GetArity() - operands.size());
+
+    return intersection_pli;
+}
+
+bool PLICache::ShouldCache() {
+    switch (caching_method_) {
+        case CachingMethod::kCoin:
+            return coin_();
+        case CachingMethod::kNoCaching:
+            return false;
+        case CachingMethod::kAllCaching:
+            return true;
+        default:
+            throw std::logic_error(kUnsupportedCachingMethod);
+    }
+}
+
+PLICache::PLIPtr PLICache::CachingProcess(Vertical const& vertical,
+                                          std::unique_ptr<PositionListIndex> pli) {
+    std::shared_ptr<PositionListIndex> shared_pli = std::move(pli);
+    size_t const bytes = shared_pli->GetBytes();
+
+    std::scoped_lock lock(mutex_);
+    if (!ShouldCache() || bytes > capacity_bytes_) return shared_pli;
+    if (std::shared_ptr<PositionListIndex> cached_pli = index_.Get(vertical);
+        cached_pli != nullptr) {
+        /* Another thread has just cached it */
+        return cached_pli;
+    }
+    if (!MakeRoom(bytes)) return shared_pli;
+    index_.Put(vertical, shared_pli);
+    entries_.emplace(shared_pli.get(),
+                     Entry{vertical, PLICacheEntryStats{.bytes = bytes, .uses = 1,
+                                                        .last_use = requests_}});
+    bytes_ += bytes;
+    return shared_pli;
+}
+
+bool PLICache::TryReserve(size_t bytes) {
+    return budget_ == nullptr || budget_->TryReserveEvictable(bytes);
+}
+
+void PLICache::Evict(PositionListIndex const* pli) {
+    auto it = entries_.find(pli);
+    std::shared_ptr<PositionListIndex> evicted = index_.Remove(it->second.vertical);
+    probing_tables_.Erase(*evicted);
+    bytes_ -= it->second.stats.bytes;
+    if (budget_ != nullptr) {
+        budget_->Release(it->second.stats.bytes);
+    }
+    entries_.erase(it);
+    ++evictions_;
+}
+
+bool PLICache::MakeRoom(size_t bytes) {
+    if (bytes_ + bytes <= capacity_bytes_ && TryReserve(bytes)) return true;
+
+    std::vector<PositionListIndex const*> plis;
+    std::vector<PLICacheEntryStats> stats;
+    plis.reserve(entries_.size());
+    stats.reserve(entries_.size());
+    for (auto const& [pli, entry] : entries_) {
+        plis.push_back(pli);
+        stats.push_back(entry.stats);
+    }
+
+    size_t const target_bytes = capacity_bytes_ / 4 * 3;
+    for (size_t victim : eviction_policy_->GetEvictionOrder(stats)) {
+        if (bytes_ + bytes <= target_bytes && TryReserve(bytes)) return true;
+        Evict(plis[victim]);
+    }
+    return bytes_ + bytes <= capacity_bytes_ && TryReserve(bytes);
+}
+
+size_t PLICache::Size() const {
+    std::scoped_lock lock(mutex_);
+    return index_.GetSize();
+}
+
+size_t PLICache::GetBytes() const {
+    std::scoped_lock lock(mutex_);
+    return bytes_;
+}
+
+size_t PLICache::GetHits() const {
+    std::scoped_lock lock(mutex_);
+    return hits_;
+}
+
+size_t PLICache::GetMisses() const {
+    std::scoped_lock lock(mutex_);
+    return misses_;
+}
+
+size_t PLICache::GetEvictions() const {
+    std::scoped_lock lock(mutex_);
+    return evictions_;
+}
+
+}  // namespace model
@@ -0,0 +1,152 @@
+/** \file
+ * \brief PLI cache
+ *
+ * Definition of the PLICache class, a memory-limited cache of the PLIs of column combinations.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "cache_eviction_method.h"
+#include "caching_method.h"
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/pli_cache_eviction_policy.h"
+#include "model/table/position_list_index.h"
+#include "model/table/probing_table_cache.h"
+#include "model/table/vertical.h"
+#include "model/table/vertical_map.h"
+#include "util/memory_budget.h"
+
+namespace model {
+
+///
+/// \brief PLIs of column combinations, computed from the cached PLIs of their subsets
+///
+/// A requested PLI is intersected from the largest cached subsets that cover it and the column
+/// PLIs of the relation. The intermediate and final results are cached according to the
+/// CachingMethod. Cached PLIs are accounted for in bytes, and once they don't fit into the memory
+/// limit, the PLICacheEvictionPolicy picks the ones to drop. Column PLIs belong to the relation
+/// and are never evicted. Given a util::MemoryBudget, the cache reserves the PLIs there as
+/// evictable memory too and evicts more when it is refused, so it gives way to the structures of
+/// the algorithm that can't be dropped.
+///
+/// PLIs are handed out as shared pointers, so an evicted PLI stays valid for as long as a caller
+/// uses it.
+///
+/// \note All methods are thread-safe. Intersections run outside of the lock, so two threads
+///       requesting the same PLI at once may both compute it.
+///
+class PLICache {
+public:
+    using PLIPtr = std::shared_ptr<PositionListIndex const>;
+
+    static constexpr size_t kDefaultMemoryLimitBytes = size_t{2} << 30;
+    static constexpr unsigned kDefaultNaryIntersectionSize = 4;
+
+private:
+    class PositionListIndexRank {
+    public:
+        Vertical const* vertical_;
+        std::shared_ptr<PositionListIndex> pli_;
+        int added_arity_;
+
+        PositionListIndexRank(Vertical const* vertical, std::shared_ptr<PositionListIndex> pli,
+                              int initial_arity)
+            : vertical_(vertical), pli_(std::move(pli)), added_arity_(initial_arity) {}
+    };
+
+    struct Entry {
+        Vertical vertical;
+        PLICacheEntryStats stats;
+    };
+
+    using CacheMap = VerticalMap<PositionListIndex>;
+
+    ColumnLayoutRelationData* relation_data_;
+    CacheMap index_;
+    /* Evictable PLIs, i.e. all but the column ones */
+    std::unordered_map<PositionListIndex const*, Entry> entries_;
+    /* Cached PLIs are intersection operands over and over */
+    ProbingTableCache probing_tables_;
+    std::unique_ptr<PLICacheEvictionPolicy> eviction_policy_;
+    CachingMethod caching_method_;
+    /* Decides whether a PLI is cached with CachingMethod::kCoin */
+    std::function<bool()> coin_;
+    unsigned nary_intersection_size_;
+    size_t capacity_bytes_;
+    util::MemoryBudget* budget_;
+
+    mutable std::mutex mutex_;
+    size_t bytes_ = 0;
+    std::uint64_t requests_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+
+    /* Records a use of a cached PLI */
+    void Touch(PositionListIndex& pli);
+    std::shared_ptr<PositionListIndex> Find(Vertical const& vertical);
+    /* Picks cached PLIs whose intersection is the PLI of `vertical`. Operands point into
+     * `subset_entries` and `vertical_columns` */
+    std::vector<PositionListIndexRank> SelectOperands(
+            Vertical const& vertical, std::vector<CacheMap::Entry>& subset_entries,
+            std::vector<std::unique_ptr<Vertical>>& vertical_columns);
+    PLIPtr CachingProcess(Vertical const& vertical, std::unique_ptr<PositionListIndex> pli);
+    bool ShouldCache();
+    /* Evicts PLIs until `bytes` more take at most three quarters of the capacity, so that a full
+     * cache doesn't rank its entries on every insertion, and until the budget lets them in.
+     * The bytes are reserved in the budget on success */
+    bool MakeRoom(size_t bytes);
+    bool TryReserve(size_t bytes);
+    void Evict(PositionListIndex const* pli);
+
+public:
+    /// \param caching_method kCoin, kNoCaching or kAllCaching, std::invalid_argument is thrown for
+    ///        the others
+    /// \param memory_limit_bytes limit for cached PLIs and probing tables, probing tables get a
+    ///        quarter of it
+    /// \param nary_intersection_size number of operands from which the PLI is probed by all of
+    ///        their columns at once instead of intersecting them pairwise
+    /// \param budget budget of the algorithm the cached PLIs and probing tables are reserved in
+    PLICache(ColumnLayoutRelationData* relation_data, CachingMethod caching_method,
+             std::unique_ptr<PLICacheEvictionPolicy> eviction_policy,
+             size_t memory_limit_bytes = kDefaultMemoryLimitBytes,
+             unsigned nary_intersection_size = kDefaultNaryIntersectionSize,
+             util::MemoryBudget* budget = nullptr);
+
+    PLICache(PLICache const&) = delete;
+    PLICache& operator=(PLICache const&) = delete;
+    ~PLICache();
+
+    void SetCoin(std::function<bool()> coin) {
+        coin_ = std::move(coin);
+    }
+
+    /// cached PLI of `vertical` or null, counts as a use of the PLI but not as a hit
+    PLIPtr Get(Vertical const& vertical);
+    /// cached PLI of `vertical`, computed on a miss
+    PLIPtr GetOrCreateFor(Vertical const& vertical);
+
+    [[nodiscard]] size_t Size() const;
+
+    [[nodiscard]] size_t GetCapacityBytes() const noexcept {
+        return capacity_bytes_;
+    }
+
+    /// memory taken by the evictable PLIs
+    [[nodiscard]] size_t GetBytes() const;
+    [[nodiscard]] size_t GetHits() const;
+    [[nodiscard]] size_t GetMisses() const;
+    [[nodiscard]] size_t GetEvictions() const;
+
+    [[nodiscard]] ProbingTableCache const& GetProbingTables() const noexcept {
+        return probing_tables_;
+    }
+};
+
+}  // namespace model
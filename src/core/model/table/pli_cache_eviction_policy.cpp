@@ -0,0 +1,67 @@
+/** \file
+ * \brief PLI cache eviction policies
+ *
+ * Eviction policies methods definition
+ */
+#include "pli_cache_eviction_policy.h"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace model {
+
+namespace {
+
+template <typename Key>
+std::vector<size_t> SortBy(std::vector<PLICacheEntryStats> const& entries, Key key) {
+    std::vector<size_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&entries, &key](size_t lhs, size_t rhs) {
+        return key(entries[lhs]) < key(entries[rhs]);
+    });
+    return order;
+}
+
+}  // namespace
+
+std::vector<size_t> LeastRecentlyUsedPolicy::GetEvictionOrder(
+        std::vector<PLICacheEntryStats> const& entries) const {
+    return SortBy(entries, [](PLICacheEntryStats const& entry) { return entry.last_use; });
+}
+
+std::vector<size_t> MedianUsagePolicy::GetEvictionOrder(
+        std::vector<PLICacheEntryStats> const& entries) const {
+    if (entries.empty()) return {};
+    std::vector<unsigned> uses;
+    uses.reserve(entries.size());
+    for (PLICacheEntryStats const& entry : entries) {
+        uses.push_back(entry.uses);
+    }
+    auto median = uses.begin() + uses.size() / 2;
+    std::nth_element(uses.begin(), median, uses.end());
+    return SortBy(entries, [median_uses = *median](PLICacheEntryStats const& entry) {
+        return std::make_tuple(entry.uses >= median_uses, entry.last_use);
+    });
+}
+
+std::vector<size_t> HotToRemainPolicy::GetEvictionOrder(
+        std::vector<PLICacheEntryStats> const& entries) const {
+    return SortBy(entries, [](PLICacheEntryStats const& entry) {
+        return std::make_tuple(entry.uses, entry.last_use);
+    });
+}
+
+std::unique_ptr<PLICacheEvictionPolicy> CreateEvictionPolicy(CacheEvictionMethod method) {
+    switch (method) {
+        case CacheEvictionMethod::kDefault:
+            return std::make_unique<LeastRecentlyUsedPolicy>();
+        case CacheEvictionMethod::kMedainUsage:
+            return std::make_unique<MedianUsagePolicy>();
+        case CacheEvictionMethod::kHottoRemain:
+            return std::make_unique<HotToRemainPolicy>();
+    }
+    return std::make_unique<LeastRecentlyUsedPolicy>();
+}
+
+}  // namespace model
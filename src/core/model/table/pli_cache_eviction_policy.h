@@ -0,0 +1,64 @@
+/** \file
+ * \brief PLI cache eviction policies
+ *
+ * Definition of the PLICacheEvictionPolicy interface and of the policies selected by
+ * CacheEvictionMethod.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "cache_eviction_method.h"
+
+namespace model {
+
+/// what an eviction policy knows about a PLI held by PLICache
+struct PLICacheEntryStats {
+    /// memory taken by the PLI
+    size_t bytes;
+    /// number of requests served by the PLI, including the one that created it
+    unsigned uses;
+    /// request number of the latest use, larger is more recent
+    std::uint64_t last_use;
+};
+
+///
+/// \brief decides which PLIs PLICache drops once its memory limit is reached
+///
+class PLICacheEvictionPolicy {
+public:
+    /// indices of `entries` in the order they should be evicted in. The cache evicts a prefix of
+    /// it that frees enough memory
+    virtual std::vector<size_t> GetEvictionOrder(
+            std::vector<PLICacheEntryStats> const& entries) const = 0;
+
+    virtual ~PLICacheEvictionPolicy() = default;
+};
+
+/// least recently used PLIs go first
+class LeastRecentlyUsedPolicy final : public PLICacheEvictionPolicy {
+public:
+    std::vector<size_t> GetEvictionOrder(
+            std::vector<PLICacheEntryStats> const& entries) const final;
+};
+
+/// PLIs used less often than the median go first, least recently used among them first
+class MedianUsagePolicy final : public PLICacheEvictionPolicy {
+public:
+    std::vector<size_t> GetEvictionOrder(
+            std::vector<PLICacheEntryStats> const& entries) const final;
+};
+
+/// least frequently used PLIs go first, so the hot ones remain
+class HotToRemainPolicy final : public PLICacheEvictionPolicy {
+public:
+    std::vector<size_t> GetEvictionOrder(
+            std::vector<PLICacheEntryStats> const& entries) const final;
+};
+
+std::unique_ptr<PLICacheEvictionPolicy> CreateEvictionPolicy(CacheEvictionMethod method);
+
+}  // namespace model
@@ -6,26 +6,44 @@
 #include "position_list_index.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
-#include <deque>
-#include <map>
 #include <memory>
+#include <span>
 #include <utility>
 
 #include <boost/dynamic_bitset.hpp>
-#include <easylogging++.h>
 
 #include "model/table/column_layout_relation_data.h"
+#include "model/table/probing_table_cache.h"
 #include "model/table/vertical.h"
+#include "util/metrics.h"
 
 namespace model {
 
+namespace {
+
+/* Scratch buffers of PositionListIndex::ProbeClusters. Each thread has its own, so Pyro's workers
+ * probe concurrently without allocating. `slots` is indexed by probing table value and holds
+ * zeros between calls, only the values listed in `touched_values` are reset after a cluster */
+struct ProbeScratch {
+    std::vector<unsigned> slots;
+    std::vector<int> touched_values;
+};
+
+ProbeScratch& GetProbeScratch() {
+    thread_local ProbeScratch scratch;
+    return scratch;
+}
+
+std::atomic<std::uint64_t> next_pli_id{0};
+
+}  // namespace
+
 int const PositionListIndex::kSingletonValueId = 0;
-unsigned long long PositionListIndex::micros_ = 0;
-int PositionListIndex::intersection_count_ = 0;
 
-PositionListIndex::PositionListIndex(std::deque<std::vector<int>> index,
+PositionListIndex::PositionListIndex(ClusterIndex index,
                                      std::vector<int> null_cluster, unsigned int size,
                                      double entropy, unsigned long long nep,
                                      unsigned int relation_size,
@@ -40,7 +58,15 @@ PositionListIndex::PositionListIndex(std::deque<std::vector<int>> index,
       nep_(nep),
       relation_size_(relation_size),
       original_relation_size_(original_relation_size),
-      probing_table_cache_() {}
+      probing_table_cache_(),
+      id_(next_pli_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+PositionListIndex::~PositionListIndex() {
+    /* Otherwise the table of a transient PLI would take the room of the cache until evicted */
+    if (ProbingTableCache* cache = table_cache_.load(std::memory_order_acquire)) {
+        cache->Erase(*this);
+    }
+}
 
 std::unique_ptr<PositionListIndex> PositionListIndex::CreateFor(std::vector<int>& data,
                                                                 bool is_null_eq_null) {
@@ -63,7 +89,8 @@ std::unique_ptr<PositionListIndex> PositionListIndex::CreateFor(std::vector<int>
     double gini_gap = 0;
     unsigned long long nep = 0;
     unsigned int size = 0;
-    std::deque<std::vector<int>> clusters;
+    ClusterIndex clusters;
+    clusters.Reserve(data.size(), index.size());
 
     for (auto& iter : index) {
         if (iter.second.size() == 1) {
@@ -77,7 +104,7 @@ std::unique_ptr<PositionListIndex> PositionListIndex::CreateFor(std::vector<int>
                    std::log(1 - (iter.second.size() / static_cast<double>(data.size())));
         gini_gap += std::pow(iter.second.size() / static_cast<double>(data.size()), 2);
 
-        clusters.emplace_back(std::move(iter.second));
+        clusters.Append(iter.second.begin(), iter.second.end());
     }
     double entropy = log(data.size()) - key_gap / data.size();
 
@@ -86,14 +113,14 @@ std::unique_ptr<PositionListIndex> PositionListIndex::CreateFor(std::vector<int>
         inv_ent = 0;
     }
 
-    SortClusters(clusters);
+    clusters.SortClusters();
     return std::make_unique<PositionListIndex>(std::move(clusters), std::move(null_cluster), size,
                                                entropy, nep, data.size(), data.size(), inv_ent,
                                                gini_impurity);
 }
 
 std::unordered_map<int, unsigned> PositionListIndex::CreateFrequencies(
-        Cluster const& cluster, std::vector<int> const& probing_table) {
+        ClusterView cluster, ProbingTable probing_table) {
     std::unordered_map<int, unsigned> frequencies;
 
     for (int const tuple_index : cluster) {
@@ -111,25 +138,55 @@ std::unordered_map<int, unsigned> PositionListIndex::CreateFrequencies(
 //
 // }
 
-void PositionListIndex::SortClusters(std::deque<std::vector<int>>& clusters) {
-    sort(clusters.begin(), clusters.end(),
-         [](std::vector<int> const& a, std::vector<int> const& b) { return a[0] < b[0]; });
+PositionListIndex::ProbingTablePtr PositionListIndex::MakeProbingTable(std::vector<int> values) {
+    struct OwnedTable {
+        std::vector<int> values;
+        ProbingTable table;
+    };
+    auto owned = std::make_shared<OwnedTable>(std::move(values));
+    owned->table = owned->values;
+    return {owned, &owned->table};
 }
 
-std::shared_ptr<std::vector<int> const> PositionListIndex::CalculateAndGetProbingTable() const {
+PositionListIndex::ProbingTablePtr PositionListIndex::CalculateAndGetProbingTable() const {
     if (probing_table_cache_ != nullptr) return probing_table_cache_;
 
-    std::vector<int> probing_table = std::vector<int>(original_relation_size_);
+    std::vector<int> probing_table(original_relation_size_);
     int next_cluster_id = kSingletonValueId + 1;
-    for (auto& cluster : index_) {
+    ForEachCluster([&probing_table, &next_cluster_id](ClusterView cluster) {
         int value_id = next_cluster_id++;
         assert(value_id != kSingletonValueId);
         for (int position : cluster) {
             probing_table[position] = value_id;
         }
+    });
+
+    return MakeProbingTable(std::move(probing_table));
+}
+
+ClusterIndex const& PositionListIndex::GetIndex() const {
+    assert(compressed_index_ == nullptr);
+    return index_;
+}
+
+ClusterIndex& PositionListIndex::GetIndex() {
+    if (compressed_index_ != nullptr) {
+        index_ = compressed_index_->Decode(index_.GetResource());
+        compressed_index_.reset();
+    } else if (index_.IsView()) {
+        index_ = ClusterIndex::FromClusters(index_);
     }
+    return index_;
+}
 
-    return std::make_shared<std::vector<int>>(probing_table);
+bool PositionListIndex::Compress() {
+    if (compressed_index_ != nullptr) return true;
+    auto compressed_index =
+            std::make_unique<CompressedClusterIndex const>(index_, original_relation_size_);
+    if (compressed_index->GetBytes() >= index_.GetBytes()) return false;
+    compressed_index_ = std::move(compressed_index);
+    index_ = ClusterIndex(index_.GetResource());
+    return true;
 }
 
 // интересное место: true --> надо передать поле без копирования, false --> надо сконструировать и
@@ -148,126 +205,154 @@ std::shared_ptr<std::vector<int> const> PositionListIndex::CalculateAndGetProbin
 // }
 
 std::unique_ptr<PositionListIndex> PositionListIndex::Intersect(
-        PositionListIndex const* that) const {
+        PositionListIndex const* that, std::pmr::memory_resource* resource) const {
     assert(this->relation_size_ == that->relation_size_);
 
     if (this->size_ > that->size_) {
-        return that->Probe(this->CalculateAndGetProbingTable());
+        return that->Probe(this->CalculateAndGetProbingTable(), resource);
     } else {
-        return this->Probe(that->CalculateAndGetProbingTable());
+        return this->Probe(that->CalculateAndGetProbingTable(), resource);
     }
 }
 
-// TODO: null_cluster_ некорректен
-std::unique_ptr<PositionListIndex> PositionListIndex::Probe(
-        std::shared_ptr<std::vector<int> const> probing_table) const {
-    assert(this->relation_size_ == probing_table->size());
-    std::deque<std::vector<int>> new_index;
-    unsigned int new_size = 0;
-    double new_key_gap = 0.0;
-    unsigned long long new_nep = 0;
-    std::vector<int> null_cluster;
-
-    std::unordered_map<int, std::vector<int>> partial_index;
-
-    for (auto& positions : index_) {
-        for (int position : positions) {
-            if (probing_table == nullptr) LOG(DEBUG) << "NULLPTR";
-            if (position < 0 || static_cast<size_t>(position) >= probing_table->size()) {
-                LOG(DEBUG) << "position: " + std::to_string(position) +
-                                      ", size: " + std::to_string(probing_table->size());
-                for (size_t i = 0; i < positions.size(); ++i) {
-                    LOG(DEBUG) << "Position " + std::to_string(positions[i]);
-                }
-            }
-            int probing_table_value_id = (*probing_table)[position];
-            if (probing_table_value_id == kSingletonValueId) continue;
-            intersection_count_++;
-            partial_index[probing_table_value_id].push_back(position);
-        }
-
-        for (auto& iter : partial_index) {
-            auto& cluster = iter.second;
-            if (cluster.size() <= 1) continue;
-
-            new_size += cluster.size();
-            new_key_gap += cluster.size() * log(cluster.size());
-            new_nep += CalculateNep(cluster.size());
+std::unique_ptr<PositionListIndex> PositionListIndex::Intersect(
+        PositionListIndex const* that, ProbingTableCache& probing_tables,
+        std::pmr::memory_resource* resource) const {
+    assert(this->relation_size_ == that->relation_size_);
 
-            new_index.push_back(std::move(cluster));
-        }
-        partial_index.clear();
+    if (this->size_ > that->size_) {
+        return that->Probe(probing_tables.GetProbingTable(*this), resource);
+    } else {
+        return this->Probe(probing_tables.GetProbingTable(*that), resource);
     }
+}
 
-    double new_entropy = log(relation_size_) - new_key_gap / relation_size_;
-    SortClusters(new_index);
-
-    return std::make_unique<PositionListIndex>(std::move(new_index), std::move(null_cluster),
-                                               new_size, new_entropy, new_nep, relation_size_,
-                                               relation_size_);
+// TODO: null_cluster_ некорректен
+std::unique_ptr<PositionListIndex> PositionListIndex::Probe(
+        ProbingTablePtr probing_table, std::pmr::memory_resource* resource) const {
+    assert(probing_table != nullptr && this->relation_size_ == probing_table->size());
+    util::Metrics* metrics = util::Metrics::Current();
+    util::ScopedTimer timer(metrics != nullptr ? &metrics->PliIntersectionTime() : nullptr);
+    ClusterIndex new_index(resource != nullptr ? resource : std::pmr::get_default_resource());
+    unsigned long long probed_count = 0;
+    ForEachCluster([&probing_table, &new_index, &probed_count](ClusterView cluster) {
+        probed_count += ProbeCluster(cluster, *probing_table, new_index);
+    });
+    if (metrics != nullptr) {
+        metrics->PliIntersections().Add();
+        metrics->PliProbedRows().Add(probed_count);
+    }
+    return CreateFromProbedIndex(std::move(new_index), relation_size_);
 }
 
 // TODO: null_cluster_ не поддерживается
 std::unique_ptr<PositionListIndex> PositionListIndex::ProbeAll(
         Vertical const& probing_columns, ColumnLayoutRelationData& relation_data) {
     assert(this->relation_size_ == relation_data.GetNumRows());
-    std::deque<std::vector<int>> new_index;
-    unsigned int new_size = 0;
-    double new_key_gap = 0.0;
-    unsigned long long new_nep = 0;
-
-    std::map<std::vector<int>, std::vector<int>> partial_index;
-    std::vector<int> null_cluster;
-    std::vector<int> probe;
-
-    for (auto& cluster : this->index_) {
-        for (int position : cluster) {
-            if (!TakeProbe(position, relation_data, probing_columns, probe)) {
-                probe.clear();
-                continue;
-            }
-
-            partial_index[probe].push_back(position);
-            probe.clear();
+    /* Two rows agree on all probing columns iff they still share a cluster after probing by
+     * the columns one by one, so no composite keys are needed */
+    boost::dynamic_bitset<> const& probing_indices = probing_columns.GetColumnIndices();
+    size_t index = probing_indices.find_first();
+    if (index == boost::dynamic_bitset<>::npos) {
+        ClusterIndex index = compressed_index_ != nullptr ? compressed_index_->Decode()
+                                                          : ClusterIndex::FromClusters(index_);
+        return CreateFromProbedIndex(std::move(index), this->relation_size_);
+    }
+    util::Metrics* metrics = util::Metrics::Current();
+    util::ScopedTimer timer(metrics != nullptr ? &metrics->PliIntersectionTime() : nullptr);
+    ClusterIndex new_index;
+    unsigned long long probed_count = 0;
+    ProbingTable probing_table = relation_data.GetColumnData(index).GetProbingTable();
+    ForEachCluster([probing_table, &new_index, &probed_count](ClusterView cluster) {
+        probed_count += ProbeCluster(cluster, probing_table, new_index);
+    });
+    for (index = probing_indices.find_next(index); index != boost::dynamic_bitset<>::npos;
+         index = probing_indices.find_next(index)) {
+        ClusterIndex next_index;
+        probing_table = relation_data.GetColumnData(index).GetProbingTable();
+        for (ClusterView cluster : new_index) {
+            probed_count += ProbeCluster(cluster, probing_table, next_index);
         }
+        new_index = std::move(next_index);
+    }
+    if (metrics != nullptr) {
+        metrics->PliIntersections().Add(probing_indices.count());
+        metrics->PliProbedRows().Add(probed_count);
+    }
+    return CreateFromProbedIndex(std::move(new_index), this->relation_size_);
+}
 
-        for (auto& iter : partial_index) {
-            auto& new_cluster = iter.second;
-            if (new_cluster.size() == 1) continue;
-
-            new_size += new_cluster.size();
-            new_key_gap += new_cluster.size() * log(new_cluster.size());
-            new_nep += CalculateNep(new_cluster.size());
+unsigned long long PositionListIndex::ProbeCluster(ClusterView cluster, ProbingTable probing_table,
+                                                   ClusterIndex& new_index) {
+    ProbeScratch& scratch = GetProbeScratch();
+    std::vector<unsigned>& slots = scratch.slots;
+    std::vector<int>& touched_values = scratch.touched_values;
+    if (slots.empty()) {
+        /* Rows with kSingletonValueId are looked up in the second pass too */
+        slots.resize(kSingletonValueId + 1);
+    }
 
-            new_index.emplace_back(std::move(new_cluster));
+    /* First pass: count rows of the cluster per probing table value */
+    for (int position : cluster) {
+        int const value = probing_table[position];
+        if (value == kSingletonValueId) continue;
+        if (static_cast<size_t>(value) >= slots.size()) {
+            slots.resize(value + 1);
+        }
+        if (slots[value]++ == 0) {
+            touched_values.push_back(value);
         }
-        partial_index.clear();
+    }
+    if (touched_values.empty()) return 0;
+
+    /* Reserve a new cluster for every value met at least twice. From now on a slot holds the
+     * next write position plus one, and zero for rows that are dropped */
+    unsigned long long probed_count = 0;
+    size_t const num_positions = new_index.GetNumPositions();
+    for (int value : touched_values) {
+        unsigned const count = slots[value];
+        probed_count += count;
+        slots[value] = count > 1 ? new_index.AppendCluster(count) + 1 : 0;
     }
 
-    double new_entropy = log(this->relation_size_) - new_key_gap / this->relation_size_;
-
-    SortClusters(new_index);
+    /* Second pass: scatter rows into their clusters, keeping their order */
+    if (new_index.GetNumPositions() != num_positions) {
+        std::span<int> const positions = new_index.GetPositions();
+        for (int position : cluster) {
+            unsigned& slot = slots[probing_table[position]];
+            if (slot != 0) {
+                positions[slot++ - 1] = position;
+            }
+        }
+    }
 
-    return std::make_unique<PositionListIndex>(std::move(new_index), std::move(null_cluster),
-                                               new_size, new_entropy, new_nep, this->relation_size_,
-                                               this->relation_size_);
+    for (int value : touched_values) {
+        slots[value] = 0;
+    }
+    touched_values.clear();
+    return probed_count;
 }
 
-bool PositionListIndex::TakeProbe(int position, ColumnLayoutRelationData& relation_data,
-                                  Vertical const& probing_columns, std::vector<int>& probe) {
-    boost::dynamic_bitset<> probing_indices = probing_columns.GetColumnIndices();
-    for (unsigned long index = probing_indices.find_first(); index < probing_indices.size();
-         index = probing_indices.find_next(index)) {
-        int value = relation_data.GetColumnData(index).GetProbingTableValue(position);
-        if (value == PositionListIndex::kSingletonValueId) return false;
-        probe.push_back(value);
+std::unique_ptr<PositionListIndex> PositionListIndex::CreateFromProbedIndex(
+        ClusterIndex new_index, unsigned int relation_size) {
+    new_index.SortClusters();
+    double new_key_gap = 0.0;
+    unsigned long long new_nep = 0;
+    for (ClusterView cluster : new_index) {
+        new_key_gap += cluster.size() * log(cluster.size());
+        new_nep += CalculateNep(cluster.size());
     }
-    return true;
+    double new_entropy = log(relation_size) - new_key_gap / relation_size;
+    unsigned int new_size = new_index.GetNumPositions();
+
+    return std::make_unique<PositionListIndex>(std::move(new_index), Cluster{}, new_size,
+                                               new_entropy, new_nep, relation_size,
+                                               relation_size);
 }
 
 std::string PositionListIndex::ToString() const {
     std::string res = "[";
-    for (auto& cluster : index_) {
+    ForEachCluster([&res](ClusterView cluster) {
         res.push_back('[');
         for (int v : cluster) {
             res.append(std::to_string(v) + ",");
@@ -275,7 +360,7 @@ std::string PositionListIndex::ToString() const {
         if (res.find(',') != std::string::npos) res.erase(res.find_last_of(','));
         res.push_back(']');
         res.push_back(',');
-    }
+    });
     if (res.find(',') != std::string::npos) res.erase(res.find_last_of(','));
     res.push_back(']');
     return res;
@@ -4,24 +4,40 @@
 //
 
 #pragma once
-#include <deque>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
+#include "model/table/cluster_index.h"
+#include "model/table/compressed_cluster_index.h"
 #include "model/table/column.h"
 
 class ColumnLayoutRelationData;
 
 namespace model {
 
+class ProbingTableCache;
+
 class PositionListIndex {
 public:
     /* Vector of tuple indices */
     using Cluster = std::vector<int>;
+    /* Clusters of the index are views into its flat storage */
+    using ClusterView = ClusterIndex::ConstCluster;
+    /* Id of the cluster of every row, kSingletonValueId for the rows of no cluster. A table may
+     * refer to memory it doesn't own, e.g. a mapped snapshot, the pointer keeps that alive */
+    using ProbingTable = std::span<int const>;
+    using ProbingTablePtr = std::shared_ptr<ProbingTable const>;
 
 private:
-    std::deque<Cluster> index_;
+    /* Empty while the PLI is compressed */
+    ClusterIndex index_;
+    std::unique_ptr<CompressedClusterIndex const> compressed_index_;
     Cluster null_cluster_;
     unsigned int size_;
     double entropy_;
@@ -30,37 +46,51 @@ private:
     unsigned long long nep_;
     unsigned int relation_size_;
     unsigned int original_relation_size_;
-    std::shared_ptr<std::vector<int> const> probing_table_cache_;
+    ProbingTablePtr probing_table_cache_;
     unsigned int freq_ = 0;
+    /* Unique for the process lifetime, unlike the address */
+    std::uint64_t id_;
+    /* Cache that holds the probing table of this PLI, if any, the table is erased from there when
+     * the PLI is destroyed. Set and cleared by the cache */
+    mutable std::atomic<ProbingTableCache*> table_cache_ = nullptr;
+
+    friend class ProbingTableCache;
 
     static unsigned long long CalculateNep(unsigned int num_elements) {
         return static_cast<unsigned long long>(num_elements) * (num_elements - 1) / 2;
     }
 
-    static void SortClusters(std::deque<Cluster>& clusters);
-    static bool TakeProbe(int position, ColumnLayoutRelationData& relation_data,
-                          Vertical const& probing_columns, std::vector<int>& probe);
+    /* Splits `cluster` by the values of `probing_table` and appends the parts that have at least
+     * two rows to `new_index`. Counts rows per value in a reusable per-thread array instead of
+     * hashing them, so no memory is allocated besides the result.
+     * Returns the number of rows that were not singletons in `probing_table` */
+    static unsigned long long ProbeCluster(ClusterView cluster, ProbingTable probing_table,
+                                           ClusterIndex& new_index);
+    static std::unique_ptr<PositionListIndex> CreateFromProbedIndex(ClusterIndex new_index,
+                                                                    unsigned int relation_size);
 
 public:
-    static int intersection_count_;
-    static unsigned long long micros_;
     static int const kSingletonValueId;
 
-    PositionListIndex(std::deque<Cluster> index, Cluster null_cluster, unsigned int size,
+    PositionListIndex(ClusterIndex index, Cluster null_cluster, unsigned int size,
                       double entropy, unsigned long long nep, unsigned int relation_size,
                       unsigned int original_relation_size, double inverted_entropy = 0,
                       double gini_impurity = 0);
+    ~PositionListIndex();
     static std::unique_ptr<PositionListIndex> CreateFor(std::vector<int>& data,
                                                         bool is_null_eq_null);
 
-    static std::unordered_map<int, unsigned> CreateFrequencies(
-            Cluster const& cluster, std::vector<int> const& probing_table);
+    static std::unordered_map<int, unsigned> CreateFrequencies(ClusterView cluster,
+                                                               ProbingTable probing_table);
+
+    /* Table that owns `values` */
+    static ProbingTablePtr MakeProbingTable(std::vector<int> values);
 
     // если PT закеширована, выдаёт её, иначе предварительно вычисляет её -- тяжёлая операция
-    std::shared_ptr<std::vector<int> const> CalculateAndGetProbingTable() const;
+    ProbingTablePtr CalculateAndGetProbingTable() const;
 
     // выдаёт закешированную PT, либо nullptr, если она не закеширована
-    std::vector<int> const* GetCachedProbingTable() const {
+    ProbingTable const* GetCachedProbingTable() const {
         return probing_table_cache_.get();
     };
 
@@ -69,6 +99,12 @@ public:
         probing_table_cache_ = CalculateAndGetProbingTable();
     };
 
+    /* Caches a probing table computed elsewhere, e.g. read from a snapshot */
+    void CacheProbingTable(ProbingTablePtr probing_table) {
+        assert(probing_table->size() == original_relation_size_);
+        probing_table_cache_ = std::move(probing_table);
+    }
+
     // Такая структура с кешированием ProbingTable нужна, потому что к PT одиночных колонок
     // происходят частые обращения, чтобы узнать какую-то одну конкретную позицию, тогда как PT
     // наборов колонок обычно используются, чтобы один раз пересечь две партиции, и больше к ним не
@@ -76,13 +112,47 @@ public:
 
     // std::shared_ptr<const std::vector<int>> GetProbingTable(bool isCaching);
 
-    std::deque<Cluster> const& GetIndex() const noexcept {
-        return index_;
-    };
+    /* Only for a PLI that is not compressed, the clusters of a compressed one are walked with
+     * ForEachCluster, or decoded with the non-const overload */
+    ClusterIndex const& GetIndex() const;
+
+    /* If you use this method and change index in any way, all other methods will become invalid.
+     * Decompresses the PLI, and copies the clusters of a PLI read from a mapped snapshot */
+    ClusterIndex& GetIndex();
+
+    /* Calls f(ClusterView) for every cluster in order. Clusters of a compressed PLI are decoded
+     * one at a time, and a view is valid only during its call */
+    template <typename F>
+    void ForEachCluster(F&& f) const {
+        if (compressed_index_ != nullptr) {
+            compressed_index_->ForEachCluster([&f](std::span<int const> cluster) {
+                f(ClusterView{cluster});
+            });
+        } else {
+            for (ClusterView cluster : index_) {
+                f(cluster);
+            }
+        }
+    }
+
+    /* Re-encodes the clusters with CompressedClusterIndex if that takes less memory.
+     * Intersections work on compressed PLIs as they are.
+     * Returns whether the PLI is compressed */
+    bool Compress();
 
-    /* If you use this method and change index in any way, all other methods will become invalid */
-    std::deque<Cluster>& GetIndex() noexcept {
-        return index_;
+    bool IsCompressed() const noexcept {
+        return compressed_index_ != nullptr;
+    }
+
+    /* Memory taken by the clusters in their current form, not counting the probing table */
+    size_t GetClustersBytes() const noexcept {
+        return compressed_index_ != nullptr ? compressed_index_->GetBytes() : index_.GetBytes();
+    }
+
+    /* Memory taken by the PLI, not counting the probing table and a decoded copy of the index */
+    size_t GetBytes() const noexcept {
+        return sizeof(PositionListIndex) + GetClustersBytes() +
+               null_cluster_.capacity() * sizeof(int);
     }
 
     double GetNep() const {
@@ -94,11 +164,15 @@ public:
     }
 
     unsigned int GetNumNonSingletonCluster() const {
-        return index_.size();
+        return compressed_index_ != nullptr ? compressed_index_->size() : index_.size();
     }
 
     unsigned int GetNumCluster() const {
-        return index_.size() + original_relation_size_ - size_;
+        return GetNumNonSingletonCluster() + original_relation_size_ - size_;
+    }
+
+    std::uint64_t GetId() const noexcept {
+        return id_;
     }
 
     unsigned int GetFreq() const {
@@ -113,6 +187,14 @@ public:
         return relation_size_;
     }
 
+    unsigned int GetOriginalRelationSize() const {
+        return original_relation_size_;
+    }
+
+    Cluster const& GetNullCluster() const noexcept {
+        return null_cluster_;
+    }
+
     double GetEntropy() const {
         return entropy_;
     }
@@ -145,9 +227,16 @@ public:
         freq_++;
     }
 
-    std::unique_ptr<PositionListIndex> Intersect(PositionListIndex const* that) const;
-    std::unique_ptr<PositionListIndex> Probe(
-            std::shared_ptr<std::vector<int> const> probing_table) const;
+    /* Clusters of the result are allocated from `resource`, the default resource if it is null.
+     * Algorithms that create many short-lived PLIs pass their own pool here */
+    std::unique_ptr<PositionListIndex> Intersect(
+            PositionListIndex const* that, std::pmr::memory_resource* resource = nullptr) const;
+    /* Takes the probing table from `probing_tables` instead of computing it every time */
+    std::unique_ptr<PositionListIndex> Intersect(
+            PositionListIndex const* that, ProbingTableCache& probing_tables,
+            std::pmr::memory_resource* resource = nullptr) const;
+    std::unique_ptr<PositionListIndex> Probe(ProbingTablePtr probing_table,
+                                             std::pmr::memory_resource* resource = nullptr) const;
     std::unique_ptr<PositionListIndex> ProbeAll(Vertical const& probing_columns,
                                                 ColumnLayoutRelationData& relation_data);
     std::string ToString() const;
@@ -0,0 +1,219 @@
+/** \file
+ * \brief Probing table cache
+ *
+ * ProbingTableCache methods definition
+ */
+#include "probing_table_cache.h"
+
+#include "util/metrics.h"
+
+namespace model {
+
+ProbingTableCache::PinGuard::~PinGuard() {
+    for (std::uint64_t pli_id : pinned_ids_) {
+        cache_->Unpin(pli_id);
+    }
+}
+
+void ProbingTableCache::PinGuard::Add(PositionListIndex const& pli) {
+    if (pli.GetCachedProbingTable() != nullptr) return;
+    cache_->Pin(pli);
+    pinned_ids_.push_back(pli.GetId());
+}
+
+ProbingTableCache::~ProbingTableCache() {
+    DetachAll();
+    if (budget_ != nullptr) {
+        budget_->Release(bytes_);
+    }
+}
+
+ProbingTableCache::Entries::iterator ProbingTableCache::Add(
+        PositionListIndex const& pli, std::shared_ptr<ProbingTable const> table, size_t bytes) {
+    ProbingTableCache* expected = nullptr;
+    if (!pli.table_cache_.compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+        /* The PLI is kept in another cache, which it has to find its table in when destroyed */
+        return entries_.end();
+    }
+    Entries::iterator entry = entries_.emplace(hand_, pli, std::move(table), bytes);
+    index_.emplace(pli.GetId(), entry);
+    return entry;
+}
+
+void ProbingTableCache::DetachAll() noexcept {
+    for (Entry const& entry : entries_) {
+        entry.pli->table_cache_.store(nullptr, std::memory_order_release);
+    }
+}
+
+void ProbingTableCache::Remove(Entries::iterator entry) {
+    entry->pli->table_cache_.store(nullptr, std::memory_order_release);
+    bytes_ -= entry->bytes;
+    if (budget_ != nullptr) {
+        budget_->Release(entry->bytes);
+    }
+    index_.erase(entry->pli_id);
+    bool const is_hand = hand_ == entry;
+    Entries::iterator next = entries_.erase(entry);
+    if (is_hand) {
+        hand_ = next;
+    }
+}
+
+bool ProbingTableCache::EvictOne() {
+    /* Two sweeps clear every second chance bit, a third one finds nothing new */
+    size_t steps_left = 2 * entries_.size() + 1;
+    while (steps_left-- != 0) {
+        if (hand_ == entries_.end()) {
+            hand_ = entries_.begin();
+            if (hand_ == entries_.end()) break;
+        }
+        if (hand_->pin_count != 0 || hand_->table == nullptr) {
+            ++hand_;
+        } else if (hand_->referenced) {
+            hand_->referenced = false;
+            ++hand_;
+        } else {
+            Remove(hand_);
+            ++evictions_;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ProbingTableCache::MakeRoom(size_t bytes) {
+    if (bytes > capacity_bytes_) return false;
+    while (bytes_ + bytes > capacity_bytes_) {
+        if (!EvictOne()) return false;
+    }
+    while (budget_ != nullptr && !budget_->TryReserveEvictable(bytes)) {
+        if (!EvictOne()) return false;
+    }
+    return true;
+}
+
+void ProbingTableCache::Pin(PositionListIndex const& pli) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(pli.GetId());
+    if (it == index_.end()) {
+        /* Placeholder for a table that will be computed on the first probe */
+        Entries::iterator entry = Add(pli);
+        if (entry != entries_.end()) ++entry->pin_count;
+        return;
+    }
+    ++it->second->pin_count;
+}
+
+void ProbingTableCache::Unpin(std::uint64_t pli_id) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(pli_id);
+    if (it == index_.end()) return;
+    Entries::iterator entry = it->second;
+    if (--entry->pin_count == 0 && entry->table == nullptr) {
+        Remove(entry);
+    }
+}
+
+std::shared_ptr<ProbingTableCache::ProbingTable const> ProbingTableCache::GetProbingTable(
+        PositionListIndex const& pli) {
+    if (pli.GetCachedProbingTable() != nullptr) {
+        return pli.CalculateAndGetProbingTable();
+    }
+
+    util::Metrics* metrics = util::Metrics::Current();
+    {
+        std::lock_guard lock(mutex_);
+        auto it = index_.find(pli.GetId());
+        if (it != index_.end() && it->second->table != nullptr) {
+            ++hits_;
+            it->second->referenced = true;
+            if (metrics != nullptr) metrics->ProbingTableCacheHits().Add();
+            return it->second->table;
+        }
+        ++misses_;
+    }
+    if (metrics != nullptr) metrics->ProbingTableCacheMisses().Add();
+
+    std::shared_ptr<ProbingTable const> table = pli.CalculateAndGetProbingTable();
+    size_t const bytes = GetTableBytes(*table);
+
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(pli.GetId());
+    if (it != index_.end()) {
+        Entries::iterator entry = it->second;
+        if (entry->table != nullptr) {
+            /* Another thread has just cached it */
+            return entry->table;
+        }
+        if (MakeRoom(bytes)) {
+            entry->table = table;
+            entry->bytes = bytes;
+            entry->referenced = true;
+            bytes_ += bytes;
+        }
+        return table;
+    }
+    if (MakeRoom(bytes)) {
+        if (Add(pli, table, bytes) != entries_.end()) {
+            bytes_ += bytes;
+        } else if (budget_ != nullptr) {
+            budget_->Release(bytes);
+        }
+    }
+    return table;
+}
+
+void ProbingTableCache::Erase(PositionListIndex const& pli) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(pli.GetId());
+    if (it != index_.end()) {
+        Remove(it->second);
+    }
+}
+
+void ProbingTableCache::Clear() {
+    std::lock_guard lock(mutex_);
+    DetachAll();
+    if (budget_ != nullptr) {
+        budget_->Release(bytes_);
+    }
+    entries_.clear();
+    index_.clear();
+    hand_ = entries_.end();
+    bytes_ = 0;
+}
+
+void ProbingTableCache::SetCapacityBytes(size_t capacity_bytes) {
+    std::lock_guard lock(mutex_);
+    capacity_bytes_ = capacity_bytes;
+    while (bytes_ > capacity_bytes_ && EvictOne()) {
+    }
+}
+
+size_t ProbingTableCache::GetCapacityBytes() const {
+    std::lock_guard lock(mutex_);
+    return capacity_bytes_;
+}
+
+size_t ProbingTableCache::GetBytes() const {
+    std::lock_guard lock(mutex_);
+    return bytes_;
+}
+
+size_t ProbingTableCache::GetHits() const {
+    std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+size_t ProbingTableCache::GetMisses() const {
+    std::lock_guard lock(mutex_);
+    return misses_;
+}
+
+size_t ProbingTableCache::GetEvictions() const {
+    std::lock_guard lock(mutex_);
+    return evictions_;
+}
+
+}  // namespace model
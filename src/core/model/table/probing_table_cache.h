@@ -0,0 +1,138 @@
+/** \file
+ * \brief Probing table cache
+ *
+ * Definition of the ProbingTableCache class, a memory-budgeted cache of PLI probing tables.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "model/table/position_list_index.h"
+#include "util/memory_budget.h"
+
+namespace model {
+
+///
+/// \brief probing tables of composite PLIs, kept within a memory budget
+///
+/// A probing table costs 4 bytes per row of the relation however few clusters its PLI has, so
+/// lattice-based algorithms can't afford to cache one in every PLI the way ColumnData does. This
+/// cache keeps the tables of PLIs that are probed again and again, e.g. the parents of a TANE
+/// level, and drops the others using second chance (CLOCK) eviction once the budget is spent.
+///
+/// Entries are keyed by PositionListIndex::GetId(), and a PLI erases its table when it is
+/// destroyed, so the tables of transient PLIs don't take the room until they are evicted. A PLI
+/// is kept in one cache at a time, the others compute its table on every probe. Pinned tables
+/// are never evicted. The budget still holds for them: a pinned table that doesn't fit is computed
+/// on every probe, as it would be without the cache.
+///
+/// Given a util::MemoryBudget, the cache also reserves its tables there as evictable memory, so
+/// it shrinks when the other structures of the algorithm need the memory.
+///
+/// \note All methods are thread-safe. Tables are computed outside of the lock, so two threads
+///       missing the same PLI at once may both compute its table.
+///
+class ProbingTableCache {
+public:
+    using ProbingTable = PositionListIndex::ProbingTable;
+
+    /// RAII pin of a set of PLIs, e.g. the parents of the lattice level being processed
+    class PinGuard {
+    private:
+        ProbingTableCache* cache_;
+        std::vector<std::uint64_t> pinned_ids_;
+
+    public:
+        explicit PinGuard(ProbingTableCache& cache) noexcept : cache_(&cache) {}
+        PinGuard(PinGuard const&) = delete;
+        PinGuard& operator=(PinGuard const&) = delete;
+        ~PinGuard();
+
+        void Add(PositionListIndex const& pli);
+    };
+
+    static constexpr size_t kDefaultCapacityBytes = size_t{1} << 30;
+
+private:
+    struct Entry {
+        std::uint64_t pli_id;
+        PositionListIndex const* pli;
+        /* null while the PLI is pinned but has not been probed yet */
+        std::shared_ptr<ProbingTable const> table;
+        size_t bytes;
+        unsigned pin_count = 0;
+        /* second chance bit, set on every hit and cleared by the clock hand */
+        bool referenced = true;
+
+        explicit Entry(PositionListIndex const& pli,
+                       std::shared_ptr<ProbingTable const> table = nullptr, size_t bytes = 0)
+            : pli_id(pli.GetId()), pli(&pli), table(std::move(table)), bytes(bytes) {}
+    };
+
+    using Entries = std::list<Entry>;
+
+    mutable std::mutex mutex_;
+    /* entries form the clock, `hand_` points at the next eviction candidate */
+    Entries entries_;
+    Entries::iterator hand_ = entries_.end();
+    std::unordered_map<std::uint64_t, Entries::iterator> index_;
+    size_t capacity_bytes_;
+    util::MemoryBudget* budget_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+
+    static size_t GetTableBytes(ProbingTable table) noexcept {
+        return sizeof(std::vector<int>) + table.size_bytes();
+    }
+
+    /* end() if the PLI is kept in another cache */
+    Entries::iterator Add(PositionListIndex const& pli,
+                          std::shared_ptr<ProbingTable const> table = nullptr, size_t bytes = 0);
+    void Remove(Entries::iterator entry);
+    /* stops the PLIs from erasing their tables here once they are destroyed */
+    void DetachAll() noexcept;
+    /* evicts the next unpinned table the clock hand finds, false if there is none */
+    bool EvictOne();
+    /* evicts unpinned tables until `bytes` more fit or nothing evictable is left, the bytes are
+     * reserved in the budget on success */
+    bool MakeRoom(size_t bytes);
+    void Pin(PositionListIndex const& pli);
+    void Unpin(std::uint64_t pli_id);
+
+public:
+    explicit ProbingTableCache(size_t capacity_bytes = kDefaultCapacityBytes,
+                               util::MemoryBudget* budget = nullptr)
+        : capacity_bytes_(capacity_bytes), budget_(budget) {}
+
+    ProbingTableCache(ProbingTableCache const&) = delete;
+    ProbingTableCache& operator=(ProbingTableCache const&) = delete;
+    ~ProbingTableCache();
+
+    /// probing table of `pli`, computed and cached on a miss
+    /// \note PLIs that cache their own table, like the ones of ColumnData, bypass the cache
+    std::shared_ptr<ProbingTable const> GetProbingTable(PositionListIndex const& pli);
+
+    /// drop the table of a PLI that won't be probed anymore
+    void Erase(PositionListIndex const& pli);
+    void Clear();
+
+    /// evicts unpinned tables that don't fit into the new capacity
+    void SetCapacityBytes(size_t capacity_bytes);
+
+    [[nodiscard]] size_t GetCapacityBytes() const;
+    [[nodiscard]] size_t GetBytes() const;
+    [[nodiscard]] size_t GetHits() const;
+    [[nodiscard]] size_t GetMisses() const;
+    [[nodiscard]] size_t GetEvictions() const;
+};
+
+}  // namespace model
@@ -0,0 +1,46 @@
+/** \file
+ * \brief Relation loader
+ *
+ * ReadColumns and LoadRelations definition
+ */
+#include "relation_loader.h"
+
+#include <utility>
+
+#include "model/table/dataset_batch.h"
+
+namespace model {
+
+std::vector<std::vector<std::string>> ReadColumns(IDatasetStream& data_stream) {
+    size_t const num_columns = data_stream.GetNumberOfColumns();
+    std::vector<std::vector<std::string>> columns(num_columns);
+    DatasetBatch batch;
+
+    while (data_stream.GetNextBatch(DatasetBatch::kDefaultNumRows, batch) != 0) {
+        for (size_t index = 0; index < num_columns; ++index) {
+            DatasetBatch::Column const& batch_column = batch.GetColumn(index);
+            columns[index].insert(columns[index].end(), batch_column.begin(), batch_column.end());
+        }
+    }
+    return columns;
+}
+
+LoadedRelations LoadRelations(IDatasetStream& data_stream, bool is_null_eq_null,
+                              unsigned threads) {
+    std::string const relation_name = data_stream.GetRelationName();
+    std::vector<std::string> column_names;
+    for (size_t i = 0; i < data_stream.GetNumberOfColumns(); ++i) {
+        column_names.push_back(data_stream.GetColumnName(i));
+    }
+    std::vector<std::vector<std::string>> columns = ReadColumns(data_stream);
+
+    LoadedRelations relations;
+    relations.relation = ColumnLayoutRelationData::CreateFrom(relation_name, column_names, columns,
+                                                              is_null_eq_null, threads);
+    /* The encoding is done with the values, the typed columns take them over */
+    relations.typed_relation = ColumnLayoutTypedRelationData::CreateFrom(
+            relation_name, column_names, std::move(columns), is_null_eq_null, threads);
+    return relations;
+}
+
+}  // namespace model
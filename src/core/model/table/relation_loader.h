@@ -0,0 +1,42 @@
+/** \file
+ * \brief Relation loader
+ *
+ * Loading of the position list index and the typed representations of a table from a single
+ * pass over an IDatasetStream.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/column_layout_typed_relation_data.h"
+#include "model/table/idataset_stream.h"
+
+namespace model {
+
+///
+/// \brief both representations of a table, as loaded by LoadRelations
+///
+struct LoadedRelations {
+    std::unique_ptr<ColumnLayoutRelationData> relation;
+    std::unique_ptr<ColumnLayoutTypedRelationData> typed_relation;
+};
+
+/// read the rest of the stream into memory, column by column
+std::vector<std::vector<std::string>> ReadColumns(IDatasetStream& data_stream);
+
+///
+/// \brief load the table of `data_stream` for algorithms that need both of its representations
+///
+/// \note The stream is read once. The dictionary encoding refers to the raw values while the
+///       position list indexes are built, and the same values are then moved into the typed
+///       columns, so the table is neither parsed twice nor held in memory twice. The result is
+///       the same as that of ColumnLayoutRelationData::CreateFrom and
+///       ColumnLayoutTypedRelationData::CreateFrom called on the stream one after another.
+///
+LoadedRelations LoadRelations(IDatasetStream& data_stream, bool is_null_eq_null,
+                              unsigned threads = 1);
+
+}  // namespace model
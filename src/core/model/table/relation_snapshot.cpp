@@ -0,0 +1,132 @@
+/** \file
+ * \brief Relation snapshots
+ *
+ * Snapshot file header and checksum implementation
+ */
+#include "relation_snapshot.h"
+
+#include <array>
+#include <stdexcept>
+#include <system_error>
+
+namespace model::snapshot {
+
+namespace {
+
+constexpr std::array<char, 8> kMagic = {'D', 'E', 'S', 'B', 'S', 'N', 'A', 'P'};
+/* Increment on any change of the layout written by the relations */
+constexpr std::uint32_t kVersion = 1;
+std::uint64_t constexpr kPrime = 0x100000001b3ULL;
+
+}  // namespace
+
+std::uint64_t ChecksumFile(std::filesystem::path const& path) {
+    std::error_code ec;
+    auto const file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        throw std::runtime_error("Error: couldn't find file " + path.string());
+    }
+    /* FNV-1a over 8-byte words, the tail is hashed bytewise */
+    std::uint64_t hash = 0xcbf29ce484222325ULL ^ file_size;
+    if (file_size == 0) {
+        return hash;
+    }
+    boost::iostreams::mapped_file_source file(path.string());
+    char const* data = file.data();
+    std::size_t const num_words = file.size() / sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < num_words; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i * sizeof(std::uint64_t), sizeof(std::uint64_t));
+        hash = (hash ^ word) * kPrime;
+    }
+    for (std::size_t i = num_words * sizeof(std::uint64_t); i < file.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * kPrime;
+    }
+    return hash;
+}
+
+std::uint64_t ChecksumBytes(std::uint64_t checksum, std::string_view bytes) {
+    for (char byte : bytes) {
+        checksum = (checksum ^ static_cast<unsigned char>(byte)) * kPrime;
+    }
+    return checksum;
+}
+
+SnapshotWriter::SnapshotWriter(std::filesystem::path const& path, Kind kind,
+                               std::uint64_t source_checksum, bool is_null_eq_null)
+    : path_(path),
+      temp_path_(path.string() + ".tmp"),
+      out_(temp_path_, std::ios::binary | std::ios::trunc) {
+    if (!out_) {
+        throw std::runtime_error("Error: couldn't create snapshot " + path.string());
+    }
+    WriteBytes(kMagic.data(), kMagic.size());
+    Write(kVersion);
+    Write(kind);
+    Write(source_checksum);
+    Write<std::uint8_t>(is_null_eq_null);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (out_.is_open()) {
+        out_.close();
+        std::error_code ec;
+        std::filesystem::remove(temp_path_, ec);
+    }
+}
+
+void SnapshotWriter::Finish() {
+    out_.close();
+    if (!out_) {
+        std::error_code ec;
+        std::filesystem::remove(temp_path_, ec);
+        throw std::runtime_error("Error: couldn't write snapshot " + path_.string());
+    }
+    /* The old file is unlinked, not truncated, so its mappings stay valid */
+    std::filesystem::rename(temp_path_, path_);
+}
+
+SnapshotReader::SnapshotReader(std::filesystem::path const& path, Kind kind,
+                               std::uint64_t source_checksum, bool is_null_eq_null) {
+    std::error_code ec;
+    auto const file_size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        throw std::runtime_error("Error: couldn't find snapshot " + path.string());
+    }
+    if (file_size != 0) {
+        file_ = std::make_shared<boost::iostreams::mapped_file_source const>(path.string());
+        begin_ = pos_ = file_->data();
+        end_ = pos_ + file_->size();
+    }
+
+    if (std::memcmp(Take(kMagic.size()), kMagic.data(), kMagic.size()) != 0 ||
+        Read<std::uint32_t>() != kVersion) {
+        throw std::runtime_error(path.string() + " is not a snapshot of this version");
+    }
+    if (Read<Kind>() != kind) {
+        throw std::runtime_error("Snapshot " + path.string() + " holds another relation kind");
+    }
+    if (Read<std::uint64_t>() != source_checksum) {
+        throw std::runtime_error("Snapshot " + path.string() +
+                                 " was made from another version of the table");
+    }
+    if (Read<std::uint8_t>() != is_null_eq_null) {
+        throw std::runtime_error("Snapshot " + path.string() +
+                                 " was made with another null equality setting");
+    }
+}
+
+void SnapshotReader::CheckAvailable(std::uint64_t count, std::size_t size) const {
+    if (count > static_cast<std::uint64_t>(end_ - pos_) / size) {
+        throw std::runtime_error("Snapshot is truncated");
+    }
+}
+
+char const* SnapshotReader::Take(std::size_t size) {
+    CheckAvailable(size, 1);
+    char const* result = pos_;
+    pos_ += size;
+    return result;
+}
+
+}  // namespace model::snapshot
@@ -0,0 +1,164 @@
+/** \file
+ * \brief Relation snapshots
+ *
+ * Binary snapshot files that let an encoded relation be written once and read back without
+ * parsing the source table again. Used by ColumnLayoutRelationData and
+ * ColumnLayoutTypedRelationData.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace model::snapshot {
+
+/// kind of relation stored in a snapshot
+enum class Kind : std::uint32_t { kColumnLayout = 1, kColumnLayoutTyped = 2 };
+
+///
+/// \brief checksum of a whole file, stored in snapshots to tell which source they were made from
+///
+/// \note Stable across runs and platforms with the same endianness
+///
+std::uint64_t ChecksumFile(std::filesystem::path const& path);
+
+/// checksum of `bytes` continuing `checksum`, with the same stability as ChecksumFile
+std::uint64_t ChecksumBytes(std::uint64_t checksum, std::string_view bytes);
+
+///
+/// \brief sequential writer of a snapshot file
+///
+/// \note The header (format version, relation kind, source checksum and the null equality
+///       setting the relation was built with) is written on construction. The snapshot is
+///       written to a temporary file that replaces `path` in Finish, so relations still mapping
+///       an older snapshot at `path` are not affected.
+///
+class SnapshotWriter {
+private:
+    std::filesystem::path path_;
+    std::filesystem::path temp_path_;
+    std::ofstream out_;
+    std::uint64_t offset_ = 0;
+
+    void WriteBytes(char const* data, std::size_t size) {
+        out_.write(data, size);
+        offset_ += size;
+    }
+
+public:
+    SnapshotWriter(std::filesystem::path const& path, Kind kind, std::uint64_t source_checksum,
+                   bool is_null_eq_null);
+    SnapshotWriter(SnapshotWriter const&) = delete;
+    SnapshotWriter& operator=(SnapshotWriter const&) = delete;
+    /// removes the temporary file if Finish was not called
+    ~SnapshotWriter();
+
+    template <typename T>
+    void Write(T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(reinterpret_cast<char const*>(&value), sizeof(T));
+    }
+
+    /// the elements are aligned in the file, so SnapshotReader::ViewArray can refer to them
+    template <typename T>
+    void WriteArray(std::span<T const> values) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write<std::uint64_t>(values.size());
+        static constexpr char kPadding[alignof(T)] = {};
+        WriteBytes(kPadding, (alignof(T) - offset_ % alignof(T)) % alignof(T));
+        WriteBytes(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(std::vector<T> const& values) {
+        WriteArray(std::span<T const>(values));
+    }
+
+    void WriteString(std::string_view value) {
+        Write<std::uint64_t>(value.size());
+        WriteBytes(value.data(), value.size());
+    }
+
+    /// flush the file and move it to `path`, throws if anything could not be written
+    void Finish();
+};
+
+///
+/// \brief reader of a snapshot file mapped into memory
+///
+/// \note Throws std::runtime_error if the file is not a snapshot of the expected kind, was made
+///       from another source file or with another null equality setting, or is truncated
+///
+class SnapshotReader {
+private:
+    std::shared_ptr<boost::iostreams::mapped_file_source const> file_;
+    char const* begin_ = nullptr;
+    char const* pos_ = nullptr;
+    char const* end_ = nullptr;
+
+    /* Throws if fewer than `count` elements of size `size` are left */
+    void CheckAvailable(std::uint64_t count, std::size_t size) const;
+    char const* Take(std::size_t size);
+    /* Reads the size of an array written by SnapshotWriter::WriteArray and skips its padding */
+    template <typename T>
+    std::uint64_t ReadArraySize() {
+        auto const size = Read<std::uint64_t>();
+        Take((alignof(T) - (pos_ - begin_) % alignof(T)) % alignof(T));
+        CheckAvailable(size, sizeof(T));
+        return size;
+    }
+
+public:
+    SnapshotReader(std::filesystem::path const& path, Kind kind, std::uint64_t source_checksum,
+                   bool is_null_eq_null);
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> ReadArray() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto const size = ReadArraySize<T>();
+        std::vector<T> values(size);
+        std::memcpy(values.data(), Take(size * sizeof(T)), size * sizeof(T));
+        return values;
+    }
+
+    /// @return view into the mapped file, valid while the reader or GetFile() exists
+    template <typename T>
+    std::span<T const> ViewArray() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        auto const size = ReadArraySize<T>();
+        /* The mapping starts at a page boundary, so aligned offsets give aligned addresses */
+        return {reinterpret_cast<T const*>(Take(size * sizeof(T))), size};
+    }
+
+    /// @return view into the mapped file, valid while the reader exists
+    std::string_view ReadString() {
+        auto const size = Read<std::uint64_t>();
+        CheckAvailable(size, 1);
+        return {Take(size), size};
+    }
+
+    /// the mapping the views refer to, null for an empty file
+    std::shared_ptr<void const> GetFile() const noexcept {
+        return file_;
+    }
+};
+
+}  // namespace model::snapshot
@@ -1,7 +1,11 @@
 #include "typed_column_data.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cstddef>
+#include <cstring>
+#include <random>
+#include <utility>
 
 #include "column_layout_typed_relation_data.h"
 #include "create_type.h"
@@ -21,49 +25,140 @@ size_t GetNextAlignedOffset(size_t cur_offset, size_t align) {
 
 namespace model {
 
-TypeId TypedColumnDataFactory::DeduceColumnType() const {
+TypedColumnData::~TypedColumnData() {
+    if (type_ == nullptr) {
+        return;
+    }
+
+    if (is_mixed_) {
+        MixedType const* mixed = GetIfMixed();
+        for (size_t i = 0; i != rows_num_; ++i) {
+            std::byte const* value = GetValue(i);
+            TypeId const type_id = mixed->RetrieveTypeId(value);
+            if (type_id == +TypeId::kString || type_id == +TypeId::kBigInt) {
+                StringType::Destruct(mixed->RetrieveValue(value));
+            } else if (type_id == +TypeId::kDate) {
+                DateType::Destruct(mixed->RetrieveValue(value));
+            }
+        }
+    } else if (GetTypeId() == +TypeId::kDate) {
+        for (size_t i = 0; i != rows_num_; ++i) {
+            if (!IsNullOrEmpty(i)) DateType::Destruct(buffer_.get() + i * value_size_);
+        }
+    }
+}
+
+bool TypedColumnDataFactory::CheckType(TypeId type_id, std::string const& val) {
+    for (TypeChecker const& checker : kTypeCheckers) {
+        if (checker.type_id == type_id) {
+            return checker.check(val);
+        }
+    }
+    assert(false);
+    return false;
+}
+
+TypeId TypedColumnDataFactory::ClassifyValue(std::string const& val) {
+    for (TypeChecker const& checker : kTypeCheckers) {
+        if (checker.check(val)) {
+            return checker.type_id;
+        }
+    }
+    return +TypeId::kString;
+}
+
+size_t TypedColumnDataFactory::PickFirstValue(TypeInferenceSample const& sample) const {
+    std::vector<size_t> sample_indices;
+    switch (sample.method) {
+        case TypeInferenceSample::Method::kNone:
+            return 0;
+        case TypeInferenceSample::Method::kPrefix:
+            for (size_t i = 0; i != unparsed_.size() && sample_indices.size() < sample.size;
+                 ++i) {
+                sample_indices.push_back(i);
+            }
+            break;
+        case TypeInferenceSample::Method::kReservoir: {
+            std::mt19937_64 gen(sample.seed);
+            for (size_t i = 0; i != unparsed_.size(); ++i) {
+                if (sample_indices.size() < sample.size) {
+                    sample_indices.push_back(i);
+                } else if (size_t const j = std::uniform_int_distribution<size_t>(0, i)(gen);
+                           j < sample.size) {
+                    sample_indices[j] = i;
+                }
+            }
+            break;
+        }
+    }
+
+    /* The first sampled value of the type most sampled values have */
+    std::unordered_map<TypeId, std::pair<size_t, size_t>> type_counts;
+    size_t first_value = 0;
+    size_t best_count = 0;
+    for (size_t const index : sample_indices) {
+        std::string const& val = unparsed_[index];
+        if (IsNullOrEmpty(val)) continue;
+        auto& [count, first_index] = type_counts.try_emplace(ClassifyValue(val), 0, index)
+                                             .first->second;
+        if (++count > best_count) {
+            best_count = count;
+            first_value = first_index;
+        }
+    }
+    return first_value;
+}
+
+TypeId TypedColumnDataFactory::DeduceColumnType(size_t first_value) const {
     bool is_undefined = true;
     std::bitset<5> candidate_types_bitset("11111");
     TypeId first_type_id = +TypeId::kUndefined;
-    for (std::size_t i = 0; i != unparsed_.size(); ++i) {
-        if (!kNullCheck(unparsed_[i]) && !kEmptyCheck(unparsed_[i])) {
-            is_undefined = false;
-            if (first_type_id != +TypeId::kUndefined) {
-                auto& type_check = kTypeIdToChecker.at(first_type_id);
-                if (type_check(unparsed_[i])) {
-                    // undelimited and delimited dates have different bitsets
-                    if (first_type_id == +TypeId::kDate && kDelimitedDateCheck(unparsed_[i])) {
-                        candidate_types_bitset &= kTypeIdToBitset.at(first_type_id);
-                    }
-                    continue;
-                }
+    /* Candidate types are intersected, so the order values are looked at in changes nothing
+     * but the number of checks */
+    auto const narrow = [&](std::string const& val) {
+        if (IsNullOrEmpty(val)) {
+            return true;
+        }
+        is_undefined = false;
+        if (first_type_id != +TypeId::kUndefined && CheckType(first_type_id, val)) {
+            // undelimited and delimited dates have different bitsets
+            if (first_type_id == +TypeId::kDate && IsDelimitedDateValue(val)) {
+                candidate_types_bitset &= kTypeIdToBitset.at(first_type_id);
             }
+            return true;
+        }
 
-            std::bitset<5> new_candidate_types_bitset("00000");
-            bool matched = false;
-            for (auto const& [type_id, type_check] : kTypeIdToChecker) {
-                if (type_id != first_type_id && type_check(unparsed_[i])) {
-                    if (first_type_id == +TypeId::kUndefined && !matched) {
-                        first_type_id = type_id;
-                    }
-                    matched = true;
-                    new_candidate_types_bitset |= kTypeIdToBitset.at(type_id);
-                    // possible value types are known at the first match except for dates
-                    // (undelimited dates could be ints or doubles and delimited couldn't)
-                    if (type_id == +TypeId::kDate && kUndelimitedDateCheck(unparsed_[i])) {
-                        new_candidate_types_bitset |= kTypeIdToBitset.at(+TypeId::kInt);
-                    }
-                    break;
+        std::bitset<5> new_candidate_types_bitset("00000");
+        bool matched = false;
+        for (auto const& [type_id, type_check] : kTypeCheckers) {
+            if (type_id != first_type_id && type_check(val)) {
+                if (first_type_id == +TypeId::kUndefined) {
+                    first_type_id = type_id;
                 }
+                matched = true;
+                new_candidate_types_bitset |= kTypeIdToBitset.at(type_id);
+                // possible value types are known at the first match except for dates
+                // (undelimited dates could be ints or doubles and delimited couldn't)
+                if (type_id == +TypeId::kDate && IsUndelimitedDateValue(val)) {
+                    new_candidate_types_bitset |= kTypeIdToBitset.at(+TypeId::kInt);
+                }
+                break;
             }
-            if (!matched) {
-                new_candidate_types_bitset = kTypeIdToBitset.at(+TypeId::kString);
-            }
+        }
+        if (!matched) {
+            new_candidate_types_bitset = kTypeIdToBitset.at(+TypeId::kString);
+        }
 
-            candidate_types_bitset &= new_candidate_types_bitset;
-            if (candidate_types_bitset.none()) {
-                return +TypeId::kMixed;
-            }
+        candidate_types_bitset &= new_candidate_types_bitset;
+        return candidate_types_bitset.any();
+    };
+
+    if (first_value < unparsed_.size() && !narrow(unparsed_[first_value])) {
+        return +TypeId::kMixed;
+    }
+    for (std::size_t i = 0; i != unparsed_.size(); ++i) {
+        if (i != first_value && !narrow(unparsed_[i])) {
+            return +TypeId::kMixed;
         }
     }
 
@@ -83,24 +178,14 @@ TypeId TypedColumnDataFactory::DeduceColumnType() const {
 TypedColumnDataFactory::TypeMap TypedColumnDataFactory::CreateTypeMap(TypeId const type_id) const {
     TypeMap type_map;
     auto const match = [&type_map, type_id](std::string const& val, size_t const row) {
-        if (kNullCheck(val)) {
+        if (IsNullValue(val)) {
             type_map[+TypeId::kNull].insert(row);
-        } else if (kEmptyCheck(val)) {
+        } else if (IsEmptyValue(val)) {
             type_map[+TypeId::kEmpty].insert(row);
         } else if (type_id != +TypeId::kMixed) {
             type_map[type_id].insert(row);
         } else {
-            bool matched = false;
-            for (auto const& [type_id, type_check] : kTypeIdToChecker) {
-                if (type_check(val)) {
-                    type_map[type_id].insert(row);
-                    matched = true;
-                    break;
-                }
-            }
-            if (!matched) {
-                type_map[TypeId::kString].insert(row);
-            }
+            type_map[ClassifyValue(val)].insert(row);
         }
     };
 
@@ -138,59 +223,52 @@ TypedColumnDataFactory::TypeIdToType TypedColumnDataFactory::MapTypeIdsToTypes(
     return type_id_to_type;
 }
 
-size_t TypedColumnDataFactory::CalculateMixedBufSize(
-        std::vector<TypeId> const& types_layout,
-        TypeIdToType const& type_id_to_type) const noexcept {
-    size_t buf_size = 0;
-    for (TypeId const type_id : types_layout) {
-        size_t align = MixedType::GetAlignment(type_id);
-        buf_size = GetNextAlignedOffset(buf_size, align);
-        buf_size += MixedType::GetMixedValueSize(type_id_to_type.at(type_id).get());
+size_t TypedColumnDataFactory::CalculateMixedSlotSize(
+        TypeIdToType const& type_id_to_type) noexcept {
+    size_t slot_size = 0;
+    for (auto const& [type_id, type] : type_id_to_type) {
+        slot_size = std::max(slot_size, MixedType::GetMixedValueSize(type.get()));
+    }
+    /* Every slot starts at a multiple of the slot size, so it is aligned for any type */
+    return GetNextAlignedOffset(slot_size, kTypesMaxAlignment);
+}
+
+boost::dynamic_bitset<> TypedColumnDataFactory::MakeMask(size_t rows_num,
+                                                         std::unordered_set<size_t> const& rows) {
+    boost::dynamic_bitset<> mask(rows_num);
+    for (size_t const row : rows) {
+        mask.set(row);
     }
-    return buf_size;
+    return mask;
 }
 
 TypedColumnData TypedColumnDataFactory::CreateMixedFromTypeMap(std::unique_ptr<Type const> type,
                                                                TypeMap type_map) {
     assert(type->GetTypeId() == +TypeId::kMixed);
-    MixedType const* mixed_type = static_cast<MixedType const*>(type.get());
-    std::vector<std::byte const*> data;
-    data.reserve(unparsed_.size());
-
-    std::unordered_set<size_t> const& nulls = type_map[TypeId::kNull];
-    std::unordered_set<size_t> const& empties = type_map[TypeId::kEmpty];
     size_t const rows_num = unparsed_.size();
-    size_t const nulls_num = nulls.size();
-    size_t const empties_num = empties.size();
+    TypedColumnData column(column_, std::move(type), rows_num,
+                           MakeMask(rows_num, type_map[TypeId::kNull]),
+                           MakeMask(rows_num, type_map[TypeId::kEmpty]));
+    MixedType const* mixed_type = column.GetIfMixed();
 
     TypeIdToType type_id_to_type = MapTypeIdsToTypes(type_map);
     std::vector<TypeId> types_layout = GetTypesLayout(type_map);
-    size_t const buf_size = CalculateMixedBufSize(types_layout, type_id_to_type);
+    column.value_size_ = CalculateMixedSlotSize(type_id_to_type);
     static_assert(kTypesMaxAlignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
                   "Overaligned types lead to a missaligned accesses to values in the current "
                   "implementation, which is UB");
-    std::unique_ptr<std::byte[]> buf(new std::byte[buf_size]);
+    column.buffer_.reset(new std::byte[rows_num * column.value_size_]);
+    std::byte* const buf = column.buffer_.get();
     type_map.clear(); /* type_map is no longer needed, so saving space */
 
-    size_t buf_index = 0;
     for (size_t i = 0; i != types_layout.size(); ++i) {
-        TypeId const type_id = types_layout[i];
-        Type const* concrete_type = type_id_to_type.at(type_id).get();
-        size_t const value_size = mixed_type->GetMixedValueSize(concrete_type);
-
-        buf_index = GetNextAlignedOffset(buf_index, mixed_type->GetAlignment(type_id));
-        std::byte* next = buf.get() + buf_index;
-
-        assert(next + value_size <= buf.get() + buf_size);
-
-        mixed_type->ValueFromStr(next, std::move(unparsed_[i]), concrete_type);
-
-        data.push_back(next);
-        buf_index += value_size;
+        Type const* concrete_type = type_id_to_type.at(types_layout[i]).get();
+        assert(mixed_type->GetMixedValueSize(concrete_type) <= column.value_size_);
+        mixed_type->ValueFromStr(buf + i * column.value_size_, std::move(unparsed_[i]),
+                                 concrete_type);
     }
 
-    return TypedColumnData(column_, std::move(type), rows_num, nulls_num, empties_num,
-                           std::move(buf), std::move(data), {}, {});
+    return column;
 }
 
 TypedColumnData TypedColumnDataFactory::CreateConcreteFromTypeMap(std::unique_ptr<Type const> type,
@@ -202,34 +280,46 @@ TypedColumnData TypedColumnDataFactory::CreateConcreteFromTypeMap(std::unique_pt
         assert(0);
     }
 
-    std::unordered_set<size_t> nulls = std::move(type_map[TypeId::kNull]);
-    std::unordered_set<size_t> empties = std::move(type_map[TypeId::kEmpty]);
     size_t const rows_num = unparsed_.size();
-    size_t const nulls_num = nulls.size();
-    size_t const empties_num = empties.size();
-    assert(rows_num >= nulls_num + empties_num);
-
-    std::vector<std::byte const*> data(unparsed_.size());
+    TypedColumnData column(column_, std::move(type), rows_num,
+                           MakeMask(rows_num, type_map[TypeId::kNull]),
+                           MakeMask(rows_num, type_map[TypeId::kEmpty]));
+    assert(rows_num >= column.GetNumNulls() + column.GetNumEmpties());
 
     if (type_id == +TypeId::kUndefined) {
-        return TypedColumnData(column_, std::move(type), rows_num, nulls_num, empties_num, nullptr,
-                               std::move(data), std::move(nulls), std::move(empties));
+        return column;
     }
 
-    std::unique_ptr<std::byte[]> buf(type->Allocate(rows_num - nulls_num - empties_num));
+    if (column.IsHeapType()) {
+        size_t heap_size = 0;
+        for (size_t i = 0; i != rows_num; ++i) {
+            if (!column.IsNullOrEmpty(i)) heap_size += unparsed_[i].size();
+        }
+        column.string_heap_ = std::make_unique_for_overwrite<char[]>(heap_size);
+        column.string_offsets_.reserve(rows_num + 1);
+        column.string_offsets_.push_back(0);
+        size_t offset = 0;
+        for (size_t i = 0; i != rows_num; ++i) {
+            if (!column.IsNullOrEmpty(i)) {
+                std::memcpy(column.string_heap_.get() + offset, unparsed_[i].data(),
+                            unparsed_[i].size());
+                offset += unparsed_[i].size();
+            }
+            column.string_offsets_.push_back(offset);
+        }
+        return column;
+    }
 
-    size_t buf_index = 0;
-    size_t const value_size = type->GetSize();
-    for (size_t i : type_map.at(type_id)) {
-        assert(buf_index <= type->GetSize() * type_map.at(type_id).size());
-        std::byte* next = buf.get() + buf_index;
-        type->ValueFromStr(next, std::move(unparsed_[i]));
-        data[i] = next;
-        buf_index += value_size;
+    Type const& column_type = column.GetType();
+    column.value_size_ = column_type.GetSize();
+    /* Allocate zeroes the memory, so slots of nulls and empties are zero */
+    column.buffer_.reset(column_type.Allocate(rows_num));
+    for (size_t const i : type_map.at(type_id)) {
+        column_type.ValueFromStr(column.buffer_.get() + i * column.value_size_,
+                                 std::move(unparsed_[i]));
     }
 
-    return TypedColumnData(column_, std::move(type), rows_num, nulls_num, empties_num,
-                           std::move(buf), std::move(data), std::move(nulls), std::move(empties));
+    return column;
 }
 
 TypedColumnData TypedColumnDataFactory::CreateFromTypeMap(std::unique_ptr<Type const> type,
@@ -241,17 +331,32 @@ TypedColumnData TypedColumnDataFactory::CreateFromTypeMap(std::unique_ptr<Type c
     }
 }
 
-TypedColumnData TypedColumnDataFactory::CreateFrom() {
-    TypeId const type_id = DeduceColumnType();
+TypedColumnData TypedColumnDataFactory::CreateFrom(TypeInferenceSample const& sample) {
+    TypeId const type_id = DeduceColumnType(PickFirstValue(sample));
     TypeMap type_map = CreateTypeMap(type_id);
 
     return CreateFromTypeMap(CreateType(type_id, is_null_equal_null_), std::move(type_map));
 }
 
+TypedColumnData TypedColumnDataFactory::CreateFrom(Column const* col,
+                                                   std::vector<std::string> unparsed,
+                                                   bool is_null_equal_null, TypeId type_id,
+                                                   std::vector<TypeId> const& value_type_ids) {
+    assert(unparsed.size() == value_type_ids.size());
+    TypedColumnDataFactory f(col, std::move(unparsed), is_null_equal_null);
+    TypeMap type_map;
+    for (size_t i = 0; i != value_type_ids.size(); ++i) {
+        type_map[value_type_ids[i]].insert(i);
+    }
+    return f.CreateFromTypeMap(CreateType(type_id, is_null_equal_null), std::move(type_map));
+}
+
 std::vector<TypedColumnData> CreateTypedColumnData(IDatasetStream& dataset_stream,
-                                                   bool is_null_equal_null) {
+                                                   bool is_null_equal_null, unsigned threads,
+                                                   TypeInferenceSample const& sample) {
     std::unique_ptr<model::ColumnLayoutTypedRelationData> relation_data =
-            model::ColumnLayoutTypedRelationData::CreateFrom(dataset_stream, is_null_equal_null);
+            model::ColumnLayoutTypedRelationData::CreateFrom(dataset_stream, is_null_equal_null,
+                                                             threads, sample);
     std::vector<model::TypedColumnData> col_data = std::move(relation_data->GetColumnData());
     return col_data;
 }
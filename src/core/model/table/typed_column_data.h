@@ -1,40 +1,60 @@
 #pragma once
 
+#include <array>
 #include <bitset>
-#include <regex>
+#include <cassert>
+#include <memory>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <boost/dynamic_bitset.hpp>
+
 #include "abstract_column_data.h"
 #include "idataset_stream.h"
 #include "model/types/types.h"
 #include "relation_data.h"
+#include "value_classifier.h"
 
 namespace model {
 
+///
+/// \brief column of a table with values parsed into the type deduced for the column
+///
+/// \note Values are stored by column type:
+///       - Int, Double and Date columns keep one fixed-width slot per row in a single array,
+///         slots of nulls and empties are zeroed (see GetValues);
+///       - String and BigInt columns keep all values in one byte heap, row i spans
+///         [string_offsets_[i], string_offsets_[i + 1]) of it (see GetStringValue);
+///       - Mixed columns keep one slot per row as well, sized for the largest type of their
+///         values, every slot starts with the type of its value (see MixedType).
+///       Nulls and empties are bitmaps. GetValue hands out pointers to values for code that works
+///       through the Type interface, String and BigInt values are only read with GetStringValue.
+///
 class TypedColumnData : public model::AbstractColumnData {
 private:
     std::unique_ptr<Type const> type_;
     size_t rows_num_;
     size_t nulls_num_;
     size_t empties_num_;
+    bool is_mixed_;
+    size_t value_size_ = 0;
     std::unique_ptr<std::byte[]> buffer_;
-    std::vector<std::byte const*> data_;
-    /* For non-mixed type only */
-    std::unordered_set<size_t> nulls_;
-    std::unordered_set<size_t> empties_;
-
-    TypedColumnData(Column const* column, std::unique_ptr<Type const> type, size_t const rows_num,
-                    size_t nulls_num, size_t empties_num, std::unique_ptr<std::byte[]> buffer,
-                    std::vector<std::byte const*> data, std::unordered_set<size_t> nulls,
-                    std::unordered_set<size_t> empties) noexcept
+    std::vector<size_t> string_offsets_;
+    std::unique_ptr<char[]> string_heap_;
+    boost::dynamic_bitset<> nulls_;
+    boost::dynamic_bitset<> empties_;
+
+    TypedColumnData(Column const* column, std::unique_ptr<Type const> type, size_t rows_num,
+                    boost::dynamic_bitset<> nulls, boost::dynamic_bitset<> empties) noexcept
         : AbstractColumnData(column),
           type_(std::move(type)),
           rows_num_(rows_num),
-          nulls_num_(nulls_num),
-          empties_num_(empties_num),
-          buffer_(std::move(buffer)),
-          data_(std::move(data)),
+          nulls_num_(nulls.count()),
+          empties_num_(empties.count()),
+          is_mixed_(type_->GetTypeId() == +TypeId::kMixed),
           nulls_(std::move(nulls)),
           empties_(std::move(empties)) {}
 
@@ -46,24 +66,7 @@ public:
     TypedColumnData(TypedColumnData&& other) noexcept = default;
     TypedColumnData& operator=(TypedColumnData&& other) noexcept = default;
 
-    ~TypedColumnData() {
-        if (type_ == nullptr) {
-            return;
-        }
-
-        MixedType const* mixed = GetIfMixed();
-        for (size_t i = 0; i != data_.size(); ++i) {
-            if (GetValueTypeId(i) == +TypeId::kString || GetValueTypeId(i) == +TypeId::kBigInt ||
-                GetValueTypeId(i) == +TypeId::kDate) {
-                std::byte const* value = (mixed) ? mixed->RetrieveValue(data_[i]) : data_[i];
-                if (GetValueTypeId(i) == +TypeId::kDate) {
-                    DateType::Destruct(value);
-                } else {
-                    StringType::Destruct(value);
-                }
-            }
-        }
-    }
+    ~TypedColumnData();
 
     TypeId GetTypeId() const noexcept {
         return type_->GetTypeId();
@@ -73,22 +76,62 @@ public:
         return *type_;
     }
 
-    std::vector<std::byte const*> const& GetData() const noexcept {
-        return data_;
+    /// whether values of the column are text read with GetStringValue (String and BigInt)
+    bool IsHeapType() const noexcept {
+        TypeId const type_id = GetTypeId();
+        return type_id == +TypeId::kString || type_id == +TypeId::kBigInt;
+    }
+
+    /// pointer to a value, nullptr for nulls and empties of non-mixed columns
+    std::byte const* GetValue(size_t index) const {
+        assert(!IsHeapType());
+        if (!is_mixed_ && IsNullOrEmpty(index)) {
+            return nullptr;
+        }
+        return buffer_.get() + index * value_size_;
+    }
+
+    ///
+    /// \brief values of an Int, Double or Date column, one per row
+    ///
+    /// \note Slots of nulls and empties hold zeroes, so sums and similar scans may skip the
+    ///       null and empty masks when zero is harmless for them.
+    ///
+    template <typename T>
+    std::span<T const> GetValues() const noexcept {
+        assert(!is_mixed_ && !IsHeapType() && sizeof(T) == value_size_);
+        return {reinterpret_cast<T const*>(buffer_.get()), buffer_ ? rows_num_ : 0};
+    }
+
+    /// text of a String or BigInt value, works for such values of mixed columns as well
+    std::string_view GetStringValue(size_t index) const {
+        if (is_mixed_) {
+            return Type::GetValue<String>(GetIfMixed()->RetrieveValue(GetValue(index)));
+        }
+        assert(IsHeapType());
+        return {string_heap_.get() + string_offsets_[index],
+                string_offsets_[index + 1] - string_offsets_[index]};
+    }
+
+    boost::dynamic_bitset<> const& GetNullMask() const noexcept {
+        return nulls_;
     }
 
-    std::byte const* GetValue(size_t index) const noexcept {
-        return data_[index];
+    boost::dynamic_bitset<> const& GetEmptyMask() const noexcept {
+        return empties_;
     }
 
     std::string GetDataAsString(size_t index) const {
         if (IsNull(index)) {
             NullType null_type(true);
-            return null_type.ValueToString(GetValue(index));
+            return null_type.ValueToString(nullptr);
         }
         if (IsEmpty(index)) {
             EmptyType empty_type;
-            return empty_type.ValueToString(GetValue(index));
+            return empty_type.ValueToString(nullptr);
+        }
+        if (IsHeapType()) {
+            return std::string(GetStringValue(index));
         }
         return type_->ValueToString(GetValue(index));
     }
@@ -106,21 +149,11 @@ public:
     }
 
     bool IsNull(size_t index) const noexcept {
-        MixedType const* mixed = GetIfMixed();
-        if (mixed != nullptr) {
-            return mixed->RetrieveTypeId(data_[index]) == +TypeId::kNull;
-        } else {
-            return nulls_.find(index) != nulls_.end();
-        }
+        return nulls_.test(index);
     }
 
     bool IsEmpty(size_t index) const noexcept {
-        MixedType const* mixed = GetIfMixed();
-        if (mixed != nullptr) {
-            return mixed->RetrieveTypeId(data_[index]) == +TypeId::kEmpty;
-        } else {
-            return empties_.find(index) != empties_.end();
-        }
+        return empties_.test(index);
     }
 
     bool IsNullOrEmpty(size_t index) const noexcept {
@@ -128,9 +161,8 @@ public:
     }
 
     TypeId GetValueTypeId(size_t index) const noexcept {
-        TypeId const type_id = type_->GetTypeId();
-        if (type_id == +TypeId::kMixed) {
-            return static_cast<MixedType const*>(type_.get())->RetrieveTypeId(data_[index]);
+        if (is_mixed_) {
+            return MixedType::RetrieveTypeId(GetValue(index));
         }
 
         if (IsNull(index)) {
@@ -140,7 +172,7 @@ public:
             return TypeId::kEmpty;
         }
 
-        return type_id;
+        return type_->GetTypeId();
     }
 
     bool IsNumeric() const noexcept {
@@ -150,11 +182,11 @@ public:
     }
 
     bool IsMixed() const noexcept {
-        return GetTypeId() == +TypeId::kMixed;
+        return is_mixed_;
     }
 
     MixedType const* GetIfMixed() const noexcept {
-        return dynamic_cast<MixedType const*>(type_.get());
+        return is_mixed_ ? static_cast<MixedType const*>(type_.get()) : nullptr;
     }
 
     std::string ToString() const final {
@@ -162,6 +194,26 @@ public:
     }
 };
 
+///
+/// \brief values TypedColumnDataFactory looks at first to guess the type of a column
+///
+/// \note The guess only decides which value the full pass over the column starts with, so the
+///       deduced type is the same with any sample. A good guess saves trying every type on
+///       values of a column whose first rows are not typical of it.
+///
+struct TypeInferenceSample {
+    enum class Method {
+        kNone,      ///< start with the first value that is neither null nor empty
+        kPrefix,    ///< guess from the first `size` values
+        kReservoir  ///< guess from `size` values picked uniformly at random
+    };
+
+    Method method = Method::kNone;
+    size_t size = 0;
+    /// seed of the reservoir sampling, a fixed one keeps loading reproducible
+    unsigned seed = 0;
+};
+
 class TypedColumnDataFactory {
 private:
     using TypeMap = std::unordered_map<TypeId, std::unordered_set<size_t>>;
@@ -171,65 +223,19 @@ private:
     std::vector<std::string> unparsed_;
     bool is_null_equal_null_;
 
+    struct TypeChecker {
+        TypeId type_id;
+        bool (*check)(std::string const&);
+    };
+
     inline static std::vector<TypeId> const kAllCandidateTypes = {
             +TypeId::kDate, +TypeId::kInt, +TypeId::kBigInt, +TypeId::kDouble, +TypeId::kString};
-    inline static std::unordered_map<TypeId, std::regex> const kTypeIdToRegex = {
-            {+TypeId::kBigInt, std::regex(R"(^(\+|-)?\d{20,}$)")},
-            {+TypeId::kInt, std::regex(R"(^(\+|-)?\d{1,19}$)")},
-            {+TypeId::kNull, std::regex(Null::kValue.data())},
-            {+TypeId::kEmpty, std::regex(R"(^$)")}};
-    inline static auto const kNullCheck = [](std::string const& val) {
-        return std::regex_match(val, kTypeIdToRegex.at(+TypeId::kNull));
-    };
-    inline static auto const kEmptyCheck = [](std::string const& val) {
-        return std::regex_match(val, kTypeIdToRegex.at(+TypeId::kEmpty));
-    };
-    inline static std::function<bool(std::string const&)> const kUndelimitedDateCheck =
-            [](std::string const& val) {
-                bool is_undelimited_date = false;
-                try {
-                    boost::gregorian::from_undelimited_string(val);
-                    is_undelimited_date = true;
-                } catch (...) {
-                }
-                return is_undelimited_date;
-            };
-    inline static std::function<bool(std::string const&)> const kDelimitedDateCheck =
-            [](std::string const& val) {
-                bool is_simple_date = false;
-                try {
-                    boost::gregorian::from_simple_string(val);
-                    is_simple_date = true;
-                } catch (...) {
-                }
-                return is_simple_date;
-            };
-    inline static std::unordered_map<TypeId, std::function<bool(std::string const&)>> const
-            kTypeIdToChecker = {{TypeId::kDouble,
-                                 [](std::string const& val) {
-                                     bool is_double = false;
-                                     try {
-                                         std::size_t pos = 0;
-                                         std::stod(val, &pos);
-                                         if (pos == val.size()) {
-                                             is_double = true;
-                                         }
-                                     } catch (...) {
-                                     }
-                                     return is_double;
-                                 }},
-                                {TypeId::kBigInt,
-                                 [](std::string const& val) {
-                                     return std::regex_match(val,
-                                                             kTypeIdToRegex.at(+TypeId::kBigInt));
-                                 }},
-                                {TypeId::kInt,
-                                 [](std::string const& val) {
-                                     return std::regex_match(val, kTypeIdToRegex.at(+TypeId::kInt));
-                                 }},
-                                {TypeId::kDate, [](std::string const& val) {
-                                     return kDelimitedDateCheck(val) || kUndelimitedDateCheck(val);
-                                 }}};
+    /* A value gets the type of the first checker that accepts it */
+    inline static std::array<TypeChecker, 4> const kTypeCheckers = {
+            {{+TypeId::kDate, [](std::string const& val) { return IsDateValue(val); }},
+             {+TypeId::kInt, [](std::string const& val) { return IsIntValue(val); }},
+             {+TypeId::kBigInt, [](std::string const& val) { return IsBigIntValue(val); }},
+             {+TypeId::kDouble, [](std::string const& val) { return IsDoubleValue(val); }}}};
     // each 1 represents a possible type from kAllCandidateTypes
     inline static std::unordered_map<TypeId, std::bitset<5>> const kTypeIdToBitset = {
             {+TypeId::kDate, std::bitset<5>("00001")},  // bitset for delimited dates
@@ -238,16 +244,24 @@ private:
             {+TypeId::kDouble, std::bitset<5>("01000")},
             {+TypeId::kString, std::bitset<5>("10000")}};
 
-    size_t CalculateMixedBufSize(std::vector<TypeId> const& types_layout,
-                                 TypeIdToType const& type_id_to_type) const noexcept;
+    static size_t CalculateMixedSlotSize(TypeIdToType const& type_id_to_type) noexcept;
     std::vector<TypeId> GetTypesLayout(TypeMap const& tm) const;
     TypeIdToType MapTypeIdsToTypes(TypeMap const& tm) const;
-    TypeId DeduceColumnType() const;
+    static bool CheckType(TypeId type_id, std::string const& val);
+    static bool IsNullOrEmpty(std::string const& val) noexcept {
+        return IsNullValue(val) || IsEmptyValue(val);
+    }
+    /* Type of the first checker that accepts the value, kString if none does */
+    static TypeId ClassifyValue(std::string const& val);
+    size_t PickFirstValue(TypeInferenceSample const& sample) const;
+    TypeId DeduceColumnType(size_t first_value) const;
     TypeMap CreateTypeMap(TypeId const type_id) const;
+    static boost::dynamic_bitset<> MakeMask(size_t rows_num,
+                                            std::unordered_set<size_t> const& rows);
     TypedColumnData CreateMixedFromTypeMap(std::unique_ptr<Type const> type, TypeMap type_map);
     TypedColumnData CreateConcreteFromTypeMap(std::unique_ptr<Type const> type, TypeMap type_map);
     TypedColumnData CreateFromTypeMap(std::unique_ptr<Type const> type, TypeMap type_map);
-    TypedColumnData CreateFrom();
+    TypedColumnData CreateFrom(TypeInferenceSample const& sample);
 
     TypedColumnDataFactory(Column const* col, std::vector<std::string> unparsed,
                            bool is_null_equal_null)
@@ -255,13 +269,22 @@ private:
 
 public:
     static TypedColumnData CreateFrom(Column const* col, std::vector<std::string> unparsed,
-                                      bool is_null_equal_null) {
+                                      bool is_null_equal_null,
+                                      TypeInferenceSample const& sample = {}) {
         TypedColumnDataFactory f(col, std::move(unparsed), is_null_equal_null);
-        return f.CreateFrom();
+        return f.CreateFrom(sample);
     }
+
+    /* Builds a column whose types are already known without deducing them: type_id is the type
+     * of the column, value_type_ids[i] is the type of unparsed[i]. Used to restore columns from
+     * snapshots */
+    static TypedColumnData CreateFrom(Column const* col, std::vector<std::string> unparsed,
+                                      bool is_null_equal_null, TypeId type_id,
+                                      std::vector<TypeId> const& value_type_ids);
 };
 
 std::vector<TypedColumnData> CreateTypedColumnData(IDatasetStream& dataset_stream,
-                                                   bool is_null_equal_null);
+                                                   bool is_null_equal_null, unsigned threads = 1,
+                                                   TypeInferenceSample const& sample = {});
 
 }  // namespace model
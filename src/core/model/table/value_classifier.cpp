@@ -0,0 +1,154 @@
+/** \file
+ * \brief Value classifier
+ *
+ * Definition of the checks declared in value_classifier.h
+ */
+#include "value_classifier.h"
+
+#include <bit>
+#include <cerrno>
+#include <cstdlib>
+
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+#include "model/types/builtin.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr bool IsDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+/* Same set of characters std::isspace has in the "C" locale, the one strtod skips */
+constexpr bool IsSpace(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+/* Number of digits of a value that is an optional sign followed by digits only, 0 otherwise */
+size_t CountSignedDigits(std::string_view value) noexcept {
+    char const* first = value.data();
+    char const* const last = first + value.size();
+    if (first != last && (*first == '+' || *first == '-')) {
+        ++first;
+    }
+    size_t const digits = model::CountLeadingDigits(first, last);
+    return first + digits == last ? digits : 0;
+}
+
+}  // namespace
+
+namespace model {
+
+size_t CountLeadingDigits(char const* first, char const* last) noexcept {
+    char const* const begin = first;
+#if defined(__AVX2__)
+    __m256i const zero_vect = _mm256_set1_epi8('0');
+    __m256i const nine_vect = _mm256_set1_epi8(9);
+    int constexpr vect_reg_size = 32;
+    for (; last - first >= vect_reg_size; first += vect_reg_size) {
+        __m256i const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+        /* Digits are the bytes that stay the same when clamped to 9 after subtracting '0' */
+        __m256i const offsets = _mm256_sub_epi8(chunk, zero_vect);
+        __m256i const is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(offsets, nine_vect), offsets);
+        auto const mask = ~static_cast<unsigned>(_mm256_movemask_epi8(is_digit));
+        if (mask != 0) return first - begin + std::countr_zero(mask);
+    }
+#elif defined(__SSE2__)
+    __m128i const zero_vect = _mm_set1_epi8('0');
+    __m128i const nine_vect = _mm_set1_epi8(9);
+    int constexpr vect_reg_size = 16;
+    for (; last - first >= vect_reg_size; first += vect_reg_size) {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        __m128i const offsets = _mm_sub_epi8(chunk, zero_vect);
+        __m128i const is_digit = _mm_cmpeq_epi8(_mm_min_epu8(offsets, nine_vect), offsets);
+        auto const mask = ~static_cast<unsigned>(_mm_movemask_epi8(is_digit)) & 0xFFFFu;
+        if (mask != 0) return first - begin + std::countr_zero(mask);
+    }
+#endif
+    while (first != last && IsDigit(*first)) {
+        ++first;
+    }
+    return first - begin;
+}
+
+bool IsNullValue(std::string_view value) noexcept {
+    return value == Null::kValue;
+}
+
+bool IsIntValue(std::string_view value) noexcept {
+    size_t const digits = CountSignedDigits(value);
+    return digits >= 1 && digits <= 19;
+}
+
+bool IsBigIntValue(std::string_view value) noexcept {
+    return CountSignedDigits(value) >= 20;
+}
+
+bool IsDoubleValue(std::string const& value) noexcept {
+    /* strtod skips leading whitespace and a sign, anything it can convert starts with a digit,
+     * a point, "inf" or "nan" after that. Rejecting the rest here saves the call */
+    size_t start = 0;
+    while (start < value.size() && IsSpace(value[start])) {
+        ++start;
+    }
+    if (start < value.size() && (value[start] == '+' || value[start] == '-')) {
+        ++start;
+    }
+    if (start == value.size()) {
+        return false;
+    }
+    switch (value[start]) {
+        case '.':
+        case 'i':
+        case 'I':
+        case 'n':
+        case 'N':
+            break;
+        default:
+            if (!IsDigit(value[start])) return false;
+    }
+
+    /* std::stod without the exceptions: it throws when nothing is converted and on ERANGE */
+    char const* const begin = value.c_str();
+    char* end = nullptr;
+    int const saved_errno = errno;
+    errno = 0;
+    std::strtod(begin, &end);
+    bool const out_of_range = errno == ERANGE;
+    errno = saved_errno;
+    return end != begin && !out_of_range && static_cast<size_t>(end - begin) == value.size();
+}
+
+bool IsDelimitedDateValue(std::string const& value) {
+    /* The year is always given with digits, values without them are not worth an exception */
+    if (value.find_first_of("0123456789") == std::string::npos) {
+        return false;
+    }
+    try {
+        boost::gregorian::from_simple_string(value);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool IsUndelimitedDateValue(std::string const& value) {
+    /* The four digit year goes first, month and day take at least three more characters */
+    if (value.size() < 7 || CountLeadingDigits(value.data(), value.data() + 4) != 4) {
+        return false;
+    }
+    try {
+        boost::gregorian::from_undelimited_string(value);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+}  // namespace model
@@ -0,0 +1,49 @@
+/** \file
+ * \brief Value classifier
+ *
+ * Regex-free checks that TypedColumnDataFactory uses to find out which types an unparsed value
+ * may have.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace model {
+
+/// the value is the null literal, Null::kValue
+bool IsNullValue(std::string_view value) noexcept;
+
+/// the value is the empty string
+inline bool IsEmptyValue(std::string_view value) noexcept {
+    return value.empty();
+}
+
+/// an optional sign followed by 1 to 19 ASCII digits, as `^(\+|-)?\d{1,19}$` matches
+bool IsIntValue(std::string_view value) noexcept;
+
+/// an optional sign followed by 20 or more ASCII digits, as `^(\+|-)?\d{20,}$` matches
+bool IsBigIntValue(std::string_view value) noexcept;
+
+/// std::stod consumes the whole value without throwing
+bool IsDoubleValue(std::string const& value) noexcept;
+
+/// boost::gregorian::from_simple_string accepts the value
+bool IsDelimitedDateValue(std::string const& value);
+
+/// boost::gregorian::from_undelimited_string accepts the value
+bool IsUndelimitedDateValue(std::string const& value);
+
+inline bool IsDateValue(std::string const& value) {
+    return IsDelimitedDateValue(value) || IsUndelimitedDateValue(value);
+}
+
+///
+/// \brief length of the run of ASCII digits at the beginning of [first, last)
+///
+/// \note Uses AVX2/SSE2 when available, checks 32/16 bytes per step
+///
+size_t CountLeadingDigits(char const* first, char const* last) noexcept;
+
+}  // namespace model
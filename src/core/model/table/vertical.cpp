@@ -29,44 +29,44 @@ bool Vertical::Intersects(Vertical const& that) const {
 Vertical Vertical::Union(Vertical const& that) const {
     boost::dynamic_bitset<> retained_column_indices(column_indices_);
     retained_column_indices |= that.column_indices_;
-    return schema_->GetVertical(retained_column_indices);
+    return schema_->GetVertical(std::move(retained_column_indices));
 }
 
 Vertical Vertical::Union(Column const& that) const {
     boost::dynamic_bitset<> retained_column_indices(column_indices_);
     retained_column_indices.set(that.GetIndex());
-    return schema_->GetVertical(retained_column_indices);
+    return schema_->GetVertical(std::move(retained_column_indices));
 }
 
 Vertical Vertical::Project(Vertical const& that) const {
     boost::dynamic_bitset<> retained_column_indices(column_indices_);
     retained_column_indices &= that.column_indices_;
-    return schema_->GetVertical(retained_column_indices);
+    return schema_->GetVertical(std::move(retained_column_indices));
 }
 
 Vertical Vertical::Without(Vertical const& that) const {
     boost::dynamic_bitset<> retained_column_indices(column_indices_);
-    retained_column_indices &= ~that.column_indices_;
-    return schema_->GetVertical(retained_column_indices);
+    retained_column_indices -= that.column_indices_;
+    return schema_->GetVertical(std::move(retained_column_indices));
 }
 
 Vertical Vertical::Without(Column const& that) const {
     boost::dynamic_bitset<> retained_column_indices(column_indices_);
     retained_column_indices.reset(that.GetIndex());
-    return schema_->GetVertical(retained_column_indices);
+    return schema_->GetVertical(std::move(retained_column_indices));
 }
 
 Vertical Vertical::Invert() const {
     boost::dynamic_bitset<> flipped_indices(column_indices_);
     flipped_indices.resize(schema_->GetNumColumns());
     flipped_indices.flip();
-    return schema_->GetVertical(flipped_indices);
+    return schema_->GetVertical(std::move(flipped_indices));
 }
 
 Vertical Vertical::Invert(Vertical const& scope) const {
     boost::dynamic_bitset<> flipped_indices(column_indices_);
     flipped_indices ^= scope.column_indices_;
-    return schema_->GetVertical(flipped_indices);
+    return schema_->GetVertical(std::move(flipped_indices));
 }
 
 std::unique_ptr<Vertical> Vertical::EmptyVertical(RelationalSchema const* rel_schema) {
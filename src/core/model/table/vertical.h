@@ -18,6 +18,10 @@ private:
     // Vertical(shared_ptr<RelationalSchema>& relSchema, int indices);
 
     // TODO: unique_ptr<column_indices_> if this is big
+    /* TODO: keep the indices in the model::ColumnSet that DispatchColumnSet picks for the schema,
+     * so that Union, Without and the rest of the set algebra stop allocating. The TANE lattice
+     * levels, VerticalMap and the Python bindings use the dynamic_bitset of GetColumnIndices()
+     * directly and have to be moved to it, or given a conversion, first */
     boost::dynamic_bitset<> column_indices_;
     RelationalSchema const* schema_;
 
@@ -56,7 +60,7 @@ public:
         return !(*this < rhs && *this == rhs);
     }
 
-    boost::dynamic_bitset<> GetColumnIndices() const {
+    boost::dynamic_bitset<> const& GetColumnIndices() const {
         return column_indices_;
     }
 
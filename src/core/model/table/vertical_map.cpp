@@ -1,7 +1,10 @@
 #include "vertical_map.h"
 
+#include <algorithm>
 #include <exception>
+#include <limits>
 #include <queue>
+#include <stdexcept>
 #include <unordered_set>
 
 #include "fd/pyrocommon/core/dependency_candidate.h"
@@ -12,220 +15,176 @@
 namespace model {
 
 template <class Value>
-std::shared_ptr<Value> VerticalMap<Value>::SetTrie::Associate(Bitset const& key, size_t next_bit,
-                                                              std::shared_ptr<Value> value) {
-    next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
-    if (next_bit == boost::dynamic_bitset<>::npos) {
-        std::swap(value, value_);
-        return value;
-    }
-    return GetOrCreateSubTrie(next_bit)->Associate(key, next_bit + 1, std::move(value));
+typename VerticalMap<Value>::SetTrie::Child const* VerticalMap<Value>::SetTrie::FindChild(
+        NodeId node, size_t bit) const {
+    std::vector<Child> const& children = nodes_[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), bit,
+                               [](Child const& child, size_t bit) { return child.bit < bit; });
+    if (it == children.end() || it->bit != bit) return nullptr;
+    return &*it;
 }
 
 template <class Value>
-std::shared_ptr<Value const> VerticalMap<Value>::SetTrie::Get(Bitset const& key,
-                                                              size_t next_bit) const {
-    next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
-    if (next_bit == boost::dynamic_bitset<>::npos) {
-        return value_;
+typename VerticalMap<Value>::SetTrie::NodeId VerticalMap<Value>::SetTrie::CreateNode() {
+    if (!free_nodes_.empty()) {
+        NodeId node = free_nodes_.back();
+        free_nodes_.pop_back();
+        return node;
     }
-
-    auto subtrie = GetSubtrie(next_bit);
-    if (subtrie == nullptr) return nullptr;
-    return subtrie->Get(key, next_bit + 1);
+    if (nodes_.size() > std::numeric_limits<NodeId>::max()) {
+        throw std::length_error("Error in CreateNode: too many SetTrie nodes");
+    }
+    nodes_.emplace_back();
+    return nodes_.size() - 1;
 }
 
 template <class Value>
-std::shared_ptr<Value> VerticalMap<Value>::SetTrie::Remove(Bitset const& key, size_t next_bit) {
-    next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
-    if (next_bit == Bitset::npos) {
-        auto removed_value = value_;
-        value_ = nullptr;
-        return removed_value;
-    }
-
-    auto subtrie = GetSubtrie(next_bit);
-    if (subtrie == nullptr) return nullptr;
-    auto removed_value = subtrie->Remove(key, next_bit + 1);
-    if (subtrie->IsEmpty()) {
-        subtries_[next_bit - offset_] = nullptr;
-    }
-
-    return removed_value;
+void VerticalMap<Value>::SetTrie::ReleaseNode(NodeId node) {
+    // Frees the children array as well
+    nodes_[node] = Node{};
+    free_nodes_.push_back(node);
 }
 
 template <class Value>
-bool VerticalMap<Value>::SetTrie::IsEmpty() const {
-    if (value_ == nullptr) return false;
-    return std::all_of(subtries_.begin(), subtries_.end(),
-                       [](auto& subtrie_ptr) { return subtrie_ptr == nullptr; });
+typename VerticalMap<Value>::SetTrie::NodeId VerticalMap<Value>::SetTrie::GetOrCreateChild(
+        NodeId node, size_t bit) {
+    if (Child const* child = FindChild(node, bit); child != nullptr) return child->node;
+
+    // Creating a node may reallocate the pool, so the parent is looked up afterwards
+    NodeId const new_node = CreateNode();
+    std::vector<Child>& children = nodes_[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), bit,
+                               [](Child const& child, size_t bit) { return child.bit < bit; });
+    children.insert(it, Child{static_cast<std::uint32_t>(bit), new_node});
+    return new_node;
 }
 
 template <class Value>
-typename VerticalMap<Value>::SetTrie* VerticalMap<Value>::SetTrie::GetOrCreateSubTrie(
-        size_t index) {
-    if (subtries_.empty()) {
-        subtries_ = std::vector<std::unique_ptr<SetTrie>>(dimension_ - offset_);
-    }
-    SetTrie* subtrie = GetSubtrie(index);
-    if (subtrie == nullptr) {
-        subtries_[index - offset_] = std::make_unique<SetTrie>(index + 1, dimension_);
+std::shared_ptr<Value> VerticalMap<Value>::SetTrie::Associate(Bitset const& key,
+                                                              std::shared_ptr<Value> value) {
+    NodeId node = kRoot;
+    for (size_t bit = key.find_first(); bit != Bitset::npos; bit = key.find_next(bit)) {
+        node = GetOrCreateChild(node, bit);
     }
-    return subtries_[index - offset_].get();
+    std::swap(value, nodes_[node].value);
+    return value;
 }
 
 template <class Value>
-typename VerticalMap<Value>::SetTrie* VerticalMap<Value>::SetTrie::GetSubtrie(size_t index) {
-    return const_cast<VerticalMap<Value>::SetTrie*>(
-            (const_cast<VerticalMap<Value>::SetTrie const*>(this))->GetSubtrie(index));
+std::shared_ptr<Value const> VerticalMap<Value>::SetTrie::Get(Bitset const& key) const {
+    NodeId node = kRoot;
+    for (size_t bit = key.find_first(); bit != Bitset::npos; bit = key.find_next(bit)) {
+        Child const* child = FindChild(node, bit);
+        if (child == nullptr) return nullptr;
+        node = child->node;
+    }
+    return nodes_[node].value;
 }
 
 template <class Value>
-typename VerticalMap<Value>::SetTrie const* VerticalMap<Value>::SetTrie::GetSubtrie(
-        size_t index) const {
-    if (subtries_.empty()) {
-        return nullptr;
+std::shared_ptr<Value> VerticalMap<Value>::SetTrie::Remove(Bitset const& key) {
+    std::vector<std::pair<NodeId, std::uint32_t>> path;
+    NodeId node = kRoot;
+    for (size_t bit = key.find_first(); bit != Bitset::npos; bit = key.find_next(bit)) {
+        Child const* child = FindChild(node, bit);
+        if (child == nullptr) return nullptr;
+        path.emplace_back(node, child->bit);
+        node = child->node;
     }
-    if (index < offset_ || index >= dimension_) {
-        throw std::runtime_error("Error in GetSubtrie: index must be in [offset_; dimension_)");
+    std::shared_ptr<Value> removed_value = std::move(nodes_[node].value);
+    nodes_[node].value = nullptr;
+
+    // prune the nodes that have no entries below them
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        if (nodes_[node].value != nullptr || !nodes_[node].children.empty()) break;
+        ReleaseNode(node);
+        auto const& [parent, bit] = *it;
+        std::vector<Child>& children = nodes_[parent].children;
+        children.erase(std::find_if(children.begin(), children.end(),
+                                    [bit = bit](Child const& child) { return child.bit == bit; }));
+        node = parent;
     }
-    return subtries_[index - offset_].get();
+    return removed_value;
 }
 
 template <class Value>
 void VerticalMap<Value>::SetTrie::TraverseEntries(
-        Bitset& subset_key,
-        std::function<void(Bitset const&, std::shared_ptr<Value const>)> collector) const {
-    if (value_ != nullptr) {
-        collector(Bitset(subset_key), value_);
+        NodeId node, Bitset& subset_key,
+        std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector) const {
+    if (nodes_[node].value != nullptr) {
+        collector(subset_key, nodes_[node].value);
     }
-    for (size_t i = offset_; i < dimension_; i++) {
-        auto subtrie = GetSubtrie(i);
-        if (subtrie != nullptr) {
-            subset_key.set(i);
-            subtrie->TraverseEntries(subset_key, collector);
-            subset_key.reset(i);
-        }
+    for (Child const& child : nodes_[node].children) {
+        subset_key.set(child.bit);
+        TraverseEntries(child.node, subset_key, collector);
+        subset_key.reset(child.bit);
     }
 }
 
 template <class Value>
 bool VerticalMap<Value>::SetTrie::CollectSubsetKeys(
-        Bitset const& key, size_t next_bit, Bitset& subset_key,
+        NodeId node, Bitset const& key, Bitset& subset_key,
         std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector) const {
-    if (value_ != nullptr) {
-        if (!collector(Bitset(subset_key), value_)) return false;
+    if (nodes_[node].value != nullptr) {
+        if (!collector(subset_key, nodes_[node].value)) return false;
     }
 
-    for (next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
-         next_bit != Bitset::npos; next_bit = key.find_next(next_bit)) {
-        auto subtrie = GetSubtrie(next_bit);
-        if (subtrie != nullptr) {
-            subset_key.set(next_bit);
-            if (!subtrie->CollectSubsetKeys(key, next_bit + 1, subset_key, collector)) return false;
-            subset_key.reset(next_bit);
-        }
+    for (Child const& child : nodes_[node].children) {
+        if (!key.test(child.bit)) continue;
+        subset_key.set(child.bit);
+        if (!CollectSubsetKeys(child.node, key, subset_key, collector)) return false;
+        subset_key.reset(child.bit);
     }
     return true;
 }
 
 template <class Value>
 bool VerticalMap<Value>::SetTrie::CollectSupersetKeys(
-        Bitset const& key, size_t next_bit, Bitset& superset_key,
+        NodeId node, Bitset const& key, size_t required_bit, Bitset& superset_key,
         std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector) const {
-    if (next_bit != Bitset::npos) {
-        next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
+    if (required_bit == Bitset::npos && nodes_[node].value != nullptr) {
+        if (!collector(superset_key, nodes_[node].value)) return false;
     }
-    if (next_bit == Bitset::npos) {
-        if (value_ != nullptr) {
-            if (!collector(Bitset(superset_key), value_)) return false;
-        }
-        for (size_t i = offset_; i < dimension_; i++) {
-            auto subtrie = GetSubtrie(i);
-            if (subtrie != nullptr) {
-                superset_key.set(i);
-                if (!subtrie->CollectSupersetKeys(key, next_bit, superset_key, collector))
-                    return false;
-                superset_key.reset(i);
-            }
-        }
-    } else {
-        for (size_t i = offset_; i < next_bit; i++) {
-            auto subtrie = GetSubtrie(i);
-            if (subtrie != nullptr) {
-                superset_key.set(i);
-                if (!subtrie->CollectSupersetKeys(key, next_bit, superset_key, collector))
-                    return false;
-                superset_key.reset(i);
-            }
-        }
 
-        auto subtrie = GetSubtrie(next_bit);
-        if (subtrie != nullptr) {
-            superset_key.set(next_bit);
-            if (!subtrie->CollectSupersetKeys(key, next_bit + 1, superset_key, collector))
-                return false;
-            superset_key.reset(next_bit);
-        }
+    // paths are ascending, so children past the required bit can't lead to a superset
+    for (Child const& child : nodes_[node].children) {
+        if (child.bit > required_bit) break;
+        size_t const next_required_bit =
+                child.bit == required_bit ? key.find_next(required_bit) : required_bit;
+        superset_key.set(child.bit);
+        if (!CollectSupersetKeys(child.node, key, next_required_bit, superset_key, collector))
+            return false;
+        superset_key.reset(child.bit);
     }
     return true;
 }
 
 template <class Value>
-bool VerticalMap<Value>::SetTrie::CollectRestrictedSupersetKeys(
-        Bitset const& key, Bitset const& blacklist, size_t next_bit, Bitset& superset_key,
+void VerticalMap<Value>::SetTrie::CollectRestrictedSupersetKeys(
+        NodeId node, Bitset const& key, Bitset const& blacklist, size_t required_bit,
+        Bitset& superset_key,
         std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector) const {
-    if (next_bit != Bitset::npos) {
-        next_bit = (next_bit == 0 ? key.find_first() : key.find_next(next_bit - 1));
+    if (required_bit == Bitset::npos && nodes_[node].value != nullptr) {
+        collector(superset_key, nodes_[node].value);
     }
-    if (next_bit == Bitset::npos) {
-        if (value_ != nullptr) {
-            collector(Bitset(superset_key), value_);
-        }
-        for (size_t i = offset_; i < dimension_; i++) {
-            if (blacklist.test(i)) continue;
-            auto subtrie = GetSubtrie(i);
-            if (subtrie != nullptr) {
-                superset_key.set(i);
-                if (!subtrie->CollectRestrictedSupersetKeys(key, blacklist, next_bit, superset_key,
-                                                            collector)) {
-                    return false;
-                }
-                superset_key.reset(i);
-            }
-        }
-    } else {
-        for (size_t i = offset_; i < next_bit; i++) {
-            if (blacklist.test(i)) continue;
-            auto subtrie = GetSubtrie(i);
-            if (subtrie != nullptr) {
-                superset_key.set(i);
-                if (!subtrie->CollectRestrictedSupersetKeys(key, blacklist, next_bit, superset_key,
-                                                            collector)) {
-                    return false;
-                }
-                superset_key.reset(i);
-            }
-        }
 
-        auto subtrie = GetSubtrie(next_bit);
-        if (subtrie != nullptr) {
-            superset_key.set(next_bit);
-            if (!subtrie->CollectRestrictedSupersetKeys(key, blacklist, next_bit + 1, superset_key,
-                                                        collector)) {
-                return false;
-            }
-            superset_key.reset(next_bit);
-        }
+    for (Child const& child : nodes_[node].children) {
+        if (child.bit > required_bit) break;
+        if (blacklist.test(child.bit)) continue;
+        size_t const next_required_bit =
+                child.bit == required_bit ? key.find_next(required_bit) : required_bit;
+        superset_key.set(child.bit);
+        CollectRestrictedSupersetKeys(child.node, key, blacklist, next_required_bit, superset_key,
+                                      collector);
+        superset_key.reset(child.bit);
     }
-    return true;
 }
 
 template <class Value>
 std::vector<Vertical> VerticalMap<Value>::GetSubsetKeys(Vertical const& vertical) const {
     std::vector<Vertical> subset_keys;
     Bitset subset_key(relation_->GetNumColumns());
-    set_trie_.CollectSubsetKeys(vertical.GetColumnIndices(), 0, subset_key,
+    set_trie_.CollectSubsetKeys(vertical.GetColumnIndicesRef(), subset_key,
                                 [&subset_keys, this](auto& indices, [[maybe_unused]] auto value) {
                                     subset_keys.push_back(relation_->GetVertical(indices));
                                     return true;
@@ -238,7 +197,7 @@ std::vector<typename VerticalMap<Value>::Entry> VerticalMap<Value>::GetSubsetEnt
         Vertical const& vertical) const {
     std::vector<typename VerticalMap<Value>::Entry> entries;
     Bitset subset_key(relation_->GetNumColumns());
-    set_trie_.CollectSubsetKeys(vertical.GetColumnIndices(), 0, subset_key,
+    set_trie_.CollectSubsetKeys(vertical.GetColumnIndicesRef(), subset_key,
                                 [&entries, this](auto& indices, auto value) {
                                     entries.emplace_back(relation_->GetVertical(indices), value);
                                     return true;
@@ -252,7 +211,7 @@ typename VerticalMap<Value>::Entry VerticalMap<Value>::GetAnySubsetEntry(
         Vertical const& vertical) const {
     typename VerticalMap<Value>::Entry entry;
     Bitset subset_key(relation_->GetNumColumns());
-    set_trie_.CollectSubsetKeys(vertical.GetColumnIndices(), 0, subset_key,
+    set_trie_.CollectSubsetKeys(vertical.GetColumnIndicesRef(), subset_key,
                                 [&entry, this](auto& indices, auto value) {
                                     entry = {relation_->GetVertical(indices), value};
                                     return false;
@@ -266,7 +225,7 @@ typename VerticalMap<Value>::Entry VerticalMap<Value>::GetAnySubsetEntry(
         std::function<bool(Vertical const*, std::shared_ptr<Value const>)> const& condition) const {
     typename VerticalMap<Value>::Entry entry;
     Bitset subset_key(relation_->GetNumColumns());
-    set_trie_.CollectSubsetKeys(vertical.GetColumnIndices(), 0, subset_key,
+    set_trie_.CollectSubsetKeys(vertical.GetColumnIndicesRef(), subset_key,
                                 [&entry, this, &condition](auto& indices, auto value) {
                                     auto kv = relation_->GetVertical(indices);
                                     if (condition(&kv, value)) {
@@ -284,7 +243,7 @@ std::vector<typename VerticalMap<Value>::Entry> VerticalMap<Value>::GetSupersetE
         Vertical const& vertical) const {
     std::vector<typename VerticalMap<Value>::Entry> entries;
     Bitset superset_key(relation_->GetNumColumns());
-    set_trie_.CollectSupersetKeys(vertical.GetColumnIndices(), 0, superset_key,
+    set_trie_.CollectSupersetKeys(vertical.GetColumnIndicesRef(), superset_key,
                                   [&entries, this](auto& indices, auto value) {
                                       entries.emplace_back(relation_->GetVertical(indices), value);
                                       return true;
@@ -297,7 +256,7 @@ typename VerticalMap<Value>::Entry VerticalMap<Value>::GetAnySupersetEntry(
         Vertical const& vertical) const {
     typename VerticalMap<Value>::Entry entry;
     Bitset superset_key(relation_->GetNumColumns());
-    set_trie_.CollectSupersetKeys(vertical.GetColumnIndices(), 0, superset_key,
+    set_trie_.CollectSupersetKeys(vertical.GetColumnIndicesRef(), superset_key,
                                   [&entry, this](auto& indices, auto value) {
                                       entry = {relation_->GetVertical(indices), value};
                                       return false;
@@ -311,7 +270,7 @@ typename VerticalMap<Value>::Entry VerticalMap<Value>::GetAnySupersetEntry(
         std::function<bool(Vertical const*, std::shared_ptr<Value const>)> condition) const {
     typename VerticalMap<Value>::Entry entry;
     Bitset superset_key(relation_->GetNumColumns());
-    set_trie_.CollectSupersetKeys(vertical.GetColumnIndices(), 0, superset_key,
+    set_trie_.CollectSupersetKeys(vertical.GetColumnIndicesRef(), superset_key,
                                   [&entry, this, &condition](auto& indices, auto value) {
                                       auto kv = relation_->GetVertical(indices);
                                       if (condition(&kv, value)) {
@@ -327,7 +286,7 @@ typename VerticalMap<Value>::Entry VerticalMap<Value>::GetAnySupersetEntry(
 template <class Value>
 std::vector<typename VerticalMap<Value>::Entry> VerticalMap<Value>::GetRestrictedSupersetEntries(
         Vertical const& vertical, Vertical const& exclusion) const {
-    if (vertical.GetColumnIndices().intersects(exclusion.GetColumnIndices()))
+    if (vertical.GetColumnIndicesRef().intersects(exclusion.GetColumnIndicesRef()))
         throw std::runtime_error(
                 "Error in GetRestrictedSupersetEntries: a vertical shouldn't intersect with a "
                 "restriction");
@@ -335,7 +294,7 @@ std::vector<typename VerticalMap<Value>::Entry> VerticalMap<Value>::GetRestricte
     std::vector<typename VerticalMap<Value>::Entry> entries;
     Bitset superset_key(relation_->GetNumColumns());
     set_trie_.CollectRestrictedSupersetKeys(
-            vertical.GetColumnIndices(), exclusion.GetColumnIndices(), 0, superset_key,
+            vertical.GetColumnIndicesRef(), exclusion.GetColumnIndicesRef(), superset_key,
             [&entries, this](auto& indices, auto value) {
                 entries.emplace_back(relation_->GetVertical(indices), value);
                 return true;
@@ -399,14 +358,14 @@ unsigned int VerticalMap<Value>::RemoveFromUsageCounter(
 
 template <class Value>
 std::shared_ptr<Value> VerticalMap<Value>::Remove(Vertical const& key) {
-    auto removed_value = set_trie_.Remove(key.GetColumnIndices(), 0);
+    auto removed_value = set_trie_.Remove(key.GetColumnIndicesRef());
     if (removed_value != nullptr) size_--;
     return removed_value;
 }
 
 template <class Value>
 std::shared_ptr<Value> VerticalMap<Value>::Remove(VerticalMap::Bitset const& key) {
-    auto removed_value = set_trie_.Remove(key, 0);
+    auto removed_value = set_trie_.Remove(key);
     if (removed_value != nullptr) size_--;
     return removed_value;
 }
@@ -490,7 +449,7 @@ void VerticalMap<Value>::Shrink(std::unordered_map<Vertical, unsigned int>& usag
 
 template <class Value>
 std::shared_ptr<Value> VerticalMap<Value>::Put(Vertical const& key, std::shared_ptr<Value> value) {
-    auto old_value = set_trie_.Associate(key.GetColumnIndices(), 0, std::move(value));
+    auto old_value = set_trie_.Associate(key.GetColumnIndicesRef(), std::move(value));
     if (old_value == nullptr) size_++;
 
     return old_value;
@@ -498,17 +457,17 @@ std::shared_ptr<Value> VerticalMap<Value>::Put(Vertical const& key, std::shared_
 
 template <class Value>
 std::shared_ptr<Value const> VerticalMap<Value>::Get(Vertical const& key) const {
-    return set_trie_.Get(key.GetColumnIndices(), 0);
+    return set_trie_.Get(key.GetColumnIndicesRef());
 }
 
 template <class Value>
 std::shared_ptr<Value> VerticalMap<Value>::Get(Vertical const& key) {
-    return std::const_pointer_cast<Value>(set_trie_.Get(key.GetColumnIndices(), 0));
+    return std::const_pointer_cast<Value>(set_trie_.Get(key.GetColumnIndicesRef()));
 }
 
 template <class Value>
 std::shared_ptr<Value const> VerticalMap<Value>::Get(Bitset const& key) const {
-    return set_trie_.Get(key, 0);
+    return set_trie_.Get(key);
 }
 
 // explicitly instantiate to solve template implementation linking issues
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <shared_mutex>
@@ -23,70 +24,102 @@ protected:
 
     // typename std::shared_ptr<Value> shared_ptr<Value>;
 
-    // Each node corresponds to a bit in a bitset. Each node also has a vector of the possible
-    // consequent set bits.
+    // Each key is a path of its set bits in ascending order. Nodes live in one pool and refer to
+    // each other by index, every node keeps only the children that exist, sorted by bit. Const
+    // methods don't modify the trie, so they may run concurrently.
     class SetTrie {
     private:
-        size_t offset_;
-        size_t dimension_;
-        std::vector<std::unique_ptr<SetTrie>> subtries_;  // unique_ptr?
-        std::shared_ptr<Value> value_;
+        using NodeId = std::uint32_t;
 
-        bool IsEmpty() const;
+        static constexpr NodeId kRoot = 0;
 
-    public:
-        explicit SetTrie(size_t dimension) : SetTrie(0, dimension) {}
+        struct Child {
+            std::uint32_t bit;
+            NodeId node;
+        };
+
+        struct Node {
+            std::shared_ptr<Value> value;
+            std::vector<Child> children;
+        };
 
-        SetTrie(size_t offset, size_t dimension) : offset_(offset), dimension_(dimension) {}
+        std::vector<Node> nodes_;
+        // Indices of removed nodes, reused before the pool grows
+        std::vector<NodeId> free_nodes_;
+
+        // Returns the child of the node along the given bit or nullptr
+        Child const* FindChild(NodeId node, size_t bit) const;
+        // Not a const method as a node may be created
+        NodeId GetOrCreateChild(NodeId node, size_t bit);
+        NodeId CreateNode();
+        void ReleaseNode(NodeId node);
+
+        bool CollectSubsetKeys(
+                NodeId node, Bitset const& key, Bitset& subset_key,
+                std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector)
+                const;
+        // required_bit is the least bit of the key not on the path yet, or npos
+        bool CollectSupersetKeys(
+                NodeId node, Bitset const& key, size_t required_bit, Bitset& superset_key,
+                std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector)
+                const;
+        void CollectRestrictedSupersetKeys(
+                NodeId node, Bitset const& key, Bitset const& blacklist, size_t required_bit,
+                Bitset& superset_key,
+                std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector)
+                const;
+        void TraverseEntries(
+                NodeId node, Bitset& subset_key,
+                std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector)
+                const;
+
+    public:
+        SetTrie() : nodes_(1) {}
 
         // Sets given key to a given value
         // Returns the old value with ownership
-        // Not a const method as SetTrie gets changed
-        std::shared_ptr<Value> Associate(Bitset const& key, size_t next_bit,
-                                         std::shared_ptr<Value> value);
+        std::shared_ptr<Value> Associate(Bitset const& key, std::shared_ptr<Value> value);
 
         // Returns a pointer to the value mapped by the given key
-        std::shared_ptr<Value const> Get(Bitset const& key, size_t next_bit) const;
+        std::shared_ptr<Value const> Get(Bitset const& key) const;
 
-        // Erases an entry with the given key
+        // Erases an entry with the given key and the nodes left without entries below them
         // Returns the old value with ownership
-        std::shared_ptr<Value> Remove(Bitset const& key, size_t next_bit);
-
-        // Gets the subtrie with the given index. If such a subtrie does not exist, creates one
-        // Not a const method as a SetTrie may be created
-        SetTrie* GetOrCreateSubTrie(size_t index);
+        std::shared_ptr<Value> Remove(Bitset const& key);
 
-        // Gets the subtrie with the given index
-        // Non-const version of the method -- needed in getOrCreateSubtrie to manipulate SetTrie*
-        SetTrie* GetSubtrie(size_t index);
-
-        // Gets the subtrie with the given index
-        // Const version of the method
-        SetTrie const* GetSubtrie(size_t index) const;
-
-        // Calls collector on every trie that is a subset of the given subset_key
-        bool CollectSubsetKeys(
-                Bitset const& key, size_t next_bit, Bitset& subset_key,
+        // Calls collector on every entry whose key is a subset of the given key
+        void CollectSubsetKeys(
+                Bitset const& key, Bitset& subset_key,
                 std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector)
-                const;
+                const {
+            CollectSubsetKeys(kRoot, key, subset_key, collector);
+        }
 
-        // Calls collector on every trie that is a superset of the given subsetKey
-        bool CollectSupersetKeys(
-                Bitset const& key, size_t next_bit, Bitset& superset_key,
+        // Calls collector on every entry whose key is a superset of the given key
+        void CollectSupersetKeys(
+                Bitset const& key, Bitset& superset_key,
                 std::function<bool(Bitset const&, std::shared_ptr<Value const>)> const& collector)
-                const;
-
-        // Calls collector on every trie that is a superset of the given subsetKey with no bits from
-        // the blacklist
-        bool CollectRestrictedSupersetKeys(
-                Bitset const& key, Bitset const& blacklist, size_t next_bit, Bitset& superset_key,
+                const {
+            CollectSupersetKeys(kRoot, key, key.find_first(), superset_key, collector);
+        }
+
+        // Calls collector on every entry whose key is a superset of the given key with no bits
+        // from the blacklist
+        void CollectRestrictedSupersetKeys(
+                Bitset const& key, Bitset const& blacklist, Bitset& superset_key,
                 std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector)
-                const;
+                const {
+            CollectRestrictedSupersetKeys(kRoot, key, blacklist, key.find_first(), superset_key,
+                                          collector);
+        }
 
         // Calls collector on every entry
         void TraverseEntries(
                 Bitset& subset_key,
-                std::function<void(Bitset const&, std::shared_ptr<Value const>)> collector) const;
+                std::function<void(Bitset const&, std::shared_ptr<Value const>)> const& collector)
+                const {
+            TraverseEntries(kRoot, subset_key, collector);
+        }
     };
 
     RelationalSchema const* relation_;
@@ -102,7 +135,7 @@ public:
     using Entry = std::pair<Vertical, std::shared_ptr<Value const>>;
 
     explicit VerticalMap(RelationalSchema const* relation)
-        : relation_(relation), set_trie_(relation->GetNumColumns()) {}
+        : relation_(relation) {}
 
     virtual size_t GetSize() const {
         return size_;
@@ -170,7 +203,8 @@ public:
 };
 
 /*
- * A version of VerticalMap for parallel processing. Uses reader-writer mutex for blocking.
+ * A version of VerticalMap for parallel processing. Uses reader-writer mutex for blocking, lookups
+ * take it shared and don't block each other.
  * */
 template <class V>
 class BlockingVerticalMap : public VerticalMap<V> {
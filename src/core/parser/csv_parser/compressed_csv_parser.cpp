@@ -0,0 +1,176 @@
+#include "compressed_csv_parser.h"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <easylogging++.h>
+
+#include "parser/csv_parser/csv_scanner.h"
+
+namespace {
+
+constexpr std::array<unsigned char, 2> kGzipMagic = {0x1f, 0x8b};
+constexpr std::array<unsigned char, 4> kZstdMagic = {0x28, 0xb5, 0x2f, 0xfd};
+
+template <size_t N>
+bool StartsWith(std::string_view header, std::array<unsigned char, N> const& magic) {
+    if (header.size() < N) return false;
+    for (size_t i = 0; i < N; ++i) {
+        if (static_cast<unsigned char>(header[i]) != magic[i]) return false;
+    }
+    return true;
+}
+
+/* "data.csv.gz" is reported as "data.csv", like CSVParser would name the inflated file */
+std::string RelationNameOf(std::filesystem::path const& path) {
+    std::filesystem::path const extension = path.extension();
+    if (extension == ".gz" || extension == ".zst") {
+        return path.stem().string();
+    }
+    return path.filename().string();
+}
+
+}  // namespace
+
+CompressedCSVParser::CompressedCSVParser(std::filesystem::path const& path)
+    : CompressedCSVParser(path, ',', true) {}
+
+CompressedCSVParser::CompressedCSVParser(std::filesystem::path const& path, char separator,
+                                         bool has_header)
+    : path_(path),
+      separator_(separator),
+      has_header_(has_header),
+      relation_name_(RelationNameOf(path)) {
+    // Wrong path
+    if (!std::filesystem::exists(path)) {
+        throw std::runtime_error("Error: couldn't find file " + path.string());
+    }
+    if (separator == '\0') {
+        throw std::invalid_argument("Invalid separator");
+    }
+    std::optional<Compression> const compression = DetectCompression(path);
+    if (!compression) {
+        throw std::runtime_error("Error: " + path.string() + " is not gzip or zstd compressed");
+    }
+    compression_ = *compression;
+
+    Open();
+    Row first_row;
+    ParseLine(GetNextLine(), first_row);
+    number_of_columns_ = first_row.size();
+    column_names_ = std::move(first_row);
+
+    if (!has_header_) {
+        /* The first line is a record, decompress it once more */
+        Open();
+        for (size_t i = 0; i < number_of_columns_; ++i) {
+            column_names_[i] = std::to_string(i);
+        }
+    }
+}
+
+CompressedCSVParser::CompressedCSVParser(CSVConfig const& csv_config)
+    : CompressedCSVParser(csv_config.path, csv_config.separator, csv_config.has_header) {}
+
+std::optional<CompressedCSVParser::Compression> CompressedCSVParser::DetectCompression(
+        std::filesystem::path const& path) {
+    std::ifstream file(path, std::ios_base::binary);
+    std::array<char, kZstdMagic.size()> buffer{};
+    file.read(buffer.data(), buffer.size());
+    std::string_view const header(buffer.data(), file.gcount());
+    if (StartsWith(header, kGzipMagic)) return Compression::kGzip;
+    if (StartsWith(header, kZstdMagic)) return Compression::kZstd;
+    return std::nullopt;
+}
+
+void CompressedCSVParser::Open() {
+    namespace io = boost::iostreams;
+    source_.reset();
+
+    file_.close();
+    file_.clear();
+    file_.open(path_, std::ios_base::binary);
+    if (!file_) {
+        throw std::runtime_error("Error: couldn't open file " + path_.string());
+    }
+
+    switch (compression_) {
+        case Compression::kGzip:
+            source_.push(io::gzip_decompressor());
+            break;
+        case Compression::kZstd:
+            source_.push(io::zstd_decompressor());
+            break;
+    }
+    source_.push(file_);
+    /* The chain is complete only now, a stream without it is always bad */
+    source_.clear();
+    /* Corrupted input must not look like the end of the file */
+    source_.exceptions(std::ios_base::badbit);
+    has_next_ = source_.peek() != std::istream::traits_type::eof();
+}
+
+void CompressedCSVParser::Reset() {
+    Open();
+    // Skip header
+    if (has_header_) {
+        GetNextLine();
+    }
+}
+
+std::string_view CompressedCSVParser::GetNextLine() {
+    line_.clear();
+    if (has_next_) {
+        std::getline(source_, line_);
+        has_next_ = source_.peek() != std::istream::traits_type::eof();
+    }
+    return parser::csv::Rtrim(line_);
+}
+
+void CompressedCSVParser::ParseLine(std::string_view line, Row& row) const {
+    row.reserve(number_of_columns_);
+    parser::csv::SplitRecord(line, separator_, [&row](std::string_view field, bool has_quotes) {
+        if (has_quotes) {
+            row.push_back(parser::csv::Unquote(field));
+        } else {
+            row.emplace_back(field);
+        }
+    });
+}
+
+CompressedCSVParser::Row CompressedCSVParser::GetNextRow() {
+    Row row;
+    ParseLine(GetNextLine(), row);
+    if (number_of_columns_ == 1 && row.empty()) {
+        row = {""};
+    }
+    return row;
+}
+
+size_t CompressedCSVParser::GetNextBatch(size_t max_rows, model::DatasetBatch& batch) {
+    batch.Clear(number_of_columns_);
+    while (batch.GetNumRows() < max_rows && has_next_) {
+        /* The line buffer is reused, so the batch keeps its own copy of the line */
+        std::string_view const line = batch.Store(GetNextLine());
+        batch_fields_.clear();
+        parser::csv::SplitRecord(line, separator_, [this, &batch](std::string_view field,
+                                                                  bool has_quotes) {
+            batch_fields_.push_back(has_quotes ? batch.Store(parser::csv::Unquote(field)) : field);
+        });
+        if (number_of_columns_ == 1 && batch_fields_.empty()) {
+            batch_fields_.emplace_back();
+        }
+        if (batch_fields_.size() != number_of_columns_) {
+            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
+                         << number_of_columns_ << ", got " << batch_fields_.size() << ")";
+            continue;
+        }
+        batch.AppendRow(batch_fields_);
+    }
+    return batch.GetNumRows();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include "model/table/idataset_stream.h"
+#include "parser/csv_parser/csv_parser.h"
+
+/* CSV reader for gzip or zstd compressed files. Records are decompressed on the fly through a
+ * Boost.Iostreams filter chain, so the file is never inflated to disk. Produces exactly the same
+ * rows as CSVParser does on the decompressed file */
+class CompressedCSVParser final : public model::IDatasetStream {
+public:
+    enum class Compression { kGzip, kZstd };
+
+private:
+    std::filesystem::path path_;
+    Compression compression_;
+    std::ifstream file_;
+    boost::iostreams::filtering_istream source_;
+    char separator_;
+    bool has_header_;
+    bool has_next_ = false;
+    size_t number_of_columns_ = 0;
+    std::vector<std::string> column_names_;
+    std::string relation_name_;
+    std::string line_;
+    std::vector<std::string_view> batch_fields_;
+
+    /* Rewinds the compressed file and rebuilds the filter chain in front of it */
+    void Open();
+    std::string_view GetNextLine();
+    void ParseLine(std::string_view line, Row& row) const;
+
+public:
+    explicit CompressedCSVParser(std::filesystem::path const& path);
+    CompressedCSVParser(std::filesystem::path const& path, char separator, bool has_header);
+    explicit CompressedCSVParser(CSVConfig const& csv_config);
+
+    /* Recognizes the format by the magic number at the beginning of the file,
+     * std::nullopt for uncompressed or unreadable files */
+    static std::optional<Compression> DetectCompression(std::filesystem::path const& path);
+
+    Row GetNextRow() override;
+    size_t GetNextBatch(size_t max_rows, model::DatasetBatch& batch) override;
+
+    bool HasNextRow() const override {
+        return has_next_;
+    }
+
+    char GetSeparator() const {
+        return separator_;
+    }
+
+    Compression GetCompression() const {
+        return compression_;
+    }
+
+    size_t GetNumberOfColumns() const override {
+        return number_of_columns_;
+    }
+
+    std::string GetColumnName(size_t index) const override {
+        return column_names_[index];
+    }
+
+    std::string GetRelationName() const override {
+        return relation_name_;
+    }
+
+    std::filesystem::path GetSourcePath() const override {
+        return path_;
+    }
+
+    std::string GetSourceFormat() const override {
+        return {separator_, has_header_ ? 'h' : 'n'};
+    }
+
+    void Reset() override;
+};
@@ -0,0 +1,18 @@
+#include "create_csv_parser.h"
+
+#include "parser/csv_parser/compressed_csv_parser.h"
+#include "parser/csv_parser/mmap_csv_parser.h"
+
+std::shared_ptr<model::IDatasetStream> CreateCSVParser(CSVConfig const& csv_config) {
+    /* Compressed files can only be read through a decompressing stream */
+    if (CompressedCSVParser::DetectCompression(csv_config.path)) {
+        return std::make_shared<CompressedCSVParser>(csv_config);
+    }
+    switch (csv_config.reader_type) {
+        case CSVReaderType::kMmap:
+            return std::make_shared<MmapCSVParser>(csv_config);
+        case CSVReaderType::kStream:
+            break;
+    }
+    return std::make_shared<CSVParser>(csv_config);
+}
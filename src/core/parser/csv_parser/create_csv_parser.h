@@ -0,0 +1,10 @@
+#pragma once
+
+#include <memory>
+
+#include "model/table/idataset_stream.h"
+#include "parser/csv_parser/csv_parser.h"
+
+/* Creates the dataset stream selected by `csv_config.reader_type`. Gzip and zstd compressed
+ * files are recognized by their contents and always read by CompressedCSVParser */
+std::shared_ptr<model::IDatasetStream> CreateCSVParser(CSVConfig const& csv_config);
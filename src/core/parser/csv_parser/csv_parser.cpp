@@ -1,15 +1,22 @@
 #include "csv_parser.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/tokenizer.hpp>
+#include <easylogging++.h>
+
+#include "parser/csv_parser/csv_scanner.h"
+#include "parser/csv_parser/mmap_csv_parser.h"
 
 inline std::string& CSVParser::Rtrim(std::string& s) {
     boost::trim_right(s);
@@ -19,7 +26,8 @@ inline std::string& CSVParser::Rtrim(std::string& s) {
 CSVParser::CSVParser(std::filesystem::path const& path) : CSVParser(path, ',', true) {}
 
 CSVParser::CSVParser(std::filesystem::path const& path, char separator, bool has_header)
-    : source_(path),
+    : path_(path),
+      source_(path),
       separator_(separator),
       has_header_(has_header),
       has_next_(true),
@@ -76,6 +84,7 @@ void CSVParser::Reset() {
 
     next_line_.clear();
     has_next_ = true;
+    rows_read_ = 0;
 
     // Skip header
     if (has_header_) {
@@ -86,17 +95,28 @@ void CSVParser::Reset() {
     GetNextIfHas();
 }
 
-void CSVParser::GetLine(unsigned long long const line_index) {
-    Reset();
-
-    // Index is less than the line number by one. Skip line_index lines
-    for (unsigned long long i = 0; i < line_index; ++i) {
-        SkipLine();
+bool CSVParser::SeekRow(unsigned long long const line_index) {
+    if (row_offsets_.empty()) {
+        // No rows in the file
+        return false;
     }
-
-    std::getline(source_, next_line_);
-
-    Rtrim(next_line_);
+    unsigned long long const block =
+            std::min(line_index / kRowOffsetsStep, row_offsets_.size() - 1ULL);
+    // Keep reading if the row is ahead of the current one and no indexed row is closer
+    bool const read_forward = has_next_ && rows_read_ != 0 && rows_read_ - 1 <= line_index &&
+                              rows_read_ - 1 >= block * kRowOffsetsStep;
+    if (!read_forward) {
+        source_.clear();
+        source_.seekg(row_offsets_[block]);
+        rows_read_ = block * kRowOffsetsStep;
+        has_next_ = true;
+        GetNextIfHas();
+    }
+    // Rows read on the way extend the index
+    while (has_next_ && rows_read_ <= line_index) {
+        GetNextIfHas();
+    }
+    return has_next_;
 }
 
 void CSVParser::GetNextIfHas() {
@@ -107,13 +127,16 @@ void CSVParser::GetNextIfHas() {
             has_next_ = false;
             return;
         }
+        if (rows_read_ == row_offsets_.size() * kRowOffsetsStep) {
+            row_offsets_.push_back(source_.tellg());
+        }
         GetNext();
+        ++rows_read_;
     }
 }
 
 std::string CSVParser::GetUnparsedLine(unsigned long long const line_index) {
-    GetLine(line_index);
-    std::string line = next_line_;
+    std::string line = SeekRow(line_index) ? next_line_ : std::string{};
 
     // For correctness of GetNextRow() after this method
     GetNextIfHas();
@@ -164,19 +187,95 @@ std::vector<std::string> CSVParser::ParseString(std::string const& s) const {
     return tokens;
 }
 
+std::vector<std::string> CSVParser::ParseRow(std::string const& line) const {
+    std::vector<std::string> result = ParseString(line);
+    if (number_of_columns_ == 1 && result.empty()) {
+        result = {""};
+    }
+    return result;
+}
+
 std::vector<std::string> CSVParser::ParseLine(unsigned long long const line_index) {
-    std::string unparsed_line = GetUnparsedLine(line_index);
-    std::vector<std::string> parsed = ParseString(unparsed_line);
+    std::vector<std::string> parsed;
+    if (SeekRow(line_index)) {
+        parsed = ParseRow(next_line_);
+    }
+
+    // For correctness of GetNextRow() after this method
+    GetNextIfHas();
+
     return parsed;
 }
 
-std::vector<std::string> CSVParser::GetNextRow() {
-    std::vector<std::string> result = ParseString(next_line_);
-    if (number_of_columns_ == 1 && result.empty()) {
-        result = {""};
+std::vector<std::vector<std::string>> CSVParser::ParseLines(
+        std::span<size_t const> line_indices) {
+    if (line_indices.empty()) {
+        return {};
+    }
+    std::vector<size_t> order(line_indices.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&line_indices](size_t lhs, size_t rhs) {
+        return line_indices[lhs] < line_indices[rhs];
+    });
+
+    std::vector<std::vector<std::string>> rows(line_indices.size());
+    for (size_t position : order) {
+        if (SeekRow(line_indices[position])) {
+            rows[position] = ParseRow(next_line_);
+        }
     }
 
+    // For correctness of GetNextRow() after this method
+    GetNextIfHas();
+
+    return rows;
+}
+
+std::vector<std::string> CSVParser::GetNextRow() {
+    std::vector<std::string> result = ParseRow(next_line_);
+
     GetNextIfHas();
 
     return result;
 }
+
+std::vector<std::unique_ptr<model::IDatasetStream>> CSVParser::SplitIntoChunks(
+        size_t max_chunks) {
+    /* The first row is always read ahead, so nothing has been returned while at most one row
+     * was read. The offset of a row in the middle of the file is not known */
+    if (!has_next_ || rows_read_ > 1) {
+        return {};
+    }
+    std::vector<std::unique_ptr<model::IDatasetStream>> chunks =
+            MmapCSVParser(path_, separator_, has_header_).SplitIntoChunks(max_chunks);
+    if (!chunks.empty()) {
+        has_next_ = false;
+    }
+    return chunks;
+}
+
+size_t CSVParser::GetNextBatch(size_t max_rows, model::DatasetBatch& batch) {
+    batch.Clear(number_of_columns_);
+    while (batch.GetNumRows() < max_rows && has_next_) {
+        /* One copy of the whole line, unquoted fields are views into it */
+        std::string_view const line = batch.Store(next_line_);
+        batch_fields_.clear();
+        parser::csv::SplitRecord(line, separator_, [this, &batch](std::string_view field,
+                                                                  bool has_quotes) {
+            batch_fields_.push_back(has_quotes ? batch.Store(parser::csv::Unquote(field)) : field);
+        });
+        if (number_of_columns_ == 1 && batch_fields_.empty()) {
+            batch_fields_.emplace_back();
+        }
+
+        GetNextIfHas();
+
+        if (batch_fields_.size() != static_cast<size_t>(number_of_columns_)) {
+            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
+                         << number_of_columns_ << ", got " << batch_fields_.size() << ")";
+            continue;
+        }
+        batch.AppendRow(batch_fields_);
+    }
+    return batch.GetNumRows();
+}
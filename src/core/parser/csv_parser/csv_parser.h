@@ -7,19 +7,30 @@
 
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "model/table/idataset_stream.h"
 
+/* IDatasetStream implementation that CreateCSVParser uses to read the file */
+enum class CSVReaderType {
+    kStream, /* CSVParser, reads the file line by line through std::ifstream */
+    kMmap    /* MmapCSVParser, maps the file into memory and scans it vectorized */
+};
+
 struct CSVConfig {
     std::filesystem::path path;
     char separator;
     bool has_header;
+    CSVReaderType reader_type = CSVReaderType::kStream;
 };
 
 class CSVParser : public model::IDatasetStream {
 private:
+    std::filesystem::path path_;
     std::ifstream source_;
     char separator_;
     char escape_symbol_ = '\\';
@@ -30,10 +41,20 @@ private:
     int number_of_columns_;
     std::vector<std::string> column_names_;
     std::string relation_name_;
+    std::vector<std::string_view> batch_fields_;
+    /* Sparse row index built while reading: row_offsets_[i] is the position in the file of
+     * the row number i * kRowOffsetsStep */
+    std::vector<std::streamoff> row_offsets_;
+    /* Number of rows read since the beginning of the file, next_line_ holds the last one */
+    unsigned long long rows_read_ = 0;
+
+    static constexpr unsigned long long kRowOffsetsStep = 256;
+
     void GetNext();
     void PeekNext();
-    void GetLine(unsigned long long const line_index);
+    bool SeekRow(unsigned long long const line_index);
     std::vector<std::string> ParseString(std::string const& s) const;
+    std::vector<std::string> ParseRow(std::string const& line) const;
     void GetNextIfHas();
     void SkipLine();
 
@@ -46,8 +67,18 @@ public:
     explicit CSVParser(CSVConfig const& csv_config);
 
     std::vector<std::string> GetNextRow() override;
+    size_t GetNextBatch(size_t max_rows, model::DatasetBatch& batch) override;
+    /* Records never span lines, so a stream that has not been read from yet is split at newlines
+     * of the mapped file, the chunks are read by MmapCSVParser, which gives the same rows */
+    std::vector<std::unique_ptr<model::IDatasetStream>> SplitIntoChunks(
+            size_t max_chunks) override;
+    /* Random access to rows by their index, the header is not counted. Rows are reached from
+     * the closest indexed row before them, after the call GetNextRow() returns the next row */
     std::string GetUnparsedLine(unsigned long long const line_index);
     std::vector<std::string> ParseLine(unsigned long long const line_index);
+    /* Parse several rows at once, reading them in file order. The result follows the order of
+     * line_indices, rows past the end of the file are empty */
+    std::vector<std::vector<std::string>> ParseLines(std::span<size_t const> line_indices);
 
     bool HasNextRow() const override {
         return has_next_;
@@ -69,5 +100,13 @@ public:
         return relation_name_;
     }
 
+    std::filesystem::path GetSourcePath() const override {
+        return path_;
+    }
+
+    std::string GetSourceFormat() const override {
+        return {separator_, has_header_ ? 'h' : 'n'};
+    }
+
     void Reset() override;
 };
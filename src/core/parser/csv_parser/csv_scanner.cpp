@@ -0,0 +1,81 @@
+#include "csv_scanner.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace parser::csv {
+
+char const* FindFirstOf(char const* first, char const* last, char a, char b) noexcept {
+#if defined(__AVX2__)
+    __m256i const a_vect = _mm256_set1_epi8(a);
+    __m256i const b_vect = _mm256_set1_epi8(b);
+    int constexpr vect_reg_size = 32;
+    for (; last - first >= vect_reg_size; first += vect_reg_size) {
+        __m256i const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+        __m256i const cmp_res = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, a_vect),
+                                                _mm256_cmpeq_epi8(chunk, b_vect));
+        auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(cmp_res));
+        if (mask != 0) return first + std::countr_zero(mask);
+    }
+#elif defined(__SSE2__)
+    __m128i const a_vect = _mm_set1_epi8(a);
+    __m128i const b_vect = _mm_set1_epi8(b);
+    int constexpr vect_reg_size = 16;
+    for (; last - first >= vect_reg_size; first += vect_reg_size) {
+        __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        __m128i const cmp_res =
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, a_vect), _mm_cmpeq_epi8(chunk, b_vect));
+        auto const mask = static_cast<unsigned>(_mm_movemask_epi8(cmp_res));
+        if (mask != 0) return first + std::countr_zero(mask);
+    }
+#endif
+    for (; first != last; ++first) {
+        if (*first == a || *first == b) return first;
+    }
+    return last;
+}
+
+char const* Find(char const* first, char const* last, char c) noexcept {
+    /* memchr is already vectorized by every libc we build with */
+    void const* found = std::memchr(first, c, last - first);
+    return found == nullptr ? last : static_cast<char const*>(found);
+}
+
+std::string_view Rtrim(std::string_view line) noexcept {
+    auto is_space = [](char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    };
+    size_t length = line.size();
+    while (length > 0 && is_space(line[length - 1])) {
+        --length;
+    }
+    return line.substr(0, length);
+}
+
+std::string Unquote(std::string_view raw_field) {
+    std::size_t const length = raw_field.size();
+    bool const is_enclosed =
+            length >= 2 && raw_field.front() == kQuote && raw_field.back() == kQuote;
+
+    std::string value;
+    value.reserve(length);
+    for (std::size_t index = 0; index < length; ++index) {
+        if (raw_field[index] == kQuote) {
+            if (is_enclosed && index > 0 && index + 2 < length && raw_field[index + 1] == kQuote) {
+                value.push_back(kQuote);
+                ++index;
+            }
+        } else {
+            value.push_back(raw_field[index]);
+        }
+    }
+    return value;
+}
+
+}  // namespace parser::csv
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace parser::csv {
+
+inline constexpr char kQuote = '"';
+inline constexpr char kNewline = '\n';
+
+/* Returns the position of the first `a` or `b` in [first, last), or `last` if there is none.
+ * Uses AVX2/SSE2 when available, compares 32/16 bytes per step */
+char const* FindFirstOf(char const* first, char const* last, char a, char b) noexcept;
+
+/* Returns the position of the first `c` in [first, last), or `last` if there is none */
+char const* Find(char const* first, char const* last, char c) noexcept;
+
+/* Drops trailing whitespace, same as CSVParser::Rtrim does for every line */
+std::string_view Rtrim(std::string_view line) noexcept;
+
+/* Turns a raw field (with quote characters still in place) into its value.
+ * All quotes are dropped except doubled quotes inside a field enclosed in double-quotes,
+ * which become a single quote. This is exactly what CSVParser::ParseString does with every
+ * token produced by boost::escaped_list_separator */
+std::string Unquote(std::string_view raw_field);
+
+/* Splits a trimmed line into raw fields and calls `on_field(raw_field, has_quotes)` for each.
+ * Separators between an odd and an even quote are part of the field, backslashes have no
+ * special meaning. An empty line has no fields, a trailing separator gives an empty last
+ * field. This mirrors the tokenization CSVParser::ParseString gets from boost */
+template <typename OnField>
+void SplitRecord(std::string_view line, char separator, OnField&& on_field) {
+    if (line.empty()) return;
+
+    char const* const end = line.data() + line.size();
+    char const* field_begin = line.data();
+    char const* pos = field_begin;
+    bool in_quotes = false;
+    bool has_quotes = false;
+
+    while ((pos = FindFirstOf(pos, end, separator, kQuote)) != end) {
+        if (*pos == kQuote && separator != kQuote) {
+            in_quotes = !in_quotes;
+            has_quotes = true;
+        } else if (!in_quotes) {
+            on_field(std::string_view(field_begin, pos - field_begin), has_quotes);
+            field_begin = pos + 1;
+            has_quotes = false;
+        }
+        ++pos;
+    }
+    on_field(std::string_view(field_begin, end - field_begin), has_quotes);
+}
+
+}  // namespace parser::csv
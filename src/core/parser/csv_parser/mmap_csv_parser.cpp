@@ -0,0 +1,131 @@
+#include "mmap_csv_parser.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <easylogging++.h>
+
+#include "parser/csv_parser/csv_scanner.h"
+
+MmapCSVParser::MmapCSVParser(std::filesystem::path const& path) : MmapCSVParser(path, ',', true) {}
+
+MmapCSVParser::MmapCSVParser(std::filesystem::path const& path, char separator, bool has_header)
+    : path_(path),
+      separator_(separator),
+      has_header_(has_header),
+      relation_name_(path.filename().string()) {
+    std::error_code ec;
+    auto const file_size = std::filesystem::file_size(path, ec);
+    // Wrong path
+    if (ec) {
+        throw std::runtime_error("Error: couldn't find file " + path.string());
+    }
+    if (separator == '\0') {
+        throw std::invalid_argument("Invalid separator");
+    }
+    /* Empty files cannot be mapped, they are just an empty range */
+    if (file_size != 0) {
+        file_.open(path.string());
+        if (!file_.is_open()) {
+            throw std::runtime_error("Error: couldn't map file " + path.string());
+        }
+        pos_ = file_.data();
+        end_ = pos_ + file_.size();
+    }
+
+    Row first_row;
+    ParseLine(GetNextLine(), first_row);
+    number_of_columns_ = first_row.size();
+    column_names_ = std::move(first_row);
+
+    if (has_header_) {
+        data_begin_ = pos_;
+    } else {
+        data_begin_ = file_.is_open() ? file_.data() : nullptr;
+        pos_ = data_begin_;
+        for (size_t i = 0; i < number_of_columns_; ++i) {
+            column_names_[i] = std::to_string(i);
+        }
+    }
+}
+
+MmapCSVParser::MmapCSVParser(CSVConfig const& csv_config)
+    : MmapCSVParser(csv_config.path, csv_config.separator, csv_config.has_header) {}
+
+std::string_view MmapCSVParser::GetNextLine() {
+    char const* const line_begin = pos_;
+    char const* const line_end = parser::csv::Find(pos_, end_, parser::csv::kNewline);
+    pos_ = line_end == end_ ? end_ : line_end + 1;
+    return parser::csv::Rtrim(std::string_view(line_begin, line_end - line_begin));
+}
+
+void MmapCSVParser::ParseLine(std::string_view line, Row& row) const {
+    row.reserve(number_of_columns_);
+    parser::csv::SplitRecord(line, separator_, [&row](std::string_view field, bool has_quotes) {
+        if (has_quotes) {
+            row.push_back(parser::csv::Unquote(field));
+        } else {
+            row.emplace_back(field);
+        }
+    });
+}
+
+MmapCSVParser::Row MmapCSVParser::GetNextRow() {
+    Row row;
+    ParseLine(GetNextLine(), row);
+    if (number_of_columns_ == 1 && row.empty()) {
+        row = {""};
+    }
+    return row;
+}
+
+size_t MmapCSVParser::GetNextBatch(size_t max_rows, model::DatasetBatch& batch) {
+    batch.Clear(number_of_columns_);
+    while (batch.GetNumRows() < max_rows && HasNextRow()) {
+        batch_fields_.clear();
+        /* Unquoted fields are views straight into the mapped file */
+        parser::csv::SplitRecord(GetNextLine(), separator_,
+                                 [this, &batch](std::string_view field, bool has_quotes) {
+                                     batch_fields_.push_back(
+                                             has_quotes ? batch.Store(parser::csv::Unquote(field))
+                                                        : field);
+                                 });
+        if (number_of_columns_ == 1 && batch_fields_.empty()) {
+            batch_fields_.emplace_back();
+        }
+        if (batch_fields_.size() != number_of_columns_) {
+            LOG(WARNING) << "Unexpected number of columns for a row, skipping (expected "
+                         << number_of_columns_ << ", got " << batch_fields_.size() << ")";
+            continue;
+        }
+        batch.AppendRow(batch_fields_);
+    }
+    return batch.GetNumRows();
+}
+
+std::vector<std::unique_ptr<model::IDatasetStream>> MmapCSVParser::SplitIntoChunks(
+        size_t max_chunks) {
+    assert(max_chunks != 0);
+    std::vector<std::unique_ptr<model::IDatasetStream>> chunks;
+    size_t const chunk_size = static_cast<size_t>(end_ - pos_) / max_chunks;
+    while (pos_ != end_) {
+        char const* chunk_end = end_;
+        if (chunks.size() + 1 < max_chunks && chunk_size != 0 &&
+            static_cast<size_t>(end_ - pos_) > chunk_size) {
+            /* Records never span lines, so a chunk may end right after any newline */
+            chunk_end = parser::csv::Find(pos_ + chunk_size, end_, parser::csv::kNewline);
+            if (chunk_end != end_) ++chunk_end;
+        }
+        /* Copies share the mapping */
+        auto chunk = std::make_unique<MmapCSVParser>(*this);
+        chunk->data_begin_ = pos_;
+        chunk->pos_ = pos_;
+        chunk->end_ = chunk_end;
+        chunks.push_back(std::move(chunk));
+        pos_ = chunk_end;
+    }
+    return chunks;
+}
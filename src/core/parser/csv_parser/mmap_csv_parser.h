@@ -0,0 +1,76 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "model/table/idataset_stream.h"
+#include "parser/csv_parser/csv_parser.h"
+
+/* CSV reader that maps the whole file into memory and looks for newlines, separators and
+ * quotes with vectorized scanning instead of reading it line by line through std::ifstream.
+ * Produces exactly the same rows as CSVParser: records end at '\n', trailing whitespace of a
+ * record is dropped and fields are unquoted by the rules of CSVParser::ParseString */
+class MmapCSVParser final : public model::IDatasetStream {
+private:
+    std::filesystem::path path_;
+    boost::iostreams::mapped_file_source file_;
+    char const* data_begin_ = nullptr; /* first byte after the header */
+    char const* pos_ = nullptr;        /* beginning of the next record */
+    char const* end_ = nullptr;
+    char separator_;
+    bool has_header_;
+    size_t number_of_columns_ = 0;
+    std::vector<std::string> column_names_;
+    std::string relation_name_;
+    std::vector<std::string_view> batch_fields_;
+
+    std::string_view GetNextLine();
+    void ParseLine(std::string_view line, Row& row) const;
+
+public:
+    explicit MmapCSVParser(std::filesystem::path const& path);
+    MmapCSVParser(std::filesystem::path const& path, char separator, bool has_header);
+    explicit MmapCSVParser(CSVConfig const& csv_config);
+
+    Row GetNextRow() override;
+    size_t GetNextBatch(size_t max_rows, model::DatasetBatch& batch) override;
+    std::vector<std::unique_ptr<model::IDatasetStream>> SplitIntoChunks(
+            size_t max_chunks) override;
+
+    bool HasNextRow() const override {
+        return pos_ != end_;
+    }
+
+    char GetSeparator() const {
+        return separator_;
+    }
+
+    size_t GetNumberOfColumns() const override {
+        return number_of_columns_;
+    }
+
+    std::string GetColumnName(size_t index) const override {
+        return column_names_[index];
+    }
+
+    std::string GetRelationName() const override {
+        return relation_name_;
+    }
+
+    std::filesystem::path GetSourcePath() const override {
+        return path_;
+    }
+
+    std::string GetSourceFormat() const override {
+        return {separator_, has_header_ ? 'h' : 'n'};
+    }
+
+    void Reset() override {
+        pos_ = data_begin_;
+    }
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace util {
+
+// Lets a running algorithm be stopped from the outside, either explicitly or by a deadline.
+// Mining loops poll StopRequested, which is cheap enough to be called for every candidate: it
+// reads a couple of atomics and, if there is a deadline, the steady clock. Once a stop is observed
+// it is remembered, so that the caller can tell a complete result from a partial one.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr Clock::rep kNoDeadline = Clock::time_point::max().time_since_epoch().count();
+
+    std::atomic<bool> cancel_requested_ = false;
+    std::atomic<Clock::rep> deadline_ = kNoDeadline;
+    std::atomic<bool> stopped_ = false;
+    // Token of the algorithm that runs this one as its part, it can stop this one too
+    CancellationToken* parent_ = nullptr;
+
+public:
+    // May be called from any thread
+    void Cancel() noexcept {
+        cancel_requested_.store(true, std::memory_order_relaxed);
+    }
+
+    // Moves the deadline to `deadline` if it is earlier than the current one
+    void LimitDeadline(Clock::time_point deadline) noexcept {
+        Clock::rep const ticks = deadline.time_since_epoch().count();
+        Clock::rep current = deadline_.load(std::memory_order_relaxed);
+        while (ticks < current &&
+               !deadline_.compare_exchange_weak(current, ticks, std::memory_order_relaxed)) {
+        }
+    }
+
+    void SetParent(CancellationToken* parent) noexcept {
+        parent_ = parent;
+    }
+
+    // Forgets the deadline and the stop requests
+    void Reset() noexcept {
+        cancel_requested_.store(false, std::memory_order_relaxed);
+        deadline_.store(kNoDeadline, std::memory_order_relaxed);
+        stopped_.store(false, std::memory_order_relaxed);
+    }
+
+    bool StopRequested() noexcept {
+        if (stopped_.load(std::memory_order_relaxed)) return true;
+        Clock::rep const deadline = deadline_.load(std::memory_order_relaxed);
+        if (cancel_requested_.load(std::memory_order_relaxed) ||
+            (deadline != kNoDeadline && Clock::now().time_since_epoch().count() >= deadline) ||
+            (parent_ != nullptr && parent_->StopRequested())) {
+            stopped_.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Whether StopRequested has returned true since the last Reset
+    bool Stopped() const noexcept {
+        return stopped_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace util
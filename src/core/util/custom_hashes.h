@@ -1,5 +1,10 @@
 #pragma once
 
+#include <limits>
+
+#include <boost/functional/hash.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+
 #include "model/table/relational_schema.h"
 #include "model/table/vertical.h"
 
@@ -24,7 +29,14 @@ private:
 template <>
 inline size_t CustomHashing::BitsetHash<CustomHashing::BitsetHashingMethod::kTryConvertToUlong>(
         boost::dynamic_bitset<> const& bitset) {
-    return bitset.to_ulong();
+    if (bitset.size() <= std::numeric_limits<unsigned long>::digits) {
+        return bitset.to_ulong();
+    }
+    /* Schemas wider than a word don't fit into unsigned long, so their blocks are combined */
+    size_t hash = 0;
+    auto combine = [&hash](auto block) { boost::hash_combine(hash, block); };
+    boost::to_block_range(bitset, boost::make_function_output_iterator(combine));
+    return hash;
 }
 
 template <>
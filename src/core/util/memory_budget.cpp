@@ -0,0 +1,63 @@
+#include "util/memory_budget.h"
+
+#include <string>
+
+namespace util {
+
+MemoryBudget& MemoryBudget::Process() {
+    static MemoryBudget process_budget;
+    return process_budget;
+}
+
+bool MemoryBudget::TryReserve(size_t bytes, bool evictable) noexcept {
+    size_t const limit = GetLimit();
+    size_t const allowed = evictable ? EvictableLimit(limit) : limit;
+    size_t used = used_.load(std::memory_order_relaxed);
+    do {
+        if (bytes > allowed || used > allowed - bytes) return false;
+    } while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+    if (parent_ != nullptr && !parent_->TryReserve(bytes, evictable)) {
+        used_.fetch_sub(bytes, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t const new_used = used + bytes;
+    size_t peak = peak_.load(std::memory_order_relaxed);
+    while (peak < new_used &&
+           !peak_.compare_exchange_weak(peak, new_used, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void MemoryBudget::Reserve(size_t bytes) {
+    if (!TryReserve(bytes)) {
+        throw MemoryLimitError("Memory limit is exceeded: " + std::to_string(bytes) +
+                               " more bytes are needed while " + std::to_string(GetUsed()) +
+                               " bytes are in use");
+    }
+}
+
+void MemoryBudget::Release(size_t bytes) noexcept {
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+    if (parent_ != nullptr) {
+        parent_->Release(bytes);
+    }
+}
+
+void* BudgetedResource::do_allocate(size_t bytes, size_t alignment) {
+    budget_.Reserve(bytes);
+    try {
+        return upstream_->allocate(bytes, alignment);
+    } catch (...) {
+        budget_.Release(bytes);
+        throw;
+    }
+}
+
+void BudgetedResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    budget_.Release(bytes);
+}
+
+}  // namespace util
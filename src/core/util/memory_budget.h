@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace util {
+
+/* Thrown when a structure that can't be dropped doesn't fit into the memory limit */
+class MemoryLimitError : public std::runtime_error {
+public:
+    explicit MemoryLimitError(std::string const& message) : std::runtime_error(message) {}
+};
+
+/* Accounts for the memory taken by the large structures of an algorithm: cached PLIs, probing
+ * tables, lattice levels, distance matrices. They reserve their bytes here and release them when
+ * they are freed, so the sum is known without hooking the global allocator.
+ * Reservations are passed on to the parent, the budget of every algorithm has the process-wide
+ * one as its parent, so a limit on the latter covers all the algorithms running at once.
+ * Structures that can be dropped, i.e. caches, reserve with TryReserveEvictable, which leaves a
+ * quarter of the limit to the ones that can't. A cache that gets refused evicts its entries and
+ * retries, so the caches give way once the other structures grow.
+ * NOTE: all methods are thread-safe */
+class MemoryBudget {
+public:
+    static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
+
+private:
+    MemoryBudget* parent_;
+    std::atomic<size_t> limit_;
+    std::atomic<size_t> used_ = 0;
+    std::atomic<size_t> peak_ = 0;
+
+    static size_t EvictableLimit(size_t limit) noexcept {
+        return limit == kUnlimited ? limit : limit - limit / 4;
+    }
+
+    bool TryReserve(size_t bytes, bool evictable) noexcept;
+
+public:
+    explicit MemoryBudget(MemoryBudget* parent = nullptr, size_t limit = kUnlimited) noexcept
+        : parent_(parent), limit_(limit) {}
+
+    MemoryBudget(MemoryBudget const&) = delete;
+    MemoryBudget& operator=(MemoryBudget const&) = delete;
+
+    /* Parent of the budgets of the algorithms, it is not limited unless the embedding application
+     * limits it */
+    static MemoryBudget& Process();
+
+    /* Reservations made before are kept even if they exceed the new limit */
+    void SetLimit(size_t limit) noexcept {
+        limit_.store(limit, std::memory_order_relaxed);
+    }
+
+    /* For structures that are needed to go on, throws MemoryLimitError if `bytes` don't fit */
+    void Reserve(size_t bytes);
+
+    /* For structures that would be dropped or replaced with smaller ones if `bytes` don't fit */
+    bool TryReserve(size_t bytes) noexcept {
+        return TryReserve(bytes, false);
+    }
+
+    /* Like TryReserve, but fails once three quarters of the limit are taken */
+    bool TryReserveEvictable(size_t bytes) noexcept {
+        return TryReserve(bytes, true);
+    }
+
+    void Release(size_t bytes) noexcept;
+
+    /* Forgets the peak, reservations that are still held count as the new one */
+    void ResetPeak() noexcept {
+        peak_.store(used_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t GetLimit() const noexcept {
+        return limit_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t GetUsed() const noexcept {
+        return used_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t GetPeak() const noexcept {
+        return peak_.load(std::memory_order_relaxed);
+    }
+};
+
+/* Bytes reserved in a MemoryBudget for as long as the object lives */
+class MemoryReservation {
+private:
+    MemoryBudget* budget_ = nullptr;
+    size_t bytes_ = 0;
+
+    MemoryReservation(MemoryBudget* budget, size_t bytes) noexcept
+        : budget_(budget), bytes_(bytes) {}
+
+public:
+    MemoryReservation() noexcept = default;
+
+    /* Throws MemoryLimitError if `bytes` don't fit */
+    static MemoryReservation Make(MemoryBudget& budget, size_t bytes) {
+        budget.Reserve(bytes);
+        return {&budget, bytes};
+    }
+
+    /* Empty reservation if `bytes` don't fit */
+    static MemoryReservation TryMake(MemoryBudget& budget, size_t bytes) noexcept {
+        if (!budget.TryReserve(bytes)) return {};
+        return {&budget, bytes};
+    }
+
+    MemoryReservation(MemoryReservation&& other) noexcept
+        : budget_(std::exchange(other.budget_, nullptr)), bytes_(std::exchange(other.bytes_, 0)) {}
+
+    MemoryReservation& operator=(MemoryReservation&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            budget_ = std::exchange(other.budget_, nullptr);
+            bytes_ = std::exchange(other.bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~MemoryReservation() {
+        Reset();
+    }
+
+    void Reset() noexcept {
+        if (budget_ != nullptr) {
+            budget_->Release(bytes_);
+            budget_ = nullptr;
+            bytes_ = 0;
+        }
+    }
+
+    explicit operator bool() const noexcept {
+        return budget_ != nullptr;
+    }
+
+    [[nodiscard]] size_t GetBytes() const noexcept {
+        return bytes_;
+    }
+};
+
+/* Memory resource that reserves what it allocates in a MemoryBudget. It is meant to be the
+ * upstream of a pool resource, so that the budget is charged for whole chunks rather than for
+ * every allocation. Throws MemoryLimitError when an allocation doesn't fit */
+class BudgetedResource final : public std::pmr::memory_resource {
+private:
+    MemoryBudget& budget_;
+    std::pmr::memory_resource* upstream_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit BudgetedResource(MemoryBudget& budget,
+                              std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : budget_(budget), upstream_(upstream) {}
+};
+
+}  // namespace util
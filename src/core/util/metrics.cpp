@@ -0,0 +1,140 @@
+#include "util/metrics.h"
+
+#include <bit>
+
+namespace util {
+
+namespace detail {
+
+size_t ThreadMetricShard() noexcept {
+    static std::atomic<size_t> next_shard = 0;
+    thread_local size_t const shard =
+            next_shard.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return shard;
+}
+
+}  // namespace detail
+
+namespace {
+
+template <typename T>
+T& GetOrCreate(std::shared_mutex& mutex,
+               std::map<std::string, std::unique_ptr<T>, std::less<>>& metrics,
+               std::string_view name) {
+    {
+        std::shared_lock lock(mutex);
+        if (auto it = metrics.find(name); it != metrics.end()) {
+            return *it->second;
+        }
+    }
+    std::lock_guard lock(mutex);
+    auto it = metrics.find(name);
+    if (it == metrics.end()) {
+        it = metrics.emplace(std::string(name), std::make_unique<T>()).first;
+    }
+    return *it->second;
+}
+
+}  // namespace
+
+uint64_t MetricCounter::Get() const noexcept {
+    uint64_t sum = 0;
+    for (Shard const& shard : shards_) {
+        sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void MetricCounter::Reset() noexcept {
+    for (Shard& shard : shards_) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::Record(uint64_t value) noexcept {
+    buckets_[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.Add(value);
+}
+
+MetricHistogram::Value MetricHistogram::Get() const {
+    Value value{0, sum_.Get(), std::vector<uint64_t>(kNumBuckets)};
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        value.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        value.count += value.buckets[i];
+    }
+    return value;
+}
+
+void MetricHistogram::Reset() noexcept {
+    for (std::atomic<uint64_t>& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.Reset();
+}
+
+thread_local Metrics* Metrics::current_ = nullptr;
+
+Metrics::Metrics()
+    : pli_intersections_(Counter("pli_intersections")),
+      pli_probed_rows_(Counter("pli_probed_rows")),
+      pli_intersection_time_(Timer("pli_intersection")),
+      pli_cache_hits_(Counter("pli_cache_hits")),
+      pli_cache_misses_(Counter("pli_cache_misses")),
+      probing_table_cache_hits_(Counter("probing_table_cache_hits")),
+      probing_table_cache_misses_(Counter("probing_table_cache_misses")),
+      validations_(Counter("validations")),
+      validation_time_(Timer("validation")) {}
+
+MetricCounter& Metrics::Counter(std::string_view name) {
+    return GetOrCreate(mutex_, counters_, name);
+}
+
+MetricTimer& Metrics::Timer(std::string_view name) {
+    return GetOrCreate(mutex_, timers_, name);
+}
+
+MetricHistogram& Metrics::Histogram(std::string_view name) {
+    return GetOrCreate(mutex_, histograms_, name);
+}
+
+std::map<std::string, uint64_t> Metrics::GetCounters() const {
+    std::shared_lock lock(mutex_);
+    std::map<std::string, uint64_t> values;
+    for (auto const& [name, counter] : counters_) {
+        values.emplace(name, counter->Get());
+    }
+    return values;
+}
+
+std::map<std::string, MetricTimer::Value> Metrics::GetTimers() const {
+    std::shared_lock lock(mutex_);
+    std::map<std::string, MetricTimer::Value> values;
+    for (auto const& [name, timer] : timers_) {
+        values.emplace(name, timer->Get());
+    }
+    return values;
+}
+
+std::map<std::string, MetricHistogram::Value> Metrics::GetHistograms() const {
+    std::shared_lock lock(mutex_);
+    std::map<std::string, MetricHistogram::Value> values;
+    for (auto const& [name, histogram] : histograms_) {
+        values.emplace(name, histogram->Get());
+    }
+    return values;
+}
+
+void Metrics::Reset() noexcept {
+    std::shared_lock lock(mutex_);
+    for (auto const& [name, counter] : counters_) {
+        counter->Reset();
+    }
+    for (auto const& [name, timer] : timers_) {
+        timer->Reset();
+    }
+    for (auto const& [name, histogram] : histograms_) {
+        histogram->Reset();
+    }
+}
+
+}  // namespace util
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+namespace detail {
+
+constexpr size_t kMetricShards = 16;
+
+/* Index of the shard the calling thread writes to */
+size_t ThreadMetricShard() noexcept;
+
+}  // namespace detail
+
+/* Counter that is cheap to increment from many threads at once: every thread adds to its own
+ * cache line, the shards are summed only when the counter is read */
+class MetricCounter {
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value = 0;
+    };
+
+    std::array<Shard, detail::kMetricShards> shards_;
+
+public:
+    void Add(uint64_t value = 1) noexcept {
+        shards_[detail::ThreadMetricShard()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t Get() const noexcept;
+    void Reset() noexcept;
+};
+
+/* Total time and number of the timed sections */
+class MetricTimer {
+private:
+    MetricCounter nanos_;
+    MetricCounter count_;
+
+public:
+    struct Value {
+        uint64_t count;
+        std::chrono::nanoseconds total;
+    };
+
+    void Record(std::chrono::nanoseconds duration) noexcept {
+        nanos_.Add(duration.count());
+        count_.Add();
+    }
+
+    [[nodiscard]] Value Get() const noexcept {
+        return {count_.Get(), std::chrono::nanoseconds(nanos_.Get())};
+    }
+
+    void Reset() noexcept {
+        nanos_.Reset();
+        count_.Reset();
+    }
+};
+
+/* Records the time from construction to destruction, does nothing if the timer is null */
+class ScopedTimer {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    MetricTimer* timer_;
+    Clock::time_point start_;
+
+public:
+    explicit ScopedTimer(MetricTimer* timer) noexcept
+        : timer_(timer), start_(timer != nullptr ? Clock::now() : Clock::time_point{}) {}
+
+    ScopedTimer(ScopedTimer const&) = delete;
+    ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+    ~ScopedTimer() {
+        if (timer_ != nullptr) {
+            timer_->Record(Clock::now() - start_);
+        }
+    }
+};
+
+/* Calls `f` and records the time it took into `timer` */
+template <typename F>
+decltype(auto) TimedCall(MetricTimer& timer, F&& f) {
+    ScopedTimer scoped_timer(&timer);
+    return std::forward<F>(f)();
+}
+
+/* Distribution of non-negative values over power-of-two buckets: bucket 0 holds zeros, bucket i
+ * holds the values in [2^(i-1), 2^i). Unlike the counters, the buckets are not split per thread,
+ * as they are many and the threads rarely hit the same one at once */
+class MetricHistogram {
+public:
+    static constexpr size_t kNumBuckets = 65;
+
+    struct Value {
+        uint64_t count;
+        uint64_t sum;
+        std::vector<uint64_t> buckets;
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+    MetricCounter sum_;
+
+public:
+    void Record(uint64_t value) noexcept;
+
+    [[nodiscard]] Value Get() const;
+    void Reset() noexcept;
+};
+
+/* Counters, timers and histograms of one algorithm, see Algorithm::GetMetrics. Metrics are
+ * created by name on first use and live as long as the registry, so the references to them may
+ * be kept. The metrics of the model classes shared by the algorithms (PLI intersections, caches)
+ * and the validation metrics most miners record are created beforehand and recorded into the
+ * registry of the current thread, which is set for the duration of Algorithm::Execute and passed
+ * on to the tasks of util::TaskGroup. Threads created by an algorithm itself should set it with
+ * Scope.
+ * Looking a metric up by name takes a shared lock, so hot loops should rather keep the reference.
+ * NOTE: all methods are thread-safe */
+class Metrics {
+public:
+    /* Makes `metrics` the registry of the current thread until destruction */
+    class Scope {
+    private:
+        Metrics* previous_;
+
+    public:
+        explicit Scope(Metrics* metrics) noexcept : previous_(std::exchange(current_, metrics)) {}
+
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+        ~Scope() {
+            current_ = previous_;
+        }
+    };
+
+private:
+    static thread_local Metrics* current_;
+
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, std::unique_ptr<MetricCounter>, std::less<>> counters_;
+    std::map<std::string, std::unique_ptr<MetricTimer>, std::less<>> timers_;
+    std::map<std::string, std::unique_ptr<MetricHistogram>, std::less<>> histograms_;
+
+    MetricCounter& pli_intersections_;
+    MetricCounter& pli_probed_rows_;
+    MetricTimer& pli_intersection_time_;
+    MetricCounter& pli_cache_hits_;
+    MetricCounter& pli_cache_misses_;
+    MetricCounter& probing_table_cache_hits_;
+    MetricCounter& probing_table_cache_misses_;
+    MetricCounter& validations_;
+    MetricTimer& validation_time_;
+
+public:
+    Metrics();
+
+    Metrics(Metrics const&) = delete;
+    Metrics& operator=(Metrics const&) = delete;
+
+    /* Null outside of Algorithm::Execute */
+    static Metrics* Current() noexcept {
+        return current_;
+    }
+
+    MetricCounter& Counter(std::string_view name);
+    MetricTimer& Timer(std::string_view name);
+    MetricHistogram& Histogram(std::string_view name);
+
+    MetricCounter& PliIntersections() noexcept {
+        return pli_intersections_;
+    }
+
+    /* Rows of the intersected PLIs that were looked up in a probing table */
+    MetricCounter& PliProbedRows() noexcept {
+        return pli_probed_rows_;
+    }
+
+    MetricTimer& PliIntersectionTime() noexcept {
+        return pli_intersection_time_;
+    }
+
+    MetricCounter& PliCacheHits() noexcept {
+        return pli_cache_hits_;
+    }
+
+    MetricCounter& PliCacheMisses() noexcept {
+        return pli_cache_misses_;
+    }
+
+    MetricCounter& ProbingTableCacheHits() noexcept {
+        return probing_table_cache_hits_;
+    }
+
+    MetricCounter& ProbingTableCacheMisses() noexcept {
+        return probing_table_cache_misses_;
+    }
+
+    /* Candidate dependencies checked against the data, by the miners that validate them */
+    MetricCounter& Validations() noexcept {
+        return validations_;
+    }
+
+    MetricTimer& ValidationTime() noexcept {
+        return validation_time_;
+    }
+
+    [[nodiscard]] std::map<std::string, uint64_t> GetCounters() const;
+    [[nodiscard]] std::map<std::string, MetricTimer::Value> GetTimers() const;
+    [[nodiscard]] std::map<std::string, MetricHistogram::Value> GetHistograms() const;
+
+    /* Zeroes all the metrics, the references to them stay valid */
+    void Reset() noexcept;
+};
+
+}  // namespace util
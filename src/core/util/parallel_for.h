@@ -1,61 +1,107 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <system_error>
-#include <thread>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
-#include <easylogging++.h>
+#include "util/task_scheduler.h"
 
 namespace util {
 
+namespace detail {
+
+/* Threads take the elements in chunks of a fraction of what is left, so the chunks are large at
+ * first and get smaller to the end, and a thread that got expensive elements does not hold up the
+ * others */
+template <std::random_access_iterator It, typename Function>
+void ParallelForeachRandomAccess(It begin, size_t length, unsigned threads_num, Function& f) {
+    constexpr size_t kChunksPerThread = 2;
+    std::atomic<size_t> next = 0;
+    auto run = [begin, length, threads_num, &next, &f](unsigned worker_index) {
+        size_t first = next.load(std::memory_order_relaxed);
+        while (first < length) {
+            size_t const chunk_size =
+                    std::max<size_t>(1, (length - first) / (kChunksPerThread * threads_num));
+            if (!next.compare_exchange_weak(first, first + chunk_size,
+                                            std::memory_order_relaxed)) {
+                continue;
+            }
+            try {
+                for (It it = begin + first, last = it + chunk_size; it != last; ++it) {
+                    f(worker_index, *it);
+                }
+            } catch (...) {
+                /* Don't let the other threads start new chunks */
+                next.store(length, std::memory_order_relaxed);
+                throw;
+            }
+            first = next.load(std::memory_order_relaxed);
+        }
+    };
+
+    TaskScheduler& scheduler = TaskScheduler::Instance();
+    scheduler.Reserve(threads_num);
+    TaskGroup group(scheduler);
+    for (unsigned worker_index = 1; worker_index < threads_num; ++worker_index) {
+        group.Run([&run, worker_index]() { run(worker_index); });
+    }
+    run(0);
+    group.Wait();
+}
+
+}  // namespace detail
+
 /* Parallel version of std::for_each which allows to specify the number of threads to use.
+ * Calls f(worker_index, element), where worker_index < threads_num_max tells apart the threads
+ * running at once, so that they can keep their own state without synchronization.
  * If threads_num_max == 1 then behaves like a sequential std::for_each.
+ * Runs on the process-wide TaskScheduler, so it can be nested into other parallel operations.
  * NOTE: actual number of threads to be used is minimum of the
  *       std::distance(begin, end) and threads_num_max.
  */
-template <typename It, typename UnaryFunction>
-inline void ParallelForeach(It begin, It end, unsigned const threads_num_max, UnaryFunction f) {
+template <typename It, typename BinaryFunction>
+inline void ParallelForeachByWorker(It begin, It end, unsigned const threads_num_max,
+                                    BinaryFunction f) {
     assert(threads_num_max != 0);
-    auto const length = std::distance(begin, end);
+    auto const length = static_cast<size_t>(std::distance(begin, end));
     if (length == 0) {
         return;
     }
     auto const threads_num_actual =
-            static_cast<unsigned>(std::min(length, static_cast<decltype(length)>(threads_num_max)));
-    auto const items_per_thread = std::distance(begin, end) / threads_num_actual;
-    std::vector<std::thread> threads;
-    threads.reserve(threads_num_actual);
-
-    auto const task = [&f](It first, It last) {
-        for (; first != last; ++first) {
-            f(*first);
-        }
-    };
-
-    It p = begin;
-    for (unsigned i = 0; i < threads_num_actual - 1; ++i) {
-        It prev = p;
-        std::advance(p, items_per_thread);
-        try {
-            threads.emplace_back(task, prev, p);
-        } catch (std::system_error const& e) {
-            /* Could not create a new thread */
-            LOG(WARNING) << "Created " << threads.size() << " threads in ParallelForeach. "
-                         << "Could not create new thread: " << e.what();
-            /* Fall through to the serial case for the remaining elements */
-            p = prev;
-            break;
+            static_cast<unsigned>(std::min(length, static_cast<size_t>(threads_num_max)));
+    if (threads_num_actual == 1) {
+        for (; begin != end; ++begin) {
+            f(0u, *begin);
         }
+        return;
     }
 
-    for (; p != end; ++p) {
-        f(*p);
+    if constexpr (std::random_access_iterator<It>) {
+        detail::ParallelForeachRandomAccess(begin, length, threads_num_actual, f);
+    } else {
+        std::vector<It> iterators;
+        iterators.reserve(length);
+        for (; begin != end; ++begin) {
+            iterators.push_back(begin);
+        }
+        auto dereference = [&f](unsigned worker_index, It it) { f(worker_index, *it); };
+        detail::ParallelForeachRandomAccess(iterators.begin(), length, threads_num_actual,
+                                            dereference);
     }
+}
 
-    for (auto& thread : threads) {
-        thread.join();
-    }
+/* Parallel version of std::for_each which allows to specify the number of threads to use.
+ * If threads_num_max == 1 then behaves like a sequential std::for_each.
+ * NOTE: actual number of threads to be used is minimum of the
+ *       std::distance(begin, end) and threads_num_max.
+ */
+template <typename It, typename UnaryFunction>
+inline void ParallelForeach(It begin, It end, unsigned const threads_num_max, UnaryFunction f) {
+    ParallelForeachByWorker(begin, end, threads_num_max,
+                            [&f](unsigned, auto&& element) { f(element); });
 }
 
 }  // namespace util
@@ -0,0 +1,161 @@
+#include "util/task_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+#include <easylogging++.h>
+
+namespace util {
+
+thread_local TaskScheduler::Worker* TaskScheduler::current_worker_ = nullptr;
+
+TaskScheduler& TaskScheduler::Instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    unsigned const num_workers = num_workers_.load(std::memory_order_acquire);
+    for (unsigned i = 0; i < num_workers; ++i) {
+        workers_[i]->thread.join();
+    }
+}
+
+void TaskScheduler::Reserve(unsigned threads_num) {
+    unsigned const num_workers = std::min(std::max(threads_num, 1u) - 1, kMaxWorkers);
+    if (num_workers_.load(std::memory_order_acquire) >= num_workers) return;
+
+    std::lock_guard lock(grow_mutex_);
+    for (unsigned i = num_workers_.load(std::memory_order_relaxed); i < num_workers; ++i) {
+        workers_[i] = std::make_unique<Worker>();
+        try {
+            workers_[i]->thread = std::thread(&TaskScheduler::WorkerLoop, this, workers_[i].get());
+        } catch (std::system_error const& e) {
+            /* The threads that wait for their tasks run them, so fewer workers only mean less
+             * parallelism */
+            LOG(WARNING) << "Created " << i << " worker threads. Could not create new thread: "
+                         << e.what();
+            workers_[i].reset();
+            return;
+        }
+        num_workers_.store(i + 1, std::memory_order_release);
+    }
+}
+
+void TaskScheduler::Submit(Task task) {
+    if (current_worker_ != nullptr) {
+        std::lock_guard lock(current_worker_->mutex);
+        current_worker_->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard lock(shared_mutex_);
+        shared_tasks_.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(sleep_mutex_);
+        num_pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    sleep_cv_.notify_one();
+}
+
+bool TaskScheduler::TakeTask(Task& task) {
+    auto take = [&task](std::mutex& mutex, std::deque<Task>& tasks, bool from_back) {
+        std::lock_guard lock(mutex);
+        if (tasks.empty()) return false;
+        if (from_back) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+        } else {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        return true;
+    };
+
+    bool found = (current_worker_ != nullptr &&
+                  take(current_worker_->mutex, current_worker_->tasks, true)) ||
+                 take(shared_mutex_, shared_tasks_, false);
+    if (!found) {
+        /* Threads start stealing from different victims, so they don't contend for one deque */
+        static thread_local unsigned next_victim = 0;
+        unsigned const num_workers = num_workers_.load(std::memory_order_acquire);
+        for (unsigned i = 0; i < num_workers && !found; ++i) {
+            Worker* victim = workers_[(next_victim + i) % num_workers].get();
+            found = victim != current_worker_ && take(victim->mutex, victim->tasks, false);
+        }
+        ++next_victim;
+    }
+    if (found) {
+        num_pending_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void TaskScheduler::WorkerLoop(Worker* worker) {
+    current_worker_ = worker;
+    Task task;
+    while (true) {
+        if (TakeTask(task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex_);
+        sleep_cv_.wait(lock, [this]() {
+            return stop_ || num_pending_.load(std::memory_order_relaxed) > 0;
+        });
+        if (stop_) return;
+    }
+}
+
+bool TaskScheduler::RunPendingTask() {
+    Task task;
+    if (!TakeTask(task)) return false;
+    task();
+    return true;
+}
+
+void TaskGroup::Finish(std::exception_ptr exception) noexcept {
+    /* Waiters may destroy the group as soon as the mutex is released */
+    std::lock_guard lock(mutex_);
+    if (exception != nullptr && exception_ == nullptr) {
+        exception_ = std::move(exception);
+    }
+    if (--num_running_ == 0) {
+        finished_cv_.notify_all();
+    }
+}
+
+void TaskGroup::WaitNoThrow() noexcept {
+    /* A waiter that has nothing to run sleeps, but not for long, since the unfinished tasks may
+     * spawn tasks it could help with */
+    constexpr auto kSleepTime = std::chrono::milliseconds(1);
+    while (true) {
+        {
+            std::lock_guard lock(mutex_);
+            if (num_running_ == 0) return;
+        }
+        if (scheduler_.RunPendingTask()) continue;
+        std::unique_lock lock(mutex_);
+        finished_cv_.wait_for(lock, kSleepTime, [this]() { return num_running_ == 0; });
+    }
+}
+
+void TaskGroup::Wait() {
+    WaitNoThrow();
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(mutex_);
+        exception = std::exchange(exception_, nullptr);
+    }
+    if (exception != nullptr) {
+        std::rethrow_exception(exception);
+    }
+}
+
+}  // namespace util
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "util/metrics.h"
+
+namespace util {
+
+/* Process-wide pool of worker threads that run tasks with work stealing. Every worker has its own
+ * deque: it pushes the tasks it spawns to the back and takes them from there, while the idle
+ * workers steal from the front of the other deques. Tasks submitted from the outside go to a
+ * shared queue. Workers are created on demand, so the number of threads a parallel operation
+ * runs on is limited only by what its caller asks for (see kThreadNumberOpt). A thread waiting
+ * for its tasks runs the pending ones, so tasks can spawn and wait for other tasks */
+class TaskScheduler {
+public:
+    /* Must not throw, TaskGroup takes care of the exceptions of its tasks */
+    using Task = std::function<void()>;
+
+    /* Requests for more threads are capped by it */
+    static constexpr unsigned kMaxWorkers = 256;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    /* Only the first num_workers_ are created, the workers are never destroyed before the
+     * scheduler, so they can be stolen from without locking the array */
+    std::array<std::unique_ptr<Worker>, kMaxWorkers> workers_;
+    std::atomic<unsigned> num_workers_ = 0;
+    std::mutex grow_mutex_;
+
+    std::mutex shared_mutex_;
+    std::deque<Task> shared_tasks_;
+
+    /* Number of the submitted tasks that are not taken yet. It is incremented under sleep_mutex_,
+     * so an idle worker cannot miss a task, and may go below zero for a moment, as a task can be
+     * taken before it is counted */
+    std::atomic<std::ptrdiff_t> num_pending_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    bool stop_ = false;
+
+    static thread_local Worker* current_worker_;
+
+    TaskScheduler() = default;
+
+    bool TakeTask(Task& task);
+    void WorkerLoop(Worker* worker);
+
+public:
+    static TaskScheduler& Instance();
+
+    TaskScheduler(TaskScheduler const&) = delete;
+    TaskScheduler& operator=(TaskScheduler const&) = delete;
+    ~TaskScheduler();
+
+    /* Makes sure that `threads_num` threads can run tasks at once: the calling one and
+     * threads_num - 1 workers */
+    void Reserve(unsigned threads_num);
+
+    void Submit(Task task);
+
+    /* Runs a pending task, if there is one */
+    bool RunPendingTask();
+
+    unsigned GetNumWorkers() const noexcept {
+        return num_workers_.load(std::memory_order_acquire);
+    }
+};
+
+/* Tasks that are waited for together. The first exception thrown by a task is rethrown by Wait,
+ * the group must outlive its tasks, so it waits for them on destruction. Tasks record their
+ * metrics into the registry of the thread that has called Run */
+class TaskGroup {
+private:
+    TaskScheduler& scheduler_;
+    std::mutex mutex_;
+    std::condition_variable finished_cv_;
+    size_t num_running_ = 0;
+    std::exception_ptr exception_;
+
+    void Finish(std::exception_ptr exception) noexcept;
+
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::Instance())
+        : scheduler_(scheduler) {}
+
+    TaskGroup(TaskGroup const&) = delete;
+    TaskGroup& operator=(TaskGroup const&) = delete;
+
+    ~TaskGroup() {
+        WaitNoThrow();
+    }
+
+    template <typename F>
+    void Run(F&& f) {
+        {
+            std::lock_guard lock(mutex_);
+            ++num_running_;
+        }
+        scheduler_.Submit([this, f = std::forward<F>(f), metrics = Metrics::Current()]() mutable {
+            Metrics::Scope metrics_scope(metrics);
+            std::exception_ptr exception;
+            try {
+                f();
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            Finish(std::move(exception));
+        });
+    }
+
+    /* Runs pending tasks, of this group or not, until the tasks of the group are finished */
+    void Wait();
+    void WaitNoThrow() noexcept;
+};
+
+}  // namespace util
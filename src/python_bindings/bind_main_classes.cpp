@@ -1,5 +1,6 @@
 #include "bind_main_classes.h"
 
+#include <chrono>
 #include <typeindex>
 #include <typeinfo>
 
@@ -13,6 +14,8 @@
 #include "py_util/get_py_type.h"
 #include "py_util/opt_to_py.h"
 #include "py_util/py_to_any.h"
+#include "util/memory_budget.h"
+#include "util/metrics.h"
 
 namespace {
 namespace py = pybind11;
@@ -41,6 +44,8 @@ void BindMainClasses(py::module_& main_module) {
 
     py::register_exception<config::ConfigurationError>(main_module, "ConfigurationError",
                                                        PyExc_ValueError);
+    py::register_exception<util::MemoryLimitError>(main_module, "MemoryLimitError",
+                                                   PyExc_MemoryError);
 
 #define CERTAIN_SCRIPTS_ONLY                                                       \
     "\nThis option is only expected to be used by Python scripts in which it is\n" \
@@ -106,9 +111,58 @@ void BindMainClasses(py::module_& main_module) {
                     "execute",
                     [](Algorithm& algo, py::kwargs const& kwargs) {
                         ConfigureAlgo(algo, kwargs);
+                        // Options are converted by now, so that cancel may be called from
+                        // another Python thread while the algorithm runs
+                        py::gil_scoped_release release;
                         algo.Execute();
                     },
-                    "Process data.");
+                    "Process data.")
+            .def("cancel", &Algorithm::Cancel,
+                 "Ask the running execute to stop. The algorithm stops at the nearest point "
+                 "where it can keep a correct partial result. May be called from another "
+                 "thread. If execute is not running, the next one stops.")
+            .def(
+                    "set_time_limit",
+                    [](Algorithm& algo, double seconds) {
+                        if (seconds < 0) {
+                            throw config::ConfigurationError("Time limit must not be negative");
+                        }
+                        algo.SetTimeLimit(std::chrono::milliseconds(
+                                static_cast<std::chrono::milliseconds::rep>(seconds * 1000)));
+                    },
+                    "seconds"_a,
+                    "Limit the time execute may take, 0 means no limit. When the time is up, "
+                    "the algorithm stops as if cancel was called.")
+            .def("is_complete", &Algorithm::IsComplete,
+                 "Whether the last execute ran to the end, rather than being stopped by cancel "
+                 "or by the time limit.")
+            .def("get_peak_memory_usage", &Algorithm::GetPeakMemoryUsage,
+                 "Get the most memory in bytes that the caches, lattice levels and matrices of "
+                 "the last execute took at once.")
+            .def(
+                    "get_metrics",
+                    [](Algorithm const& algo) {
+                        util::Metrics const& metrics = algo.GetMetrics();
+                        py::dict timers;
+                        for (auto const& [name, timer] : metrics.GetTimers()) {
+                            timers[py::str(name)] = py::dict(
+                                    "count"_a = timer.count,
+                                    "seconds"_a = std::chrono::duration<double>(timer.total)
+                                                          .count());
+                        }
+                        py::dict histograms;
+                        for (auto const& [name, histogram] : metrics.GetHistograms()) {
+                            histograms[py::str(name)] =
+                                    py::dict("count"_a = histogram.count, "sum"_a = histogram.sum,
+                                             "buckets"_a = histogram.buckets);
+                        }
+                        return py::dict("counters"_a = metrics.GetCounters(),
+                                        "timers"_a = timers, "histograms"_a = histograms);
+                    },
+                    "Get the metrics of the last execute as a dict with \"counters\", "
+                    "\"timers\" (count and total seconds of the timed sections) and "
+                    "\"histograms\" (count, sum and power-of-two buckets, the i-th bucket holds "
+                    "the values in [2^(i-1), 2^i)).");
 #undef CERTAIN_SCRIPTS_ONLY
 }
 }  // namespace python_bindings
@@ -19,19 +19,10 @@ static bool IsDataFrame(py::handle object) {
     }
 }
 
-static bool AllColumnsAreStrings(py::handle dataframe) {
-    py::object dtypes = dataframe.attr("dtypes");
-    return dtypes[dtypes.attr("__ne__")(py::str{"string"})].attr("empty").cast<bool>();
-}
-
 config::InputTable CreateDataFrameReader(py::handle dataframe, std::string name) {
     if (!IsDataFrame(dataframe))
         throw config::ConfigurationError("Passed object is not a dataframe");
-    if (AllColumnsAreStrings(dataframe)) {
-        return std::make_shared<StringDataframeReader>(dataframe, std::move(name));
-    } else {
-        return std::make_shared<ArbitraryDataframeReader>(dataframe, std::move(name));
-    }
+    return std::make_shared<DataframeReader>(dataframe, std::move(name));
 }
 
 }  // namespace python_bindings
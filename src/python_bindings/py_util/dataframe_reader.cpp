@@ -1,13 +1,20 @@
 #include "dataframe_reader.h"
 
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <Python.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/pytypes.h>
-#include <pybind11/stl.h>
 
 #include "model/types/builtin.h"
 
@@ -24,48 +31,236 @@ static std::vector<std::string> GetColumnNames(py::handle dataframe) {
     return names;
 }
 
-DataframeReaderBase::DataframeReaderBase(py::handle dataframe, std::string name)
-    : dataframe_(py::reinterpret_borrow<py::object>(dataframe)),
-      df_iter_(dataframe_.attr("itertuples")(false, py::none{})),
-      name_(std::move(name)),
-      column_names_(GetColumnNames(dataframe_)) {}
+// Copies the column out of the buffer of its NumPy representation, converting
+// it to T if the dtype is narrower.
+template <typename T>
+static std::vector<T> CopyValues(py::handle series) {
+    auto array = py::array_t<T, py::array::c_style | py::array::forcecast>::ensure(
+            series.attr("to_numpy")());
+    if (!array) {
+        throw py::error_already_set();
+    }
+    T const* data = array.data();
+    return std::vector<T>(data, data + array.size());
+}
+
+// Writes the same text as Python's repr(float), which is what str() shows for
+// the floats DataFrame.itertuples yields.
+template <size_t N>
+static std::string_view FormatFloat(double value, std::array<char, N>& buffer) {
+    if (std::isinf(value)) {
+        return value > 0 ? "inf" : "-inf";
+    }
+    // Shortest round-trip digits, "-d.ddde+XX"
+    std::array<char, N> scientific;
+    char const* const scientific_end =
+            std::to_chars(scientific.data(), scientific.data() + N, value,
+                          std::chars_format::scientific)
+                    .ptr;
+    char const* pos = scientific.data();
+    char* out = buffer.data();
+    if (*pos == '-') {
+        *out++ = *pos++;
+    }
+    std::array<char, N> digits;
+    size_t num_digits = 0;
+    for (; *pos != 'e'; ++pos) {
+        if (*pos != '.') digits[num_digits++] = *pos;
+    }
+    ++pos;
+    bool const negative_exponent = *pos++ == '-';
+    int exponent = 0;
+    std::from_chars(pos, scientific_end, exponent);
+    if (negative_exponent) exponent = -exponent;
 
-void DataframeReaderBase::Reset() {
-    df_iter_ = dataframe_.attr("itertuples")(false, py::none{});
+    // Position of the decimal point relative to the first digit
+    int const point = exponent + 1;
+    auto write_digits = [&out, &digits](size_t from, size_t to) {
+        out = std::copy(digits.data() + from, digits.data() + to, out);
+    };
+    if (-4 < point && point <= 16) {
+        if (point <= 0) {
+            *out++ = '0';
+            *out++ = '.';
+            out = std::fill_n(out, -point, '0');
+            write_digits(0, num_digits);
+        } else if (static_cast<size_t>(point) < num_digits) {
+            write_digits(0, point);
+            *out++ = '.';
+            write_digits(point, num_digits);
+        } else {
+            write_digits(0, num_digits);
+            out = std::fill_n(out, point - num_digits, '0');
+            *out++ = '.';
+            *out++ = '0';
+        }
+    } else {
+        write_digits(0, 1);
+        if (num_digits > 1) {
+            *out++ = '.';
+            write_digits(1, num_digits);
+        }
+        *out++ = 'e';
+        *out++ = exponent < 0 ? '-' : '+';
+        if (std::abs(exponent) < 10) {
+            *out++ = '0';
+        }
+        out = std::to_chars(out, buffer.data() + N, std::abs(exponent)).ptr;
+    }
+    return {buffer.data(), static_cast<size_t>(out - buffer.data())};
 }
 
-std::string DataframeReaderBase::GetRelationName() const {
-    return name_;
+DataframeReader::Column DataframeReader::ReadColumn(py::handle series) {
+    py::object dtype = series.attr("dtype");
+    // Extension dtypes (nullable integers, categories, ...) have no buffer of
+    // plain values and are read like object columns.
+    if (py::isinstance<py::dtype>(dtype)) {
+        switch (py::cast<py::dtype>(dtype).kind()) {
+            case 'i':
+                return {CopyValues<std::int64_t>(series), {}};
+            case 'u':
+                return {CopyValues<std::uint64_t>(series), {}};
+            case 'f':
+                return {CopyValues<double>(series), {}};
+            case 'b':
+                return {CopyValues<bool>(series), {}};
+            default:
+                break;
+        }
+    }
+
+    // Pandas uses several Python objects for its null value representation, so
+    // nullity is left to `isna`, which checks the whole column in one call.
+    std::vector<bool> const is_null = CopyValues<bool>(series.attr("isna")());
+    py::list values = series.attr("tolist")();
+    size_t const size = values.size();
+    Column column{std::vector<std::string>(size), boost::dynamic_bitset<>(size)};
+    auto& strings = std::get<std::vector<std::string>>(column.values);
+    for (size_t i = 0; i < size; ++i) {
+        if (is_null[i]) {
+            column.nulls.set(i);
+            continue;
+        }
+        py::handle value = values[i];
+        if (PyUnicode_Check(value.ptr())) {
+            // Strings are taken as they are, without creating a new str object
+            Py_ssize_t length;
+            char const* data = PyUnicode_AsUTF8AndSize(value.ptr(), &length);
+            if (data == nullptr) {
+                throw py::error_already_set();
+            }
+            strings[i].assign(data, length);
+        } else {
+            strings[i] = py::str(value);
+        }
+    }
+    return column;
 }
 
-std::string DataframeReaderBase::GetColumnName(size_t index) const {
-    return column_names_.at(index);
+DataframeReader::DataframeReader(py::handle dataframe, std::string name)
+    : column_names_(GetColumnNames(dataframe)), name_(std::move(name)), end_(py::len(dataframe)) {
+    auto columns = std::make_shared<std::vector<Column>>();
+    columns->reserve(column_names_.size());
+    py::object iloc = dataframe.attr("iloc");
+    py::slice const all_rows(0, static_cast<py::ssize_t>(end_), 1);
+    for (size_t i = 0; i < column_names_.size(); ++i) {
+        // Column names may repeat, so columns are taken by position
+        columns->push_back(ReadColumn(iloc[py::make_tuple(all_rows, i)]));
+    }
+    columns_ = std::move(columns);
 }
 
-size_t DataframeReaderBase::GetNumberOfColumns() const {
-    return column_names_.size();
+std::string_view DataframeReader::FormatValue(Column const& column, size_t row,
+                                              NumberBuffer& buffer) {
+    return std::visit(
+            [&column, row, &buffer](auto const& values) -> std::string_view {
+                using Values = std::decay_t<decltype(values)>;
+                if constexpr (std::is_same_v<Values, std::vector<std::string>>) {
+                    return column.nulls.test(row) ? model::Null::kValue
+                                                  : std::string_view{values[row]};
+                } else if constexpr (std::is_same_v<Values, std::vector<bool>>) {
+                    return values[row] ? "True" : "False";
+                } else if constexpr (std::is_same_v<Values, std::vector<double>>) {
+                    return std::isnan(values[row]) ? model::Null::kValue
+                                                   : FormatFloat(values[row], buffer);
+                } else {
+                    char const* end =
+                            std::to_chars(buffer.data(), buffer.data() + buffer.size(), values[row])
+                                    .ptr;
+                    return {buffer.data(), static_cast<size_t>(end - buffer.data())};
+                }
+            },
+            column.values);
 }
 
-bool DataframeReaderBase::HasNextRow() const {
-    return df_iter_ != py::iterator::sentinel();
+DataframeReader::Row DataframeReader::GetNextRow() {
+    Row row;
+    row.reserve(columns_->size());
+    NumberBuffer buffer;
+    for (Column const& column : *columns_) {
+        row.emplace_back(FormatValue(column, pos_, buffer));
+    }
+    ++pos_;
+    return row;
 }
 
-std::vector<std::string> StringDataframeReader::GetNextRow() {
-    return py::cast<std::vector<std::string>>(*df_iter_++);
+size_t DataframeReader::GetNextBatch(size_t max_rows, model::DatasetBatch& batch) {
+    batch.Clear(columns_->size());
+    // No Python objects are touched from here on. Chunks may also be read by
+    // threads that do not hold the GIL in the first place.
+    std::optional<py::gil_scoped_release> release;
+    if (PyGILState_Check()) {
+        release.emplace();
+    }
+    NumberBuffer buffer;
+    size_t const last = pos_ + std::min(max_rows, end_ - pos_);
+    for (; pos_ < last; ++pos_) {
+        batch_fields_.clear();
+        for (Column const& column : *columns_) {
+            std::string_view const value = FormatValue(column, pos_, buffer);
+            // Strings are views into the column, which outlives the batch
+            batch_fields_.push_back(value.data() == buffer.data() ? batch.Store(value) : value);
+        }
+        batch.AppendRow(batch_fields_);
+    }
+    return batch.GetNumRows();
 }
 
-std::vector<std::string> ArbitraryDataframeReader::GetNextRow() {
-    std::vector<std::string> strings{};
-    auto tuple_row = py::reinterpret_borrow<py::object>(*df_iter_);
-    ++df_iter_;
-    for (py::handle el : tuple_row) {
-        // When reading from .csv files, pandas treats some values as nulls,
-        // and empty values are among those values, which may cause some
-        // confusion here, since in Desbordante only the literal "NULL" string
-        // is interpreted as the null value.
-        strings.emplace_back(is_null_(el) ? model::Null::kValue : py::str(el));
+std::vector<std::unique_ptr<model::IDatasetStream>> DataframeReader::SplitIntoChunks(
+        size_t max_chunks) {
+    assert(max_chunks != 0);
+    std::vector<std::unique_ptr<model::IDatasetStream>> chunks;
+    size_t const chunk_size = (end_ - pos_ + max_chunks - 1) / max_chunks;
+    for (size_t begin = pos_; begin < end_; begin += chunk_size) {
+        // Copies share the columns
+        auto chunk = std::make_unique<DataframeReader>(*this);
+        chunk->begin_ = begin;
+        chunk->pos_ = begin;
+        chunk->end_ = std::min(end_, begin + chunk_size);
+        chunks.push_back(std::move(chunk));
     }
-    return strings;
+    pos_ = end_;
+    return chunks;
+}
+
+void DataframeReader::Reset() {
+    pos_ = begin_;
+}
+
+std::string DataframeReader::GetRelationName() const {
+    return name_;
+}
+
+std::string DataframeReader::GetColumnName(size_t index) const {
+    return column_names_.at(index);
+}
+
+size_t DataframeReader::GetNumberOfColumns() const {
+    return column_names_.size();
+}
+
+bool DataframeReader::HasNextRow() const {
+    return pos_ != end_;
 }
 
 }  // namespace python_bindings
@@ -1,20 +1,64 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 #include <pybind11/pybind11.h>
 
 #include "model/table/idataset_stream.h"
 
 namespace python_bindings {
 
-class DataframeReaderBase : public model::IDatasetStream {
-protected:
-    pybind11::object dataframe_;
-    pybind11::iterator df_iter_;
-    std::string name_;
+// Reads a DataFrame column by column instead of iterating over its rows.
+// Columns with a NumPy integer, unsigned, floating point or boolean dtype are
+// copied out of their buffers at once. Other columns are converted to strings
+// in one pass over the list of their values, with nullity checked for the whole
+// column by `isna`. All of this happens in the constructor, which is the only
+// place where the reader touches Python objects. Rows are formatted later, in
+// GetNextBatch, with the GIL released, and the values look exactly the way
+// `str` shows the Python objects `DataFrame.itertuples` would produce.
+//
+// Pandas treats some values as nulls when reading .csv files, and empty values
+// are among those values, which may cause some confusion here, since in
+// Desbordante only the literal "NULL" string is interpreted as the null value.
+class DataframeReader final : public model::IDatasetStream {
+private:
+    struct Column {
+        std::variant<std::vector<std::int64_t>, std::vector<std::uint64_t>, std::vector<double>,
+                     std::vector<bool>, std::vector<std::string>>
+                values;
+        // Only string columns have nulls here, NaN is the null of a float column
+        boost::dynamic_bitset<> nulls;
+    };
+
+    // Shared by the chunks made by SplitIntoChunks
+    std::shared_ptr<std::vector<Column> const> columns_;
     std::vector<std::string> column_names_;
+    std::string name_;
+    size_t begin_ = 0;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    std::vector<std::string_view> batch_fields_;
+
+    // Large enough for any integer and for repr of any float
+    using NumberBuffer = std::array<char, 32>;
+
+    static Column ReadColumn(pybind11::handle series);
+    // Returns a view into the column, into `buffer` for numbers, or Null::kValue
+    static std::string_view FormatValue(Column const& column, size_t row, NumberBuffer& buffer);
 
 public:
-    explicit DataframeReaderBase(pybind11::handle dataframe, std::string name = "Pandas dataframe");
+    explicit DataframeReader(pybind11::handle dataframe, std::string name = "Pandas dataframe");
+
+    Row GetNextRow() final;
+    size_t GetNextBatch(size_t max_rows, model::DatasetBatch& batch) final;
+    std::vector<std::unique_ptr<model::IDatasetStream>> SplitIntoChunks(size_t max_chunks) final;
 
     void Reset() final;
     [[nodiscard]] std::string GetRelationName() const final;
@@ -23,38 +67,4 @@ public:
     [[nodiscard]] bool HasNextRow() const final;
 };
 
-// If a DataFrame only consists of Python strings, then there is no need to get
-// string representations of every value, and we can get away with the normal
-// pybind11's conversions, which speeds up the reading process.
-class StringDataframeReader final : public DataframeReaderBase {
-public:
-    using DataframeReaderBase::DataframeReaderBase;
-
-    std::vector<std::string> GetNextRow() final;
-};
-
-// If a dataframe consists of arbitrary Python objects, we have to first check
-// for nullity and switch it out for Desbordante's null value if it is null.
-// Pandas uses several Python objects for its null value representation, so the
-// most robust way to check for a DataFrame's value nullity is to use the
-// `pandas.isna` function.
-// If the value is not null, then we have to convert it to std::string, which
-// involves converting it to a Python str first.
-class ArbitraryDataframeReader final : public DataframeReaderBase {
-private:
-    // Used in GetNextRow to check arbitrary dataframe values for nullity.
-    // Statically storing this may cause problems with garbage collection, but
-    // importing a module on every call may cause performance problems, and
-    // storing it as a field is a compromise, which is used here.
-    std::function<bool(pybind11::handle)> is_null_ =
-            [check_null = pybind11::module_::import("pandas").attr("isna")](pybind11::handle obj) {
-                return check_null(obj).cast<bool>();
-            };
-
-public:
-    using DataframeReaderBase::DataframeReaderBase;
-
-    [[nodiscard]] std::vector<std::string> GetNextRow() final;
-};
-
 }  // namespace python_bindings
@@ -15,7 +15,7 @@
 #include "config/exceptions.h"
 #include "config/tabular_data/input_table_type.h"
 #include "config/tabular_data/input_tables_type.h"
-#include "parser/csv_parser/csv_parser.h"
+#include "parser/csv_parser/create_csv_parser.h"
 #include "py_util/create_dataframe_reader.h"
 #include "util/enum_to_available_values.h"
 
@@ -40,10 +40,9 @@ config::InputTable CreateCsvParser(std::string_view option_name, py::tuple const
         throw config::ConfigurationError("Cannot create a CSV parser from passed tuple.");
     }
 
-    return std::make_shared<CSVParser>(
-            CastAndReplaceCastError<std::string>(option_name, arguments[0]),
-            CastAndReplaceCastError<char>(option_name, arguments[1]),
-            CastAndReplaceCastError<bool>(option_name, arguments[2]));
+    return CreateCSVParser({CastAndReplaceCastError<std::string>(option_name, arguments[0]),
+                            CastAndReplaceCastError<char>(option_name, arguments[1]),
+                            CastAndReplaceCastError<bool>(option_name, arguments[2])});
 }
 
 config::InputTable PythonObjToInputTable(std::string_view option_name, py::handle obj) {
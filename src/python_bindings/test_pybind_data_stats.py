@@ -1,5 +1,7 @@
 import unittest
+
 import desbordante as db
+import pandas
 
 DATASET_PATH = "TestDataStats.csv"
 SEPARATOR = ','
@@ -250,5 +252,27 @@ class TestDataStats(unittest.TestCase):
         expected = {"abc", "abd", "abe", "eeee", "ggg", "gre", "grg"}
         self.assertEqual(expected, res)
 
+
+class TestDataFrameInput(unittest.TestCase):
+    def test_numeric_and_string_columns(self) -> None:
+        dataframe = pandas.DataFrame({
+            "int": [3, -1, 2, 2],
+            "float": [0.5, None, 1e20, -2.0],
+            "bool": [True, False, True, True],
+            "str": ["a", None, "bc", "a"],
+        })
+        data_stats = db.statistics.algorithms.DataStats()
+        data_stats.load_data(table=dataframe)
+        data_stats.execute()
+
+        self.assertEqual(-1, data_stats.get_min(0))
+        self.assertEqual(6, data_stats.get_sum(0))
+        self.assertEqual(1, data_stats.get_num_nulls(1))
+        self.assertEqual(1e20, data_stats.get_max(1))
+        self.assertEqual(2, data_stats.get_number_of_distinct(2))
+        self.assertEqual(1, data_stats.get_num_nulls(3))
+        self.assertEqual("abc", data_stats.get_vocab(3))
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -24,6 +24,7 @@ CSVConfig const kWdcKepler = CreateCsvConfig("WDC_kepler.csv", ',', true);
 CSVConfig const kWdcPlanetz = CreateCsvConfig("WDC_planetz.csv", ',', true);
 CSVConfig const kWdcAge = CreateCsvConfig("WDC_age.csv", ',', true);
 CSVConfig const kTestWide = CreateCsvConfig("TestWide.csv", ',', true);
+CSVConfig const kTestWide70 = CreateCsvConfig("TestWide70.csv", ',', true);
 CSVConfig const kAbalone = CreateCsvConfig("abalone.csv", ',', false);
 CSVConfig const kIris = CreateCsvConfig("iris.csv", ',', false);
 CSVConfig const kAdult = CreateCsvConfig("adult.csv", ';', false);
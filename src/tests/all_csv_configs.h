@@ -14,6 +14,7 @@ extern CSVConfig const kWdcKepler;
 extern CSVConfig const kWdcPlanetz;
 extern CSVConfig const kWdcAge;
 extern CSVConfig const kTestWide;
+extern CSVConfig const kTestWide70;
 extern CSVConfig const kAbalone;
 extern CSVConfig const kIris;
 extern CSVConfig const kAdult;
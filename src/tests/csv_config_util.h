@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "config/tabular_data/input_table_type.h"
+#include "parser/csv_parser/create_csv_parser.h"
 #include "parser/csv_parser/csv_parser.h"
 
 namespace tests {
@@ -28,7 +29,7 @@ struct CSVConfigsHash {
 
 /// create input table from csv config
 inline config::InputTable MakeInputTable(CSVConfig const& csv_config) {
-    return std::make_shared<CSVParser>(csv_config);
+    return CreateCSVParser(csv_config);
 }
 
 }  // namespace tests
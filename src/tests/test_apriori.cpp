@@ -318,4 +318,26 @@ TEST_F(ARAlgorithmTest, RepeatedExecutionConsistentResult) {
     }
 }
 
+/* A cancelled execution keeps only true rules and tells it is incomplete, the request is consumed
+ * by the execution it stopped */
+TEST_F(ARAlgorithmTest, StopsOnCancel) {
+    auto algorithm = CreateAlgorithmInstance(kRulesKaggleRows, 0.1, 0.5, true);
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    auto const full_result = ToSet(algorithm->GetArStringsList());
+
+    algos::ConfigureFromMap(*algorithm, GetParamMap(kRulesKaggleRows, 0.1, 0.5, true));
+    algorithm->Cancel();
+    algorithm->Execute();
+    ASSERT_FALSE(algorithm->IsComplete());
+    for (auto const& rule : ToSet(algorithm->GetArStringsList())) {
+        ASSERT_TRUE(full_result.contains(rule));
+    }
+
+    algos::ConfigureFromMap(*algorithm, GetParamMap(kRulesKaggleRows, 0.1, 0.5, true));
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    CheckAssociationRulesListsEquality(algorithm->GetArStringsList(), full_result);
+}
+
 }  // namespace tests
@@ -26,20 +26,33 @@ static void CheckCfdSetsEquality(std::set<std::string> const& actual,
 
 class CFDAlgorithmTest : public ::testing::Test {
 protected:
-    static std::unique_ptr<algos::cfd::FDFirstAlgorithm> CreateAlgorithmInstance(
-            CSVConfig const& csv_config, unsigned minsup, double minconf, char const* substrategy,
-            unsigned int max_lhs, unsigned columns_number = 0, unsigned tuples_number = 0) {
+    static algos::StdParamsMap GetParamMap(CSVConfig const& csv_config, unsigned minsup,
+                                           double minconf, char const* substrategy,
+                                           unsigned int max_lhs, unsigned columns_number = 0,
+                                           unsigned tuples_number = 0) {
         using namespace config::names;
 
-        algos::StdParamsMap params{
-                {kCsvConfig, csv_config},
+        return {{kCsvConfig, csv_config},
                 {kCfdMinimumSupport, minsup},
                 {kCfdMinimumConfidence, minconf},
                 {kCfdMaximumLhs, max_lhs},
                 {kCfdSubstrategy, algos::cfd::Substrategy::_from_string(substrategy)},
                 {kCfdTuplesNumber, tuples_number},
                 {kCfdColumnsNumber, columns_number}};
-        return algos::CreateAndLoadAlgorithm<algos::cfd::FDFirstAlgorithm>(params);
+    }
+
+    template <typename... Args>
+    static std::unique_ptr<algos::cfd::FDFirstAlgorithm> CreateAlgorithmInstance(Args&&... args) {
+        return algos::CreateAndLoadAlgorithm<algos::cfd::FDFirstAlgorithm>(
+                GetParamMap(std::forward<Args>(args)...));
+    }
+
+    static std::set<std::string> GetCfdStrings(algos::cfd::FDFirstAlgorithm const& algorithm) {
+        std::set<std::string> cfds;
+        for (auto const& cfd : algorithm.GetItemsetCfds()) {
+            cfds.insert(algorithm.GetCfdString(cfd));
+        }
+        return cfds;
     }
 };
 
@@ -118,4 +131,26 @@ TEST_F(CFDAlgorithmTest, PartialMushroomDataset) {
 
     CheckCfdSetsEquality(actual_cfds, expected_cfds);
 }
+/* A cancelled execution keeps only true CFDs and tells it is incomplete, the request is consumed by
+ * the execution it stopped */
+TEST_F(CFDAlgorithmTest, StopsOnCancel) {
+    auto algorithm = CreateAlgorithmInstance(kTennis, 8, 0.85, "dfs", 3);
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    std::set<std::string> const full_cfds = GetCfdStrings(*algorithm);
+
+    algos::ConfigureFromMap(*algorithm, GetParamMap(kTennis, 8, 0.85, "dfs", 3));
+    algorithm->Cancel();
+    algorithm->Execute();
+    ASSERT_FALSE(algorithm->IsComplete());
+    for (std::string const& cfd : GetCfdStrings(*algorithm)) {
+        ASSERT_TRUE(full_cfds.contains(cfd));
+    }
+
+    algos::ConfigureFromMap(*algorithm, GetParamMap(kTennis, 8, 0.85, "dfs", 3));
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    CheckCfdSetsEquality(GetCfdStrings(*algorithm), full_cfds);
+}
+
 }  // namespace tests
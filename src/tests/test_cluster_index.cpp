@@ -0,0 +1,62 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/table/cluster_index.h"
+#include "model/table/compressed_cluster_index.h"
+
+namespace tests {
+
+using std::vector;
+
+TEST(ClusterIndexTest, Layout) {
+    vector<vector<int>> const clusters = {{6, 7, 18}, {0, 2, 8, 11}, {4, 14}, {1, 5, 9}};
+    model::ClusterIndex index = model::ClusterIndex::FromClusters(clusters);
+    ASSERT_EQ(index.size(), clusters.size());
+    ASSERT_EQ(index.GetNumPositions(), 12u);
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        ASSERT_EQ(vector<int>(index[i]), clusters[i]);
+    }
+
+    index.SortClusters();
+    vector<vector<int>> const sorted = {{0, 2, 8, 11}, {1, 5, 9}, {4, 14}, {6, 7, 18}};
+    ASSERT_EQ(vector<vector<int>>(index.begin(), index.end()), sorted);
+    ASSERT_EQ(index.GetPositions().front(), 0);
+    ASSERT_EQ(index, model::ClusterIndex::FromClusters(sorted));
+
+    model::ClusterIndex built;
+    for (vector<int> const& cluster : sorted) {
+        for (int position : cluster) {
+            built.AppendPosition(position);
+        }
+        built.CloseCluster();
+    }
+    ASSERT_EQ(built, index);
+}
+
+TEST(CompressedClusterIndexTest, RoundTripsEveryEncoding) {
+    using Encoding = model::CompressedClusterIndex::Encoding;
+    vector<vector<int>> const clusters = {
+            {5, 6, 7, 8}, {10, 12, 15, 16, 17, 19, 20}, {40000, 3, 65000}, {2, 4, 90000}};
+    auto encoding = [](vector<int> const& cluster, bool fits_uint16) {
+        return model::CompressedClusterIndex::ChooseEncoding(cluster, fits_uint16);
+    };
+    ASSERT_EQ(encoding(clusters[0], true), Encoding::kRun);
+    ASSERT_EQ(encoding(clusters[1], true), Encoding::kDelta);
+    ASSERT_EQ(encoding(clusters[2], true), Encoding::kUInt16);
+    ASSERT_EQ(encoding(clusters[2], false), Encoding::kUInt32);
+    ASSERT_EQ(encoding(clusters[3], false), Encoding::kDelta);
+
+    for (unsigned relation_size : {65536u, 100000u}) {
+        vector<vector<int>> const relation_clusters(clusters.begin(),
+                                                    clusters.end() - (relation_size <= 65536));
+        auto index = model::ClusterIndex::FromClusters(relation_clusters);
+        model::CompressedClusterIndex compressed(index, relation_size);
+        ASSERT_EQ(compressed.size(), index.size());
+        ASSERT_EQ(compressed.GetNumPositions(), index.GetNumPositions());
+        ASSERT_LT(compressed.GetBytes(), index.GetBytes());
+        ASSERT_EQ(compressed.Decode(), index);
+    }
+}
+
+}  // namespace tests
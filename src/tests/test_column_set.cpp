@@ -0,0 +1,80 @@
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include "model/table/column_set.h"
+
+namespace tests {
+
+namespace {
+
+template <size_t kWords>
+void CheckColumnSetMatchesBitset(size_t num_columns) {
+    using ColumnSet = model::ColumnSet<kWords>;
+    std::mt19937 gen(num_columns);
+    std::bernoulli_distribution bit;
+    auto random_bitset = [&]() {
+        boost::dynamic_bitset<> bitset(num_columns);
+        for (size_t i = 0; i < num_columns; ++i) bitset[i] = bit(gen);
+        return bitset;
+    };
+    auto indices = [](auto const& set) {
+        std::vector<size_t> indices;
+        for (size_t i = set.find_first(); i != set.npos; i = set.find_next(i)) {
+            indices.push_back(i);
+        }
+        return indices;
+    };
+
+    for (int i = 0; i < 100; ++i) {
+        boost::dynamic_bitset<> const lhs = random_bitset();
+        boost::dynamic_bitset<> const rhs = random_bitset();
+        ColumnSet const lhs_set(lhs);
+        ColumnSet const rhs_set(rhs);
+
+        ASSERT_EQ(lhs_set.ToBitset(), lhs);
+        ASSERT_EQ(indices(lhs_set), indices(lhs));
+        ASSERT_EQ(lhs_set.find_next(ColumnSet::npos), lhs.find_next(lhs.npos));
+        ASSERT_EQ(lhs_set.count(), lhs.count());
+        ASSERT_EQ(lhs_set.intersects(rhs_set), lhs.intersects(rhs));
+        ASSERT_EQ((lhs_set & rhs_set).is_subset_of(lhs_set), true);
+        ASSERT_EQ((lhs_set | rhs_set).ToBitset(), lhs | rhs);
+        ASSERT_EQ((lhs_set ^ rhs_set).ToBitset(), lhs ^ rhs);
+        ASSERT_EQ((lhs_set - rhs_set).ToBitset(), lhs - rhs);
+        ASSERT_EQ((~lhs_set).ToBitset(), ~lhs);
+        ASSERT_EQ(lhs_set < rhs_set, lhs < rhs);
+        ASSERT_EQ(lhs_set == rhs_set, lhs == rhs);
+    }
+}
+
+}  // namespace
+
+TEST(ColumnSetTest, MatchesDynamicBitset) {
+    CheckColumnSetMatchesBitset<1>(13);
+    CheckColumnSetMatchesBitset<1>(64);
+    CheckColumnSetMatchesBitset<2>(100);
+    CheckColumnSetMatchesBitset<4>(200);
+}
+
+TEST(ColumnSetTest, DispatchesByWidth) {
+    auto words = [](size_t num_columns) {
+        return model::DispatchColumnSet(num_columns, [](auto column_set_type) -> size_t {
+            using ColumnSetType = typename decltype(column_set_type)::type;
+            if constexpr (std::is_same_v<ColumnSetType, boost::dynamic_bitset<>>) {
+                return 0;
+            } else {
+                return ColumnSetType::kMaxColumns / ColumnSetType::kWordBits;
+            }
+        });
+    };
+    ASSERT_EQ(words(1), 1u);
+    ASSERT_EQ(words(64), 1u);
+    ASSERT_EQ(words(65), 2u);
+    ASSERT_EQ(words(256), 4u);
+    ASSERT_EQ(words(257), 0u);
+}
+
+}  // namespace tests
@@ -1,14 +1,24 @@
 #include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "all_csv_configs.h"
 #include "csv_config_util.h"
+#include "model/table/dataset_batch.h"
+#include "parser/csv_parser/compressed_csv_parser.h"
 #include "parser/csv_parser/csv_parser.h"
+#include "parser/csv_parser/mmap_csv_parser.h"
 
 namespace tests {
 
@@ -18,6 +28,50 @@ using ::testing::ContainerEq;
 
 class TestCSVParser : public ::testing::Test {};
 
+CSVConfig WithMmap(CSVConfig table) {
+    table.reader_type = CSVReaderType::kMmap;
+    return table;
+}
+
+/* Writes a compressed copy of the table into a new directory in the temporary one, so that tests
+ * running at once don't overwrite each other's copies. Remove it with RemoveCompressed */
+CSVConfig Compress(CSVConfig table, CompressedCSVParser::Compression compression) {
+    namespace io = boost::iostreams;
+    bool const gzip = compression == CompressedCSVParser::Compression::kGzip;
+    std::random_device random;
+    std::filesystem::path directory;
+    do {
+        directory = std::filesystem::temp_directory_path() /
+                    ("desbordante_test_" + std::to_string(random()) + std::to_string(random()));
+    } while (!std::filesystem::create_directory(directory));
+    std::filesystem::path compressed_path =
+            directory / (table.path.filename().string() + (gzip ? ".gz" : ".zst"));
+    std::ifstream input(table.path, std::ios_base::binary);
+    std::ofstream output(compressed_path, std::ios_base::binary | std::ios_base::trunc);
+    io::filtering_ostream compressor;
+    if (gzip) {
+        compressor.push(io::gzip_compressor());
+    } else {
+        compressor.push(io::zstd_compressor());
+    }
+    compressor.push(output);
+    io::copy(input, compressor);
+    table.path = std::move(compressed_path);
+    return table;
+}
+
+void RemoveCompressed(CSVConfig const& compressed_table) {
+    std::filesystem::remove_all(compressed_table.path.parent_path());
+}
+
+std::vector<std::vector<std::string>> ReadAllRows(model::IDatasetStream& stream) {
+    std::vector<std::vector<std::string>> rows;
+    while (stream.HasNextRow()) {
+        rows.push_back(stream.GetNextRow());
+    }
+    return rows;
+}
+
 }  // namespace
 
 static void CheckGetNextRow(CSVConfig const& table,
@@ -48,6 +102,89 @@ TEST(TestCSVParser, TestGetNextRow) {
                                  {"a", "a,a", "a"}});
 }
 
+TEST(TestCSVParser, TestMmapGetNextRow) {
+    CheckGetNextRow(WithMmap(kNullEmpty),
+                    {{"1", "NULL", "3", "1"}, {"1", "2", "", "1"}, {"1", "2", "3", "1"}});
+    CheckGetNextRow(WithMmap(kTestSingleColumn), {{"1"}, {"2"}, {"3"}, {"3"}});
+    CheckGetNextRow(WithMmap(kTestWide), {{"1", "3", "3", "4", "5"}, {"2", "3", "4", "4", "6"}});
+    CheckGetNextRow(WithMmap(kTestEmpty), {});
+    CheckGetNextRow(WithMmap(kTestParse), {{"", "\\\\\\\"", "b\"b\\\\ b"},
+                                           {"\"", "\\\\", "b\\"},
+                                           {"a,bc", "a,\"bc", "a\",bc"},
+                                           {"bb", "\\\\", "\\\\"},
+                                           {"a", "a,a", "a"}});
+}
+
+static void CheckMmapMatchesStream(CSVConfig const& table) {
+    CSVParser stream_parser(table);
+    MmapCSVParser mmap_parser(table);
+
+    ASSERT_EQ(stream_parser.GetNumberOfColumns(), mmap_parser.GetNumberOfColumns())
+            << "Fail on " << table.path;
+    for (std::size_t index = 0; index < stream_parser.GetNumberOfColumns(); ++index) {
+        ASSERT_EQ(stream_parser.GetColumnName(index), mmap_parser.GetColumnName(index))
+                << "Fail on " << table.path;
+    }
+
+    std::size_t row_index = 0;
+    while (stream_parser.HasNextRow()) {
+        ASSERT_TRUE(mmap_parser.HasNextRow()) << "Fail on " << table.path << ", row " << row_index;
+        ASSERT_THAT(mmap_parser.GetNextRow(), ContainerEq(stream_parser.GetNextRow()))
+                << "Fail on " << table.path << ", row " << row_index;
+        ++row_index;
+    }
+    ASSERT_FALSE(mmap_parser.HasNextRow()) << "Fail on " << table.path;
+}
+
+TEST(TestCSVParser, TestMmapMatchesStream) {
+    for (CSVConfig const& table :
+         {kNullEmpty, kTestSingleColumn, kTestWide, kTestEmpty, kTestParse, kTestLong, kTestFD,
+          kTestDataStats, kACShippingDates, kSimpleTypes, kSimpleTypos, kTest1, kIndTestNulls,
+          kWdcAstronomical, kWdcSatellites, kCIPublicHighway700, kAbalone, kAdult}) {
+        CheckMmapMatchesStream(table);
+    }
+}
+
+static void CheckCompressedMatchesStream(CSVConfig const& table,
+                                         CompressedCSVParser::Compression compression) {
+    CSVConfig const compressed_table = Compress(table, compression);
+    CSVParser stream_parser(table);
+    config::InputTable compressed_parser = MakeInputTable(compressed_table);
+    ASSERT_NE(dynamic_cast<CompressedCSVParser*>(compressed_parser.get()), nullptr);
+
+    ASSERT_EQ(compressed_parser->GetRelationName(), stream_parser.GetRelationName());
+    ASSERT_EQ(compressed_parser->GetNumberOfColumns(), stream_parser.GetNumberOfColumns())
+            << "Fail on " << table.path;
+    for (std::size_t index = 0; index < stream_parser.GetNumberOfColumns(); ++index) {
+        ASSERT_EQ(compressed_parser->GetColumnName(index), stream_parser.GetColumnName(index))
+                << "Fail on " << table.path;
+    }
+
+    std::vector<std::vector<std::string>> const expected = ReadAllRows(stream_parser);
+    ASSERT_THAT(ReadAllRows(*compressed_parser), ContainerEq(expected)) << "Fail on " << table.path;
+    compressed_parser->Reset();
+    ASSERT_THAT(ReadAllRows(*compressed_parser), ContainerEq(expected)) << "Fail on " << table.path;
+
+    /* Decompression is sequential, so the stream is not split and is still read as a whole */
+    compressed_parser->Reset();
+    ASSERT_TRUE(compressed_parser->SplitIntoChunks(3).empty());
+    ASSERT_THAT(ReadAllRows(*compressed_parser), ContainerEq(expected)) << "Fail on " << table.path;
+
+    RemoveCompressed(compressed_table);
+}
+
+TEST(TestCSVParser, TestCompressedMatchesStream) {
+    for (CSVConfig const& table : {kNullEmpty, kTestSingleColumn, kTestWide, kTestEmpty, kTestParse,
+                                   kTestLong, kACShippingDates, kSimpleTypes, kTest1,
+                                   kCIPublicHighway700}) {
+        CheckCompressedMatchesStream(table, CompressedCSVParser::Compression::kGzip);
+        CheckCompressedMatchesStream(table, CompressedCSVParser::Compression::kZstd);
+        CSVConfig headerless = table;
+        headerless.has_header = false;
+        CheckCompressedMatchesStream(headerless, CompressedCSVParser::Compression::kZstd);
+    }
+}
+
 static void CheckHasNextRow(CSVConfig const& table, std::size_t num_rows) {
     config::InputTable parser = MakeInputTable(table);
     if (table.has_header) num_rows--;
@@ -96,6 +233,93 @@ TEST(TestCSVParser, TestReset) {
     CheckReset(kAdult, 32561);
     CheckReset(kTestEmpty, 1);
     CheckReset(kTest1, 20);
+    CheckReset(WithMmap(kACShippingDates), 6);
+    CheckReset(WithMmap(kAdult), 32561);
+    CheckReset(WithMmap(kTestEmpty), 1);
+    CheckReset(WithMmap(kTest1), 20);
+}
+
+static void CheckGetNextBatch(CSVConfig const& table, std::size_t batch_size) {
+    config::InputTable row_parser = MakeInputTable(table);
+    config::InputTable batch_parser = MakeInputTable(table);
+
+    std::vector<std::vector<std::string>> expected;
+    while (row_parser->HasNextRow()) {
+        std::vector<std::string> row = row_parser->GetNextRow();
+        if (row.size() == row_parser->GetNumberOfColumns()) {
+            expected.push_back(std::move(row));
+        }
+    }
+
+    std::vector<std::vector<std::string>> actual;
+    model::DatasetBatch batch;
+    while (batch_parser->GetNextBatch(batch_size, batch) != 0) {
+        ASSERT_LE(batch.GetNumRows(), batch_size) << "Fail on " << table.path;
+        ASSERT_EQ(batch.GetNumColumns(), batch_parser->GetNumberOfColumns())
+                << "Fail on " << table.path;
+        for (std::size_t row_index = 0; row_index < batch.GetNumRows(); ++row_index) {
+            std::vector<std::string>& row = actual.emplace_back();
+            for (std::size_t column_index = 0; column_index < batch.GetNumColumns();
+                 ++column_index) {
+                row.emplace_back(batch.GetValue(row_index, column_index));
+            }
+        }
+    }
+
+    ASSERT_THAT(actual, ContainerEq(expected)) << "Fail on " << table.path;
+}
+
+TEST(TestCSVParser, TestGetNextBatch) {
+    for (CSVConfig const& table : {kNullEmpty, kTestSingleColumn, kTestEmpty, kTestParse, kTestLong,
+                                   kACShippingDates, kSimpleTypes, kTest1, kCIPublicHighway700}) {
+        CSVConfig const compressed = Compress(table, CompressedCSVParser::Compression::kGzip);
+        for (std::size_t batch_size : {1, 3, 4096}) {
+            CheckGetNextBatch(table, batch_size);
+            CheckGetNextBatch(WithMmap(table), batch_size);
+            CheckGetNextBatch(compressed, batch_size);
+        }
+        RemoveCompressed(compressed);
+    }
+}
+
+static void CheckRandomAccess(CSVConfig const& table) {
+    CSVParser parser(table);
+    std::vector<std::vector<std::string>> rows;
+    while (parser.HasNextRow()) {
+        rows.push_back(parser.GetNextRow());
+    }
+
+    // Include indices past the last row
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> distribution(0, rows.size() + 1);
+    std::vector<std::size_t> indices;
+    for (int i = 0; i < 200; ++i) {
+        indices.push_back(distribution(gen));
+    }
+
+    std::vector<std::vector<std::string>> expected;
+    for (std::size_t index : indices) {
+        if (index >= rows.size()) {
+            ASSERT_TRUE(parser.ParseLine(index).empty()) << "Fail on " << table.path;
+            expected.emplace_back();
+            continue;
+        }
+        ASSERT_THAT(parser.ParseLine(index), ContainerEq(rows[index])) << "Fail on " << table.path;
+        if (index + 1 < rows.size()) {
+            ASSERT_THAT(parser.GetNextRow(), ContainerEq(rows[index + 1]))
+                    << "Fail on " << table.path;
+        }
+        expected.push_back(rows[index]);
+    }
+
+    ASSERT_THAT(parser.ParseLines(indices), ContainerEq(expected)) << "Fail on " << table.path;
+}
+
+TEST(TestCSVParser, TestRandomAccess) {
+    CheckRandomAccess(kTest1);
+    CheckRandomAccess(kACShippingDates);
+    CheckRandomAccess(kCIPublicHighway700);
+    CheckRandomAccess(kAdult);
 }
 
 }  // namespace tests
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <memory>
+#include <set>
 
 #include <gtest/gtest.h>
 
@@ -11,6 +12,7 @@
 #include "csv_config_util.h"
 #include "fd/fd_verifier/dynamic_fd_verifier.h"
 #include "fd/fd_verifier/dynamic_stats_calculator.h"
+#include "model/table/dynamic_table_data.h"
 #include "model/types/builtin.h"
 
 namespace {
@@ -170,4 +172,59 @@ INSTANTIATE_TEST_SUITE_P(
 
 // clang-format on
 
+TEST(DynamicFDVerifierTest, KeepsStatisticsAcrossExecutions) {
+    auto verifier = algos::CreateAndLoadAlgorithm<DynamicFDVerifier>(
+            DynFDVerifyingParams({1}, {2, 3}).params);
+    verifier->SetOption(onam::kDeleteStatements, std::unordered_set<size_t>{1, 6, 3});
+    verifier->Execute();
+    algos::ConfigureFromMap(*verifier,
+                            {{onam::kInsertStatements, MakeInputTable(kTestDynamicFDInsert)}});
+    verifier->Execute();
+    /* The same as deleting and inserting in one batch */
+    EXPECT_FALSE(verifier->FDHolds());
+    EXPECT_DOUBLE_EQ(verifier->GetError(), 7.L / 66);
+    EXPECT_EQ(verifier->GetNumErrorRows(), 12u);
+    EXPECT_EQ(verifier->GetNumErrorClusters(), 5u);
+}
+
+TEST(DynamicTableDataTest, CompactionKeepsRowIds) {
+    model::DynamicTableData table(*MakeInputTable(kTestDynamicFDInit));
+    table.Update(nullptr, nullptr, {1, 2, 3, 5, 6, 7, 8});
+    ASSERT_TRUE(table.NeedsCompaction());
+    std::vector<int> const new_rows = table.Compact();
+    EXPECT_FALSE(table.NeedsCompaction());
+    EXPECT_EQ(new_rows, (std::vector<int>{0, -1, -1, -1, 1, -1, -1, -1, -1, 2, 3, 4}));
+    EXPECT_EQ(table.GetNumRowsTotal(), 5u);
+    EXPECT_FALSE(table.IsRowIndexValid(1));
+    EXPECT_EQ(table.FindRow(9), 2u);
+    EXPECT_EQ(table.GetValue(*table.FindRow(11), 2), "abc");
+    EXPECT_EQ(table.GetValueCode(*table.FindRow(9), 3), table.GetValueCode(*table.FindRow(4), 3));
+
+    std::vector<size_t> const inserted_rows =
+            table.Update(MakeInputTable(kTestDynamicFDInsert), nullptr, {});
+    EXPECT_EQ(inserted_rows, (std::vector<size_t>{5, 6, 7}));
+    EXPECT_EQ(table.GetRowId(5), 12u);
+    EXPECT_EQ(table.GetValue(7, 2), "666");
+}
+
+TEST(DynamicFDVerifierTest, KeepsRowIdsAfterCompaction) {
+    auto verifier = algos::CreateAndLoadAlgorithm<DynamicFDVerifier>(
+            DynFDVerifyingParams({1}, {5}).params);
+    /* Most of the rows are deleted, so the table is compacted */
+    verifier->SetOption(onam::kDeleteStatements,
+                        std::unordered_set<size_t>{1, 2, 3, 5, 6, 7, 8});
+    verifier->Execute();
+    algos::ConfigureFromMap(*verifier,
+                            {{onam::kInsertStatements, MakeInputTable(kTestDynamicFDInsert)},
+                             {onam::kUpdateStatements, MakeInputTable(kTestDynamicFDUpdate)}});
+    verifier->Execute();
+    EXPECT_DOUBLE_EQ(verifier->GetError(), 1.L / 7);
+    EXPECT_EQ(verifier->GetNumErrorRows(), 6u);
+    std::set<std::set<int>> clusters;
+    for (Highlight const& highlight : verifier->GetHighlights()) {
+        clusters.emplace(highlight.GetCluster().begin(), highlight.GetCluster().end());
+    }
+    EXPECT_EQ(clusters, (std::set<std::set<int>>{{9, 10, 11}, {12, 13, 14}}));
+}
+
 }  // namespace tests
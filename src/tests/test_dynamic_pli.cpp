@@ -0,0 +1,75 @@
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/table/dynamic_position_list_index.h"
+
+namespace tests {
+
+TEST(DynamicPLITest, UpdatesMatchRebuild) {
+    using model::DynPLI;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> random_value(0, 9);
+    std::bernoulli_distribution random_change(0.1);
+
+    /* Values of the rows by their ids, nullopt for the deleted ones */
+    std::vector<std::optional<int>> values;
+    std::vector<DynPLI::ClusterValue> records;
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back(random_value(gen));
+        records.push_back({*values.back()});
+    }
+    auto pli = DynPLI::CreateFor(records);
+
+    for (int batch = 0; batch < 50; ++batch) {
+        std::vector<std::pair<size_t, DynPLI::ClusterValue>> inserted;
+        std::unordered_set<size_t> deleted;
+        for (size_t row = 0; row < values.size(); ++row) {
+            if (!values[row].has_value() || !random_change(gen)) continue;
+            deleted.insert(row);
+            if (random_change(gen)) {
+                values[row].reset();
+            } else {
+                values[row] = random_value(gen);
+                inserted.emplace_back(row, DynPLI::ClusterValue{*values[row]});
+            }
+        }
+        for (int i = 0; i < 5; ++i) {
+            values.emplace_back(random_value(gen));
+            inserted.emplace_back(values.size() - 1, DynPLI::ClusterValue{*values.back()});
+        }
+        pli->UpdateWith(inserted, deleted);
+
+        std::map<int, std::set<int>> expected;
+        size_t num_rows = 0;
+        for (size_t row = 0; row < values.size(); ++row) {
+            if (!values[row].has_value()) {
+                ASSERT_EQ(pli->GetClusterId(row), DynPLI::kNoCluster);
+                continue;
+            }
+            expected[*values[row]].insert(row);
+            ++num_rows;
+        }
+        std::map<int, std::set<int>> actual;
+        for (DynPLI::ClusterId id = 0; id < static_cast<int>(pli->GetClusters().size()); ++id) {
+            DynPLI::Cluster const& cluster = pli->GetCluster(id);
+            if (cluster.empty()) continue;
+            for (int row : cluster) {
+                ASSERT_EQ(pli->GetClusterId(row), id);
+            }
+            actual[pli->GetClusterValue(id).front()].insert(cluster.begin(), cluster.end());
+        }
+        ASSERT_EQ(actual, expected);
+        ASSERT_EQ(pli->GetNumCluster(), expected.size());
+        ASSERT_EQ(pli->GetSize(), num_rows);
+        ASSERT_EQ(pli->GetRelationSize(), values.size());
+    }
+}
+
+}  // namespace tests
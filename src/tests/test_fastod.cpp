@@ -1,11 +1,15 @@
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "algorithms/algo_factory.h"
+#include "algorithms/fd/tane/tane.h"
 #include "algorithms/od/fastod/fastod.h"
 #include "algorithms/od/fastod/hashing/hashing.h"
+#include "algorithms/od/fastod/storage/data_frame.h"
+#include "algorithms/od/fastod/storage/partition_cache.h"
 #include "all_csv_configs.h"
 #include "config/names.h"
 #include "csv_config_util.h"
@@ -47,6 +51,103 @@ class FastodResultHashTest : public ::testing::TestWithParam<CSVConfigHash> {};
 
 }  // namespace
 
+TEST(FastodAttributeSetTest, WorksBeyondWord) {
+    using algos::fastod::AttributeSet, algos::fastod::CreateAttributeSet;
+    model::ColumnIndex constexpr kAttributeCount = 130;
+    std::vector<model::ColumnIndex> const attributes{0, 5, 63, 64, 100, 129};
+
+    AttributeSet set(kAttributeCount);
+    for (model::ColumnIndex attribute : attributes) {
+        set.Set(attribute);
+    }
+    std::vector<model::ColumnIndex> iterated;
+    set.Iterate([&iterated](model::ColumnIndex attribute) { iterated.push_back(attribute); });
+    EXPECT_EQ(iterated, attributes);
+    EXPECT_EQ(set.Count(), attributes.size());
+    EXPECT_EQ(set.ToString(), "{1,6,64,65,101,130}");
+
+    AttributeSet const narrow = algos::fastod::Difference(
+            set, CreateAttributeSet({64, 100, 129}, kAttributeCount));
+    EXPECT_EQ(narrow, CreateAttributeSet({0, 5, 63}, kAttributeCount));
+    EXPECT_LT(narrow, set);
+    EXPECT_FALSE(narrow.Test(100));
+    /* Sets within the first word hash as they did when the whole set was one word */
+    EXPECT_EQ(std::hash<AttributeSet>{}(narrow), (1ULL << 0) | (1ULL << 5) | (1ULL << 63));
+}
+
+/* Before the attribute sets had more than one word this table made Fastod throw. Constancy ODs
+ * are exactly the FDs, so they are checked against TANE, and every order OD has to hold */
+TEST(FastodTest, WorksOnDatasetWiderThanWord) {
+    using namespace config::names;
+    using algos::fastod::AttributeSet, algos::fastod::SimpleCanonicalOD;
+    algos::StdParamsMap const params{{kCsvConfig, kTestWide70}};
+    std::unique_ptr<algos::Fastod> fastod = algos::CreateAndLoadAlgorithm<algos::Fastod>(params);
+    fastod->Execute();
+    auto tane = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+    tane->Execute();
+
+    auto data = std::make_shared<algos::fastod::DataFrame>(algos::fastod::DataFrame::FromCsv(
+            kTestWide70.path, kTestWide70.separator, kTestWide70.has_header));
+    model::ColumnIndex const column_count = data->GetColumnCount();
+    ASSERT_GT(column_count, 64u);
+    std::vector<SimpleCanonicalOD> expected_simple;
+    for (FD const& fd : tane->FdList()) {
+        AttributeSet context(column_count);
+        for (model::ColumnIndex index : fd.GetLhsIndices()) {
+            context.Set(index);
+        }
+        expected_simple.emplace_back(context, fd.GetRhsIndex());
+    }
+    std::vector<SimpleCanonicalOD> simple = fastod->GetSimpleDependencies();
+    std::sort(simple.begin(), simple.end());
+    std::sort(expected_simple.begin(), expected_simple.end());
+    ASSERT_TRUE(simple == expected_simple);
+
+    algos::fastod::PartitionCache cache;
+    ASSERT_FALSE(fastod->GetAscendingDependencies().empty());
+    for (auto const& od : fastod->GetAscendingDependencies()) {
+        EXPECT_TRUE(od.IsValid(data, cache)) << od.ToString();
+    }
+    for (auto const& od : fastod->GetDescendingDependencies()) {
+        EXPECT_TRUE(od.IsValid(data, cache)) << od.ToString();
+    }
+}
+
+/* A cancelled execution keeps only valid ODs and tells it is incomplete, the request is consumed by
+ * the execution it stopped */
+TEST(FastodCancellationTest, StopsOnCancel) {
+    using namespace config::names;
+    algos::StdParamsMap const params{{kCsvConfig, kWdcAstrology}};
+    std::unique_ptr<algos::Fastod> fastod = algos::CreateAndLoadAlgorithm<algos::Fastod>(params);
+    fastod->Execute();
+    ASSERT_TRUE(fastod->IsComplete());
+    auto const sorted = [](auto ods) {
+        std::sort(ods.begin(), ods.end());
+        return ods;
+    };
+    auto const full_asc = sorted(fastod->GetAscendingDependencies());
+    auto const full_desc = sorted(fastod->GetDescendingDependencies());
+    auto const full_simple = sorted(fastod->GetSimpleDependencies());
+
+    algos::ConfigureFromMap(*fastod, params);
+    fastod->Cancel();
+    fastod->Execute();
+    ASSERT_FALSE(fastod->IsComplete());
+    auto const is_subset = [](auto const& ods, auto const& full) {
+        return std::includes(full.begin(), full.end(), ods.begin(), ods.end());
+    };
+    ASSERT_TRUE(is_subset(sorted(fastod->GetAscendingDependencies()), full_asc));
+    ASSERT_TRUE(is_subset(sorted(fastod->GetDescendingDependencies()), full_desc));
+    ASSERT_TRUE(is_subset(sorted(fastod->GetSimpleDependencies()), full_simple));
+
+    algos::ConfigureFromMap(*fastod, params);
+    fastod->Execute();
+    ASSERT_TRUE(fastod->IsComplete());
+    ASSERT_TRUE(sorted(fastod->GetAscendingDependencies()) == full_asc);
+    ASSERT_TRUE(sorted(fastod->GetDescendingDependencies()) == full_desc);
+    ASSERT_TRUE(sorted(fastod->GetSimpleDependencies()) == full_simple);
+}
+
 TEST_P(FastodResultHashTest, CorrectnessTest) {
     CSVConfigHash csv_config_hash = GetParam();
     size_t actual_hash = RunFastod(csv_config_hash.config);
@@ -1,4 +1,8 @@
 #include <algorithm>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -102,6 +106,18 @@ TYPED_TEST_P(AlgorithmTest, WorksOnWideDataset) {
     ASSERT_TRUE(CheckFdListEquality(true_fd_collection, algorithm->FdList()));
 }
 
+/* More columns than fit into a machine word, with FDs between the columns on both sides of the
+ * boundary */
+TYPED_TEST_P(AlgorithmTest, WorksOnDatasetWiderThanWord) {
+    auto reference = algos::CreateAndLoadAlgorithm<algos::Tane>(
+            TestFixture::GetParamMap(kTestWide70));
+    reference->Execute();
+
+    auto algorithm = TestFixture::CreateAlgorithmInstance(kTestWide70);
+    algorithm->Execute();
+    ASSERT_TRUE(CheckFdListEquality(FDsToSet(reference->FdList()), algorithm->FdList()));
+}
+
 TYPED_TEST_P(AlgorithmTest, LightDatasetsConsistentHash) {
     TestFixture::PerformConsistentHashTestOn(TestFixture::kLightDatasets);
 }
@@ -121,6 +137,28 @@ TYPED_TEST_P(AlgorithmTest, ConsistentRepeatedExecution) {
     }
 }
 
+/* A cancelled execution must keep only true FDs and has to tell it is incomplete. The request is
+ * consumed by the execution it stopped */
+TYPED_TEST_P(AlgorithmTest, StopsOnCancel) {
+    auto algorithm = TestFixture::CreateAlgorithmInstance(kCIPublicHighway700);
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    auto const full_res = FDsToSet(algorithm->FdList());
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(kCIPublicHighway700));
+    algorithm->Cancel();
+    algorithm->Execute();
+    ASSERT_FALSE(algorithm->IsComplete());
+    for (auto const& fd : FDsToSet(algorithm->FdList())) {
+        ASSERT_TRUE(full_res.contains(fd));
+    }
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(kCIPublicHighway700));
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    ASSERT_TRUE(CheckFdListEquality(full_res, algorithm->FdList()));
+}
+
 namespace {
 void MaxLhsTestFun(CSVConfig config, std::list<FD> const& fds_list, config::MaxLhsType max_lhs) {
     using namespace config::names;
@@ -151,10 +189,68 @@ TYPED_TEST_P(AlgorithmTest, MaxLHSOptionWork) {
     MaxLhsTestFun(kCIPublicHighway700, algo_large->FdList(), max_lhs);
 }
 
+/* Metrics are recorded into the algorithm that runs, PLI intersections included, and describe
+ * the last execution only */
+TEST(AlgorithmMetricsTest, DescribeLastExecution) {
+    using namespace config::names;
+    algos::StdParamsMap const params = {{kCsvConfig, kCIPublicHighway700},
+                                        {kError, config::ErrorType{0.0}}};
+    auto algorithm = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+    algorithm->Execute();
+    std::map<std::string, uint64_t> const counters = algorithm->GetMetrics().GetCounters();
+    ASSERT_GT(counters.at("pli_intersections"), 0u);
+    ASSERT_GT(counters.at("validations"), 0u);
+    ASSERT_GT(algorithm->GetMetrics().GetTimers().at("dependency_computation").count, 0u);
+
+    algos::ConfigureFromMap(*algorithm, params);
+    algorithm->Execute();
+    ASSERT_EQ(algorithm->GetMetrics().GetCounters(), counters);
+}
+
+/* The first load writes the snapshot and the next one reads it, the results are the same */
+TEST(TaneTest, Snapshot) {
+    using namespace config::names;
+    std::random_device random;
+    std::filesystem::path directory;
+    do {
+        directory = std::filesystem::temp_directory_path() /
+                    ("desbordante_test_" + std::to_string(random()) + std::to_string(random()));
+    } while (!std::filesystem::create_directory(directory));
+    std::filesystem::path const snapshot_path = directory / "relation.snapshot";
+
+    algos::StdParamsMap params = {{kCsvConfig, kCIPublicHighway700},
+                                  {kError, config::ErrorType{0.0}}};
+    auto reference = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+    reference->Execute();
+    params.emplace(kSnapshot, snapshot_path);
+    for (int i = 0; i < 2; ++i) {
+        auto algorithm = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+        EXPECT_TRUE(std::filesystem::exists(snapshot_path));
+        algorithm->Execute();
+        EXPECT_TRUE(CheckFdListEquality(FDsToSet(reference->FdList()), algorithm->FdList()));
+    }
+    std::filesystem::remove_all(directory);
+}
+
+/* Column PLIs compressed while loading give the same dependencies */
+TEST(TaneTest, CompressedPlis) {
+    using namespace config::names;
+    for (CSVConfig const& csv_config : {kCIPublicHighway700, kWdcAstronomical, kTestWide70}) {
+        algos::StdParamsMap params = {{kCsvConfig, csv_config}, {kError, config::ErrorType{0.0}}};
+        auto reference = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+        reference->Execute();
+
+        params.emplace(kCompressPlis, true);
+        auto algorithm = algos::CreateAndLoadAlgorithm<algos::Tane>(params);
+        algorithm->Execute();
+        ASSERT_TRUE(CheckFdListEquality(FDsToSet(reference->FdList()), algorithm->FdList()));
+    }
+}
+
 REGISTER_TYPED_TEST_SUITE_P(AlgorithmTest, ThrowsOnEmpty, ReturnsEmptyOnSingleNonKey,
-                            WorksOnLongDataset, WorksOnWideDataset, LightDatasetsConsistentHash,
-                            HeavyDatasetsConsistentHash, ConsistentRepeatedExecution,
-                            MaxLHSOptionWork);
+                            WorksOnLongDataset, WorksOnWideDataset, WorksOnDatasetWiderThanWord,
+                            LightDatasetsConsistentHash, HeavyDatasetsConsistentHash,
+                            ConsistentRepeatedExecution, StopsOnCancel, MaxLHSOptionWork);
 
 using Algorithms =
         ::testing::Types<algos::Tane, algos::Pyro, algos::FastFDs, algos::DFD, algos::Depminer,
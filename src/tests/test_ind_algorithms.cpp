@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "algorithms/algo_factory.h"
@@ -161,11 +164,13 @@ namespace {
 template <typename Algorithm>
 class GeneralINDAlgorithmTest : public ::testing::Test {
 protected:
-    static std::unique_ptr<Algorithm> CreateAlgorithmInstance(CSVConfigs const& csv_configs) {
+    static algos::StdParamsMap GetParamMap(CSVConfigs const& csv_configs) {
         using namespace config::names;
-        return algos::CreateAndLoadAlgorithm<Algorithm>(algos::StdParamsMap{
-                {kCsvConfigs, csv_configs},
-        });
+        return {{kCsvConfigs, csv_configs}};
+    }
+
+    static std::unique_ptr<Algorithm> CreateAlgorithmInstance(CSVConfigs const& csv_configs) {
+        return algos::CreateAndLoadAlgorithm<Algorithm>(GetParamMap(csv_configs));
     }
 };
 
@@ -184,6 +189,29 @@ TYPED_TEST(GeneralINDAlgorithmTest, TestEmptyTablesCollection) {
     ASSERT_THROW(TestFixture::CreateAlgorithmInstance({}), config::ConfigurationError);
 }
 
+/* A cancelled execution keeps only true INDs and tells it is incomplete, the request is consumed by
+ * the execution it stopped */
+TYPED_TEST(GeneralINDAlgorithmTest, StopsOnCancel) {
+    CSVConfigs const csv_configs = {kIndTest3aryInds};
+    auto algorithm = TestFixture::CreateAlgorithmInstance(csv_configs);
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    std::vector<INDTest> const full_res = ToSortedINDTestVec(algorithm->INDList());
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(csv_configs));
+    algorithm->Cancel();
+    algorithm->Execute();
+    ASSERT_FALSE(algorithm->IsComplete());
+    for (model::IND const& ind : algorithm->INDList()) {
+        ASSERT_TRUE(std::binary_search(full_res.begin(), full_res.end(), ToINDTest(ind)));
+    }
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(csv_configs));
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    ASSERT_EQ(ToSortedINDTestVec(algorithm->INDList()), full_res);
+}
+
 namespace {
 
 template <typename Algorithm>
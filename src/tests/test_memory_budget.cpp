@@ -0,0 +1,50 @@
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/memory_budget.h"
+
+namespace tests {
+
+TEST(MemoryBudgetTest, ReservesWithinLimits) {
+    util::MemoryBudget parent(nullptr, 1000);
+    util::MemoryBudget budget(&parent);
+
+    budget.Reserve(600);
+    ASSERT_EQ(parent.GetUsed(), 600u);
+    ASSERT_FALSE(budget.TryReserve(500));
+    ASSERT_THROW(budget.Reserve(500), util::MemoryLimitError);
+    ASSERT_FALSE(budget.TryReserveEvictable(200));
+    ASSERT_TRUE(budget.TryReserveEvictable(100));
+    ASSERT_TRUE(budget.TryReserve(300));
+    ASSERT_EQ(budget.GetUsed(), 1000u);
+    budget.Release(1000);
+    ASSERT_EQ(parent.GetUsed(), 0u);
+    ASSERT_EQ(budget.GetPeak(), 1000u);
+    budget.ResetPeak();
+    ASSERT_EQ(budget.GetPeak(), 0u);
+
+    budget.SetLimit(100);
+    {
+        auto reservation = util::MemoryReservation::TryMake(budget, 100);
+        ASSERT_TRUE(reservation);
+        ASSERT_FALSE(util::MemoryReservation::TryMake(budget, 1));
+        auto moved = std::move(reservation);
+        ASSERT_EQ(budget.GetUsed(), 100u);
+    }
+    ASSERT_EQ(budget.GetUsed(), 0u);
+
+    budget.SetLimit(util::MemoryBudget::kUnlimited);
+    util::BudgetedResource budgeted(budget);
+    {
+        std::pmr::vector<int> values(&budgeted);
+        values.resize(100);
+        ASSERT_GE(budget.GetUsed(), 100 * sizeof(int));
+        ASSERT_THROW(values.resize(1000), util::MemoryLimitError);
+    }
+    ASSERT_EQ(budget.GetUsed(), 0u);
+}
+
+}  // namespace tests
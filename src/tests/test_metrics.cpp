@@ -0,0 +1,37 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/metrics.h"
+#include "util/parallel_for.h"
+
+namespace tests {
+
+TEST(MetricsTest, CollectsFromParallelTasks) {
+    util::Metrics metrics;
+    std::vector<unsigned> values(1000, 5);
+    {
+        util::Metrics::Scope scope(&metrics);
+        util::ParallelForeach(values.begin(), values.end(), 4, [](unsigned value) {
+            util::Metrics::Current()->Counter("values").Add();
+            util::Metrics::Current()->Histogram("sizes").Record(value);
+        });
+    }
+    ASSERT_EQ(util::Metrics::Current(), nullptr);
+    ASSERT_EQ(metrics.GetCounters().at("values"), 1000u);
+    util::MetricHistogram::Value const sizes = metrics.GetHistograms().at("sizes");
+    ASSERT_EQ(sizes.count, 1000u);
+    ASSERT_EQ(sizes.sum, 5000u);
+    /* 5 is in [2^2, 2^3) */
+    ASSERT_EQ(sizes.buckets[3], 1000u);
+
+    util::MetricTimer& timer = metrics.Timer("timer");
+    util::TimedCall(timer, [] {});
+    ASSERT_EQ(timer.Get().count, 1u);
+
+    metrics.Reset();
+    ASSERT_EQ(metrics.GetCounters().at("values"), 0u);
+    ASSERT_EQ(timer.Get().count, 0u);
+}
+
+}  // namespace tests
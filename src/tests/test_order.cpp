@@ -54,6 +54,31 @@ TEST_F(OrderTest, SmallDataset) {
     EXPECT_EQ(expected, actual);
 }
 
+/* A cancelled execution keeps only valid ODs and tells it is incomplete, the request is consumed by
+ * the execution it stopped */
+TEST_F(OrderTest, StopsOnCancel) {
+    using namespace config::names;
+    auto a = CreateOrderInstance(kODnorm6);
+    a->Execute();
+    ASSERT_TRUE(a->IsComplete());
+    OD const full = a->GetValidODs();
+
+    algos::ConfigureFromMap(*a, {{kCsvConfig, kODnorm6}});
+    a->Cancel();
+    a->Execute();
+    ASSERT_FALSE(a->IsComplete());
+    for (auto const& [lhs, rhs_set] : a->GetValidODs()) {
+        for (auto const& rhs : rhs_set) {
+            ASSERT_TRUE(full.contains(lhs) && full.at(lhs).contains(rhs));
+        }
+    }
+
+    algos::ConfigureFromMap(*a, {{kCsvConfig, kODnorm6}});
+    a->Execute();
+    ASSERT_TRUE(a->IsComplete());
+    EXPECT_EQ(full, a->GetValidODs());
+}
+
 TEST_F(OrderTest, BigWithDifferentTypes) {
     auto a = CreateOrderInstance(kNeighbors10k);
     a->Execute();
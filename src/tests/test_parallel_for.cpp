@@ -0,0 +1,54 @@
+#include <atomic>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/parallel_for.h"
+
+namespace tests {
+
+TEST(ParallelForeachTest, NestedUnevenWork) {
+    std::vector<unsigned> outer(64);
+    std::iota(outer.begin(), outer.end(), 0);
+    std::vector<std::atomic<size_t>> sums(outer.size());
+    /* The work of an element grows with it, so the threads that got the first elements finish
+     * early and have to take over the rest */
+    util::ParallelForeach(outer.begin(), outer.end(), 4, [&sums](unsigned i) {
+        std::vector<size_t> inner(i * 100);
+        std::iota(inner.begin(), inner.end(), 0);
+        util::ParallelForeach(inner.begin(), inner.end(), 4, [&sums, i](size_t value) {
+            sums[i].fetch_add(value, std::memory_order_relaxed);
+        });
+    });
+    for (size_t i = 0; i < outer.size(); ++i) {
+        size_t const n = i * 100;
+        EXPECT_EQ(sums[i].load(), n * (n - 1) / 2);
+    }
+}
+
+TEST(ParallelForeachTest, WorkerIndices) {
+    unsigned const threads_num = 3;
+    std::vector<size_t> counts(threads_num);
+    std::list<int> elements(1000, 1);
+    util::ParallelForeachByWorker(elements.begin(), elements.end(), threads_num,
+                                  [&counts, threads_num](unsigned worker_index, int element) {
+                                      ASSERT_LT(worker_index, threads_num);
+                                      counts[worker_index] += element;
+                                  });
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), size_t{0}), elements.size());
+}
+
+TEST(ParallelForeachTest, RethrowsException) {
+    std::vector<int> elements(1000);
+    std::iota(elements.begin(), elements.end(), 0);
+    auto task = [](int element) {
+        if (element == 500) throw std::runtime_error("Element 500");
+    };
+    EXPECT_THROW(util::ParallelForeach(elements.begin(), elements.end(), 4, task),
+                 std::runtime_error);
+}
+
+}  // namespace tests
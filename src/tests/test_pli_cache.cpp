@@ -0,0 +1,69 @@
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/dynamic_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include "all_csv_configs.h"
+#include "csv_config_util.h"
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/pli_cache.h"
+#include "model/table/pli_cache_eviction_policy.h"
+#include "model/table/relational_schema.h"
+#include "model/table/vertical.h"
+#include "util/caching_method.h"
+
+namespace tests {
+
+TEST(PLICacheTest, EvictsWithinMemoryLimit) {
+    auto relation =
+            ColumnLayoutRelationData::CreateFrom(*MakeInputTable(kCIPublicHighway700), true);
+    RelationalSchema const* schema = relation->GetSchema();
+    size_t const num_columns = relation->GetNumColumns();
+    auto column_pli = [&relation](size_t index) {
+        return relation->GetColumnData(index).GetPositionListIndex();
+    };
+    auto vertical = [schema, num_columns](std::initializer_list<size_t> indices) {
+        boost::dynamic_bitset<> bitset(num_columns);
+        for (size_t index : indices) bitset.set(index);
+        return schema->GetVertical(std::move(bitset));
+    };
+
+    /* Room for a few composite PLIs */
+    model::PLICache cache(relation.get(), CachingMethod::kAllCaching,
+                          std::make_unique<model::LeastRecentlyUsedPolicy>(),
+                          column_pli(0)->GetBytes() * 4);
+    for (size_t i = 0; i < num_columns; ++i) {
+        for (size_t j = i + 1; j < num_columns; ++j) {
+            auto pli = cache.GetOrCreateFor(vertical({i, j}));
+            ASSERT_EQ(pli->GetNepAsLong(), column_pli(i)->Intersect(column_pli(j))->GetNepAsLong());
+            ASSERT_LE(cache.GetBytes(), cache.GetCapacityBytes());
+        }
+    }
+    ASSERT_GT(cache.GetEvictions(), 0u);
+    ASSERT_EQ(cache.GetHits(), 0u);
+
+    Vertical const last = vertical({num_columns - 2, num_columns - 1});
+    ASSERT_EQ(cache.GetOrCreateFor(last), cache.Get(last));
+    ASSERT_EQ(cache.GetHits(), 1u);
+
+    auto pli = cache.GetOrCreateFor(vertical({0, 1, num_columns - 1}));
+    ASSERT_EQ(pli->GetNepAsLong(), column_pli(0)
+                                           ->Intersect(column_pli(1))
+                                           ->Intersect(column_pli(num_columns - 1))
+                                           ->GetNepAsLong());
+    ASSERT_EQ(cache.GetMisses(), num_columns * (num_columns - 1) / 2 + 1);
+}
+
+TEST(PLICacheTest, RejectsUnsupportedCachingMethods) {
+    auto relation = ColumnLayoutRelationData::CreateFrom(*MakeInputTable(kTest1), true);
+    for (CachingMethod method : {CachingMethod::kEntropy, CachingMethod::kGini}) {
+        ASSERT_THROW(model::PLICache(relation.get(), method,
+                                     std::make_unique<model::LeastRecentlyUsedPolicy>()),
+                     std::invalid_argument);
+    }
+}
+
+}  // namespace tests
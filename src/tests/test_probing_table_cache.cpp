@@ -0,0 +1,114 @@
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "all_csv_configs.h"
+#include "csv_config_util.h"
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/probing_table_cache.h"
+#include "util/memory_budget.h"
+
+namespace tests {
+
+using std::vector, std::unique_ptr;
+using ::testing::ElementsAreArray;
+
+TEST(ProbingTableCacheTest, EvictsAndPins) {
+    auto input_table = MakeInputTable(kCIPublicHighway700);
+    auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+    model::PLI const* column_pli = relation->GetColumnData(0).GetPositionListIndex();
+    vector<unique_ptr<model::PLI>> plis;
+    for (size_t i = 1; i < 4; ++i) {
+        plis.push_back(column_pli->Intersect(relation->GetColumnData(i).GetPositionListIndex()));
+        ASSERT_EQ(plis.back()->GetCachedProbingTable(), nullptr);
+    }
+    size_t const table_bytes = sizeof(vector<int>) + relation->GetNumRows() * sizeof(int);
+
+    /* Room for one table */
+    model::ProbingTableCache cache(table_bytes * 3 / 2);
+    ASSERT_EQ(cache.GetProbingTable(*column_pli).get(), column_pli->GetCachedProbingTable());
+    ASSERT_EQ(cache.GetBytes(), 0u);
+
+    auto table = cache.GetProbingTable(*plis[0]);
+    ASSERT_THAT(*table, ElementsAreArray(*plis[0]->CalculateAndGetProbingTable()));
+    ASSERT_EQ(cache.GetProbingTable(*plis[0]), table);
+    ASSERT_EQ(cache.GetHits(), 1u);
+    ASSERT_EQ(cache.GetMisses(), 1u);
+
+    cache.GetProbingTable(*plis[1]);
+    ASSERT_EQ(cache.GetEvictions(), 1u);
+    ASSERT_LE(cache.GetBytes(), cache.GetCapacityBytes());
+    ASSERT_NE(cache.GetProbingTable(*plis[0]), table);
+
+    {
+        model::ProbingTableCache::PinGuard pins(cache);
+        pins.Add(*plis[0]);
+        auto pinned_table = cache.GetProbingTable(*plis[0]);
+        cache.GetProbingTable(*plis[2]);
+        ASSERT_EQ(cache.GetProbingTable(*plis[0]), pinned_table);
+        ASSERT_LE(cache.GetBytes(), cache.GetCapacityBytes());
+    }
+    cache.Erase(*plis[0]);
+    ASSERT_EQ(cache.GetBytes(), 0u);
+}
+
+TEST(ProbingTableCacheTest, GivesWayToMemoryBudget) {
+    auto input_table = MakeInputTable(kCIPublicHighway700);
+    auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+    model::PLI const* column_pli = relation->GetColumnData(0).GetPositionListIndex();
+    vector<unique_ptr<model::PLI>> plis;
+    for (size_t i = 1; i < 4; ++i) {
+        plis.push_back(column_pli->Intersect(relation->GetColumnData(i).GetPositionListIndex()));
+    }
+    size_t const table_bytes = sizeof(vector<int>) + relation->GetNumRows() * sizeof(int);
+
+    /* Three quarters of the limit, i.e. what caches may take, hold one table */
+    util::MemoryBudget budget(nullptr, table_bytes * 2);
+    {
+        model::ProbingTableCache cache(table_bytes * 10, &budget);
+        cache.GetProbingTable(*plis[0]);
+        ASSERT_EQ(budget.GetUsed(), cache.GetBytes());
+        cache.GetProbingTable(*plis[1]);
+        ASSERT_EQ(cache.GetEvictions(), 1u);
+        ASSERT_EQ(budget.GetUsed(), cache.GetBytes());
+
+        /* Once the memory is taken by something else, the tables are computed on every probe */
+        auto reservation = util::MemoryReservation::Make(budget, table_bytes);
+        auto table = cache.GetProbingTable(*plis[2]);
+        ASSERT_THAT(*table, ElementsAreArray(*plis[2]->CalculateAndGetProbingTable()));
+        ASSERT_EQ(cache.GetBytes(), 0u);
+        ASSERT_EQ(budget.GetUsed(), table_bytes);
+    }
+    ASSERT_EQ(budget.GetUsed(), 0u);
+}
+
+TEST(ProbingTableCacheTest, ForgetsDestroyedPLIs) {
+    auto input_table = MakeInputTable(kCIPublicHighway700);
+    auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+    model::PLI const* column_pli = relation->GetColumnData(0).GetPositionListIndex();
+    size_t const table_bytes = sizeof(vector<int>) + relation->GetNumRows() * sizeof(int);
+
+    model::ProbingTableCache cache(table_bytes * 10);
+    model::ProbingTableCache other_cache(table_bytes * 10);
+    auto kept = column_pli->Intersect(relation->GetColumnData(1).GetPositionListIndex());
+    {
+        auto transient = column_pli->Intersect(relation->GetColumnData(2).GetPositionListIndex());
+        cache.GetProbingTable(*kept);
+        cache.GetProbingTable(*transient);
+        ASSERT_EQ(cache.GetBytes(), 2 * table_bytes);
+    }
+    ASSERT_EQ(cache.GetBytes(), table_bytes);
+
+    /* A PLI is kept in one cache only */
+    other_cache.GetProbingTable(*kept);
+    ASSERT_EQ(other_cache.GetBytes(), 0u);
+
+    cache.SetCapacityBytes(table_bytes / 2);
+    ASSERT_EQ(cache.GetBytes(), 0u);
+    other_cache.GetProbingTable(*kept);
+    ASSERT_EQ(other_cache.GetBytes(), table_bytes);
+}
+
+}  // namespace tests
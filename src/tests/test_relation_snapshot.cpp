@@ -0,0 +1,211 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "all_csv_configs.h"
+#include "csv_config_util.h"
+#include "model/table/column_layout_relation_data.h"
+#include "model/table/column_layout_typed_relation_data.h"
+#include "model/table/relation_snapshot.h"
+
+namespace tests {
+
+namespace mo = model;
+
+namespace {
+
+class TestRelationSnapshot : public ::testing::Test {
+protected:
+    /* Unique, so that concurrent runs don't share it */
+    std::filesystem::path directory_;
+    std::filesystem::path snapshot_path_;
+
+    void SetUp() override {
+        std::random_device random;
+        do {
+            directory_ = std::filesystem::temp_directory_path() /
+                         ("desbordante_test_" + std::to_string(random()) +
+                          std::to_string(random()));
+        } while (!std::filesystem::create_directory(directory_));
+        snapshot_path_ = directory_ / "relation.snapshot";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory_);
+    }
+};
+
+bool IsMapped(ColumnLayoutRelationData const& relation, size_t column_index) {
+    return relation.GetColumnData(column_index).GetPositionListIndex()->GetIndex().IsView();
+}
+
+void ExpectSameRelations(ColumnLayoutRelationData const& actual,
+                         ColumnLayoutRelationData const& expected) {
+    EXPECT_EQ(actual.GetSchema()->GetName(), expected.GetSchema()->GetName());
+    ASSERT_EQ(actual.GetNumColumns(), expected.GetNumColumns());
+    ASSERT_EQ(actual.GetNumRows(), expected.GetNumRows());
+    for (size_t i = 0; i < expected.GetNumColumns(); ++i) {
+        ColumnData const& expected_column = expected.GetColumnData(i);
+        ColumnData const& actual_column = actual.GetColumnData(i);
+        mo::PLI const& expected_pli = *expected_column.GetPositionListIndex();
+        mo::PLI const& actual_pli = *actual_column.GetPositionListIndex();
+        EXPECT_EQ(actual_column.GetColumn()->GetName(), expected_column.GetColumn()->GetName());
+        EXPECT_THAT(actual_column.GetProbingTable(),
+                    ::testing::ElementsAreArray(expected_column.GetProbingTable()));
+        EXPECT_EQ(actual_pli.GetIndex(), expected_pli.GetIndex());
+        EXPECT_EQ(actual_pli.GetNullCluster(), expected_pli.GetNullCluster());
+        EXPECT_EQ(actual_pli.GetNepAsLong(), expected_pli.GetNepAsLong());
+        EXPECT_EQ(actual_pli.GetEntropy(), expected_pli.GetEntropy());
+        EXPECT_EQ(actual_pli.GetSize(), expected_pli.GetSize());
+    }
+}
+
+}  // namespace
+
+TEST_F(TestRelationSnapshot, ColumnLayoutRoundTrip) {
+    for (CSVConfig const& csv_config : {kTest1, kNullEmpty, kCIPublicHighway700, kTestMetric}) {
+        for (bool is_null_eq_null : {true, false}) {
+            std::uint64_t const checksum = mo::snapshot::ChecksumFile(csv_config.path);
+            auto input_table = MakeInputTable(csv_config);
+            auto expected = ColumnLayoutRelationData::CreateFrom(*input_table, is_null_eq_null);
+            expected->WriteSnapshot(snapshot_path_, checksum, is_null_eq_null);
+            auto actual = ColumnLayoutRelationData::ReadSnapshot(snapshot_path_, checksum,
+                                                                 is_null_eq_null);
+            ExpectSameRelations(*actual, *expected);
+        }
+    }
+}
+
+/* The read relation refers to the mapping, which outlives the file name, and the PLIs are
+ * copied before they are changed */
+TEST_F(TestRelationSnapshot, ColumnLayoutIsMapped) {
+    std::uint64_t const checksum = mo::snapshot::ChecksumFile(kCIPublicHighway700.path);
+    auto input_table = MakeInputTable(kCIPublicHighway700);
+    auto expected = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+    expected->WriteSnapshot(snapshot_path_, checksum, true);
+    auto actual = ColumnLayoutRelationData::ReadSnapshot(snapshot_path_, checksum, true);
+    std::filesystem::remove(snapshot_path_);
+
+    for (size_t i = 0; i < actual->GetNumColumns(); ++i) {
+        ASSERT_TRUE(IsMapped(*actual, i));
+    }
+    ExpectSameRelations(*actual, *expected);
+    auto intersection = actual->GetColumnData(0).GetPositionListIndex()->Intersect(
+            actual->GetColumnData(1).GetPositionListIndex());
+    auto expected_intersection = expected->GetColumnData(0).GetPositionListIndex()->Intersect(
+            expected->GetColumnData(1).GetPositionListIndex());
+    EXPECT_EQ(intersection->GetIndex(), expected_intersection->GetIndex());
+
+    mo::ClusterIndex& clusters = actual->GetColumnData(0).GetPositionListIndex()->GetIndex();
+    ASSERT_FALSE(clusters.IsView());
+    clusters.SortClusters();
+    EXPECT_EQ(clusters, expected->GetColumnData(0).GetPositionListIndex()->GetIndex());
+}
+
+/* The snapshot is written on the first load and read on the next ones, until the table is read
+ * another way */
+TEST_F(TestRelationSnapshot, CreateWithSnapshot) {
+    auto expected = ColumnLayoutRelationData::CreateFrom(*MakeInputTable(kTest1), true);
+    auto created = ColumnLayoutRelationData::CreateWithSnapshot(*MakeInputTable(kTest1),
+                                                                snapshot_path_, true);
+    ASSERT_TRUE(std::filesystem::exists(snapshot_path_));
+    ASSERT_FALSE(IsMapped(*created, 0));
+    ExpectSameRelations(*created, *expected);
+
+    auto read = ColumnLayoutRelationData::CreateWithSnapshot(*MakeInputTable(kTest1),
+                                                             snapshot_path_, true);
+    ASSERT_TRUE(IsMapped(*read, 0));
+    ExpectSameRelations(*read, *expected);
+
+    /* Replaced while the relation read before still maps the old snapshot */
+    CSVConfig without_header = kTest1;
+    without_header.has_header = false;
+    auto expected_without_header =
+            ColumnLayoutRelationData::CreateFrom(*MakeInputTable(without_header), false);
+    auto recreated = ColumnLayoutRelationData::CreateWithSnapshot(
+            *MakeInputTable(without_header), snapshot_path_, false);
+    ASSERT_FALSE(IsMapped(*recreated, 0));
+    ExpectSameRelations(*recreated, *expected_without_header);
+    ExpectSameRelations(*read, *expected);
+    auto reread = ColumnLayoutRelationData::CreateWithSnapshot(*MakeInputTable(without_header),
+                                                               snapshot_path_, false);
+    ASSERT_TRUE(IsMapped(*reread, 0));
+    ExpectSameRelations(*reread, *expected_without_header);
+}
+
+/* The header has no separator in it, so only the rows tell the two separators apart */
+TEST_F(TestRelationSnapshot, CreateWithSnapshotTellsSeparatorsApart) {
+    std::filesystem::path const table_path = directory_ / "table.csv";
+    std::ofstream(table_path) << "name\na,1\nb\na;2\nb\n";
+    for (char separator : {',', ';', ','}) {
+        CSVConfig const csv_config{table_path, separator, true};
+        auto expected = ColumnLayoutRelationData::CreateFrom(*MakeInputTable(csv_config), true);
+        auto created = ColumnLayoutRelationData::CreateWithSnapshot(*MakeInputTable(csv_config),
+                                                                    snapshot_path_, true);
+        ASSERT_FALSE(IsMapped(*created, 0));
+        ExpectSameRelations(*created, *expected);
+    }
+}
+
+TEST_F(TestRelationSnapshot, TypedRoundTrip) {
+    for (CSVConfig const& csv_config : {kSimpleTypes, kNullEmpty, kTestMetric, kWdcSatellites}) {
+        std::uint64_t const checksum = mo::snapshot::ChecksumFile(csv_config.path);
+        auto input_table = MakeInputTable(csv_config);
+        auto expected = mo::ColumnLayoutTypedRelationData::CreateFrom(*input_table, true);
+        expected->WriteSnapshot(snapshot_path_, checksum, true);
+        auto actual = mo::ColumnLayoutTypedRelationData::ReadSnapshot(snapshot_path_, checksum,
+                                                                      true);
+
+        ASSERT_EQ(actual->GetNumColumns(), expected->GetNumColumns());
+        ASSERT_EQ(actual->GetNumRows(), expected->GetNumRows());
+        for (size_t i = 0; i < expected->GetNumColumns(); ++i) {
+            mo::TypedColumnData const& expected_column = expected->GetColumnData(i);
+            mo::TypedColumnData const& actual_column = actual->GetColumnData(i);
+            ASSERT_EQ(actual_column.GetTypeId(), expected_column.GetTypeId());
+            EXPECT_EQ(actual_column.GetNumNulls(), expected_column.GetNumNulls());
+            EXPECT_EQ(actual_column.GetNumEmpties(), expected_column.GetNumEmpties());
+            for (size_t row = 0; row < expected_column.GetNumRows(); ++row) {
+                ASSERT_EQ(actual_column.GetValueTypeId(row), expected_column.GetValueTypeId(row))
+                        << "Column " << i << ", row " << row;
+                if (expected_column.IsNullOrEmpty(row)) {
+                    continue;
+                }
+                if (expected_column.IsHeapType()) {
+                    EXPECT_EQ(actual_column.GetStringValue(row),
+                              expected_column.GetStringValue(row))
+                            << "Column " << i << ", row " << row;
+                    continue;
+                }
+                EXPECT_EQ(expected_column.GetType().Compare(expected_column.GetValue(row),
+                                                            actual_column.GetValue(row)),
+                          mo::CompareResult::kEqual)
+                        << "Column " << i << ", row " << row;
+            }
+        }
+    }
+}
+
+TEST_F(TestRelationSnapshot, StaleSnapshotIsRejected) {
+    std::uint64_t const checksum = mo::snapshot::ChecksumFile(kTest1.path);
+    ASSERT_NE(checksum, mo::snapshot::ChecksumFile(kTestMetric.path));
+    auto input_table = MakeInputTable(kTest1);
+    ColumnLayoutRelationData::CreateFrom(*input_table, true)
+            ->WriteSnapshot(snapshot_path_, checksum, true);
+
+    EXPECT_THROW(ColumnLayoutRelationData::ReadSnapshot(snapshot_path_, checksum + 1, true),
+                 std::runtime_error);
+    EXPECT_THROW(ColumnLayoutRelationData::ReadSnapshot(snapshot_path_, checksum, false),
+                 std::runtime_error);
+    EXPECT_THROW(mo::ColumnLayoutTypedRelationData::ReadSnapshot(snapshot_path_, checksum, true),
+                 std::runtime_error);
+    EXPECT_NO_THROW(ColumnLayoutRelationData::ReadSnapshot(snapshot_path_, checksum, true));
+}
+
+}  // namespace tests
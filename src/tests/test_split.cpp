@@ -9,6 +9,7 @@
 #include "all_csv_configs.h"
 #include "config/names.h"
 #include "csv_config_util.h"
+#include "util/memory_budget.h"
 
 namespace tests {
 
@@ -28,6 +29,12 @@ void CompareDDStringLists(std::set<std::pair<std::set<model::DFStringConstraint>
 }
 
 class SplitAlgorithmTest : public ::testing::Test {
+protected:
+    /* Tests that limit the process-wide budget get it lifted even if they fail midway */
+    void TearDown() override {
+        util::MemoryBudget::Process().SetLimit(util::MemoryBudget::kUnlimited);
+    }
+
 public:
     static algos::StdParamsMap GetParamMap(CSVConfig const& csv_config,
                                            std::optional<CSVConfig> const& dif_table_csv_config) {
@@ -69,6 +76,25 @@ TEST_F(SplitAlgorithmTest, Test1) {
     CompareDDStringLists(expected_results, actual_results);
 }
 
+/* Without the memory for the distance matrices the distances are calculated on demand */
+TEST_F(SplitAlgorithmTest, WorksWithoutDistanceMatrices) {
+    auto algo = CreateSplitAlgorithmInstance(kTestDD1);
+    algo->Execute();
+    ASSERT_GT(algo->GetPeakMemoryUsage(), 0u);
+    auto to_strings = [](std::list<model::DDString> const& dds) {
+        std::list<std::string> strings;
+        for (auto const& dd : dds) strings.push_back(dd.ToString());
+        return strings;
+    };
+    auto const expected_results = to_strings(algo->GetDDStringList());
+
+    util::MemoryBudget::Process().SetLimit(0);
+    algos::ConfigureFromMap(*algo, GetParamMap(kTestDD1, std::nullopt));
+    algo->Execute();
+    ASSERT_EQ(algo->GetPeakMemoryUsage(), 0u);
+    ASSERT_EQ(to_strings(algo->GetDDStringList()), expected_results);
+}
+
 TEST_F(SplitAlgorithmTest, Test2) {
     auto algo = CreateSplitAlgorithmInstance(kTestDD2, kTestDif1);
     algo->Execute();
@@ -1,4 +1,9 @@
 #include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
 
 #include <gtest/gtest.h>
 
@@ -6,6 +11,8 @@
 #include "all_csv_configs.h"
 #include "csv_config_util.h"
 #include "model/table/column_layout_typed_relation_data.h"
+#include "model/table/relational_schema.h"
+#include "model/table/value_classifier.h"
 
 namespace tests {
 
@@ -35,6 +42,23 @@ TEST_P(TestTypeParsing, DefaultTest) {
     }
 }
 
+TEST_P(TestTypeParsing, SampledInference) {
+    auto const& [expected, csv_config] = GetParam();
+    using Method = mo::TypeInferenceSample::Method;
+    for (mo::TypeInferenceSample const& sample :
+         {mo::TypeInferenceSample{Method::kPrefix, 16}, mo::TypeInferenceSample{Method::kPrefix, 0},
+          mo::TypeInferenceSample{Method::kReservoir, 64, 1}}) {
+        auto input_table = MakeInputTable(csv_config);
+        std::vector<mo::TypedColumnData> column_data{
+                mo::CreateTypedColumnData(*input_table, true, 2, sample)};
+
+        ASSERT_EQ(column_data.size(), expected.size());
+        for (size_t i = 0; i < column_data.size(); ++i) {
+            EXPECT_EQ(column_data[i].GetTypeId(), expected[i]) << "Column index: " << i;
+        }
+    }
+}
+
 // clang-format off
 INSTANTIATE_TEST_SUITE_P(
     TypeSystem, TestTypeParsing,
@@ -77,6 +101,88 @@ INSTANTIATE_TEST_SUITE_P(
 
 // clang-format on
 
+TEST(TypeSystem, ValueClassifier) {
+    EXPECT_TRUE(mo::IsNullValue("NULL"));
+    EXPECT_FALSE(mo::IsNullValue("null"));
+    EXPECT_TRUE(mo::IsEmptyValue(""));
+
+    for (std::string const value : {"0", "-7", "+42", "1234567890123456789"}) {
+        EXPECT_TRUE(mo::IsIntValue(value)) << value;
+        EXPECT_FALSE(mo::IsBigIntValue(value)) << value;
+    }
+    for (std::string const value : {"12345678901234567890", "-123456789012345678901234567890123"}) {
+        EXPECT_FALSE(mo::IsIntValue(value)) << value;
+        EXPECT_TRUE(mo::IsBigIntValue(value)) << value;
+    }
+    for (std::string const value : {"", "+", "-", "1 ", " 1", "1.0", "--1", "1-", "12a3"}) {
+        EXPECT_FALSE(mo::IsIntValue(value)) << value;
+        EXPECT_FALSE(mo::IsBigIntValue(value)) << value;
+    }
+
+    for (std::string const value : {"1.5", "-.5", " 3e2", "1e-300", "inf", "NaN", "0x1p3"}) {
+        EXPECT_TRUE(mo::IsDoubleValue(value)) << value;
+    }
+    for (std::string const value : {"", " ", "1.5 ", "1e400", "1e-400", "abc", "1.5.5"}) {
+        EXPECT_FALSE(mo::IsDoubleValue(value)) << value;
+    }
+
+    EXPECT_TRUE(mo::IsDelimitedDateValue("2020-01-31"));
+    EXPECT_TRUE(mo::IsDelimitedDateValue("2020/1/31"));
+    EXPECT_FALSE(mo::IsDelimitedDateValue("20200131"));
+    EXPECT_FALSE(mo::IsDelimitedDateValue("Jan-Feb"));
+    EXPECT_TRUE(mo::IsUndelimitedDateValue("20200131"));
+    EXPECT_FALSE(mo::IsUndelimitedDateValue("20201331"));
+    EXPECT_FALSE(mo::IsUndelimitedDateValue("2020-01-31"));
+
+    std::string const digits(100, '7');
+    for (size_t length = 0; length < digits.size(); ++length) {
+        std::string value = digits;
+        value[length] = 'x';
+        EXPECT_EQ(mo::CountLeadingDigits(value.data(), value.data() + value.size()), length);
+    }
+}
+
+TEST(TypeSystem, ColumnarStorage) {
+    RelationalSchema schema("storage");
+    schema.AppendColumn("ints");
+    schema.AppendColumn("strings");
+    schema.AppendColumn("mixed");
+
+    mo::TypedColumnData ints = mo::TypedColumnDataFactory::CreateFrom(
+            schema.GetColumn(0), {"1", "NULL", "", "-5"}, true);
+    ASSERT_EQ(ints.GetTypeId(), +TypeId::kInt);
+    std::span<mo::Int const> const int_values = ints.GetValues<mo::Int>();
+    EXPECT_EQ(std::vector<mo::Int>(int_values.begin(), int_values.end()),
+              (std::vector<mo::Int>{1, 0, 0, -5}));
+    EXPECT_EQ(ints.GetNullMask(), boost::dynamic_bitset<>(std::string("0010")));
+    EXPECT_EQ(ints.GetEmptyMask(), boost::dynamic_bitset<>(std::string("0100")));
+    EXPECT_EQ(ints.GetValue(1), nullptr);
+    EXPECT_EQ(mo::Type::GetValue<mo::Int>(ints.GetValue(3)), -5);
+    EXPECT_EQ(ints.GetValue(3), reinterpret_cast<std::byte const*>(&int_values[3]));
+
+    mo::TypedColumnData strings = mo::TypedColumnDataFactory::CreateFrom(
+            schema.GetColumn(1), {"ab", "", "NULL", "c d"}, true);
+    ASSERT_EQ(strings.GetTypeId(), +TypeId::kString);
+    EXPECT_EQ(strings.GetStringValue(0), "ab");
+    EXPECT_EQ(strings.GetStringValue(3), "c d");
+    EXPECT_TRUE(strings.IsEmpty(1));
+    EXPECT_TRUE(strings.IsNull(2));
+    EXPECT_EQ(strings.GetDataAsString(2), "NULL");
+    EXPECT_EQ(strings.GetDataAsString(3), "c d");
+
+    mo::TypedColumnData mixed = mo::TypedColumnDataFactory::CreateFrom(
+            schema.GetColumn(2), {"1", "x", "NULL", "2.5"}, true);
+    ASSERT_EQ(mixed.GetTypeId(), +TypeId::kMixed);
+    EXPECT_TRUE(mixed.IsNull(2));
+    EXPECT_FALSE(mixed.IsNullOrEmpty(1));
+    EXPECT_EQ(mixed.GetValueTypeId(1), +TypeId::kString);
+    EXPECT_EQ(mixed.GetStringValue(1), "x");
+    EXPECT_EQ(mixed.GetValueTypeId(3), +TypeId::kDouble);
+    EXPECT_EQ(mo::Type::GetValue<mo::Double>(mixed.GetIfMixed()->RetrieveValue(mixed.GetValue(3))),
+              2.5);
+    EXPECT_EQ(mixed.GetDataAsString(0), "1");
+}
+
 TEST(TypeSystem, SumColumnDoubles) {
     auto input_table = MakeInputTable(kIris);
     std::vector<mo::TypedColumnData> col_data{mo::CreateTypedColumnData(*input_table, true)};
@@ -85,8 +191,8 @@ TEST(TypeSystem, SumColumnDoubles) {
     ASSERT_EQ(col.GetTypeId(), static_cast<TypeId>(TypeId::kDouble));
     mo::INumericType const& type = static_cast<mo::INumericType const&>(col.GetType());
     std::unique_ptr<std::byte[]> sum(type.Allocate());
-    for (std::byte const* value : col.GetData()) {
-        type.Add(sum.get(), value, sum.get());
+    for (size_t i = 0; i < col.GetNumRows(); ++i) {
+        type.Add(sum.get(), col.GetValue(i), sum.get());
     }
     mo::Double expected = 876.5;
     EXPECT_DOUBLE_EQ(type.GetValue<mo::Double>(sum.get()), expected);
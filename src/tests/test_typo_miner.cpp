@@ -226,7 +226,7 @@ class SquashClusterTest : public ::testing::TestWithParam<TestingParam> {};
 static void VerifySquashed(ColumnLayoutRelationData const& rel, FD const& fd,
                            model::PLI::Cluster const& cluster,
                            std::vector<algos::TypoMiner::SquashedElement> const& squashed) {
-    std::vector<int> const& probing_table =
+    model::PLI::ProbingTable const probing_table =
             rel.GetColumnData(fd.GetRhs().GetIndex()).GetProbingTable();
     unsigned cluster_index = 0;
     for (auto const& squashed_element : squashed) {
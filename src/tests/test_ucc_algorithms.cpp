@@ -1,6 +1,8 @@
 #include <memory>
 #include <ostream>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <boost/dynamic_bitset.hpp>
 #include <gmock/gmock.h>
@@ -143,9 +145,39 @@ TYPED_TEST_P(UCCAlgorithmTest, ConsistentHashOnHeavyDatasetsParallel) {
     TestFixture::PerformConsistentHashTestOn(TestFixture::kHeavyDatasets);
 }
 
+/* A cancelled execution keeps only true UCCs and tells it is incomplete, the request is consumed by
+ * the execution it stopped */
+TYPED_TEST_P(UCCAlgorithmTest, StopsOnCancel) {
+    TestFixture::SetThreadsParam(1);
+    auto to_set = [](std::list<model::UCC> const& uccs) {
+        std::set<std::vector<unsigned>> indices;
+        for (Vertical const& ucc : uccs) {
+            indices.insert(ucc.GetColumnIndicesAsVector());
+        }
+        return indices;
+    };
+    auto algorithm = TestFixture::CreateAlgorithmInstance(kCIPublicHighway700);
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    auto const full_res = to_set(algorithm->UCCList());
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(kCIPublicHighway700));
+    algorithm->Cancel();
+    algorithm->Execute();
+    ASSERT_FALSE(algorithm->IsComplete());
+    for (std::vector<unsigned> const& ucc : to_set(algorithm->UCCList())) {
+        ASSERT_TRUE(full_res.contains(ucc));
+    }
+
+    algos::ConfigureFromMap(*algorithm, TestFixture::GetParamMap(kCIPublicHighway700));
+    algorithm->Execute();
+    ASSERT_TRUE(algorithm->IsComplete());
+    ASSERT_EQ(to_set(algorithm->UCCList()), full_res);
+}
+
 REGISTER_TYPED_TEST_SUITE_P(UCCAlgorithmTest, ConsistentHashOnLightDatasets,
                             ConsistentHashOnHeavyDatasets, ConsistentHashOnLightDatasetsParallel,
-                            ConsistentHashOnHeavyDatasetsParallel);
+                            ConsistentHashOnHeavyDatasetsParallel, StopsOnCancel);
 
 using Algorithms = ::testing::Types<algos::HyUCC, algos::PyroUCC, algos::HPIValid>;
 INSTANTIATE_TYPED_TEST_SUITE_P(UCCAlgorithmTest, UCCAlgorithmTest, Algorithms);
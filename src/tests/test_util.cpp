@@ -1,5 +1,8 @@
+#include <cmath>
 #include <iostream>
-#include <thread>
+#include <map>
+#include <memory_resource>
+#include <set>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -9,14 +12,17 @@
 #include "fd/pyrocommon/model/list_agree_set_sample.h"
 #include "levenshtein_distance.h"
 #include "model/table/agree_set_factory.h"
+#include "model/table/cluster_index.h"
 #include "model/table/column_layout_relation_data.h"
 #include "model/table/identifier_set.h"
+#include "model/table/relation_loader.h"
+#include "model/table/relational_schema.h"
 
 namespace tests {
 
 using std::deque, std::vector, std::cout, std::endl, std::unique_ptr, model::AgreeSetFactory,
         model::MCGenMethod, model::AgreeSetsGenMethod;
-using ::testing::ContainerEq, ::testing::Eq;
+using ::testing::ContainerEq, ::testing::ElementsAreArray, ::testing::Eq;
 
 namespace fs = std::filesystem;
 
@@ -29,7 +35,8 @@ TEST(pliChecker, first) {
         auto input_table = MakeInputTable(kTest1);
         auto test = ColumnLayoutRelationData::CreateFrom(*input_table, true);
         auto column_data = test->GetColumnData(0);
-        index = column_data.GetPositionListIndex()->GetIndex();
+        model::ClusterIndex const& clusters = column_data.GetPositionListIndex()->GetIndex();
+        index = deque<vector<int>>(clusters.begin(), clusters.end());
     } catch (std::runtime_error& e) {
         cout << "Exception raised in test: " << e.what() << endl;
         FAIL();
@@ -49,7 +56,8 @@ TEST(pliChecker, second) {
         auto input_table = MakeInputTable(kTest1);
         auto test = ColumnLayoutRelationData::CreateFrom(*input_table, false);
         auto column_data = test->GetColumnData(0);
-        index = column_data.GetPositionListIndex()->GetIndex();
+        model::ClusterIndex const& clusters = column_data.GetPositionListIndex()->GetIndex();
+        index = deque<vector<int>>(clusters.begin(), clusters.end());
     } catch (std::runtime_error& e) {
         cout << "Exception raised in test: " << e.what() << endl;
         FAIL();
@@ -57,6 +65,96 @@ TEST(pliChecker, second) {
     ASSERT_THAT(index, ContainerEq(ans));
 }
 
+TEST(pliChecker, IntersectWithMemoryResource) {
+    auto input_table = MakeInputTable(kTest1);
+    auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+    std::pmr::unsynchronized_pool_resource pool;
+    for (size_t i = 0; i < relation->GetNumColumns(); ++i) {
+        for (size_t j = i + 1; j < relation->GetNumColumns(); ++j) {
+            model::PLI const* lhs = relation->GetColumnData(i).GetPositionListIndex();
+            model::PLI const* rhs = relation->GetColumnData(j).GetPositionListIndex();
+            auto expected = lhs->Intersect(rhs);
+            auto pooled = lhs->Intersect(rhs, &pool);
+            ASSERT_EQ(pooled->GetIndex().GetResource(), &pool);
+            ASSERT_EQ(pooled->GetIndex(), expected->GetIndex());
+            ASSERT_EQ(pooled->GetNepAsLong(), expected->GetNepAsLong());
+            ASSERT_DOUBLE_EQ(pooled->GetEntropy(), expected->GetEntropy());
+        }
+    }
+}
+
+TEST(pliChecker, ParallelLoadMatchesSequential) {
+    for (CSVConfig csv_config : {kTest1, kBreastCancer, kAbalone, kCIPublicHighway700, kTestEmpty,
+                                 kTestSingleColumn, kTestLong}) {
+        for (bool is_null_eq_null : {true, false}) {
+            csv_config.reader_type = CSVReaderType::kStream;
+            auto sequential_table = MakeInputTable(csv_config);
+            auto sequential = ColumnLayoutRelationData::CreateFrom(*sequential_table,
+                                                                   is_null_eq_null, 1);
+            /* Both readers split the file into chunks */
+            for (CSVReaderType reader_type : {CSVReaderType::kStream, CSVReaderType::kMmap}) {
+                csv_config.reader_type = reader_type;
+                for (unsigned threads : {2u, 3u, 8u}) {
+                    auto parallel_table = MakeInputTable(csv_config);
+                    auto parallel = ColumnLayoutRelationData::CreateFrom(*parallel_table,
+                                                                         is_null_eq_null, threads);
+                    ASSERT_EQ(parallel->GetNumRows(), sequential->GetNumRows());
+                    ASSERT_EQ(parallel->GetNumColumns(), sequential->GetNumColumns());
+                    for (size_t i = 0; i < sequential->GetNumColumns(); ++i) {
+                        ColumnData const& expected = sequential->GetColumnData(i);
+                        ColumnData const& actual = parallel->GetColumnData(i);
+                        EXPECT_THAT(actual.GetProbingTable(),
+                                    ElementsAreArray(expected.GetProbingTable()));
+                        EXPECT_EQ(actual.GetPositionListIndex()->GetIndex(),
+                                  expected.GetPositionListIndex()->GetIndex());
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(pliChecker, SharedLoaderMatchesSeparateLoads) {
+    for (CSVConfig const& csv_config : {kTest1, kNullEmpty, kBreastCancer, kCIPublicHighway700}) {
+        for (bool is_null_eq_null : {true, false}) {
+            auto input_table = MakeInputTable(csv_config);
+            auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, is_null_eq_null);
+            input_table->Reset();
+            auto typed_relation =
+                    model::ColumnLayoutTypedRelationData::CreateFrom(*input_table, is_null_eq_null);
+            for (unsigned threads : {1u, 3u}) {
+                auto shared_table = MakeInputTable(csv_config);
+                model::LoadedRelations loaded =
+                        model::LoadRelations(*shared_table, is_null_eq_null, threads);
+                ASSERT_EQ(loaded.relation->GetNumRows(), relation->GetNumRows());
+                ASSERT_EQ(loaded.typed_relation->GetNumRows(), typed_relation->GetNumRows());
+                ASSERT_EQ(loaded.relation->GetNumColumns(), relation->GetNumColumns());
+                for (size_t i = 0; i < relation->GetNumColumns(); ++i) {
+                    ColumnData const& expected = relation->GetColumnData(i);
+                    ColumnData const& actual = loaded.relation->GetColumnData(i);
+                    EXPECT_EQ(actual.GetColumn()->GetName(), expected.GetColumn()->GetName());
+                    EXPECT_THAT(actual.GetProbingTable(),
+                                ElementsAreArray(expected.GetProbingTable()));
+                    EXPECT_EQ(actual.GetPositionListIndex()->GetIndex(),
+                              expected.GetPositionListIndex()->GetIndex());
+
+                    model::TypedColumnData const& expected_typed =
+                            typed_relation->GetColumnData(i);
+                    model::TypedColumnData const& actual_typed =
+                            loaded.typed_relation->GetColumnData(i);
+                    ASSERT_EQ(actual_typed.GetTypeId(), expected_typed.GetTypeId());
+                    for (size_t row = 0; row < expected_typed.GetNumRows(); ++row) {
+                        EXPECT_EQ(actual_typed.GetValueTypeId(row),
+                                  expected_typed.GetValueTypeId(row));
+                        EXPECT_EQ(actual_typed.GetDataAsString(row),
+                                  expected_typed.GetDataAsString(row));
+                    }
+                }
+            }
+        }
+    }
+}
+
 TEST(pliIntersectChecker, first) {
     deque<vector<int>> ans = {{2, 5}};
     std::shared_ptr<model::PositionListIndex> intersection;
@@ -75,7 +173,108 @@ TEST(pliIntersectChecker, first) {
         cout << "Exception raised in test: " << e.what() << endl;
         FAIL();
     }
-    ASSERT_THAT(intersection->GetIndex(), ContainerEq(ans));
+    model::ClusterIndex const& clusters = intersection->GetIndex();
+    ASSERT_THAT(deque<vector<int>>(clusters.begin(), clusters.end()), ContainerEq(ans));
+}
+
+namespace {
+
+/* Intersection by definition: rows agree iff they have the same value in every column */
+deque<vector<int>> GroupRows(ColumnLayoutRelationData const& relation,
+                             vector<size_t> const& columns) {
+    std::map<vector<int>, vector<int>> groups;
+    for (size_t row = 0; row < relation.GetNumRows(); ++row) {
+        vector<int> key;
+        for (size_t column : columns) {
+            int value = relation.GetColumnData(column).GetProbingTableValue(row);
+            if (value == model::PLI::kSingletonValueId) break;
+            key.push_back(value);
+        }
+        if (key.size() == columns.size()) groups[key].push_back(row);
+    }
+    deque<vector<int>> clusters;
+    for (auto& [key, rows] : groups) {
+        if (rows.size() > 1) clusters.push_back(std::move(rows));
+    }
+    std::sort(clusters.begin(), clusters.end());
+    return clusters;
+}
+
+void CheckClusters(model::PLI const& pli, deque<vector<int>> const& expected) {
+    model::ClusterIndex const& clusters = pli.GetIndex();
+    ASSERT_EQ(deque<vector<int>>(clusters.begin(), clusters.end()), expected);
+    unsigned long long nep = 0;
+    double key_gap = 0;
+    for (vector<int> const& cluster : expected) {
+        nep += cluster.size() * (cluster.size() - 1) / 2;
+        key_gap += cluster.size() * std::log(cluster.size());
+    }
+    ASSERT_EQ(pli.GetNepAsLong(), nep);
+    ASSERT_NEAR(pli.GetEntropy(),
+                std::log(pli.GetRelationSize()) - key_gap / pli.GetRelationSize(), 1e-9);
+}
+
+}  // namespace
+
+TEST(pliIntersectChecker, MatchesGroupingByValues) {
+    for (CSVConfig const& csv_config : {kTest1, kCIPublicHighway700, kNullEmpty}) {
+        auto input_table = MakeInputTable(csv_config);
+        auto relation = ColumnLayoutRelationData::CreateFrom(*input_table, true);
+        size_t const num_columns = relation->GetNumColumns();
+        for (size_t i = 0; i < num_columns; ++i) {
+            model::PLI const* lhs = relation->GetColumnData(i).GetPositionListIndex();
+            for (size_t j = i + 1; j < num_columns; ++j) {
+                model::PLI const* rhs = relation->GetColumnData(j).GetPositionListIndex();
+                CheckClusters(*lhs->Intersect(rhs), GroupRows(*relation, {i, j}));
+                CheckClusters(*rhs->Intersect(lhs), GroupRows(*relation, {i, j}));
+            }
+        }
+
+        boost::dynamic_bitset<> probing_indices(num_columns);
+        vector<size_t> columns = {0};
+        for (size_t i = 1; i < std::min<size_t>(num_columns, 4); ++i) {
+            probing_indices.set(i);
+            columns.push_back(i);
+            model::PLI* pli = relation->GetColumnData(0).GetPositionListIndex();
+            auto probed = pli->ProbeAll(relation->GetSchema()->GetVertical(probing_indices),
+                                        *relation);
+            CheckClusters(*probed, GroupRows(*relation, columns));
+        }
+    }
+}
+
+TEST(pliChecker, CompressedIntersect) {
+    auto relation =
+            ColumnLayoutRelationData::CreateFrom(*MakeInputTable(kCIPublicHighway700), true);
+    auto compressed_relation = ColumnLayoutRelationData::CreateFrom(
+            *MakeInputTable(kCIPublicHighway700), true, 1, true);
+    auto clusters_of = [](model::PLI const& pli) {
+        vector<vector<int>> clusters;
+        pli.ForEachCluster([&clusters](model::PLI::ClusterView cluster) {
+            clusters.emplace_back(cluster.begin(), cluster.end());
+        });
+        return clusters;
+    };
+
+    for (size_t i = 0; i + 1 < relation->GetNumColumns(); ++i) {
+        model::PLI const* pli = relation->GetColumnData(i).GetPositionListIndex();
+        model::PLI const* compressed_pli =
+                compressed_relation->GetColumnData(i).GetPositionListIndex();
+        ASSERT_TRUE(compressed_pli->IsCompressed());
+        ASSERT_LT(compressed_pli->GetClustersBytes(), pli->GetClustersBytes());
+        ASSERT_EQ(compressed_pli->GetNumNonSingletonCluster(), pli->GetNumNonSingletonCluster());
+        ASSERT_EQ(compressed_pli->ToString(), pli->ToString());
+
+        /* Probe the compressed clusters, and build a probing table from them */
+        auto compressed_table = compressed_pli->CalculateAndGetProbingTable();
+        ASSERT_THAT(*compressed_table, ElementsAreArray(*pli->GetCachedProbingTable()));
+        model::PLI const* next = relation->GetColumnData(i + 1).GetPositionListIndex();
+        auto intersection = pli->Intersect(next);
+        auto compressed_intersection = compressed_pli->Probe(next->CalculateAndGetProbingTable());
+        ASSERT_EQ(compressed_intersection->GetIndex(), intersection->GetIndex());
+        ASSERT_EQ(compressed_intersection->GetNepAsLong(), intersection->GetNepAsLong());
+        ASSERT_EQ(clusters_of(*compressed_pli), clusters_of(*pli));
+    }
 }
 
 TEST(testingBitsetToLonglong, first) {
@@ -195,14 +394,17 @@ TEST(AgreeSetFactoryTest, UsingHandlePartition) {
     TestAgreeSetFactory(c);
 }
 
-#if 0
 TEST(AgreeSetFactoryTest, MCGenParallel) {
     AgreeSetFactory::Configuration c(AgreeSetsGenMethod::kUsingVectorOfIDSets,
-                                     MCGenMethod::kParallel,
-                                     std::thread::hardware_concurrency());
-    testAgreeSetFactory(c);
+                                     MCGenMethod::kParallel, 4);
+    TestAgreeSetFactory(c);
+}
+
+TEST(AgreeSetFactoryTest, UsingMapOfIDSetsParallel) {
+    AgreeSetFactory::Configuration c(AgreeSetsGenMethod::kUsingMapOfIDSets,
+                                     MCGenMethod::kUsingCalculateSupersets, 4);
+    TestAgreeSetFactory(c);
 }
-#endif
 
 struct TestLevenshteinParam {
     std::string l;
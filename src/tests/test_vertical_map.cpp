@@ -0,0 +1,68 @@
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+
+#include <boost/dynamic_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include "model/table/relational_schema.h"
+#include "model/table/vertical.h"
+#include "model/table/vertical_map.h"
+
+namespace tests {
+
+TEST(VerticalMapTest, MatchesBruteForce) {
+    size_t const num_columns = 10;
+    RelationalSchema schema("vertical_map");
+    for (size_t i = 0; i < num_columns; ++i) {
+        schema.AppendColumn(std::to_string(i));
+    }
+    schema.Init();
+
+    auto keys_of = [](auto const& entries) {
+        std::set<boost::dynamic_bitset<>> keys;
+        for (auto const& [key, value] : entries) {
+            keys.insert(key.GetColumnIndices());
+            EXPECT_EQ(*value, key);
+        }
+        return keys;
+    };
+
+    model::VerticalMap<Vertical> map(&schema);
+    std::set<boost::dynamic_bitset<>> expected;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<unsigned long> random_key(0, (1ul << num_columns) - 1);
+    for (int i = 0; i < 1000; ++i) {
+        boost::dynamic_bitset<> key(num_columns, random_key(gen));
+        Vertical vertical = schema.GetVertical(key);
+        if (i % 3 == 2) {
+            ASSERT_EQ(map.Remove(vertical) != nullptr, expected.erase(key) == 1);
+        } else {
+            ASSERT_EQ(map.Put(vertical, std::make_shared<Vertical>(vertical)) == nullptr,
+                      expected.insert(key).second);
+        }
+        ASSERT_EQ(map.GetSize(), expected.size());
+
+        boost::dynamic_bitset<> probe(num_columns, random_key(gen));
+        Vertical probe_vertical = schema.GetVertical(probe);
+        std::set<boost::dynamic_bitset<>> subsets, supersets, restricted_supersets;
+        for (auto const& expected_key : expected) {
+            if (expected_key.is_subset_of(probe)) subsets.insert(expected_key);
+            if (probe.is_subset_of(expected_key)) {
+                supersets.insert(expected_key);
+                if (!expected_key.intersects(key - probe)) {
+                    restricted_supersets.insert(expected_key);
+                }
+            }
+        }
+        ASSERT_EQ(keys_of(map.GetSubsetEntries(probe_vertical)), subsets);
+        ASSERT_EQ(keys_of(map.GetSupersetEntries(probe_vertical)), supersets);
+        ASSERT_EQ(keys_of(map.GetRestrictedSupersetEntries(probe_vertical,
+                                                           schema.GetVertical(key - probe))),
+                  restricted_supersets);
+        ASSERT_EQ(map.ContainsKey(probe_vertical), expected.count(probe) == 1);
+    }
+}
+
+}  // namespace tests